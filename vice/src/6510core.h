@@ -86,4 +86,27 @@
         }                                       \
     } while (0)
 
+/* Opcode dispatch in the 65xx cores (6510core.c, 6510dtvcore.c, 65c02core.c).
+
+   The opcodes are written as a switch using the macros below. When
+   configured with --enable-computed-goto and built with a compiler that
+   supports labels as values, every opcode becomes a label instead and the
+   core jumps through a table of their addresses, which gives one indirect
+   branch per opcode without the range check of the switch.  */
+#if defined(USE_COMPUTED_GOTO_DISPATCH) && defined(__GNUC__)
+#define OPCODE_DISPATCH_GOTO
+
+#define OPCODE_SWITCH(op, table)    goto *(table)[(op)];
+#define OPCODE_CASE(n)              op_##n
+#define OPCODE_DEFAULT              op_default
+#define OPCODE_BREAK                goto opcode_done
+#define OPCODE_END                  opcode_done: ;
+#else
+#define OPCODE_SWITCH(op, table)    switch (op)
+#define OPCODE_CASE(n)              case n
+#define OPCODE_DEFAULT              default
+#define OPCODE_BREAK                break
+#define OPCODE_END
+#endif
+
 #endif
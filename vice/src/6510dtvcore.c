@@ -1744,6 +1744,42 @@ static const uint8_t fetch_tab[] = {
 
     {
         opcode_t opcode;
+#ifdef OPCODE_DISPATCH_GOTO
+        static const void *const opcode_table[0x100] = {
+            &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+            &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+            &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+            &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+            &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+            &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+            &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+            &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+            &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+            &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+            &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+            &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+            &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+            &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+            &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+            &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+            &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+            &&op_0x88, &&op_0x89, &&op_0x8a, &&op_0x8b, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+            &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+            &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+            &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+            &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+            &&op_0xb0, &&op_0xb1, &&op_0xb2, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+            &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+            &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7,
+            &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+            &&op_0xd0, &&op_0xd1, &&op_0xd2, &&op_0xd3, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7,
+            &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_0xdb, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_0xdf,
+            &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_0xe3, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_0xe7,
+            &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_0xeb, &&op_0xec, &&op_0xed, &&op_0xee, &&op_0xef,
+            &&op_0xf0, &&op_0xf1, &&op_0xf2, &&op_0xf3, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_0xf7,
+            &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_0xfb, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_0xff
+        };
+#endif
 #if defined (DEBUG) || defined (FEATURE_CPUMEMHISTORY)
         debug_clk = maincpu_clk;
 #endif
@@ -1795,952 +1831,953 @@ trap_skipped:
         SET_LAST_OPCODE(p0);
 #endif
 
-        switch (p0) {
-            case 0x00:          /* BRK */
+        OPCODE_SWITCH(p0, opcode_table) {
+            OPCODE_CASE(0x00):  /* BRK */
                 BRK();
-                break;
+                OPCODE_BREAK;
 
-            case 0x01:          /* ORA ($nn,X) */
+            OPCODE_CASE(0x01):  /* ORA ($nn,X) */
                 ORA(GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x02:          /* JAM - also used for traps */
+            OPCODE_CASE(0x02):  /* JAM - also used for traps */
                 STATIC_ASSERT(TRAP_OPCODE == 0x02);
                 JAM_02();
-                break;
-
-            case 0x22:          /* JAM */
-            case 0x52:          /* JAM */
-            case 0x62:          /* JAM */
-            case 0x72:          /* JAM */
-            case 0x92:          /* JAM */
-            case 0xb2:          /* JAM */
-            case 0xd2:          /* JAM */
-            case 0xf2:          /* JAM */
+                OPCODE_BREAK;
+
+            OPCODE_CASE(0x22):  /* JAM */
+            OPCODE_CASE(0x52):  /* JAM */
+            OPCODE_CASE(0x62):  /* JAM */
+            OPCODE_CASE(0x72):  /* JAM */
+            OPCODE_CASE(0x92):  /* JAM */
+            OPCODE_CASE(0xb2):  /* JAM */
+            OPCODE_CASE(0xd2):  /* JAM */
+            OPCODE_CASE(0xf2):  /* JAM */
 #ifndef C64DTV
-            case 0x12:          /* JAM */
-            case 0x32:          /* JAM */
-            case 0x42:          /* JAM */
+            OPCODE_CASE(0x12):  /* JAM */
+            OPCODE_CASE(0x32):  /* JAM */
+            OPCODE_CASE(0x42):  /* JAM */
 #endif
                 cpu_is_jammed = 1;
                 REWIND_FETCH_OPCODE(CLK);
                 JAM();
-                break;
+                OPCODE_BREAK;
 
 #ifdef C64DTV
-            case 0x12:          /* BRA $nnnn */
+            OPCODE_CASE(0x12):  /* BRA $nnnn */
                 BRANCH(1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x32:          /* SAC #$nn */
+            OPCODE_CASE(0x32):  /* SAC #$nn */
                 SAC();
-                break;
+                OPCODE_BREAK;
 
-            case 0x42:          /* SIR #$nn */
+            OPCODE_CASE(0x42):  /* SIR #$nn */
                 SIR();
-                break;
+                OPCODE_BREAK;
 #endif
 
-            case 0x03:          /* SLO ($nn,X) */
+            OPCODE_CASE(0x03):  /* SLO ($nn,X) */
                 SLO(2, GET_IND_X, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x04:          /* NOOP $nn */
-            case 0x44:          /* NOOP $nn */
-            case 0x64:          /* NOOP $nn */
+            OPCODE_CASE(0x04):  /* NOOP $nn */
+            OPCODE_CASE(0x44):  /* NOOP $nn */
+            OPCODE_CASE(0x64):  /* NOOP $nn */
                 NOOP(GET_ZERO_DUMMY, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x05:          /* ORA $nn */
+            OPCODE_CASE(0x05):  /* ORA $nn */
                 ORA(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x06:          /* ASL $nn */
+            OPCODE_CASE(0x06):  /* ASL $nn */
                 ASL(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x07:          /* SLO $nn */
+            OPCODE_CASE(0x07):  /* SLO $nn */
                 SLO(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x08:          /* PHP */
+            OPCODE_CASE(0x08):  /* PHP */
                 PHP();
-                break;
+                OPCODE_BREAK;
 
-            case 0x09:          /* ORA #$nn */
+            OPCODE_CASE(0x09):  /* ORA #$nn */
                 ORA(GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0a:          /* ASL A */
+            OPCODE_CASE(0x0a):  /* ASL A */
                 ASL_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x0b:          /* ANC #$nn */
-            case 0x2b:          /* ANC #$nn */
+            OPCODE_CASE(0x0b):  /* ANC #$nn */
+            OPCODE_CASE(0x2b):  /* ANC #$nn */
                 ANC();
-                break;
+                OPCODE_BREAK;
 
-            case 0x0c:          /* NOOP $nnnn */
+            OPCODE_CASE(0x0c):  /* NOOP $nnnn */
                 NOOP(GET_ABS_DUMMY, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0d:          /* ORA $nnnn */
+            OPCODE_CASE(0x0d):  /* ORA $nnnn */
                 ORA(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0e:          /* ASL $nnnn */
+            OPCODE_CASE(0x0e):  /* ASL $nnnn */
                 ASL(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0f:          /* SLO $nnnn */
+            OPCODE_CASE(0x0f):  /* SLO $nnnn */
                 SLO(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x10:          /* BPL $nnnn */
+            OPCODE_CASE(0x10):  /* BPL $nnnn */
                 BRANCH(!LOCAL_SIGN());
-                break;
+                OPCODE_BREAK;
 
-            case 0x11:          /* ORA ($nn),Y */
+            OPCODE_CASE(0x11):  /* ORA ($nn),Y */
                 ORA(GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x13:          /* SLO ($nn),Y */
+            OPCODE_CASE(0x13):  /* SLO ($nn),Y */
                 SLO(2, GET_IND_Y_RMW, SET_IND_RMW);
-                break;
-
-            case 0x14:          /* NOOP $nn,X */
-            case 0x34:          /* NOOP $nn,X */
-            case 0x54:          /* NOOP $nn,X */
-            case 0x74:          /* NOOP $nn,X */
-            case 0xd4:          /* NOOP $nn,X */
-            case 0xf4:          /* NOOP $nn,X */
+                OPCODE_BREAK;
+
+            OPCODE_CASE(0x14):  /* NOOP $nn,X */
+            OPCODE_CASE(0x34):  /* NOOP $nn,X */
+            OPCODE_CASE(0x54):  /* NOOP $nn,X */
+            OPCODE_CASE(0x74):  /* NOOP $nn,X */
+            OPCODE_CASE(0xd4):  /* NOOP $nn,X */
+            OPCODE_CASE(0xf4):  /* NOOP $nn,X */
                 NOOP(GET_ZERO_X_DUMMY, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x15:          /* ORA $nn,X */
+            OPCODE_CASE(0x15):  /* ORA $nn,X */
                 ORA(GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x16:          /* ASL $nn,X */
+            OPCODE_CASE(0x16):  /* ASL $nn,X */
                 ASL(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x17:          /* SLO $nn,X */
+            OPCODE_CASE(0x17):  /* SLO $nn,X */
                 SLO(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x18:          /* CLC */
+            OPCODE_CASE(0x18):  /* CLC */
                 CLC();
-                break;
+                OPCODE_BREAK;
 
-            case 0x19:          /* ORA $nnnn,Y */
+            OPCODE_CASE(0x19):  /* ORA $nnnn,Y */
                 ORA(GET_ABS_Y, 3);
-                break;
-
-            case 0x1a:          /* NOOP */
-            case 0x3a:          /* NOOP */
-            case 0x5a:          /* NOOP */
-            case 0x7a:          /* NOOP */
-            case 0xda:          /* NOOP */
-            case 0xfa:          /* NOOP */
-            case 0xea:          /* NOP */
+                OPCODE_BREAK;
+
+            OPCODE_CASE(0x1a):  /* NOOP */
+            OPCODE_CASE(0x3a):  /* NOOP */
+            OPCODE_CASE(0x5a):  /* NOOP */
+            OPCODE_CASE(0x7a):  /* NOOP */
+            OPCODE_CASE(0xda):  /* NOOP */
+            OPCODE_CASE(0xfa):  /* NOOP */
+            OPCODE_CASE(0xea):  /* NOP */
                 NOOP(GET_IMM_DUMMY, 1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1b:          /* SLO $nnnn,Y */
+            OPCODE_CASE(0x1b):  /* SLO $nnnn,Y */
                 SLO(3, GET_ABS_Y_RMW, SET_ABS_Y_RMW);
-                break;
-
-            case 0x1c:          /* NOOP $nnnn,X */
-            case 0x3c:          /* NOOP $nnnn,X */
-            case 0x5c:          /* NOOP $nnnn,X */
-            case 0x7c:          /* NOOP $nnnn,X */
-            case 0xdc:          /* NOOP $nnnn,X */
-            case 0xfc:          /* NOOP $nnnn,X */
+                OPCODE_BREAK;
+
+            OPCODE_CASE(0x1c):  /* NOOP $nnnn,X */
+            OPCODE_CASE(0x3c):  /* NOOP $nnnn,X */
+            OPCODE_CASE(0x5c):  /* NOOP $nnnn,X */
+            OPCODE_CASE(0x7c):  /* NOOP $nnnn,X */
+            OPCODE_CASE(0xdc):  /* NOOP $nnnn,X */
+            OPCODE_CASE(0xfc):  /* NOOP $nnnn,X */
                 NOOP(GET_ABS_X_DUMMY, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1d:          /* ORA $nnnn,X */
+            OPCODE_CASE(0x1d):  /* ORA $nnnn,X */
                 ORA(GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1e:          /* ASL $nnnn,X */
+            OPCODE_CASE(0x1e):  /* ASL $nnnn,X */
                 ASL(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1f:          /* SLO $nnnn,X */
+            OPCODE_CASE(0x1f):  /* SLO $nnnn,X */
                 SLO(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x20:          /* JSR $nnnn */
+            OPCODE_CASE(0x20):  /* JSR $nnnn */
                 JSR();
-                break;
+                OPCODE_BREAK;
 
-            case 0x21:          /* AND ($nn,X) */
+            OPCODE_CASE(0x21):  /* AND ($nn,X) */
                 AND(GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x23:          /* RLA ($nn,X) */
+            OPCODE_CASE(0x23):  /* RLA ($nn,X) */
                 RLA(2, GET_IND_X, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x24:          /* BIT $nn */
+            OPCODE_CASE(0x24):  /* BIT $nn */
                 BIT(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x25:          /* AND $nn */
+            OPCODE_CASE(0x25):  /* AND $nn */
                 AND(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x26:          /* ROL $nn */
+            OPCODE_CASE(0x26):  /* ROL $nn */
                 ROL(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x27:          /* RLA $nn */
+            OPCODE_CASE(0x27):  /* RLA $nn */
                 RLA(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x28:          /* PLP */
+            OPCODE_CASE(0x28):  /* PLP */
                 PLP();
-                break;
+                OPCODE_BREAK;
 
-            case 0x29:          /* AND #$nn */
+            OPCODE_CASE(0x29):  /* AND #$nn */
                 AND(GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2a:          /* ROL A */
+            OPCODE_CASE(0x2a):  /* ROL A */
                 ROL_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x2c:          /* BIT $nnnn */
+            OPCODE_CASE(0x2c):  /* BIT $nnnn */
                 BIT(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2d:          /* AND $nnnn */
+            OPCODE_CASE(0x2d):  /* AND $nnnn */
                 AND(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2e:          /* ROL $nnnn */
+            OPCODE_CASE(0x2e):  /* ROL $nnnn */
                 ROL(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2f:          /* RLA $nnnn */
+            OPCODE_CASE(0x2f):  /* RLA $nnnn */
                 RLA(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x30:          /* BMI $nnnn */
+            OPCODE_CASE(0x30):  /* BMI $nnnn */
                 BRANCH(LOCAL_SIGN());
-                break;
+                OPCODE_BREAK;
 
-            case 0x31:          /* AND ($nn),Y */
+            OPCODE_CASE(0x31):  /* AND ($nn),Y */
                 AND(GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x33:          /* RLA ($nn),Y */
+            OPCODE_CASE(0x33):  /* RLA ($nn),Y */
                 RLA(2, GET_IND_Y_RMW, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x35:          /* AND $nn,X */
+            OPCODE_CASE(0x35):  /* AND $nn,X */
                 AND(GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x36:          /* ROL $nn,X */
+            OPCODE_CASE(0x36):  /* ROL $nn,X */
                 ROL(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x37:          /* RLA $nn,X */
+            OPCODE_CASE(0x37):  /* RLA $nn,X */
                 RLA(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x38:          /* SEC */
+            OPCODE_CASE(0x38):  /* SEC */
                 SEC();
-                break;
+                OPCODE_BREAK;
 
-            case 0x39:          /* AND $nnnn,Y */
+            OPCODE_CASE(0x39):  /* AND $nnnn,Y */
                 AND(GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3b:          /* RLA $nnnn,Y */
+            OPCODE_CASE(0x3b):  /* RLA $nnnn,Y */
                 RLA(3, GET_ABS_Y_RMW, SET_ABS_Y_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3d:          /* AND $nnnn,X */
+            OPCODE_CASE(0x3d):  /* AND $nnnn,X */
                 AND(GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3e:          /* ROL $nnnn,X */
+            OPCODE_CASE(0x3e):  /* ROL $nnnn,X */
                 ROL(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3f:          /* RLA $nnnn,X */
+            OPCODE_CASE(0x3f):  /* RLA $nnnn,X */
                 RLA(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x40:          /* RTI */
+            OPCODE_CASE(0x40):  /* RTI */
                 RTI();
-                break;
+                OPCODE_BREAK;
 
-            case 0x41:          /* EOR ($nn,X) */
+            OPCODE_CASE(0x41):  /* EOR ($nn,X) */
                 EOR(GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x43:          /* SRE ($nn,X) */
+            OPCODE_CASE(0x43):  /* SRE ($nn,X) */
                 SRE(2, GET_IND_X, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x45:          /* EOR $nn */
+            OPCODE_CASE(0x45):  /* EOR $nn */
                 EOR(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x46:          /* LSR $nn */
+            OPCODE_CASE(0x46):  /* LSR $nn */
                 LSR(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x47:          /* SRE $nn */
+            OPCODE_CASE(0x47):  /* SRE $nn */
                 SRE(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x48:          /* PHA */
+            OPCODE_CASE(0x48):  /* PHA */
                 PHA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x49:          /* EOR #$nn */
+            OPCODE_CASE(0x49):  /* EOR #$nn */
                 EOR(GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4a:          /* LSR A */
+            OPCODE_CASE(0x4a):  /* LSR A */
                 LSR_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x4b:          /* ASR #$nn */
+            OPCODE_CASE(0x4b):  /* ASR #$nn */
                 ASR();
-                break;
+                OPCODE_BREAK;
 
-            case 0x4c:          /* JMP $nnnn */
+            OPCODE_CASE(0x4c):  /* JMP $nnnn */
                 JMP(p2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4d:          /* EOR $nnnn */
+            OPCODE_CASE(0x4d):  /* EOR $nnnn */
                 EOR(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4e:          /* LSR $nnnn */
+            OPCODE_CASE(0x4e):  /* LSR $nnnn */
                 LSR(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4f:          /* SRE $nnnn */
+            OPCODE_CASE(0x4f):  /* SRE $nnnn */
                 SRE(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x50:          /* BVC $nnnn */
+            OPCODE_CASE(0x50):  /* BVC $nnnn */
                 BRANCH(!LOCAL_OVERFLOW());
-                break;
+                OPCODE_BREAK;
 
-            case 0x51:          /* EOR ($nn),Y */
+            OPCODE_CASE(0x51):  /* EOR ($nn),Y */
                 EOR(GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x53:          /* SRE ($nn),Y */
+            OPCODE_CASE(0x53):  /* SRE ($nn),Y */
                 SRE(2, GET_IND_Y_RMW, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x55:          /* EOR $nn,X */
+            OPCODE_CASE(0x55):  /* EOR $nn,X */
                 EOR(GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x56:          /* LSR $nn,X */
+            OPCODE_CASE(0x56):  /* LSR $nn,X */
                 LSR(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x57:          /* SRE $nn,X */
+            OPCODE_CASE(0x57):  /* SRE $nn,X */
                 SRE(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x58:          /* CLI */
+            OPCODE_CASE(0x58):  /* CLI */
                 CLI();
-                break;
+                OPCODE_BREAK;
 
-            case 0x59:          /* EOR $nnnn,Y */
+            OPCODE_CASE(0x59):  /* EOR $nnnn,Y */
                 EOR(GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5b:          /* SRE $nnnn,Y */
+            OPCODE_CASE(0x5b):  /* SRE $nnnn,Y */
                 SRE(3, GET_ABS_Y_RMW, SET_ABS_Y_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5d:          /* EOR $nnnn,X */
+            OPCODE_CASE(0x5d):  /* EOR $nnnn,X */
                 EOR(GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5e:          /* LSR $nnnn,X */
+            OPCODE_CASE(0x5e):  /* LSR $nnnn,X */
                 LSR(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5f:          /* SRE $nnnn,X */
+            OPCODE_CASE(0x5f):  /* SRE $nnnn,X */
                 SRE(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x60:          /* RTS */
+            OPCODE_CASE(0x60):  /* RTS */
                 RTS();
-                break;
+                OPCODE_BREAK;
 
-            case 0x61:          /* ADC ($nn,X) */
+            OPCODE_CASE(0x61):  /* ADC ($nn,X) */
                 ADC(GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x63:          /* RRA ($nn,X) */
+            OPCODE_CASE(0x63):  /* RRA ($nn,X) */
                 RRA(2, GET_IND_X, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x65:          /* ADC $nn */
+            OPCODE_CASE(0x65):  /* ADC $nn */
                 ADC(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x66:          /* ROR $nn */
+            OPCODE_CASE(0x66):  /* ROR $nn */
                 ROR(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x67:          /* RRA $nn */
+            OPCODE_CASE(0x67):  /* RRA $nn */
                 RRA(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x68:          /* PLA */
+            OPCODE_CASE(0x68):  /* PLA */
                 PLA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x69:          /* ADC #$nn */
+            OPCODE_CASE(0x69):  /* ADC #$nn */
                 ADC(GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x6a:          /* ROR A */
+            OPCODE_CASE(0x6a):  /* ROR A */
                 ROR_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x6b:          /* ARR #$nn */
+            OPCODE_CASE(0x6b):  /* ARR #$nn */
                 ARR();
-                break;
+                OPCODE_BREAK;
 
-            case 0x6c:          /* JMP ($nnnn) */
+            OPCODE_CASE(0x6c):  /* JMP ($nnnn) */
                 JMP_IND();
-                break;
+                OPCODE_BREAK;
 
-            case 0x6d:          /* ADC $nnnn */
+            OPCODE_CASE(0x6d):  /* ADC $nnnn */
                 ADC(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x6e:          /* ROR $nnnn */
+            OPCODE_CASE(0x6e):  /* ROR $nnnn */
                 ROR(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x6f:          /* RRA $nnnn */
+            OPCODE_CASE(0x6f):  /* RRA $nnnn */
                 RRA(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x70:          /* BVS $nnnn */
+            OPCODE_CASE(0x70):  /* BVS $nnnn */
                 BRANCH(LOCAL_OVERFLOW());
-                break;
+                OPCODE_BREAK;
 
-            case 0x71:          /* ADC ($nn),Y */
+            OPCODE_CASE(0x71):  /* ADC ($nn),Y */
                 ADC(GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x73:          /* RRA ($nn),Y */
+            OPCODE_CASE(0x73):  /* RRA ($nn),Y */
                 RRA(2, GET_IND_Y_RMW, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x75:          /* ADC $nn,X */
+            OPCODE_CASE(0x75):  /* ADC $nn,X */
                 ADC(GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x76:          /* ROR $nn,X */
+            OPCODE_CASE(0x76):  /* ROR $nn,X */
                 ROR(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x77:          /* RRA $nn,X */
+            OPCODE_CASE(0x77):  /* RRA $nn,X */
                 RRA(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x78:          /* SEI */
+            OPCODE_CASE(0x78):  /* SEI */
                 SEI();
-                break;
+                OPCODE_BREAK;
 
-            case 0x79:          /* ADC $nnnn,Y */
+            OPCODE_CASE(0x79):  /* ADC $nnnn,Y */
                 ADC(GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7b:          /* RRA $nnnn,Y */
+            OPCODE_CASE(0x7b):  /* RRA $nnnn,Y */
                 RRA(3, GET_ABS_Y_RMW, SET_ABS_Y_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7d:          /* ADC $nnnn,X */
+            OPCODE_CASE(0x7d):  /* ADC $nnnn,X */
                 ADC(GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7e:          /* ROR $nnnn,X */
+            OPCODE_CASE(0x7e):  /* ROR $nnnn,X */
                 ROR(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7f:          /* RRA $nnnn,X */
+            OPCODE_CASE(0x7f):  /* RRA $nnnn,X */
                 RRA(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x80:          /* NOOP #$nn */
-            case 0x82:          /* NOOP #$nn */
-            case 0x89:          /* NOOP #$nn */
-            case 0xc2:          /* NOOP #$nn */
-            case 0xe2:          /* NOOP #$nn */
+            OPCODE_CASE(0x80):  /* NOOP #$nn */
+            OPCODE_CASE(0x82):  /* NOOP #$nn */
+            OPCODE_CASE(0x89):  /* NOOP #$nn */
+            OPCODE_CASE(0xc2):  /* NOOP #$nn */
+            OPCODE_CASE(0xe2):  /* NOOP #$nn */
                 NOOP(GET_IMM_DUMMY, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x81:          /* STA ($nn,X) */
+            OPCODE_CASE(0x81):  /* STA ($nn,X) */
                 ST(reg_a_read, SET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x83:          /* SAX ($nn,X) */
+            OPCODE_CASE(0x83):  /* SAX ($nn,X) */
                 ST(reg_a_read & reg_x, SET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x84:          /* STY $nn */
+            OPCODE_CASE(0x84):  /* STY $nn */
                 ST(reg_y, SET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x85:          /* STA $nn */
+            OPCODE_CASE(0x85):  /* STA $nn */
                 ST(reg_a_read, SET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x86:          /* STX $nn */
+            OPCODE_CASE(0x86):  /* STX $nn */
                 ST(reg_x, SET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x87:          /* SAX $nn */
+            OPCODE_CASE(0x87):  /* SAX $nn */
                 ST(reg_a_read & reg_x, SET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x88:          /* DEY */
+            OPCODE_CASE(0x88):  /* DEY */
                 DEY();
-                break;
+                OPCODE_BREAK;
 
-            case 0x8a:          /* TXA */
+            OPCODE_CASE(0x8a):  /* TXA */
                 TXA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x8b:          /* ANE #$nn */
+            OPCODE_CASE(0x8b):  /* ANE #$nn */
                 ANE();
-                break;
+                OPCODE_BREAK;
 
-            case 0x8c:          /* STY $nnnn */
+            OPCODE_CASE(0x8c):  /* STY $nnnn */
                 ST(reg_y, SET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8d:          /* STA $nnnn */
+            OPCODE_CASE(0x8d):  /* STA $nnnn */
                 ST(reg_a_read, SET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8e:          /* STX $nnnn */
+            OPCODE_CASE(0x8e):  /* STX $nnnn */
                 ST(reg_x, SET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8f:          /* SAX $nnnn */
+            OPCODE_CASE(0x8f):  /* SAX $nnnn */
                 ST(reg_a_read & reg_x, SET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x90:          /* BCC $nnnn */
+            OPCODE_CASE(0x90):  /* BCC $nnnn */
                 BRANCH(!LOCAL_CARRY());
-                break;
+                OPCODE_BREAK;
 
-            case 0x91:          /* STA ($nn),Y */
+            OPCODE_CASE(0x91):  /* STA ($nn),Y */
                 ST(reg_a_read, SET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x93:          /* SHA ($nn),Y */
+            OPCODE_CASE(0x93):  /* SHA ($nn),Y */
                 SHA_IND_Y();
-                break;
+                OPCODE_BREAK;
 
-            case 0x94:          /* STY $nn,X */
+            OPCODE_CASE(0x94):  /* STY $nn,X */
                 ST(reg_y, SET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x95:          /* STA $nn,X */
+            OPCODE_CASE(0x95):  /* STA $nn,X */
                 ST(reg_a_read, SET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x96:          /* STX $nn,Y */
+            OPCODE_CASE(0x96):  /* STX $nn,Y */
                 ST(reg_x, SET_ZERO_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x97:          /* SAX $nn,Y */
+            OPCODE_CASE(0x97):  /* SAX $nn,Y */
                 ST(reg_a_read & reg_x, SET_ZERO_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x98:          /* TYA */
+            OPCODE_CASE(0x98):  /* TYA */
                 TYA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x99:          /* STA $nnnn,Y */
+            OPCODE_CASE(0x99):  /* STA $nnnn,Y */
                 ST(reg_a_read, SET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9a:          /* TXS */
+            OPCODE_CASE(0x9a):  /* TXS */
                 TXS();
-                break;
+                OPCODE_BREAK;
 
-            case 0x9b:          /* NOP (SHS) $nnnn,Y */
+            OPCODE_CASE(0x9b):  /* NOP (SHS) $nnnn,Y */
 #ifdef C64DTV
                 NOOP(GET_ABS_Y_DUMMY, 3);
 #else
                 SHS_ABS_Y();
 #endif
-                break;
+                OPCODE_BREAK;
 
-            case 0x9c:          /* SHY $nnnn,X */
+            OPCODE_CASE(0x9c):  /* SHY $nnnn,X */
                 SH_ABS_I(reg_y, reg_x);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9d:          /* STA $nnnn,X */
+            OPCODE_CASE(0x9d):  /* STA $nnnn,X */
                 ST(reg_a_read, SET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9e:          /* SHX $nnnn,Y */
+            OPCODE_CASE(0x9e):  /* SHX $nnnn,Y */
                 SH_ABS_I(reg_x, reg_y);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9f:          /* SHA $nnnn,Y */
+            OPCODE_CASE(0x9f):  /* SHA $nnnn,Y */
                 SH_ABS_I(reg_a_read & reg_x, reg_y);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa0:          /* LDY #$nn */
+            OPCODE_CASE(0xa0):  /* LDY #$nn */
                 LD(reg_y, GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa1:          /* LDA ($nn,X) */
+            OPCODE_CASE(0xa1):  /* LDA ($nn,X) */
                 LD(reg_a_write, GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa2:          /* LDX #$nn */
+            OPCODE_CASE(0xa2):  /* LDX #$nn */
                 LD(reg_x, GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa3:          /* LAX ($nn,X) */
+            OPCODE_CASE(0xa3):  /* LAX ($nn,X) */
                 LAX(GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa4:          /* LDY $nn */
+            OPCODE_CASE(0xa4):  /* LDY $nn */
                 LD(reg_y, GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa5:          /* LDA $nn */
+            OPCODE_CASE(0xa5):  /* LDA $nn */
                 LD(reg_a_write, GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa6:          /* LDX $nn */
+            OPCODE_CASE(0xa6):  /* LDX $nn */
                 LD(reg_x, GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa7:          /* LAX $nn */
+            OPCODE_CASE(0xa7):  /* LAX $nn */
                 LAX(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa8:          /* TAY */
+            OPCODE_CASE(0xa8):  /* TAY */
                 TAY();
-                break;
+                OPCODE_BREAK;
 
-            case 0xa9:          /* LDA #$nn */
+            OPCODE_CASE(0xa9):  /* LDA #$nn */
                 LD(reg_a_write, GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xaa:          /* TAX */
+            OPCODE_CASE(0xaa):  /* TAX */
                 TAX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xab:          /* LXA #$nn */
+            OPCODE_CASE(0xab):  /* LXA #$nn */
                 LXA();
-                break;
+                OPCODE_BREAK;
 
-            case 0xac:          /* LDY $nnnn */
+            OPCODE_CASE(0xac):  /* LDY $nnnn */
                 LD(reg_y, GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xad:          /* LDA $nnnn */
+            OPCODE_CASE(0xad):  /* LDA $nnnn */
                 LD(reg_a_write, GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xae:          /* LDX $nnnn */
+            OPCODE_CASE(0xae):  /* LDX $nnnn */
                 LD(reg_x, GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xaf:          /* LAX $nnnn */
+            OPCODE_CASE(0xaf):  /* LAX $nnnn */
                 LAX(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb0:          /* BCS $nnnn */
+            OPCODE_CASE(0xb0):  /* BCS $nnnn */
                 BRANCH(LOCAL_CARRY());
-                break;
+                OPCODE_BREAK;
 
-            case 0xb1:          /* LDA ($nn),Y */
+            OPCODE_CASE(0xb1):  /* LDA ($nn),Y */
                 LD(reg_a_write, GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb3:          /* LAX ($nn),Y */
+            OPCODE_CASE(0xb3):  /* LAX ($nn),Y */
                 LAX(GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb4:          /* LDY $nn,X */
+            OPCODE_CASE(0xb4):  /* LDY $nn,X */
                 LD(reg_y, GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb5:          /* LDA $nn,X */
+            OPCODE_CASE(0xb5):  /* LDA $nn,X */
                 LD(reg_a_write, GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb6:          /* LDX $nn,Y */
+            OPCODE_CASE(0xb6):  /* LDX $nn,Y */
                 LD(reg_x, GET_ZERO_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb7:          /* LAX $nn,Y */
+            OPCODE_CASE(0xb7):  /* LAX $nn,Y */
                 LAX(GET_ZERO_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb8:          /* CLV */
+            OPCODE_CASE(0xb8):  /* CLV */
                 CLV();
-                break;
+                OPCODE_BREAK;
 
-            case 0xb9:          /* LDA $nnnn,Y */
+            OPCODE_CASE(0xb9):  /* LDA $nnnn,Y */
                 LD(reg_a_write, GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xba:          /* TSX */
+            OPCODE_CASE(0xba):  /* TSX */
                 TSX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xbb:          /* LAS $nnnn,Y */
+            OPCODE_CASE(0xbb):  /* LAS $nnnn,Y */
                 LAS();
-                break;
+                OPCODE_BREAK;
 
-            case 0xbc:          /* LDY $nnnn,X */
+            OPCODE_CASE(0xbc):  /* LDY $nnnn,X */
                 LD(reg_y, GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xbd:          /* LDA $nnnn,X */
+            OPCODE_CASE(0xbd):  /* LDA $nnnn,X */
                 LD(reg_a_write, GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xbe:          /* LDX $nnnn,Y */
+            OPCODE_CASE(0xbe):  /* LDX $nnnn,Y */
                 LD(reg_x, GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xbf:          /* LAX $nnnn,Y */
+            OPCODE_CASE(0xbf):  /* LAX $nnnn,Y */
                 LAX(GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc0:          /* CPY #$nn */
+            OPCODE_CASE(0xc0):  /* CPY #$nn */
                 CP(reg_y, GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc1:          /* CMP ($nn,X) */
+            OPCODE_CASE(0xc1):  /* CMP ($nn,X) */
                 CP(reg_a_read, GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc3:          /* DCP ($nn,X) */
+            OPCODE_CASE(0xc3):  /* DCP ($nn,X) */
                 DCP(2, GET_IND_X, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc4:          /* CPY $nn */
+            OPCODE_CASE(0xc4):  /* CPY $nn */
                 CP(reg_y, GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc5:          /* CMP $nn */
+            OPCODE_CASE(0xc5):  /* CMP $nn */
                 CP(reg_a_read, GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc6:          /* DEC $nn */
+            OPCODE_CASE(0xc6):  /* DEC $nn */
                 DEC(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc7:          /* DCP $nn */
+            OPCODE_CASE(0xc7):  /* DCP $nn */
                 DCP(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc8:          /* INY */
+            OPCODE_CASE(0xc8):  /* INY */
                 INY();
-                break;
+                OPCODE_BREAK;
 
-            case 0xc9:          /* CMP #$nn */
+            OPCODE_CASE(0xc9):  /* CMP #$nn */
                 CP(reg_a_read, GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xca:          /* DEX */
+            OPCODE_CASE(0xca):  /* DEX */
                 DEX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xcb:          /* SBX #$nn */
+            OPCODE_CASE(0xcb):  /* SBX #$nn */
                 SBX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xcc:          /* CPY $nnnn */
+            OPCODE_CASE(0xcc):  /* CPY $nnnn */
                 CP(reg_y, GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xcd:          /* CMP $nnnn */
+            OPCODE_CASE(0xcd):  /* CMP $nnnn */
                 CP(reg_a_read, GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xce:          /* DEC $nnnn */
+            OPCODE_CASE(0xce):  /* DEC $nnnn */
                 DEC(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xcf:          /* DCP $nnnn */
+            OPCODE_CASE(0xcf):  /* DCP $nnnn */
                 DCP(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd0:          /* BNE $nnnn */
+            OPCODE_CASE(0xd0):  /* BNE $nnnn */
                 BRANCH(!LOCAL_ZERO());
-                break;
+                OPCODE_BREAK;
 
-            case 0xd1:          /* CMP ($nn),Y */
+            OPCODE_CASE(0xd1):  /* CMP ($nn),Y */
                 CP(reg_a_read, GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd3:          /* DCP ($nn),Y */
+            OPCODE_CASE(0xd3):  /* DCP ($nn),Y */
                 DCP(2, GET_IND_Y_RMW, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd5:          /* CMP $nn,X */
+            OPCODE_CASE(0xd5):  /* CMP $nn,X */
                 CP(reg_a_read, GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd6:          /* DEC $nn,X */
+            OPCODE_CASE(0xd6):  /* DEC $nn,X */
                 DEC(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd7:          /* DCP $nn,X */
+            OPCODE_CASE(0xd7):  /* DCP $nn,X */
                 DCP(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd8:          /* CLD */
+            OPCODE_CASE(0xd8):  /* CLD */
                 CLD();
-                break;
+                OPCODE_BREAK;
 
-            case 0xd9:          /* CMP $nnnn,Y */
+            OPCODE_CASE(0xd9):  /* CMP $nnnn,Y */
                 CP(reg_a_read, GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xdb:          /* DCP $nnnn,Y */
+            OPCODE_CASE(0xdb):  /* DCP $nnnn,Y */
                 DCP(3, GET_ABS_Y_RMW, SET_ABS_Y_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xdd:          /* CMP $nnnn,X */
+            OPCODE_CASE(0xdd):  /* CMP $nnnn,X */
                 CP(reg_a_read, GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xde:          /* DEC $nnnn,X */
+            OPCODE_CASE(0xde):  /* DEC $nnnn,X */
                 DEC(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xdf:          /* DCP $nnnn,X */
+            OPCODE_CASE(0xdf):  /* DCP $nnnn,X */
                 DCP(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe0:          /* CPX #$nn */
+            OPCODE_CASE(0xe0):  /* CPX #$nn */
                 CP(reg_x, GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe1:          /* SBC ($nn,X) */
+            OPCODE_CASE(0xe1):  /* SBC ($nn,X) */
                 SBC(GET_IND_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe3:          /* ISB ($nn,X) */
+            OPCODE_CASE(0xe3):  /* ISB ($nn,X) */
                 ISB(2, GET_IND_X, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe4:          /* CPX $nn */
+            OPCODE_CASE(0xe4):  /* CPX $nn */
                 CP(reg_x, GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe5:          /* SBC $nn */
+            OPCODE_CASE(0xe5):  /* SBC $nn */
                 SBC(GET_ZERO, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe6:          /* INC $nn */
+            OPCODE_CASE(0xe6):  /* INC $nn */
                 INC(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe7:          /* ISB $nn */
+            OPCODE_CASE(0xe7):  /* ISB $nn */
                 ISB(2, GET_ZERO, SET_ZERO_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe8:          /* INX */
+            OPCODE_CASE(0xe8):  /* INX */
                 INX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xe9:          /* SBC #$nn */
-            case 0xeb:          /* USBC #$nn (same as SBC) */
+            OPCODE_CASE(0xe9):  /* SBC #$nn */
+            OPCODE_CASE(0xeb):  /* USBC #$nn (same as SBC) */
                 SBC(GET_IMM, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xec:          /* CPX $nnnn */
+            OPCODE_CASE(0xec):  /* CPX $nnnn */
                 CP(reg_x, GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xed:          /* SBC $nnnn */
+            OPCODE_CASE(0xed):  /* SBC $nnnn */
                 SBC(GET_ABS, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xee:          /* INC $nnnn */
+            OPCODE_CASE(0xee):  /* INC $nnnn */
                 INC(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xef:          /* ISB $nnnn */
+            OPCODE_CASE(0xef):  /* ISB $nnnn */
                 ISB(3, GET_ABS, SET_ABS_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf0:          /* BEQ $nnnn */
+            OPCODE_CASE(0xf0):  /* BEQ $nnnn */
                 BRANCH(LOCAL_ZERO());
-                break;
+                OPCODE_BREAK;
 
-            case 0xf1:          /* SBC ($nn),Y */
+            OPCODE_CASE(0xf1):  /* SBC ($nn),Y */
                 SBC(GET_IND_Y, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf3:          /* ISB ($nn),Y */
+            OPCODE_CASE(0xf3):  /* ISB ($nn),Y */
                 ISB(2, GET_IND_Y_RMW, SET_IND_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf5:          /* SBC $nn,X */
+            OPCODE_CASE(0xf5):  /* SBC $nn,X */
                 SBC(GET_ZERO_X, 2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf6:          /* INC $nn,X */
+            OPCODE_CASE(0xf6):  /* INC $nn,X */
                 INC(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf7:          /* ISB $nn,X */
+            OPCODE_CASE(0xf7):  /* ISB $nn,X */
                 ISB(2, GET_ZERO_X, SET_ZERO_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf8:          /* SED */
+            OPCODE_CASE(0xf8):  /* SED */
                 SED();
-                break;
+                OPCODE_BREAK;
 
-            case 0xf9:          /* SBC $nnnn,Y */
+            OPCODE_CASE(0xf9):  /* SBC $nnnn,Y */
                 SBC(GET_ABS_Y, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xfb:          /* ISB $nnnn,Y */
+            OPCODE_CASE(0xfb):  /* ISB $nnnn,Y */
                 ISB(3, GET_ABS_Y_RMW, SET_ABS_Y_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xfd:          /* SBC $nnnn,X */
+            OPCODE_CASE(0xfd):  /* SBC $nnnn,X */
                 SBC(GET_ABS_X, 3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xfe:          /* INC $nnnn,X */
+            OPCODE_CASE(0xfe):  /* INC $nnnn,X */
                 INC(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xff:          /* ISB $nnnn,X */
+            OPCODE_CASE(0xff):  /* ISB $nnnn,X */
                 ISB(3, GET_ABS_X_RMW, SET_ABS_X_RMW);
-                break;
+                OPCODE_BREAK;
         }
+        OPCODE_END
 
 #if !defined(DRIVE_CPU)
         if (maincpu_profiling) {
@@ -1631,6 +1631,42 @@
 
     {
         opcode_t opcode;
+#ifdef OPCODE_DISPATCH_GOTO
+        static const void *const opcode_table[0x100] = {
+            &&op_0x00, &&op_0x01, &&op_0x02, &&op_default, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+            &&op_0x08, &&op_0x09, &&op_0x0a, &&op_default, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+            &&op_0x10, &&op_0x11, &&op_0x12, &&op_default, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+            &&op_0x18, &&op_0x19, &&op_0x1a, &&op_default, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+            &&op_0x20, &&op_0x21, &&op_0x22, &&op_default, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+            &&op_0x28, &&op_0x29, &&op_0x2a, &&op_default, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+            &&op_0x30, &&op_0x31, &&op_0x32, &&op_default, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+            &&op_0x38, &&op_0x39, &&op_0x3a, &&op_default, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+            &&op_0x40, &&op_0x41, &&op_0x42, &&op_default, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+            &&op_0x48, &&op_0x49, &&op_0x4a, &&op_default, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+            &&op_0x50, &&op_0x51, &&op_0x52, &&op_default, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+            &&op_0x58, &&op_0x59, &&op_0x5a, &&op_default, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+            &&op_0x60, &&op_0x61, &&op_0x62, &&op_default, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+            &&op_0x68, &&op_0x69, &&op_0x6a, &&op_default, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+            &&op_0x70, &&op_0x71, &&op_0x72, &&op_default, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+            &&op_0x78, &&op_0x79, &&op_0x7a, &&op_default, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+            &&op_0x80, &&op_0x81, &&op_0x82, &&op_default, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+            &&op_0x88, &&op_0x89, &&op_0x8a, &&op_default, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+            &&op_0x90, &&op_0x91, &&op_0x92, &&op_default, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+            &&op_0x98, &&op_0x99, &&op_0x9a, &&op_default, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+            &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_default, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+            &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_default, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+            &&op_0xb0, &&op_0xb1, &&op_0xb2, &&op_default, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+            &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_default, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+            &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_default, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7,
+            &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+            &&op_0xd0, &&op_0xd1, &&op_0xd2, &&op_default, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7,
+            &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_0xdb, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_0xdf,
+            &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_default, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_0xe7,
+            &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_default, &&op_0xec, &&op_0xed, &&op_0xee, &&op_0xef,
+            &&op_0xf0, &&op_0xf1, &&op_0xf2, &&op_default, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_0xf7,
+            &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_default, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_0xff
+        };
+#endif
 #ifdef DEBUG
         CLOCK debug_clk;
 #ifdef DRIVE_CPU
@@ -1708,891 +1744,892 @@
 trap_skipped:
         SET_LAST_OPCODE(p0);
 
-        switch (p0) {
-            default:            /* 1 byte, 1 cycle NOP */
+        OPCODE_SWITCH(p0, opcode_table) {
+            OPCODE_DEFAULT:     /* 1 byte, 1 cycle NOP */
                 NOOP_IMM(SIZE_1);
-                break;
-
-            case 0x22:          /* NOP #$nn */
-            case 0x42:          /* NOP #$nn */
-            case 0x62:          /* NOP #$nn */
-            case 0x82:          /* NOP #$nn */
-            case 0xc2:          /* NOP #$nn */
-            case 0xe2:          /* NOP #$nn */
+                OPCODE_BREAK;
+
+            OPCODE_CASE(0x22):  /* NOP #$nn */
+            OPCODE_CASE(0x42):  /* NOP #$nn */
+            OPCODE_CASE(0x62):  /* NOP #$nn */
+            OPCODE_CASE(0x82):  /* NOP #$nn */
+            OPCODE_CASE(0xc2):  /* NOP #$nn */
+            OPCODE_CASE(0xe2):  /* NOP #$nn */
                 NOOP_IMM(SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x44:          /* NOP $nn */
+            OPCODE_CASE(0x44):  /* NOP $nn */
                 NOOP_ZP();
-                break;
+                OPCODE_BREAK;
 
-            case 0x54:          /* NOP $nn,X */
-            case 0xd4:          /* NOP $nn,X */
-            case 0xf4:          /* NOP $nn,X */
+            OPCODE_CASE(0x54):  /* NOP $nn,X */
+            OPCODE_CASE(0xd4):  /* NOP $nn,X */
+            OPCODE_CASE(0xf4):  /* NOP $nn,X */
                 NOOP_ZP_X();
-                break;
+                OPCODE_BREAK;
 
-            case 0xdc:          /* NOP $nnnn */
-            case 0xfc:          /* NOP $nnnn */
+            OPCODE_CASE(0xdc):  /* NOP $nnnn */
+            OPCODE_CASE(0xfc):  /* NOP $nnnn */
                 NOOP_ABS();
-                break;
+                OPCODE_BREAK;
 
-            case 0x5c:          /* NOP broken */
+            OPCODE_CASE(0x5c):  /* NOP broken */
                 NOOP_5C();
-                break;
+                OPCODE_BREAK;
 
-            case 0x00:          /* BRK */
+            OPCODE_CASE(0x00):  /* BRK */
                 BRK();
-                break;
+                OPCODE_BREAK;
 
-            case 0x01:          /* ORA ($nn,X) */
+            OPCODE_CASE(0x01):  /* ORA ($nn,X) */
                 ORA(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x02:          /* NOP #$nn - also used for traps */
+            OPCODE_CASE(0x02):  /* NOP #$nn - also used for traps */
                 STATIC_ASSERT(TRAP_OPCODE == 0x02);
                 NOP_02();
-                break;
+                OPCODE_BREAK;
 
-            case 0x04:          /* TSB $nn */
+            OPCODE_CASE(0x04):  /* TSB $nn */
                 TSB(p1, CYCLES_3, SIZE_2, LOAD_ZERO, STORE_ZERO);
-                break;
+                OPCODE_BREAK;
 
-            case 0x05:          /* ORA $nn */
+            OPCODE_CASE(0x05):  /* ORA $nn */
                 ORA(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x06:          /* ASL $nn */
+            OPCODE_CASE(0x06):  /* ASL $nn */
                 ASL(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x07:          /* RMB0 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x07):  /* RMB0 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_0);
-                break;
+                OPCODE_BREAK;
 
-            case 0x08:          /* PHP */
+            OPCODE_CASE(0x08):  /* PHP */
                 PHP();
-                break;
+                OPCODE_BREAK;
 
-            case 0x09:          /* ORA #$nn */
+            OPCODE_CASE(0x09):  /* ORA #$nn */
                 ORA(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0a:          /* ASL A */
+            OPCODE_CASE(0x0a):  /* ASL A */
                 ASL_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x0c:          /* TSB $nnnn */
+            OPCODE_CASE(0x0c):  /* TSB $nnnn */
                 TSB(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0d:          /* ORA $nnnn */
+            OPCODE_CASE(0x0d):  /* ORA $nnnn */
                 ORA(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0e:          /* ASL $nnnn */
+            OPCODE_CASE(0x0e):  /* ASL $nnnn */
                 ASL(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x0f:          /* BBR0 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x0f):  /* BBR0 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_0);
-                break;
+                OPCODE_BREAK;
 
-            case 0x10:          /* BPL $nnnn */
+            OPCODE_CASE(0x10):  /* BPL $nnnn */
                 BRANCH(!LOCAL_SIGN(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x11:          /* ORA ($nn),Y */
+            OPCODE_CASE(0x11):  /* ORA ($nn),Y */
                 ORA(LOAD_IND_Y(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x12:          /* ORA ($nn) */
+            OPCODE_CASE(0x12):  /* ORA ($nn) */
                 ORA(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x14:          /* TRB $nn */
+            OPCODE_CASE(0x14):  /* TRB $nn */
                 TRB(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x15:          /* ORA $nn,X */
+            OPCODE_CASE(0x15):  /* ORA $nn,X */
                 ORA(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x16:          /* ASL $nn,X */
+            OPCODE_CASE(0x16):  /* ASL $nn,X */
                 ASL(p1, CYCLES_2, SIZE_2, LOAD_ZERO_X, STORE_ZERO_RRW_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0x17:          /* RMB1 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x17):  /* RMB1 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x18:          /* CLC */
+            OPCODE_CASE(0x18):  /* CLC */
                 CLC();
-                break;
+                OPCODE_BREAK;
 
-            case 0x19:          /* ORA $nnnn,Y */
+            OPCODE_CASE(0x19):  /* ORA $nnnn,Y */
                 ORA(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1a:          /* INA */
+            OPCODE_CASE(0x1a):  /* INA */
                 INA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x1c:          /* TRB $nnnn */
+            OPCODE_CASE(0x1c):  /* TRB $nnnn */
                 TRB(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1d:          /* ORA $nnnn,X */
+            OPCODE_CASE(0x1d):  /* ORA $nnnn,X */
                 ORA(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1e:          /* ASL $nnnn,X */
+            OPCODE_CASE(0x1e):  /* ASL $nnnn,X */
                 ASL(p2, CYCLES_1, SIZE_3, LOAD_ABS_X, STORE_ABS_X_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x1f:          /* BBR1 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x1f):  /* BBR1 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x20:          /* JSR $nnnn */
+            OPCODE_CASE(0x20):  /* JSR $nnnn */
                 JSR();
-                break;
+                OPCODE_BREAK;
 
-            case 0x21:          /* AND ($nn,X) */
+            OPCODE_CASE(0x21):  /* AND ($nn,X) */
                 AND(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x24:          /* BIT $nn */
+            OPCODE_CASE(0x24):  /* BIT $nn */
                 BIT(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x25:          /* AND $nn */
+            OPCODE_CASE(0x25):  /* AND $nn */
                 AND(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x26:          /* ROL $nn */
+            OPCODE_CASE(0x26):  /* ROL $nn */
                 ROL(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x27:          /* RMB2 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x27):  /* RMB2 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x28:          /* PLP */
+            OPCODE_CASE(0x28):  /* PLP */
                 PLP();
-                break;
+                OPCODE_BREAK;
 
-            case 0x29:          /* AND #$nn */
+            OPCODE_CASE(0x29):  /* AND #$nn */
                 AND(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2a:          /* ROL A */
+            OPCODE_CASE(0x2a):  /* ROL A */
                 ROL_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x2c:          /* BIT $nnnn */
+            OPCODE_CASE(0x2c):  /* BIT $nnnn */
                 BIT(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2d:          /* AND $nnnn */
+            OPCODE_CASE(0x2d):  /* AND $nnnn */
                 AND(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2e:          /* ROL $nnnn */
+            OPCODE_CASE(0x2e):  /* ROL $nnnn */
                 ROL(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x2f:          /* BBR2 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x2f):  /* BBR2 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x30:          /* BMI $nnnn */
+            OPCODE_CASE(0x30):  /* BMI $nnnn */
                 BRANCH(LOCAL_SIGN(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x31:          /* AND ($nn),Y */
+            OPCODE_CASE(0x31):  /* AND ($nn),Y */
                 AND(LOAD_IND_Y(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x32:          /* AND ($nn) */
+            OPCODE_CASE(0x32):  /* AND ($nn) */
                 AND(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x34:          /* BIT $nn,X */
+            OPCODE_CASE(0x34):  /* BIT $nn,X */
                 BIT(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x35:          /* AND $nn,X */
+            OPCODE_CASE(0x35):  /* AND $nn,X */
                 AND(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x36:          /* ROL $nn,X */
+            OPCODE_CASE(0x36):  /* ROL $nn,X */
                 ROL(p1, CYCLES_2, SIZE_2, LOAD_ZERO_X, STORE_ZERO_RRW_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0x37:          /* RMB3 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x37):  /* RMB3 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x38:          /* SEC */
+            OPCODE_CASE(0x38):  /* SEC */
                 SEC();
-                break;
+                OPCODE_BREAK;
 
-            case 0x39:          /* AND $nnnn,Y */
+            OPCODE_CASE(0x39):  /* AND $nnnn,Y */
                 AND(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3a:          /* DEA */
+            OPCODE_CASE(0x3a):  /* DEA */
                 DEA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x3c:          /* BIT $nnnn,X */
+            OPCODE_CASE(0x3c):  /* BIT $nnnn,X */
                 BIT(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3d:          /* AND $nnnn,X */
+            OPCODE_CASE(0x3d):  /* AND $nnnn,X */
                 AND(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3e:          /* ROL $nnnn,X */
+            OPCODE_CASE(0x3e):  /* ROL $nnnn,X */
                 ROL(p2, CYCLES_1, SIZE_3, LOAD_ABS_X, STORE_ABS_X_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x3f:          /* BBR3 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x3f):  /* BBR3 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x40:          /* RTI */
+            OPCODE_CASE(0x40):  /* RTI */
                 RTI();
-                break;
+                OPCODE_BREAK;
 
-            case 0x41:          /* EOR ($nn,X) */
+            OPCODE_CASE(0x41):  /* EOR ($nn,X) */
                 EOR(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x45:          /* EOR $nn */
+            OPCODE_CASE(0x45):  /* EOR $nn */
                 EOR(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x46:          /* LSR $nn */
+            OPCODE_CASE(0x46):  /* LSR $nn */
                 LSR(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x47:          /* RMB4 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x47):  /* RMB4 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_4);
-                break;
+                OPCODE_BREAK;
 
-            case 0x48:          /* PHA */
+            OPCODE_CASE(0x48):  /* PHA */
                 PHA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x49:          /* EOR #$nn */
+            OPCODE_CASE(0x49):  /* EOR #$nn */
                 EOR(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4a:          /* LSR A */
+            OPCODE_CASE(0x4a):  /* LSR A */
                 LSR_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x4c:          /* JMP $nnnn */
+            OPCODE_CASE(0x4c):  /* JMP $nnnn */
                 JMP(p2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4d:          /* EOR $nnnn */
+            OPCODE_CASE(0x4d):  /* EOR $nnnn */
                 EOR(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4e:          /* LSR $nnnn */
+            OPCODE_CASE(0x4e):  /* LSR $nnnn */
                 LSR(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x4f:          /* BBR4 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x4f):  /* BBR4 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_4);
-                break;
+                OPCODE_BREAK;
 
-            case 0x50:          /* BVC $nnnn */
+            OPCODE_CASE(0x50):  /* BVC $nnnn */
                 BRANCH(!LOCAL_OVERFLOW(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x51:          /* EOR ($nn),Y */
+            OPCODE_CASE(0x51):  /* EOR ($nn),Y */
                 EOR(LOAD_IND_Y(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x52:          /* EOR ($nn) */
+            OPCODE_CASE(0x52):  /* EOR ($nn) */
                 EOR(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x55:          /* EOR $nn,X */
+            OPCODE_CASE(0x55):  /* EOR $nn,X */
                 EOR(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x56:          /* LSR $nn,X */
+            OPCODE_CASE(0x56):  /* LSR $nn,X */
                 LSR(p1, CYCLES_2, SIZE_2, LOAD_ZERO_X, STORE_ZERO_RRW_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0x57:          /* RMB5 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x57):  /* RMB5 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_5);
-                break;
+                OPCODE_BREAK;
 
-            case 0x58:          /* CLI */
+            OPCODE_CASE(0x58):  /* CLI */
                 CLI();
-                break;
+                OPCODE_BREAK;
 
-            case 0x59:          /* EOR $nnnn,Y */
+            OPCODE_CASE(0x59):  /* EOR $nnnn,Y */
                 EOR(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5a:          /* PHY */
+            OPCODE_CASE(0x5a):  /* PHY */
                 PHY();
-                break;
+                OPCODE_BREAK;
 
-            case 0x5d:          /* EOR $nnnn,X */
+            OPCODE_CASE(0x5d):  /* EOR $nnnn,X */
                 EOR(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5e:          /* LSR $nnnn,X */
+            OPCODE_CASE(0x5e):  /* LSR $nnnn,X */
                 LSR(p2, CYCLES_1, SIZE_3, LOAD_ABS_X, STORE_ABS_X_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x5f:          /* BBR5 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x5f):  /* BBR5 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_5);
-                break;
+                OPCODE_BREAK;
 
-            case 0x60:          /* RTS */
+            OPCODE_CASE(0x60):  /* RTS */
                 RTS();
-                break;
+                OPCODE_BREAK;
 
-            case 0x61:          /* ADC ($nn,X) */
+            OPCODE_CASE(0x61):  /* ADC ($nn,X) */
                 ADC(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x64:          /* STZ $nn */
+            OPCODE_CASE(0x64):  /* STZ $nn */
                 STZ_ZERO(p1, CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x65:          /* ADC $nn */
+            OPCODE_CASE(0x65):  /* ADC $nn */
                 ADC(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x66:          /* ROR $nn */
+            OPCODE_CASE(0x66):  /* ROR $nn */
                 ROR(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x67:          /* RMB6 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x67):  /* RMB6 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_6);
-                break;
+                OPCODE_BREAK;
 
-            case 0x68:          /* PLA */
+            OPCODE_CASE(0x68):  /* PLA */
                 PLA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x69:          /* ADC #$nn */
+            OPCODE_CASE(0x69):  /* ADC #$nn */
                 ADC(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x6a:          /* ROR A */
+            OPCODE_CASE(0x6a):  /* ROR A */
                 ROR_A();
-                break;
+                OPCODE_BREAK;
 
-            case 0x6c:          /* JMP ($nnnn) */
+            OPCODE_CASE(0x6c):  /* JMP ($nnnn) */
                 JMP_IND();
-                break;
+                OPCODE_BREAK;
 
-            case 0x6d:          /* ADC $nnnn */
+            OPCODE_CASE(0x6d):  /* ADC $nnnn */
                 ADC(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x6e:          /* ROR $nnnn */
+            OPCODE_CASE(0x6e):  /* ROR $nnnn */
                 ROR(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x6f:          /* BBR6 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x6f):  /* BBR6 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_6);
-                break;
+                OPCODE_BREAK;
 
-            case 0x70:          /* BVS $nnnn */
+            OPCODE_CASE(0x70):  /* BVS $nnnn */
                 BRANCH(LOCAL_OVERFLOW(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x71:          /* ADC ($nn),Y */
+            OPCODE_CASE(0x71):  /* ADC ($nn),Y */
                 ADC(LOAD_IND_Y(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x72:          /* ADC ($nn) */
+            OPCODE_CASE(0x72):  /* ADC ($nn) */
                 ADC(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x74:          /* STZ $nn,X */
+            OPCODE_CASE(0x74):  /* STZ $nn,X */
                 STZ_ZERO_X(p1, CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x75:          /* ADC $nn,X */
+            OPCODE_CASE(0x75):  /* ADC $nn,X */
                 ADC(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x76:          /* ROR $nn,X */
+            OPCODE_CASE(0x76):  /* ROR $nn,X */
                 ROR(p1, CYCLES_2, SIZE_2, LOAD_ZERO_X, STORE_ZERO_RRW_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0x77:          /* RMB7 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x77):  /* RMB7 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 RMB(BIT_7);
-                break;
+                OPCODE_BREAK;
 
-            case 0x78:          /* SEI */
+            OPCODE_CASE(0x78):  /* SEI */
                 SEI();
-                break;
+                OPCODE_BREAK;
 
-            case 0x79:          /* ADC $nnnn,Y */
+            OPCODE_CASE(0x79):  /* ADC $nnnn,Y */
                 ADC(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7a:          /* PLY */
+            OPCODE_CASE(0x7a):  /* PLY */
                 PLY();
-                break;
+                OPCODE_BREAK;
 
-            case 0x7c:          /* JMP ($nnnn,X) */
+            OPCODE_CASE(0x7c):  /* JMP ($nnnn,X) */
                 JMP_IND_X();
-                break;
+                OPCODE_BREAK;
 
-            case 0x7d:          /* ADC $nnnn,X */
+            OPCODE_CASE(0x7d):  /* ADC $nnnn,X */
                 ADC(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7e:          /* ROR $nnnn,X */
+            OPCODE_CASE(0x7e):  /* ROR $nnnn,X */
                 ROR(p2, CYCLES_1, SIZE_3, LOAD_ABS_X, STORE_ABS_X_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0x7f:          /* BBR7 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x7f):  /* BBR7 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBR(BIT_7);
-                break;
+                OPCODE_BREAK;
 
-            case 0x80:          /* BRA $nnnn */
+            OPCODE_CASE(0x80):  /* BRA $nnnn */
                 BRANCH(1, p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x81:          /* STA ($nn,X) */
+            OPCODE_CASE(0x81):  /* STA ($nn,X) */
                 STA(LOAD_ZERO_ADDR_X(p1), CYCLES_3, CYCLES_1, SIZE_2, STORE_ABS);
-                break;
+                OPCODE_BREAK;
 
-            case 0x84:          /* STY $nn */
+            OPCODE_CASE(0x84):  /* STY $nn */
                 STY_ZERO(p1, CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x85:          /* STA $nn */
+            OPCODE_CASE(0x85):  /* STA $nn */
                 STA_ZERO(p1, CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x86:          /* STX $nn */
+            OPCODE_CASE(0x86):  /* STX $nn */
                 STX_ZERO(p1, CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x87:          /* SMB0 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x87):  /* SMB0 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_0);
-                break;
+                OPCODE_BREAK;
 
-            case 0x88:          /* DEY */
+            OPCODE_CASE(0x88):  /* DEY */
                 DEY();
-                break;
+                OPCODE_BREAK;
 
-            case 0x89:          /* BIT #$nn */
+            OPCODE_CASE(0x89):  /* BIT #$nn */
                 BIT_IMM(p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8a:          /* TXA */
+            OPCODE_CASE(0x8a):  /* TXA */
                 TXA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x8c:          /* STY $nnnn */
+            OPCODE_CASE(0x8c):  /* STY $nnnn */
                 STY(p2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8d:          /* STA $nnnn */
+            OPCODE_CASE(0x8d):  /* STA $nnnn */
                 STA(p2, CYCLES_0, CYCLES_1, SIZE_3, STORE_ABS);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8e:          /* STX $nnnn */
+            OPCODE_CASE(0x8e):  /* STX $nnnn */
                 STX(p2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x8f:          /* BBS0 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x8f):  /* BBS0 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_0);
-                break;
+                OPCODE_BREAK;
 
-            case 0x90:          /* BCC $nnnn */
+            OPCODE_CASE(0x90):  /* BCC $nnnn */
                 BRANCH(!LOCAL_CARRY(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x91:          /* STA ($nn),Y */
+            OPCODE_CASE(0x91):  /* STA ($nn),Y */
                 STA_IND_Y(p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x92:          /* STA ($nn) */
+            OPCODE_CASE(0x92):  /* STA ($nn) */
                 STA(LOAD_ZERO_ADDR(p1), CYCLES_2, CYCLES_1, SIZE_2, STORE_ABS);
-                break;
+                OPCODE_BREAK;
 
-            case 0x94:          /* STY $nn,X */
+            OPCODE_CASE(0x94):  /* STY $nn,X */
                 STY_ZERO_X(p1, CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x95:          /* STA $nn,X */
+            OPCODE_CASE(0x95):  /* STA $nn,X */
                 STA_ZERO_X(p1, CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x96:          /* STX $nn,Y */
+            OPCODE_CASE(0x96):  /* STX $nn,Y */
                 STX_ZERO_Y(p1, CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0x97:          /* SMB1 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x97):  /* SMB1 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_1);
-                break;
+                OPCODE_BREAK;
 
-            case 0x98:          /* TYA */
+            OPCODE_CASE(0x98):  /* TYA */
                 TYA();
-                break;
+                OPCODE_BREAK;
 
-            case 0x99:          /* STA $nnnn,Y */
+            OPCODE_CASE(0x99):  /* STA $nnnn,Y */
                 STA(p2, CYCLES_0, CYCLES_0, SIZE_3, STORE_ABS_Y);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9a:          /* TXS */
+            OPCODE_CASE(0x9a):  /* TXS */
                 TXS();
-                break;
+                OPCODE_BREAK;
 
-            case 0x9c:          /* STZ $nnnn */
+            OPCODE_CASE(0x9c):  /* STZ $nnnn */
                 STZ(p2, CYCLES_1, SIZE_3, STORE_ABS);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9d:          /* STA $nnnn,X */
+            OPCODE_CASE(0x9d):  /* STA $nnnn,X */
                 STA(p2, CYCLES_0, CYCLES_0, SIZE_3, STORE_ABS_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9e:          /* STZ $nnnn,X */
+            OPCODE_CASE(0x9e):  /* STZ $nnnn,X */
                 STZ(p2, CYCLES_0, SIZE_3, STORE_ABS_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0x9f:          /* BBS1 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0x9f):  /* BBS1 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_1);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa0:          /* LDY #$nn */
+            OPCODE_CASE(0xa0):  /* LDY #$nn */
                 LDY(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa1:          /* LDA ($nn,X) */
+            OPCODE_CASE(0xa1):  /* LDA ($nn,X) */
                 LDA(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa2:          /* LDX #$nn */
+            OPCODE_CASE(0xa2):  /* LDX #$nn */
                 LDX(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa4:          /* LDY $nn */
+            OPCODE_CASE(0xa4):  /* LDY $nn */
                 LDY(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa5:          /* LDA $nn */
+            OPCODE_CASE(0xa5):  /* LDA $nn */
                 LDA(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa6:          /* LDX $nn */
+            OPCODE_CASE(0xa6):  /* LDX $nn */
                 LDX(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa7:          /* SMB2 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xa7):  /* SMB2 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xa8:          /* TAY */
+            OPCODE_CASE(0xa8):  /* TAY */
                 TAY();
-                break;
+                OPCODE_BREAK;
 
-            case 0xa9:          /* LDA #$nn */
+            OPCODE_CASE(0xa9):  /* LDA #$nn */
                 LDA(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xaa:          /* TAX */
+            OPCODE_CASE(0xaa):  /* TAX */
                 TAX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xac:          /* LDY $nnnn */
+            OPCODE_CASE(0xac):  /* LDY $nnnn */
                 LDY(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xad:          /* LDA $nnnn */
+            OPCODE_CASE(0xad):  /* LDA $nnnn */
                 LDA(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xae:          /* LDX $nnnn */
+            OPCODE_CASE(0xae):  /* LDX $nnnn */
                 LDX(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xaf:          /* BBS2 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xaf):  /* BBS2 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb0:          /* BCS $nnnn */
+            OPCODE_CASE(0xb0):  /* BCS $nnnn */
                 BRANCH(LOCAL_CARRY(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb1:          /* LDA ($nn),Y */
+            OPCODE_CASE(0xb1):  /* LDA ($nn),Y */
                 LDA(LOAD_IND_Y_BANK(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb2:          /* LDA ($nn) */
+            OPCODE_CASE(0xb2):  /* LDA ($nn) */
                 LDA(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb4:          /* LDY $nn,X */
+            OPCODE_CASE(0xb4):  /* LDY $nn,X */
                 LDY(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb5:          /* LDA $nn,X */
+            OPCODE_CASE(0xb5):  /* LDA $nn,X */
                 LDA(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb6:          /* LDX $nn,Y */
+            OPCODE_CASE(0xb6):  /* LDX $nn,Y */
                 LDX(LOAD_ZERO_Y(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb7:          /* SMB3 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xb7):  /* SMB3 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xb8:          /* CLV */
+            OPCODE_CASE(0xb8):  /* CLV */
                 CLV();
-                break;
+                OPCODE_BREAK;
 
-            case 0xb9:          /* LDA $nnnn,Y */
+            OPCODE_CASE(0xb9):  /* LDA $nnnn,Y */
                 LDA(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xba:          /* TSX */
+            OPCODE_CASE(0xba):  /* TSX */
                 TSX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xbc:          /* LDY $nnnn,X */
+            OPCODE_CASE(0xbc):  /* LDY $nnnn,X */
                 LDY(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xbd:          /* LDA $nnnn,X */
+            OPCODE_CASE(0xbd):  /* LDA $nnnn,X */
                 LDA(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xbe:          /* LDX $nnnn,Y */
+            OPCODE_CASE(0xbe):  /* LDX $nnnn,Y */
                 LDX(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xbf:          /* BBS3 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xbf):  /* BBS3 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc0:          /* CPY #$nn */
+            OPCODE_CASE(0xc0):  /* CPY #$nn */
                 CPY(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc1:          /* CMP ($nn,X) */
+            OPCODE_CASE(0xc1):  /* CMP ($nn,X) */
                 CMP(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc4:          /* CPY $nn */
+            OPCODE_CASE(0xc4):  /* CPY $nn */
                 CPY(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc5:          /* CMP $nn */
+            OPCODE_CASE(0xc5):  /* CMP $nn */
                 CMP(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc6:          /* DEC $nn */
+            OPCODE_CASE(0xc6):  /* DEC $nn */
                 DEC(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc7:          /* SMB4 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xc7):  /* SMB4 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_4);
-                break;
+                OPCODE_BREAK;
 
-            case 0xc8:          /* INY */
+            OPCODE_CASE(0xc8):  /* INY */
                 INY();
-                break;
+                OPCODE_BREAK;
 
-            case 0xc9:          /* CMP #$nn */
+            OPCODE_CASE(0xc9):  /* CMP #$nn */
                 CMP(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xca:          /* DEX */
+            OPCODE_CASE(0xca):  /* DEX */
                 DEX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xcb:          /* WAI (WDC65C02) / single byte, single cycle NOP (R65C02/65SC02) */
+            OPCODE_CASE(0xcb):  /* WAI (WDC65C02) / single byte, single cycle NOP (R65C02/65SC02) */
                 WAI();
-                break;
+                OPCODE_BREAK;
 
-            case 0xcc:          /* CPY $nnnn */
+            OPCODE_CASE(0xcc):  /* CPY $nnnn */
                 CPY(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xcd:          /* CMP $nnnn */
+            OPCODE_CASE(0xcd):  /* CMP $nnnn */
                 CMP(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xce:          /* DEC $nnnn */
+            OPCODE_CASE(0xce):  /* DEC $nnnn */
                 DEC(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xcf:          /* BBS4 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xcf):  /* BBS4 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_4);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd0:          /* BNE $nnnn */
+            OPCODE_CASE(0xd0):  /* BNE $nnnn */
                 BRANCH(!LOCAL_ZERO(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd1:          /* CMP ($nn),Y */
+            OPCODE_CASE(0xd1):  /* CMP ($nn),Y */
                 CMP(LOAD_IND_Y(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd2:          /* CMP ($nn) */
+            OPCODE_CASE(0xd2):  /* CMP ($nn) */
                 CMP(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd5:          /* CMP $nn,X */
+            OPCODE_CASE(0xd5):  /* CMP $nn,X */
                 CMP(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd6:          /* DEC $nn,X */
+            OPCODE_CASE(0xd6):  /* DEC $nn,X */
                 DEC(p1, CYCLES_2, SIZE_2, LOAD_ZERO_X, STORE_ZERO_RRW_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd7:          /* SMB5 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xd7):  /* SMB5 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_5);
-                break;
+                OPCODE_BREAK;
 
-            case 0xd8:          /* CLD */
+            OPCODE_CASE(0xd8):  /* CLD */
                 CLD();
-                break;
+                OPCODE_BREAK;
 
-            case 0xd9:          /* CMP $nnnn,Y */
+            OPCODE_CASE(0xd9):  /* CMP $nnnn,Y */
                 CMP(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xda:          /* PHX */
+            OPCODE_CASE(0xda):  /* PHX */
                 PHX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xdb:          /* STP (WDC65C02) / single byte, single cycle NOP (R65C02/65SC02) */
+            OPCODE_CASE(0xdb):  /* STP (WDC65C02) / single byte, single cycle NOP (R65C02/65SC02) */
                 STP();
-                break;
+                OPCODE_BREAK;
 
-            case 0xdd:          /* CMP $nnnn,X */
+            OPCODE_CASE(0xdd):  /* CMP $nnnn,X */
                 CMP(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xde:          /* DEC $nnnn,X */
+            OPCODE_CASE(0xde):  /* DEC $nnnn,X */
                 DEC(p2, CYCLES_1, SIZE_3, LOAD_ABS_X_RMW, STORE_ABS_X_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xdf:          /* BBS5 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xdf):  /* BBS5 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_5);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe0:          /* CPX #$nn */
+            OPCODE_CASE(0xe0):  /* CPX #$nn */
                 CPX(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe1:          /* SBC ($nn,X) */
+            OPCODE_CASE(0xe1):  /* SBC ($nn,X) */
                 SBC(LOAD_IND_X(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe4:          /* CPX $nn */
+            OPCODE_CASE(0xe4):  /* CPX $nn */
                 CPX(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe5:          /* SBC $nn */
+            OPCODE_CASE(0xe5):  /* SBC $nn */
                 SBC(LOAD_ZERO(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe6:          /* INC $nn */
+            OPCODE_CASE(0xe6):  /* INC $nn */
                 INC(p1, CYCLES_1, SIZE_2, LOAD_ZERO, STORE_ZERO_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe7:          /* SMB6 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xe7):  /* SMB6 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_6);
-                break;
+                OPCODE_BREAK;
 
-            case 0xe8:          /* INX */
+            OPCODE_CASE(0xe8):  /* INX */
                 INX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xe9:          /* SBC #$nn */
+            OPCODE_CASE(0xe9):  /* SBC #$nn */
                 SBC(p1, CYCLES_0, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xea:          /* NOP */
+            OPCODE_CASE(0xea):  /* NOP */
                 NOP();
-                break;
+                OPCODE_BREAK;
 
-            case 0xec:          /* CPX $nnnn */
+            OPCODE_CASE(0xec):  /* CPX $nnnn */
                 CPX(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xed:          /* SBC $nnnn */
+            OPCODE_CASE(0xed):  /* SBC $nnnn */
                 SBC(LOAD(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xee:          /* INC $nnnn */
+            OPCODE_CASE(0xee):  /* INC $nnnn */
                 INC(p2, CYCLES_1, SIZE_3, LOAD_ABS, STORE_ABS_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xef:          /* BBS6 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xef):  /* BBS6 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_6);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf0:          /* BEQ $nnnn */
+            OPCODE_CASE(0xf0):  /* BEQ $nnnn */
                 BRANCH(LOCAL_ZERO(), p1);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf1:          /* SBC ($nn),Y */
+            OPCODE_CASE(0xf1):  /* SBC ($nn),Y */
                 SBC(LOAD_IND_Y(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf2:          /* SBC ($nn) */
+            OPCODE_CASE(0xf2):  /* SBC ($nn) */
                 SBC(LOAD_INDIRECT(p1), CYCLES_1, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf5:          /* SBC $nn,X */
+            OPCODE_CASE(0xf5):  /* SBC $nn,X */
                 SBC(LOAD_ZERO_X(p1), CYCLES_2, SIZE_2);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf6:          /* INC $nn,X */
+            OPCODE_CASE(0xf6):  /* INC $nn,X */
                 INC(p1, CYCLES_2, SIZE_2, LOAD_ZERO_X, STORE_ZERO_RRW_X);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf7:          /* SMB7 $nn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xf7):  /* SMB7 $nn (65C02) / single byte, single cycle NOP (65SC02) */
                 SMB(BIT_7);
-                break;
+                OPCODE_BREAK;
 
-            case 0xf8:          /* SED */
+            OPCODE_CASE(0xf8):  /* SED */
                 SED();
-                break;
+                OPCODE_BREAK;
 
-            case 0xf9:          /* SBC $nnnn,Y */
+            OPCODE_CASE(0xf9):  /* SBC $nnnn,Y */
                 SBC(LOAD_ABS_Y(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xfa:          /* PLX */
+            OPCODE_CASE(0xfa):  /* PLX */
                 PLX();
-                break;
+                OPCODE_BREAK;
 
-            case 0xfd:          /* SBC $nnnn,X */
+            OPCODE_CASE(0xfd):  /* SBC $nnnn,X */
                 SBC(LOAD_ABS_X(p2), CYCLES_1, SIZE_3);
-                break;
+                OPCODE_BREAK;
 
-            case 0xfe:          /* INC $nnnn,X */
+            OPCODE_CASE(0xfe):  /* INC $nnnn,X */
                 INC(p2, CYCLES_1, SIZE_3, LOAD_ABS_X_RMW, STORE_ABS_X_RRW);
-                break;
+                OPCODE_BREAK;
 
-            case 0xff:          /* BBS7 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
+            OPCODE_CASE(0xff):  /* BBS7 $nn,$nnnn (65C02) / single byte, single cycle NOP (65SC02) */
                 BBS(BIT_7);
-                break;
+                OPCODE_BREAK;
         }
+        OPCODE_END
     }
 }
@@ -36,6 +36,10 @@
 #include "types.h"
 
 
+#ifdef HAVE_DEBUG_ALARMS
+alarm_trace_hook_t alarm_trace_hook = NULL;
+#endif
+
 alarm_context_t *alarm_context_new(const char *name)
 {
     alarm_context_t *new_alarm_context;
@@ -85,6 +89,10 @@ void alarm_context_time_warp(alarm_context_t *context, CLOCK warp_amount,
         return;
     }
 
+    ALARM_TRACE(context, NULL, warp_direction > 0
+                ? ALARM_TRACE_WARP_FORWARD : ALARM_TRACE_WARP_BACKWARD,
+                warp_amount);
+
     for (i = 0; i < context->num_pending_alarms; i++) {
         if (warp_direction > 0) {
             context->pending_alarms[i].clk += warp_amount;
@@ -176,6 +184,8 @@ void alarm_unset(alarm_t *alarm)
     }
     context = alarm->context;
 
+    ALARM_TRACE(context, alarm, ALARM_TRACE_UNSET, 0);
+
     if (context->num_pending_alarms > 1) {
         int last;
 
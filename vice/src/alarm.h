@@ -87,6 +87,33 @@ struct alarm_context_s {
 };
 typedef struct alarm_context_s alarm_context_t;
 
+#ifdef HAVE_DEBUG_ALARMS
+/* Alarm operations passed to `alarm_trace_hook'.  */
+typedef enum alarm_trace_op_e {
+    ALARM_TRACE_SET,            /* `clk' is the new alarm clock */
+    ALARM_TRACE_UNSET,
+    ALARM_TRACE_DISPATCH,       /* `clk' is the current CPU clock */
+    ALARM_TRACE_WARP_FORWARD,   /* `clk' is the warp amount */
+    ALARM_TRACE_WARP_BACKWARD
+} alarm_trace_op_t;
+
+typedef void (*alarm_trace_hook_t)(alarm_context_t *context, alarm_t *alarm,
+                                   alarm_trace_op_t op, CLOCK clk);
+
+/* Called for each alarm operation if not NULL, used by the alarm benchmark
+   to record a trace (see bench.c).  Only built with --enable-debug-alarms.  */
+extern alarm_trace_hook_t alarm_trace_hook;
+
+#define ALARM_TRACE(context, alarm, op, clk)                    \
+    do {                                                        \
+        if (alarm_trace_hook) {                                 \
+            alarm_trace_hook((context), (alarm), (op), (clk));  \
+        }                                                       \
+    } while (0)
+#else
+#define ALARM_TRACE(context, alarm, op, clk)
+#endif
+
 /* ------------------------------------------------------------------------ */
 
 alarm_context_t *alarm_context_new(const char *name);
@@ -140,6 +167,8 @@ inline static void alarm_context_dispatch(alarm_context_t *context,
     idx = context->next_pending_alarm_idx;
     alarm = context->pending_alarms[idx].alarm;
 
+    ALARM_TRACE(context, alarm, ALARM_TRACE_DISPATCH, cpu_clk);
+
     (alarm->callback)(offset, alarm->data);
 }
 
@@ -151,6 +180,8 @@ inline static void alarm_set(alarm_t *alarm, CLOCK cpu_clk)
     context = alarm->context;
     idx = alarm->pending_idx;
 
+    ALARM_TRACE(context, alarm, ALARM_TRACE_SET, cpu_clk);
+
     if (idx < 0) {
         int new_idx;
 
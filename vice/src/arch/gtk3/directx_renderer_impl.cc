@@ -616,6 +616,9 @@ void vice_directx_impl_async_render(void *job_data, void *pool_data)
         destroy_device_dependent_resources(context);
     } else {
         context->d3d_swap_chain->Present1(vsync ? 1 : 0, 0, &present_parameters);
+
+        /* frame pacing statistics, see vsyncarch_get_metrics() */
+        render_queue_presented(context->render_queue);
     }
 
     RENDER_UNLOCK();
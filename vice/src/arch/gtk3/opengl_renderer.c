@@ -335,6 +335,7 @@ static void vice_opengl_refresh_rect(video_canvas_t *canvas,
     context_t *context;
     backbuffer_t *backbuffer;
     int pixel_data_size_bytes;
+    unsigned int area;
 
     CANVAS_LOCK();
 
@@ -344,6 +345,19 @@ static void vice_opengl_refresh_rect(video_canvas_t *canvas,
         return;
     }
 
+    area = render_queue_set_area(context->render_queue, xs, ys, xi, yi, w, h,
+                                 context->emulated_width_next, context->emulated_height_next);
+
+    /* Nothing changed since the last frame queued for display, redraw that one */
+    if (!canvas->videoconfig->interlaced
+        && video_canvas_frame_unchanged(canvas, render_queue_displayed_frame(context->render_queue))) {
+        if (context->render_thread) {
+            render_thread_push_job(context->render_thread, render_thread_render);
+        }
+        CANVAS_UNLOCK();
+        return;
+    }
+
     /* Obtain an unused backbuffer to render to */
     pixel_data_size_bytes = context->emulated_width_next * context->emulated_height_next * 4;
     backbuffer = render_queue_get_from_pool(context->render_queue, pixel_data_size_bytes);
@@ -361,7 +375,11 @@ static void vice_opengl_refresh_rect(video_canvas_t *canvas,
 
     CANVAS_UNLOCK();
 
-    video_canvas_render(canvas, backbuffer->pixel_data, w, h, xs, ys, xi, yi, backbuffer->width * 4);
+    /* Only the lines that changed since the frame the backbuffer holds are rendered */
+    backbuffer->frame = video_canvas_render_changed(canvas, backbuffer->pixel_data, w, h, xs, ys, xi, yi,
+                                                    backbuffer->width * 4,
+                                                    render_queue_backbuffer_frame(context->render_queue, backbuffer));
+    backbuffer->frame_area = area;
 
     CANVAS_LOCK();
     if (context->render_thread) {
@@ -804,6 +822,9 @@ static void render(void *job_data, void *pool_data)
     vice_opengl_renderer_present_backbuffer(context);
     glFinish();
 
+    /* frame pacing statistics, see vsyncarch_get_metrics() */
+    render_queue_presented(context->render_queue);
+
     vice_opengl_renderer_clear_current(context);
 
     RENDER_UNLOCK();
@@ -29,40 +29,155 @@
 #include "render_queue.h"
 
 #include <assert.h>
-#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "archdep_tick.h"
 #include "lib.h"
 #include "vsyncapi.h"
 
-#define LOCK() pthread_mutex_lock(&rq->lock)
-#define UNLOCK() pthread_mutex_unlock(&rq->lock)
+/*
+ * The emulation thread renders into the backbuffers and the render thread
+ * displays them. Each backbuffer has a state word, the only data shared by
+ * both threads, which is changed with compare and swap:
+ *
+ *   FREE -> RENDERING -> QUEUED -> DISPLAYING -> FREE
+ *
+ * The emulation thread only ever holds one RENDERING buffer and the render
+ * thread one DISPLAYING buffer, so with four buffers the emulation thread
+ * always finds one FREE or QUEUED. When the render thread falls behind, the
+ * oldest QUEUED buffer is taken back and its frame counted as dropped.
+ *
+ * QUEUED states carry the queue sequence number in the upper bits, so the
+ * render thread can display the frames in order and its compare and swap
+ * fails if the buffer was taken back and queued again in the meantime.
+ */
+#define BACKBUFFER_FREE         0u
+#define BACKBUFFER_RENDERING    1u
+#define BACKBUFFER_QUEUED       2u
+#define BACKBUFFER_DISPLAYING   3u
+
+#define STATE_MASK      3u
+#define SEQUENCE_SHIFT  2
+
+/** Number of presented frames to compute the latency statistics from */
+#define LATENCY_SAMPLES         256
+
+/** Publish the frame pacing metrics every this many presents */
+#define METRICS_INTERVAL        50
 
 typedef struct vice_render_queue_s {
-    pthread_mutex_t lock;
+    /** All backbuffers, indexed like state[] */
+    backbuffer_t *backbuffers[RENDER_QUEUE_MAX_BACKBUFFERS];
+
+    /** State of each backbuffer, see above */
+    atomic_uint state[RENDER_QUEUE_MAX_BACKBUFFERS];
+
+    /** Sequence number of the next backbuffer queued for display */
+    unsigned int next_sequence;
+
+    /** When the emulated frame in each backbuffer was finished */
+    tick_t frame_tick[RENDER_QUEUE_MAX_BACKBUFFERS];
 
-    /** Holds all currently unused backbuffers */
-    backbuffer_t *backbuffer_stack[RENDER_QUEUE_MAX_BACKBUFFERS];
+    /** Frames taken back before they were displayed */
+    atomic_ulong frames_dropped;
 
-    /** How many unused backbuffers in the stack */
-    unsigned int backbuffer_stack_size;
+    /** Render area of the emulated frames, see render_queue_set_area() */
+    unsigned int area[8];
 
-    /** Holds the queue of backbuffers ready to render */
-    backbuffer_t *render_queue[RENDER_QUEUE_MAX_BACKBUFFERS];
+    /** Increased each time the render area changes */
+    unsigned int area_generation;
 
-    /** How many backbuffers in render queue */
-    unsigned int render_queue_length;
+    /** Tracked frame and render area of the last backbuffer queued for display */
+    unsigned int displayed_frame;
+    unsigned int displayed_frame_area;
 
-    /** Index of next backbuffer to render in render_queue */
-    unsigned int render_queue_next;
+    /* Everything below is only used by the render thread */
 
-    /** Allows discarding of late buffer returns */
-    unsigned int backbuffer_generation;
+    /** Frame finish tick of the last dequeued backbuffer, and whether it is yet to be presented */
+    tick_t displaying_tick;
+    bool displaying_new;
+
+    /** Latency of the last presented frames, in microseconds */
+    unsigned long latency[LATENCY_SAMPLES];
+    unsigned int latency_count;
+    unsigned int latency_next;
+
+    unsigned long frames_presented;
+    unsigned long frames_repeated;
+    unsigned int presents_since_metrics;
 } render_queue_t;
 
-static void free_backbuffer(backbuffer_t *backbuffer) {
-    lib_free(backbuffer->pixel_data);
-    lib_free(backbuffer);
+static int backbuffer_index(render_queue_t *rq, backbuffer_t *backbuffer)
+{
+    int i;
+
+    for (i = 0; i < RENDER_QUEUE_MAX_BACKBUFFERS; i++) {
+        if (rq->backbuffers[i] == backbuffer) {
+            return i;
+        }
+    }
+
+    assert(false);
+    return -1;
+}
+
+/** Find the oldest queued backbuffer, returns its index and sets its state, or -1 */
+static int oldest_queued(render_queue_t *rq, unsigned int *state)
+{
+    unsigned int s;
+    int oldest = -1;
+    int i;
+
+    for (i = 0; i < RENDER_QUEUE_MAX_BACKBUFFERS; i++) {
+        s = atomic_load(&rq->state[i]);
+        if ((s & STATE_MASK) != BACKBUFFER_QUEUED) {
+            continue;
+        }
+        /* the sequence numbers wrap, compare their distance */
+        if (oldest < 0 || (int)((s & ~STATE_MASK) - (*state & ~STATE_MASK)) < 0) {
+            oldest = i;
+            *state = s;
+        }
+    }
+
+    return oldest;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+    unsigned long la = *(const unsigned long *)a;
+    unsigned long lb = *(const unsigned long *)b;
+
+    return la < lb ? -1 : la > lb;
+}
+
+static void publish_metrics(render_queue_t *rq)
+{
+    vsync_present_metrics_t metrics;
+    unsigned long sorted[LATENCY_SAMPLES];
+    unsigned long sum = 0;
+    unsigned int i;
+
+    memset(&metrics, 0, sizeof(metrics));
+
+    if (rq->latency_count > 0) {
+        memcpy(sorted, rq->latency, rq->latency_count * sizeof(sorted[0]));
+        qsort(sorted, rq->latency_count, sizeof(sorted[0]), compare_latency);
+        for (i = 0; i < rq->latency_count; i++) {
+            sum += sorted[i];
+        }
+        metrics.latency_min_ms = sorted[0] / 1000.0;
+        metrics.latency_avg_ms = (double)sum / rq->latency_count / 1000.0;
+        metrics.latency_p99_ms = sorted[(rq->latency_count * 99) / 100] / 1000.0;
+    }
+
+    metrics.frames_presented = rq->frames_presented;
+    metrics.frames_dropped = atomic_load(&rq->frames_dropped);
+    metrics.frames_repeated = rq->frames_repeated;
+
+    vsync_set_present_metrics(&metrics);
 }
 
 /****/
@@ -75,7 +190,6 @@ void *render_queue_create(void)
     int i;
 
     rq = lib_calloc(1, sizeof(render_queue_t));
-    pthread_mutex_init(&rq->lock, NULL);
 
     /* Seed the pool with the maximum number of backbuffers */
     for (i = 0; i < RENDER_QUEUE_MAX_BACKBUFFERS; i++) {
@@ -86,9 +200,13 @@ void *render_queue_create(void)
         bb->width = 0;
         bb->height = 0;
         bb->pixel_aspect_ratio = 0.0f;
+        bb->frame = 0;
+        bb->frame_area = 0;
 
-        rq->backbuffer_stack[rq->backbuffer_stack_size++] = bb;
+        rq->backbuffers[i] = bb;
+        atomic_init(&rq->state[i], BACKBUFFER_FREE);
     }
+    atomic_init(&rq->frames_dropped, 0);
 
     return rq;
 }
@@ -99,18 +217,11 @@ void render_queue_destroy(void *render_queue)
     render_queue_t *rq = (render_queue_t *)render_queue;
     int i;
 
-    /* The unused backbuffers */
-    for (i = 0; i < rq->backbuffer_stack_size; i++) {
-        free_backbuffer(rq->backbuffer_stack[i]);
-    }
-
-    /* The backbuffers queued for rendering */
-    for (i = 0; i < rq->render_queue_length; i++) {
-        free_backbuffer(rq->render_queue[rq->render_queue_next++]);
-        rq->render_queue_next = rq->render_queue_next % RENDER_QUEUE_MAX_BACKBUFFERS;
+    for (i = 0; i < RENDER_QUEUE_MAX_BACKBUFFERS; i++) {
+        lib_free(rq->backbuffers[i]->pixel_data);
+        lib_free(rq->backbuffers[i]);
     }
 
-    pthread_mutex_destroy(&rq->lock);
     lib_free(render_queue);
 }
 
@@ -120,32 +231,53 @@ void render_queue_destroy(void *render_queue)
 backbuffer_t *render_queue_get_from_pool(void *render_queue, int pixel_data_size_bytes)
 {
     render_queue_t *rq = (render_queue_t *)render_queue;
-    backbuffer_t *bb;
+    backbuffer_t *bb = NULL;
+    unsigned int state;
+    int attempt;
+    int i;
 
-    LOCK();
+    for (attempt = 0; bb == NULL && attempt < RENDER_QUEUE_MAX_BACKBUFFERS; attempt++) {
+        /* Prefer an unused backbuffer */
+        for (i = 0; i < RENDER_QUEUE_MAX_BACKBUFFERS; i++) {
+            state = BACKBUFFER_FREE;
+            if (atomic_compare_exchange_strong(&rq->state[i], &state, BACKBUFFER_RENDERING)) {
+                bb = rq->backbuffers[i];
+                break;
+            }
+        }
+        if (bb != NULL) {
+            break;
+        }
+
+        /* The render thread is behind, take back the oldest frame it hasn't displayed */
+        i = oldest_queued(rq, &state);
+        if (i >= 0 && atomic_compare_exchange_strong(&rq->state[i], &state, BACKBUFFER_RENDERING)) {
+            bb = rq->backbuffers[i];
+            atomic_fetch_add(&rq->frames_dropped, 1);
+        }
+    }
 
-    if (!rq->backbuffer_stack_size) {
+    if (bb == NULL) {
         /* no buffers available, skip this frame */
-        UNLOCK();
+        atomic_fetch_add(&rq->frames_dropped, 1);
         return NULL;
     }
 
-    bb = rq->backbuffer_stack[rq->backbuffer_stack_size - 1];
-    rq->backbuffer_stack_size--;
-
-    UNLOCK();
-
     /* Make sure there's at least the requested size in bytes */
     if (bb->pixel_data_size_bytes < pixel_data_size_bytes) {
         lib_free(bb->pixel_data);
         bb->pixel_data = lib_malloc(pixel_data_size_bytes);
         bb->pixel_data_size_bytes = pixel_data_size_bytes;
+        bb->frame = 0;
     }
 
     bb->width = 0;
     bb->height = 0;
     bb->pixel_aspect_ratio = 0.0f;
 
+    /* the emulated frame is complete when it is rendered for display */
+    rq->frame_tick[i] = tick_now();
+
     return bb;
 }
 
@@ -153,28 +285,30 @@ backbuffer_t *render_queue_get_from_pool(void *render_queue, int pixel_data_size
 void render_queue_enqueue_for_display(void *render_queue, backbuffer_t *backbuffer)
 {
     render_queue_t *rq = (render_queue_t *)render_queue;
+    int i = backbuffer_index(rq, backbuffer);
 
-    LOCK();
-
-    assert(rq->render_queue_length < RENDER_QUEUE_MAX_BACKBUFFERS);
+    if (i < 0) {
+        return;
+    }
+    assert(atomic_load(&rq->state[i]) == BACKBUFFER_RENDERING);
 
-    rq->render_queue[(rq->render_queue_next + rq->render_queue_length) % RENDER_QUEUE_MAX_BACKBUFFERS] = backbuffer;
-    rq->render_queue_length++;
+    rq->displayed_frame = backbuffer->frame;
+    rq->displayed_frame_area = backbuffer->frame_area;
 
-    UNLOCK();
+    atomic_store(&rq->state[i], (rq->next_sequence++ << SEQUENCE_SHIFT) | BACKBUFFER_QUEUED);
 }
 
 unsigned int render_queue_length(void *render_queue)
 {
     render_queue_t *rq = (render_queue_t *)render_queue;
+    unsigned int render_queue_length = 0;
+    int i;
 
-    unsigned int render_queue_length;
-
-    LOCK();
-
-    render_queue_length = rq->render_queue_length;
-
-    UNLOCK();
+    for (i = 0; i < RENDER_QUEUE_MAX_BACKBUFFERS; i++) {
+        if ((atomic_load(&rq->state[i]) & STATE_MASK) == BACKBUFFER_QUEUED) {
+            render_queue_length++;
+        }
+    }
 
     return render_queue_length;
 }
@@ -183,35 +317,121 @@ unsigned int render_queue_length(void *render_queue)
 backbuffer_t *render_queue_dequeue_for_display(void *render_queue)
 {
     render_queue_t *rq = (render_queue_t *)render_queue;
-    void *backbuffer;
+    unsigned int state;
+    unsigned int older;
+    int i;
+
+    for (;;) {
+        /* Are there any available? */
+        i = oldest_queued(rq, &state);
+        if (i < 0) {
+            return NULL;
+        }
+        /* fails if the emulation thread took it back meanwhile */
+        if (!atomic_compare_exchange_strong(&rq->state[i], &state, BACKBUFFER_DISPLAYING)) {
+            continue;
+        }
+        /* the scan isn't a snapshot, an older frame may have been queued
+           after its backbuffer was looked at: put this one back then */
+        if (oldest_queued(rq, &older) >= 0
+            && (int)((older & ~STATE_MASK) - (state & ~STATE_MASK)) < 0) {
+            atomic_store(&rq->state[i], state);
+            continue;
+        }
+        break;
+    }
 
-    LOCK();
+    rq->displaying_tick = rq->frame_tick[i];
+    rq->displaying_new = true;
 
-    /* Are there any available? */
-    if (!rq->render_queue_length) {
-        UNLOCK();
-        return NULL;
+    return rq->backbuffers[i];
+}
+
+void render_queue_return_to_pool(void *render_queue, backbuffer_t *backbuffer)
+{
+    render_queue_t *rq = (render_queue_t *)render_queue;
+    int i = backbuffer_index(rq, backbuffer);
+
+    if (i < 0) {
+        return;
     }
+    assert(atomic_load(&rq->state[i]) == BACKBUFFER_RENDERING
+           || atomic_load(&rq->state[i]) == BACKBUFFER_DISPLAYING);
+
+    atomic_store(&rq->state[i], BACKBUFFER_FREE);
+}
 
-    backbuffer = rq->render_queue[rq->render_queue_next];
-    rq->render_queue_next = (rq->render_queue_next + 1) % RENDER_QUEUE_MAX_BACKBUFFERS;
-    rq->render_queue_length--;
+/** Called by the render thread after presenting, to measure the frame pacing */
+void render_queue_presented(void *render_queue)
+{
+    render_queue_t *rq = (render_queue_t *)render_queue;
 
-    UNLOCK();
+    if (rq->displaying_new) {
+        rq->latency[rq->latency_next] = TICK_TO_MICRO(tick_now_delta(rq->displaying_tick));
+        rq->latency_next = (rq->latency_next + 1) % LATENCY_SAMPLES;
+        if (rq->latency_count < LATENCY_SAMPLES) {
+            rq->latency_count++;
+        }
+        rq->frames_presented++;
+        rq->displaying_new = false;
+    } else {
+        rq->frames_repeated++;
+    }
 
-    return backbuffer;
+    if (++rq->presents_since_metrics >= METRICS_INTERVAL) {
+        publish_metrics(rq);
+        rq->presents_since_metrics = 0;
+    }
 }
 
-void render_queue_return_to_pool(void *render_queue, backbuffer_t *backbuffer)
+/** Set the area of the emulated frame rendered to the backbuffers, returns its
+    generation. Backbuffers rendered with another area must be rendered completely. */
+unsigned int render_queue_set_area(void *render_queue,
+                                   unsigned int xs, unsigned int ys,
+                                   unsigned int xi, unsigned int yi,
+                                   unsigned int w, unsigned int h,
+                                   unsigned int width, unsigned int height)
 {
     render_queue_t *rq = (render_queue_t *)render_queue;
+    unsigned int area[8];
+    unsigned int generation;
+
+    area[0] = xs;
+    area[1] = ys;
+    area[2] = xi;
+    area[3] = yi;
+    area[4] = w;
+    area[5] = h;
+    area[6] = width;
+    area[7] = height;
+
+    if (memcmp(area, rq->area, sizeof(area)) != 0) {
+        memcpy(rq->area, area, sizeof(area));
+        rq->area_generation++;
+    }
+    generation = rq->area_generation;
+
+    return generation;
+}
+
+/** Obtain the tracked frame a backbuffer holds with the current render area, or 0 */
+unsigned int render_queue_backbuffer_frame(void *render_queue, backbuffer_t *backbuffer)
+{
+    render_queue_t *rq = (render_queue_t *)render_queue;
+    unsigned int frame;
+
+    frame = backbuffer->frame_area == rq->area_generation ? backbuffer->frame : 0;
 
-    LOCK();
+    return frame;
+}
 
-    assert(rq->backbuffer_stack_size < RENDER_QUEUE_MAX_BACKBUFFERS);
+/** Obtain the tracked frame last queued for display with the current render area, or 0 */
+unsigned int render_queue_displayed_frame(void *render_queue)
+{
+    render_queue_t *rq = (render_queue_t *)render_queue;
+    unsigned int frame;
 
-    rq->backbuffer_stack[rq->backbuffer_stack_size] = backbuffer;
-    rq->backbuffer_stack_size++;
+    frame = rq->displayed_frame_area == rq->area_generation ? rq->displayed_frame : 0;
 
-    UNLOCK();
+    return frame;
 }
@@ -27,7 +27,7 @@
 #ifndef VICE_RENDER_QUEUE_H
 #define VICE_RENDER_QUEUE_H
 
-#define RENDER_QUEUE_MAX_BACKBUFFERS 2
+#define RENDER_QUEUE_MAX_BACKBUFFERS 4
 
 #include <stdbool.h>
 
@@ -39,6 +39,10 @@ typedef struct {
     unsigned int width;
     unsigned int height;
     float pixel_aspect_ratio;
+    /** Tracked frame the pixel data holds the output of, 0 if none, see video_canvas_render_changed() */
+    unsigned int frame;
+    /** Render area the frame was rendered with, see render_queue_set_area() */
+    unsigned int frame_area;
 } backbuffer_t;
 
 void *render_queue_create(void);
@@ -49,5 +53,14 @@ void render_queue_enqueue_for_display(void *render_queue, backbuffer_t *backbuff
 unsigned int render_queue_length(void *render_queue);
 backbuffer_t *render_queue_dequeue_for_display(void *render_queue);
 void render_queue_return_to_pool(void *render_queue, backbuffer_t *backbuffer);
+void render_queue_presented(void *render_queue);
+
+unsigned int render_queue_set_area(void *render_queue,
+                                   unsigned int xs, unsigned int ys,
+                                   unsigned int xi, unsigned int yi,
+                                   unsigned int w, unsigned int h,
+                                   unsigned int width, unsigned int height);
+unsigned int render_queue_backbuffer_frame(void *render_queue, backbuffer_t *backbuffer);
+unsigned int render_queue_displayed_frame(void *render_queue);
 
 #endif /* #ifndef VICE_RENDER_QUEUE_H */
@@ -184,6 +184,25 @@ int video_arch_get_active_chip(void)
     }
 }
 
+/** \brief  Check if a canvas is not shown at all
+ *
+ * Only the VDC window of x128 can be hidden, see the C128HideVDC resource.
+ *
+ * \param[in]   canvas  video canvas
+ *
+ * \return 1 if nothing the canvas renders is visible
+ */
+int video_arch_canvas_is_hidden(struct video_canvas_s *canvas)
+{
+    int hide_vdc = 0;
+
+    if (machine_class == VICE_MACHINE_C128
+            && canvas->window_index == SECONDARY_WINDOW) {
+        resources_get_int("C128HideVDC", &hide_vdc);
+    }
+    return hide_vdc;
+}
+
 /** \brief  Arch-specific initialization for a video canvas
  *  \param[inout] canvas The canvas being initialized
  *  \sa video_canvas_create
@@ -152,6 +152,9 @@ typedef struct video_canvas_s {
 
     /** \brief Used to limit frame rate under warp. */
     tick_t warp_next_render_tick;
+
+    /** \brief The current frame is not displayed, see vsync_will_skip_frame(). */
+    int skip_frame;
 } video_canvas_t;
 
 /** \brief Rescale and reposition the screen inside the canvas if the
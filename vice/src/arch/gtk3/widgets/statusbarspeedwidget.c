@@ -355,6 +355,8 @@ GtkWidget *statusbar_speed_widget_create(statusbar_speed_widget_state_t *state)
 
     state->last_cpu_int = -1;
     state->last_fps_int = -1;
+    state->last_runahead_int = -1;
+    state->last_present_frames = 0;
     state->last_paused = -1;
     state->last_warp = -1;
     state->last_shiftlock = -1;
@@ -479,6 +481,8 @@ void statusbar_speed_widget_update(GtkWidget *widget,
     double vsync_metric_cpu_percent;
     double vsync_metric_emulated_fps;
     int vsync_metric_warp_enabled;
+    double vsync_metric_runahead_percent;
+    vsync_present_metrics_t vsync_metric_present;
     tick_t now;
 
     /*
@@ -535,7 +539,7 @@ void statusbar_speed_widget_update(GtkWidget *widget,
         }
     }
 
-    vsyncarch_get_metrics(&vsync_metric_cpu_percent, &vsync_metric_emulated_fps, &vsync_metric_warp_enabled);
+    vsyncarch_get_metrics(&vsync_metric_cpu_percent, &vsync_metric_emulated_fps, &vsync_metric_warp_enabled, &vsync_metric_runahead_percent, &vsync_metric_present);
 
     /*
      * Updating GTK labels is expensive and this is called each frame,
@@ -544,6 +548,7 @@ void statusbar_speed_widget_update(GtkWidget *widget,
 
     int this_cpu_int = (int)(vsync_metric_cpu_percent  * pow(10, CPU_DECIMAL_PLACES) + 0.5);
     int this_fps_int = (int)(vsync_metric_emulated_fps * pow(10, FPS_DECIMAL_PLACES) + 0.5);
+    int this_runahead_int = (int)(vsync_metric_runahead_percent + 0.5);
     bool is_paused = ui_pause_active();
     bool is_shiftlock = keyboard_get_shiftlock();
     bool is_mode4080 = false;
@@ -573,6 +578,24 @@ void statusbar_speed_widget_update(GtkWidget *widget,
         state->last_cpu_int = this_cpu_int;
     }
 
+    if (state->last_runahead_int != this_runahead_int) {
+        grid = gtk_bin_get_child(GTK_BIN(widget));
+
+        /* show the extra host CPU time spent on run-ahead in the CPU
+         * label's tooltip */
+        label = gtk_grid_get_child_at(GTK_GRID(grid), 0, 0);
+        if (this_runahead_int > 0) {
+            g_snprintf(buffer,
+                       sizeof(buffer),
+                       "Run-ahead: %d%% of a frame",
+                       this_runahead_int);
+            gtk_widget_set_tooltip_text(label, buffer);
+        } else {
+            gtk_widget_set_tooltip_text(label, NULL);
+        }
+        state->last_runahead_int = this_runahead_int;
+    }
+
     /* Somehow the last state gets out of sync when pressing Alt+W and clicking
      * the warp led, or when pressing Alt+P and clicking the pause led, nearly
      * simultaneously, so we don't check for changes but always rerender the
@@ -650,6 +673,30 @@ void statusbar_speed_widget_update(GtkWidget *widget,
 
             state->last_fps_int = this_fps_int;
         }
+
+        /* show the frame pacing of the display path in the FPS label's
+         * tooltip, the render queue publishes it every few dozen frames */
+        if (state->last_present_frames != vsync_metric_present.frames_presented) {
+
+            if (grid == NULL) {
+                grid = gtk_bin_get_child(GTK_BIN(widget));
+            }
+            label = gtk_grid_get_child_at(GTK_GRID(grid), 0, 1);
+
+            g_snprintf(buffer,
+                       sizeof(buffer),
+                       "Present latency: %.1f / %.1f / %.1f ms (min/avg/p99)\n"
+                       "Frames: %lu presented, %lu dropped, %lu repeated",
+                       vsync_metric_present.latency_min_ms,
+                       vsync_metric_present.latency_avg_ms,
+                       vsync_metric_present.latency_p99_ms,
+                       vsync_metric_present.frames_presented,
+                       vsync_metric_present.frames_dropped,
+                       vsync_metric_present.frames_repeated);
+            gtk_widget_set_tooltip_text(label, buffer);
+
+            state->last_present_frames = vsync_metric_present.frames_presented;
+        }
     }
 
 #   undef CPU_DECIMAL_PLACES
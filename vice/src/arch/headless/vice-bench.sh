@@ -0,0 +1,315 @@
+#!/bin/sh
+
+# vice-bench.sh - Run the standard benchmark workloads
+#
+# This file is part of VICE, the Versatile Commodore Emulator.
+# See README for copyright notice.
+#
+#  This program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2 of the License, or
+#  (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software
+#  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+#  02111-1307  USA.
+#
+# Usage: vice-bench.sh [-b <bindir>] [-c <bindir>] [-d <datadir>] [-n <cycles>] [-o <options>] [workload...]
+#
+#   -b <bindir>   directory containing the (headless) emulators and c1541
+#   -c <bindir>   second build to compare against in the "dispatch" workload,
+#                 for example one configured with --enable-computed-goto
+#   -d <datadir>  directory containing the ROMs (usually vice/data)
+#   -n <cycles>   number of main CPU cycles to run each workload for
+#   -o <options>  extra emulator options, for example "+VICIIquietcycles"
+#                 to compare against the per pixel VIC-II pipeline
+#
+# Without workload arguments all workloads are run:
+#
+#   basic   x64sc, CPU bound BASIC loop
+#   text    x64sc, BASIC printing and scrolling text
+#   game    x64sc, multicolor text with three moving sprites in the lower
+#           border area, the screen of a typical game
+#   vicii   x64sc, multicolor bitmap, 8 expanded sprites, border color writes
+#   sid8    x64sc, 8 reSID chips playing
+#   sidpool x64sc, the "sid8" workload rendered without and with three SID
+#           worker threads (-residthreads); prints the run with workers and
+#           whether the samples of both runs are identical
+#   tde     x64sc, loading a file with true drive emulation
+#   dispatch x64sc, the "tde" workload with the opcodes of the main CPU and
+#           the 1541 CPU counted (-benchcpu); with -c also run with the
+#           second build, whose CPU state at the end must be identical
+#   frames  x64sc, sprites colliding with each other and with text while
+#           the light pen is triggered through CIA1 port B, run with every
+#           frame drawn, with only the collisions emulated and with every
+#           other frame drawn (-benchframes); prints whether the collision
+#           registers, light pen latch and CPU state of all three runs and
+#           the pixels of the frames drawn in both are identical
+#   reu     x64sc, REU DMA transfers
+#   vdc     x128, BASIC printing on the 80 column VDC screen
+#   cpm     x128, CP/M style 80 column output: scrolling lines of text with
+#           colors, reverse, underline and blinking attributes; then random
+#           VDC cells drawn with and without SSE2 (-benchvdc), one line per
+#           mode and implementation
+#   z80     x128, the Z80 running a CP/M style inner loop of block copies and
+#           checksums over RAM; it is started from BASIC through the 8502 to
+#           Z80 switch routine at $ffd0, so no CP/M system disk is needed;
+#           prints the Z80 opcodes and opcodes per second (-benchcpu)
+#   crt     x64sc, the last frame of a colored screen fed through each
+#           PAL/NTSC CRT renderer (one line per renderer and implementation)
+#   gcr     x64sc, converting a 40 track disk image to GCR and back
+#   hvsc    vsid, song length and STIL lookups in a synthetic HVSC of
+#           60000 tunes, with freshly built and with cached indexes
+#   alarms  x64sc, the main CPU alarm operations of the "tde" workload
+#           replayed into a new alarm context; needs a build configured
+#           with --enable-debug-alarms.  Use -benchalarms with -autostart
+#           to record a demo instead
+#
+# Each workload prints one "vice-bench: key=value ..." line, see bench.c.
+# The BASIC programs are typed in using -keybuf so no images need to be
+# shipped; the disk image for "tde", "dispatch" and "alarms" is created with c1541.
+
+BINDIR=.
+CMPDIR=
+DATADIR=
+CYCLES=20000000
+EXTRA=
+
+while getopts "b:c:d:n:o:" opt; do
+    case $opt in
+        b) BINDIR="$OPTARG" ;;
+        c) CMPDIR="$OPTARG" ;;
+        d) DATADIR="$OPTARG" ;;
+        n) CYCLES="$OPTARG" ;;
+        o) EXTRA="$OPTARG" ;;
+        *) echo "usage: $0 [-b bindir] [-c bindir] [-d datadir] [-n cycles] [-o options] [workload...]" >&2
+           exit 1 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+WORKLOADS="$*"
+if test -z "$WORKLOADS"; then
+    WORKLOADS="basic text game vicii sid8 sidpool tde dispatch frames reu vdc cpm z80 crt gcr hvsc alarms"
+fi
+
+TMPDIR=`mktemp -d 2>/dev/null || echo /tmp/vice-bench.$$`
+mkdir -p "$TMPDIR"
+trap 'rm -rf "$TMPDIR"' 0 1 2 15
+
+COMMON="-default -warp -silent -sounddev dummy -limitcycles $CYCLES"
+if test -n "$DATADIR"; then
+    COMMON="$COMMON -directory $DATADIR"
+fi
+COMMON="$COMMON $EXTRA"
+
+# run_workload <name> <emulator> <options...>
+run_workload()
+{
+    name="$1"
+    emu="$2"
+    shift 2
+
+    if test ! -x "$BINDIR/$emu"; then
+        echo "vice-bench: workload=$name error=missing-$emu"
+        return
+    fi
+    "$BINDIR/$emu" $COMMON -bench "$name" "$@" 2>/dev/null | grep '^vice-bench:' \
+        || echo "vice-bench: workload=$name error=failed"
+}
+
+# run_sid8 <name> <options...>
+run_sid8()
+{
+    name="$1"
+    shift
+
+    run_workload "$name" x64sc -sound -sidenginemodel resid -sidextra 7 \
+        -sid2address 0xd420 -sid3address 0xd440 -sid4address 0xd460 \
+        -sid5address 0xd480 -sid6address 0xd4a0 -sid7address 0xd4c0 \
+        -sid8address 0xd4e0 "$@" \
+        -keybuf '10 fors=54272to54496step32:pokes+24,15:pokes+5,9:pokes+6,240:pokes+4,33:next\n20 fors=54272to54496step32:pokes+1,rnd(1)*256:next:goto20\nrun\n'
+}
+
+# print the value of key $1 in the "vice-bench: sid=jobs" line of $2
+sid_value()
+{
+    echo "$2" | sed -n "s/^vice-bench: sid=jobs.* $1=\([^ ]*\).*/\1/p"
+}
+
+# print the value of key $1 in the "vice-bench: cpu=state" line of $2
+cpu_value()
+{
+    echo "$2" | sed -n "s/^vice-bench: cpu=state.* $1=\([^ ]*\).*/\1/p"
+}
+
+# print the value of key $1 in the "vice-bench: frames=" line of $2
+frames_value()
+{
+    echo "$2" | sed -n "s/^vice-bench: frames=.* $1=\([^ ]*\).*/\1/p"
+}
+
+# run_frames <mode>
+run_frames()
+{
+    run_workload frames x64sc +sound -benchframes "$1" -benchcpu -seed 1 \
+        -keybuf '10 v=53248:fori=832to894:pokei,255:next:fori=0to2:poke2040+i,13:next\n20 pokev+21,7:pokev,100:pokev+2,110:pokev+3,105:pokev+5,150:poke56323,16\n30 x=x+1and255:pokev+4,x:pokev+1,50+(xand127):pokev+32,x:poke56321,0:poke56321,16\n40 c=c+peek(v+30)+peek(v+31)+peek(v+19)+peek(v+20):goto30\nrun\n'
+}
+
+# run_tde <name> <options...>
+run_tde()
+{
+    name="$1"
+    shift
+
+    run_workload "$name" x64sc +sound -drive8type 1541 -drive8truedrive \
+        -8 "$TMPDIR/bench.d64" "$@" -keybuf 'load"bench",8,1\n'
+}
+
+# make the disk image for workload $1
+make_disk()
+{
+    if test ! -x "$BINDIR/c1541"; then
+        echo "vice-bench: workload=$1 error=missing-c1541"
+        return 1
+    fi
+    # 30000 bytes loaded to $0801, about 120 blocks
+    { printf '\001\010'; dd if=/dev/zero bs=1000 count=30 2>/dev/null; } > "$TMPDIR/bench.prg"
+    "$BINDIR/c1541" -silent -format bench,01 d64 "$TMPDIR/bench.d64" \
+        -write "$TMPDIR/bench.prg" bench >/dev/null 2>&1
+}
+
+for w in $WORKLOADS; do
+    case $w in
+        basic)
+            run_workload basic x64sc +sound \
+                -keybuf '10 a=a+1:b=sin(a)*a:goto10\nrun\n'
+            ;;
+        text)
+            run_workload text x64sc +sound \
+                -keybuf '10 print"vice-bench ";:goto10\nrun\n'
+            ;;
+        game)
+            run_workload game x64sc +sound \
+                -keybuf '10 v=53248:pokev+22,216:pokev+34,2:pokev+35,5:pokev+21,7:fori=0to2:poke2040+i,13:pokev+39+i,i+3:pokev+1+i*2,240:next\n20 x=x+1and255:pokev,x:pokev+2,255-x:pokev+4,x/2:goto20\nrun\n'
+            ;;
+        vicii)
+            run_workload vicii x64sc +sound \
+                -keybuf '10 v=53248:fori=0to7:pokev+i*2,24+i*32:pokev+1+i*2,100:next\n20 pokev+21,255:pokev+23,255:pokev+29,255:pokev+28,255\n30 pokev+17,59:pokev+22,216:pokev+24,24\n40 pokev+32,a:a=a+1:goto40\nrun\n'
+            ;;
+        sid8)
+            run_sid8 sid8
+            ;;
+        sidpool)
+            serial=`run_sid8 sidpool -residthreads 0 -benchsid`
+            pooled=`run_sid8 sidpool -residthreads 3 -benchsid`
+            echo "$pooled" | grep -v '^vice-bench: sid=jobs'
+            serial_sum=`sid_value checksum "$serial"`
+            pooled_sum=`sid_value checksum "$pooled"`
+            if test -z "$serial_sum" -o -z "$pooled_sum"; then
+                echo "vice-bench: sid=pool error=failed"
+            elif test "`sid_value pooled "$pooled"`" = 0; then
+                # without worker threads both runs take the same path
+                echo "vice-bench: sid=pool error=no-worker-threads"
+            else
+                identical=no
+                if test "$serial_sum" = "$pooled_sum"; then
+                    identical=yes
+                fi
+                echo "vice-bench: sid=pool chips=`sid_value chips "$pooled"` fragments=`sid_value fragments "$pooled"` pooled=`sid_value pooled "$pooled"` workers=`sid_value workers "$pooled"` identical=$identical"
+            fi
+            ;;
+        tde)
+            make_disk tde || continue
+            run_tde tde
+            ;;
+        dispatch)
+            make_disk dispatch || continue
+            # fixed seed, the random number generator feeds the drive
+            # rotation and the RAM init pattern
+            first=`run_tde dispatch -benchcpu -seed 1`
+            echo "$first"
+            if test -n "$CMPDIR"; then
+                second=`BINDIR="$CMPDIR" run_tde dispatch -benchcpu -seed 1`
+                echo "$second" | grep -v '^vice-bench: workload='
+                first_digest=`cpu_value digest "$first"`
+                second_digest=`cpu_value digest "$second"`
+                if test -z "$first_digest" -o -z "$second_digest"; then
+                    echo "vice-bench: cpu=compare error=failed"
+                else
+                    identical=no
+                    if test "$first_digest" = "$second_digest"; then
+                        identical=yes
+                    fi
+                    echo "vice-bench: cpu=compare dispatch=`cpu_value dispatch "$first"`,`cpu_value dispatch "$second"` identical=$identical"
+                fi
+            fi
+            ;;
+        frames)
+            draw=`run_frames draw`
+            skip=`run_frames skip`
+            alternate=`run_frames alternate`
+            echo "$skip" | grep '^vice-bench: workload='
+            first=`frames_value collisions "$draw"`
+            if test -z "$first" -o -z "`frames_value collisions "$skip"`" \
+                    -o -z "`frames_value collisions "$alternate"`"; then
+                echo "vice-bench: frames=compare error=failed"
+                continue
+            fi
+            identical=yes
+            for run in "$skip" "$alternate"; do
+                if test "`frames_value collisions "$run"`" != "$first" \
+                        -o "`cpu_value digest "$run"`" != "`cpu_value digest "$draw"`"; then
+                    identical=no
+                fi
+            done
+            pixels=no
+            if test "`frames_value pixels "$draw"`" = "`frames_value pixels "$alternate"`"; then
+                pixels=yes
+            fi
+            echo "vice-bench: frames=compare lines=`frames_value lines "$draw"` skipped=`frames_value skipped "$alternate"` identical=$identical pixels_identical=$pixels"
+            ;;
+        reu)
+            run_workload reu x64sc +sound -reu -reusize 512 \
+                -keybuf '10 r=57088:poker+2,0:poker+3,8:poker+4,0:poker+5,0:poker+6,0\n20 poker+7,0:poker+8,128:poker+9,0:poker+10,0\n30 poker+1,144:goto30\nrun\n'
+            ;;
+        vdc)
+            run_workload vdc x128 +sound -80col \
+                -keybuf '10 print"vice-bench ";:goto10\nrun\n'
+            ;;
+        cpm)
+            run_workload cpm x128 +sound -80col -benchvdc 2000 \
+                -keybuf '10 a$(0)=chr$(5):a$(1)=chr$(28)+chr$(18):a$(2)=chr$(30)+chr$(2):a$(3)=chr$(159)+chr$(15)\n20 fori=0to3:a$(i)=a$(i)+"a>dir b:*.com  pip con:=readme.txt       "+chr$(146)+chr$(130)+chr$(143):next\n30 printa$(nand3);:n=n+1:goto30\nrun\n'
+            ;;
+        z80)
+            # LD HL,$4000 / LD DE,$6000 / LD BC,$1000 / LDIR / LD HL,$6000 / XOR A
+            # loop: ADD A,(HL) / INC HL / DJNZ loop / LD (HL),A / JP $3000
+            # the Z80 continues at $ffee when switched on, JP $3000 is put there
+            run_workload z80 x128 +sound -benchcpu -seed 1 \
+                -keybuf '10 fori=0to22:reada:poke12288+i,a:next:poke65518,195:poke65519,0:poke65520,48:bank0:sys65488\n20 data33,0,64,17,0,96,1,0,16,237,176,33,0,96,175,134,35,16,252,119,195,0,48\nrun\n'
+            ;;
+        crt)
+            run_workload crt x64sc +sound -VICIIfilter 1 -benchrender 100 \
+                -keybuf '10 fori=0to999:poke1024+i,160:poke55296+i,i:next:poke53280,2\nrun\n'
+            ;;
+        gcr)
+            run_workload gcr x64sc +sound -benchgcr 50
+            ;;
+        hvsc)
+            run_workload hvsc vsid -benchhvsc 60000
+            ;;
+        alarms)
+            make_disk alarms || continue
+            run_tde alarms -benchalarms 20
+            ;;
+        *)
+            echo "vice-bench: workload=$w error=unknown-workload"
+            ;;
+    esac
+done
@@ -64,6 +64,20 @@ int video_arch_get_active_chip(void)
     return VIDEO_CHIP_VICII;
 }
 
+/** \brief  Arch-specific function to check if a canvas is not shown at all
+ *
+ * Note: this version always returns 0, so that the headless build keeps
+ * rendering every canvas for screenshots and benchmarks.
+ *
+ * \param[in]   canvas  video canvas
+ *
+ * \return 0
+ */
+int video_arch_canvas_is_hidden(struct video_canvas_s *canvas)
+{
+    return 0;
+}
+
 /** \brief  Arch-specific initialization for a video canvas
  *  \param[inout] canvas The canvas being initialized
  *  \sa video_canvas_create
@@ -117,7 +131,9 @@ char video_canvas_can_resize(video_canvas_t *canvas)
 {
     /* printf("%s\n", __func__); */
 
-    return 0;
+    /* there is no window to fit, so let the viewport follow the emulated
+       screen; otherwise it stays 0x0 and nothing is ever rendered */
+    return 1;
 }
 
 /** \brief Create a new video_canvas_s.
@@ -33,6 +33,7 @@
 #include "menu_common.h"
 #include "menu_snapshot.h"
 #include "snapshot.h"
+#include "rewind.h"
 #include "uiactions.h"
 #include "uimenu.h"
 #include "vice-event.h"
@@ -67,6 +68,15 @@ static void snapshot_quicksave_action(ui_action_map_t *self)
     ui_action_finish(self->action);
 }
 
+/** \brief  Go back one snapshot in the rewind buffer action
+ *
+ * \param[in]   self    action map
+ */
+static void snapshot_rewind_action(ui_action_map_t *self)
+{
+    rewind_trigger_restore(1);
+}
+
 /** \brief  Update status of the playback menu items
  *
  * Due to the SDL UI using traps to start/stop playback/recording of items the
@@ -200,6 +210,9 @@ static const ui_action_map_t snapshot_actions[] = {
         .handler = snapshot_quicksave_action,
         .blocks  = true
     },
+    {   .action  = ACTION_SNAPSHOT_REWIND,
+        .handler = snapshot_rewind_action
+    },
     {   .action  = ACTION_HISTORY_PLAYBACK_START,
         .handler = history_playback_start_action,
         .blocks  = true
@@ -1093,6 +1093,12 @@ int video_arch_get_active_chip(void)
     }
 }
 
+/* There is only one window, showing the active canvas */
+int video_arch_canvas_is_hidden(struct video_canvas_s *canvas)
+{
+    return sdl_num_screens > 1 && canvas != sdl_active_canvas;
+}
+
 void video_arch_canvas_init(struct video_canvas_s *canvas)
 {
     DBG(("%s: (%p, %i)", __func__, canvas, sdl_num_screens));
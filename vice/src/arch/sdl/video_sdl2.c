@@ -1180,6 +1180,24 @@ int video_arch_get_active_chip(void)
     }
 }
 
+/* In single window mode only the active canvas is shown, in dual window mode
+   the VDC window of x128 can be hidden. */
+int video_arch_canvas_is_hidden(struct video_canvas_s *canvas)
+{
+    int hide_vdc = 0;
+
+    if (sdl_num_screens < 2) {
+        return 0;
+    }
+    if (!sdl2_dual_window) {
+        return canvas != sdl_active_canvas;
+    }
+    if (machine_class == VICE_MACHINE_C128 && canvas->index == VIDEO_CANVAS_IDX_VDC) {
+        resources_get_int("C128HideVDC", &hide_vdc);
+    }
+    return hide_vdc;
+}
+
 void video_arch_canvas_init(struct video_canvas_s *canvas)
 {
     DBG(("%s: (%p, %i)", __func__, canvas, sdl_num_screens));
@@ -128,6 +128,9 @@ struct video_canvas_s {
 
     /** \brief Used to limit frame rate under warp. */
     tick_t warp_next_render_tick;
+
+    /** \brief The current frame is not displayed, see vsync_will_skip_frame(). */
+    int skip_frame;
 };
 typedef struct video_canvas_s video_canvas_t;
 
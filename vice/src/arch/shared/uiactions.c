@@ -291,6 +291,7 @@ static const ui_action_info_private_t action_info_list[] = {
     { ACTION_SNAPSHOT_SAVE,             "snapshot-save",            "Save snapshot file",               VICE_MACHINE_ALL^VICE_MACHINE_VSID },
     { ACTION_SNAPSHOT_QUICKLOAD,        "snapshot-quickload",       "Quickload snapshot",               VICE_MACHINE_ALL^VICE_MACHINE_VSID },
     { ACTION_SNAPSHOT_QUICKSAVE,        "snapshot-quicksave",       "Quicksave snapshot",               VICE_MACHINE_ALL^VICE_MACHINE_VSID },
+    { ACTION_SNAPSHOT_REWIND,           "snapshot-rewind",          "Go back one rewind snapshot",      VICE_MACHINE_ALL^VICE_MACHINE_VSID },
     { ACTION_HISTORY_RECORD_START,      "history-record-start",     "Start recording events",           VICE_MACHINE_ALL^VICE_MACHINE_VSID },
     { ACTION_HISTORY_RECORD_STOP,       "history-record-stop",      "Stop recording events",            VICE_MACHINE_ALL^VICE_MACHINE_VSID },
     { ACTION_HISTORY_PLAYBACK_START,    "history-playback-start",   "Start playing back events",        VICE_MACHINE_ALL^VICE_MACHINE_VSID },
@@ -0,0 +1,936 @@
+/** \file   bench.c
+ * \brief   Benchmark mode timing
+ *
+ * With `-bench <workload>` the emulator accounts the host time spent in a
+ * few hot subsystems and, when the `-limitcycles` limit is reached, prints
+ * a single `key=value` line to stdout and exits successfully instead of
+ * failing.  The time between entering and leaving a section is charged to
+ * that section only; nested sections (e.g. sound flushed from the vsync
+ * hook) are subtracted from the enclosing one, so the numbers add up to the
+ * total.  Sections are often shorter than the microsecond resolution of
+ * tick_now(), so the per-section numbers are only accurate on average.
+ *
+ * Measuring starts at the first vsync, so machine setup and ROM loading are
+ * not part of the result.  With `-benchrender <frames>` the last emulated
+ * frame is then also fed through the PAL/NTSC CRT renderers, which the
+ * headless UI otherwise never calls.  See arch/headless/vice-bench.sh for the set of
+ * standard workloads.
+ */
+
+/*
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+#include "vice.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "alarm.h"
+#include "archdep.h"
+#include "cmdline.h"
+#include "diskimage.h"
+#include "drive.h"
+#include "gcr.h"
+#include "lib.h"
+#include "machine.h"
+#include "maincpu.h"
+#include "mem.h"
+#include "monitor.h"
+#include "mos6510.h"
+#include "types.h"
+#include "util.h"
+#include "video.h"
+
+#include "bench.h"
+
+/* deep enough for vsync -> sound -> drive, with room to spare */
+#define BENCH_STACK_MAX 8
+
+static const char * const section_names[BENCH_SECTION_COUNT] = {
+    "video", "sound", "drive", "vsync"
+};
+
+int bench_enabled = 0;
+
+static char *workload_name = NULL;
+
+/* number of times to feed the last frame through the CRT renderers */
+static int render_frames = 0;
+
+/* number of times to convert and re-read a 40 track disk image */
+static int gcr_passes = 0;
+
+/* number of times to replay the recorded main CPU alarm trace */
+static int alarm_passes = 0;
+
+/* report the checksums of the samples of a multi-SID setup */
+static int sid_checksums = 0;
+
+/* reports of machine specific benchmarks, see bench_register_report() */
+#define BENCH_REPORTS_MAX   4
+
+static bench_report_t reports[BENCH_REPORTS_MAX];
+static int num_reports = 0;
+
+/* how frames are drawn (-benchframes), see bench_frame_skip() */
+#define BENCH_FRAMES_AUTO       0
+#define BENCH_FRAMES_DRAW       1
+#define BENCH_FRAMES_SKIP       2
+#define BENCH_FRAMES_ALTERNATE  3
+
+static int frames_mode = BENCH_FRAMES_AUTO;
+
+/* print the opcode counts and a digest of the CPU state (-benchcpu) */
+static int cpu_report = 0;
+
+static int started = 0;
+static tick_t start_tick;
+static CLOCK start_clk;
+static unsigned long frames;
+static unsigned long frames_unchanged_start;
+
+/* tick_t is only 32 bit, so sum up in 64 bit */
+static uint64_t section_ticks[BENCH_SECTION_COUNT];
+static bench_section_t section_stack[BENCH_STACK_MAX];
+static int section_depth;
+static tick_t section_mark;
+
+/** \brief  Add a report to print when the cycle limit is reached
+ *
+ * Benchmarks that only make sense for one emulator, like the HVSC lookups
+ * of vsid, live with that emulator and are run through this hook.
+ *
+ * \param[in]  report  function to call from bench_finish()
+ */
+void bench_register_report(bench_report_t report)
+{
+    if (num_reports < BENCH_REPORTS_MAX) {
+        reports[num_reports++] = report;
+    }
+}
+
+void bench_enter(bench_section_t section)
+{
+    tick_t now = tick_now();
+
+    if (section_depth > 0 && section_depth <= BENCH_STACK_MAX) {
+        section_ticks[section_stack[section_depth - 1]] += now - section_mark;
+    }
+    if (section_depth < BENCH_STACK_MAX) {
+        section_stack[section_depth] = section;
+    }
+    section_depth++;
+    section_mark = now;
+}
+
+void bench_leave(void)
+{
+    tick_t now = tick_now();
+
+    if (section_depth == 0) {
+        return;
+    }
+    section_depth--;
+    if (section_depth < BENCH_STACK_MAX) {
+        section_ticks[section_stack[section_depth]] += now - section_mark;
+    }
+    section_mark = now;
+}
+
+#ifdef HAVE_DEBUG_ALARMS
+/* recorded main CPU alarm operations, see bench_alarms_record() */
+#define BENCH_ALARM_EVENTS_MAX  (1 << 22)
+#define BENCH_ALARMS_MAX        256
+
+/* recorded after the pending alarms: `id' is the next pending alarm */
+#define BENCH_ALARM_NEXT        0xff
+
+typedef struct bench_alarm_event_s {
+    CLOCK clk;
+    uint16_t id;                /* index into recorded_alarms[] */
+    uint8_t op;                 /* alarm_trace_op_t or BENCH_ALARM_NEXT */
+} bench_alarm_event_t;
+
+static bench_alarm_event_t *alarm_events = NULL;
+static unsigned int num_alarm_events;
+static int alarm_events_truncated;
+static alarm_t *recorded_alarms[BENCH_ALARMS_MAX];
+static unsigned int num_recorded_alarms;
+
+static void bench_alarms_add(alarm_t *alarm, unsigned int op, CLOCK clk)
+{
+    bench_alarm_event_t *event;
+    unsigned int id = 0;
+
+    if (num_alarm_events >= BENCH_ALARM_EVENTS_MAX) {
+        alarm_events_truncated = 1;
+        return;
+    }
+
+    if (alarm != NULL) {
+        for (id = 0; id < num_recorded_alarms; id++) {
+            if (recorded_alarms[id] == alarm) {
+                break;
+            }
+        }
+        if (id == num_recorded_alarms) {
+            if (id >= BENCH_ALARMS_MAX) {
+                alarm_events_truncated = 1;
+                return;
+            }
+            recorded_alarms[num_recorded_alarms++] = alarm;
+        }
+    }
+
+    event = &alarm_events[num_alarm_events++];
+    event->clk = clk;
+    event->id = (uint16_t)id;
+    event->op = (uint8_t)op;
+}
+
+static void bench_alarms_trace(alarm_context_t *context, alarm_t *alarm,
+                               alarm_trace_op_t op, CLOCK clk)
+{
+    if (context == maincpu_alarm_context) {
+        bench_alarms_add(alarm, op, clk);
+    }
+}
+
+/** \brief  Start recording the alarm operations of the main CPU
+ *
+ * The alarms already pending are recorded as set first, in the order of the
+ * pending alarm array, followed by the next pending alarm.  Replaying the
+ * trace then starts from the same state, so alarms due at the same clock
+ * tick are dispatched in the same order.
+ */
+static void bench_alarms_record(void)
+{
+    alarm_context_t *context = maincpu_alarm_context;
+    unsigned int i;
+
+    alarm_events = lib_malloc(BENCH_ALARM_EVENTS_MAX * sizeof *alarm_events);
+    num_alarm_events = 0;
+    alarm_events_truncated = 0;
+    num_recorded_alarms = 0;
+
+    for (i = 0; i < context->num_pending_alarms; i++) {
+        bench_alarms_add(context->pending_alarms[i].alarm, ALARM_TRACE_SET,
+                         context->pending_alarms[i].clk);
+    }
+    if (context->num_pending_alarms > 0) {
+        bench_alarms_add(context->pending_alarms[context->next_pending_alarm_idx].alarm,
+                         BENCH_ALARM_NEXT, 0);
+    }
+
+    alarm_trace_hook = bench_alarms_trace;
+}
+#endif
+
+/* The samples rendered for each chip of a multi-SID setup, hashed per chip
+   so the result depends neither on how the chips were spread over the SID
+   worker threads nor on where the fragments end.  Comparing the checksums of
+   a run with and one without workers checks that the pool renders the same
+   samples.  */
+#define BENCH_SIDS_MAX  8
+
+static uint32_t sid_hash[BENCH_SIDS_MAX];
+static int sid_chips;
+static unsigned long sid_fragments;
+static unsigned long sid_fragments_pooled;
+static int sid_workers;
+
+void bench_sid_samples(int chip, const int16_t *buf, int nr, int interleave)
+{
+    uint32_t hash;
+    int i;
+
+    if (!started || chip >= BENCH_SIDS_MAX) {
+        return;
+    }
+    if (chip >= sid_chips) {
+        for (i = sid_chips; i <= chip; i++) {
+            sid_hash[i] = 2166136261u;
+        }
+        sid_chips = chip + 1;
+    }
+    /* FNV-1a over the little endian samples */
+    hash = sid_hash[chip];
+    for (i = 0; i < nr; i++) {
+        uint16_t sample = (uint16_t)buf[i * interleave];
+
+        hash = (hash ^ (sample & 0xff)) * 16777619u;
+        hash = (hash ^ (sample >> 8)) * 16777619u;
+    }
+    sid_hash[chip] = hash;
+}
+
+void bench_sid_fragment(int workers)
+{
+    if (!started) {
+        return;
+    }
+    sid_fragments++;
+    if (workers > 0) {
+        sid_fragments_pooled++;
+        if (workers > sid_workers) {
+            sid_workers = workers;
+        }
+    }
+}
+
+static void bench_sid_report(void)
+{
+    uint32_t checksum = 2166136261u;
+    int i;
+
+    for (i = 0; i < sid_chips; i++) {
+        checksum = (checksum ^ sid_hash[i]) * 16777619u;
+    }
+    printf("vice-bench: sid=jobs chips=%d fragments=%lu pooled=%lu workers=%d checksum=%08x\n",
+           sid_chips, sid_fragments, sid_fragments_pooled, sid_workers, (unsigned int)checksum);
+    fflush(stdout);
+}
+
+/* Opcode counts for -benchcpu.
+
+   The main CPU loop, the 6502 drive CPU loop and the Z80 loop count every
+   opcode they dispatch, the Z80 also the main CPU cycles it ran for.  Together with the clocks, registers and memory
+   of both CPUs at the end of the run they give a digest that must not
+   depend on how the cores dispatch opcodes (switch or computed goto, see
+   6510core.h), and an instructions per second figure to compare both.  */
+CLOCK bench_maincpu_instructions = 0;
+CLOCK bench_drivecpu_instructions[BENCH_DRIVES];
+CLOCK bench_z80_instructions = 0;
+CLOCK bench_z80_cycles = 0;
+
+static CLOCK maincpu_start_instructions;
+static CLOCK z80_start_instructions;
+static CLOCK z80_start_cycles;
+static CLOCK drivecpu_start_instructions[BENCH_DRIVES];
+static CLOCK drivecpu_start_clk[BENCH_DRIVES];
+
+static uint32_t cpu_hash(uint32_t hash, uint64_t value)
+{
+    int i;
+
+    /* FNV-1a over the little endian bytes */
+    for (i = 0; i < 8; i++) {
+        hash = (hash ^ (uint8_t)(value >> (i * 8))) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t cpu_hash_regs(uint32_t hash, mos6510_regs_t *regs)
+{
+    hash = cpu_hash(hash, MOS6510_REGS_GET_PC(regs));
+    hash = cpu_hash(hash, MOS6510_REGS_GET_A(regs));
+    hash = cpu_hash(hash, MOS6510_REGS_GET_X(regs));
+    hash = cpu_hash(hash, MOS6510_REGS_GET_Y(regs));
+    hash = cpu_hash(hash, MOS6510_REGS_GET_SP(regs));
+    return cpu_hash(hash, MOS6510_REGS_GET_STATUS(regs));
+}
+
+static int bench_cpu_drive_active(int dnr)
+{
+    return dnr < NUM_DISK_UNITS
+           && diskunit_context[dnr] != NULL
+           && diskunit_context[dnr]->enable
+           && diskunit_context[dnr]->cpu != NULL;
+}
+
+static void bench_cpu_start(void)
+{
+    int dnr;
+
+    maincpu_start_instructions = bench_maincpu_instructions;
+    z80_start_instructions = bench_z80_instructions;
+    z80_start_cycles = bench_z80_cycles;
+    for (dnr = 0; dnr < BENCH_DRIVES; dnr++) {
+        drivecpu_start_instructions[dnr] = bench_drivecpu_instructions[dnr];
+        if (bench_cpu_drive_active(dnr)) {
+            drivecpu_start_clk[dnr] = *(diskunit_context[dnr]->clk_ptr);
+        }
+    }
+}
+
+static void bench_cpu_report(double seconds)
+{
+    const char *dispatch;
+    uint32_t hash = 2166136261u;
+    unsigned int addr;
+    int dnr;
+
+#if defined(USE_COMPUTED_GOTO_DISPATCH) && defined(__GNUC__)
+    dispatch = "goto";
+#else
+    dispatch = "switch";
+#endif
+
+    if (bench_maincpu_instructions == 0) {
+        printf("vice-bench: cpu=maincpu error=not-counted\n");
+        fflush(stdout);
+        return;
+    }
+
+    /* let the drives catch up, so their state is taken at the same clock */
+    drive_cpu_execute_all(maincpu_clk);
+
+    printf("vice-bench: cpu=maincpu dispatch=%s instructions=%"PRIu64" cycles=%"PRIu64
+           " instructions_per_sec=%.0f\n",
+           dispatch,
+           (uint64_t)(bench_maincpu_instructions - maincpu_start_instructions),
+           (uint64_t)(maincpu_clk - start_clk),
+           (double)(bench_maincpu_instructions - maincpu_start_instructions) / seconds);
+    hash = cpu_hash(hash, maincpu_clk);
+    hash = cpu_hash(hash, bench_maincpu_instructions);
+    if (maincpu_monitor_interface->cpu_regs != NULL) {
+        hash = cpu_hash_regs(hash, maincpu_monitor_interface->cpu_regs);
+    }
+    for (addr = 0; addr < 0x10000; addr++) {
+        hash = cpu_hash(hash, mem_bank_peek(0, (uint16_t)addr, NULL));
+    }
+
+    if (bench_z80_instructions != z80_start_instructions) {
+        printf("vice-bench: cpu=z80 instructions=%"PRIu64" cycles=%"PRIu64
+               " instructions_per_sec=%.0f\n",
+               (uint64_t)(bench_z80_instructions - z80_start_instructions),
+               (uint64_t)(bench_z80_cycles - z80_start_cycles),
+               (double)(bench_z80_instructions - z80_start_instructions) / seconds);
+        hash = cpu_hash(hash, bench_z80_instructions);
+        hash = cpu_hash(hash, bench_z80_cycles);
+    }
+
+    for (dnr = 0; dnr < BENCH_DRIVES; dnr++) {
+        diskunit_context_t *unit;
+        CLOCK clk;
+
+        if (!bench_cpu_drive_active(dnr)) {
+            continue;
+        }
+        unit = diskunit_context[dnr];
+        clk = *(unit->clk_ptr);
+        printf("vice-bench: cpu=drive%d dispatch=%s instructions=%"PRIu64" cycles=%"PRIu64
+               " instructions_per_sec=%.0f\n",
+               dnr + 8,
+               dispatch,
+               (uint64_t)(bench_drivecpu_instructions[dnr] - drivecpu_start_instructions[dnr]),
+               (uint64_t)(clk - drivecpu_start_clk[dnr]),
+               (double)(bench_drivecpu_instructions[dnr] - drivecpu_start_instructions[dnr]) / seconds);
+        hash = cpu_hash(hash, clk);
+        hash = cpu_hash(hash, bench_drivecpu_instructions[dnr]);
+        hash = cpu_hash_regs(hash, &(unit->cpu->cpu_regs));
+        for (addr = 0; addr < DRIVE_RAM_SIZE; addr++) {
+            hash = cpu_hash(hash, unit->drive_ram[addr]);
+        }
+    }
+    printf("vice-bench: cpu=state dispatch=%s digest=%08x\n", dispatch, (unsigned int)hash);
+    fflush(stdout);
+}
+
+/* Forced frame drawing for -benchframes.
+
+   x64sc only emulates the sprite collisions in frames that are not
+   displayed (see vsync_will_skip_frame()).  With every frame drawn, no
+   frame drawn, or every other frame drawn, the collision registers and
+   the light pen latch sampled at the end of every line must be the same,
+   and so must the pixels of the even frames, which are drawn in both the
+   "draw" and the "alternate" mode.  */
+static unsigned long frames_forced;
+static unsigned long frames_skipped;
+static unsigned long frames_lines;
+static int frames_even;
+static uint32_t frames_collision_hash = 2166136261u;
+static uint32_t frames_pixel_hash = 2166136261u;
+
+static uint32_t frames_hash(uint32_t hash, uint8_t value)
+{
+    return (hash ^ value) * 16777619u;
+}
+
+/** \brief  Decide whether the frame starting now is skipped
+ *
+ * \return 1 to skip, 0 to draw it, -1 to leave the decision to vsync
+ */
+int bench_frame_skip(void)
+{
+    int skip;
+
+    switch (frames_mode) {
+        case BENCH_FRAMES_DRAW:
+            skip = 0;
+            break;
+        case BENCH_FRAMES_SKIP:
+            skip = 1;
+            break;
+        case BENCH_FRAMES_ALTERNATE:
+            skip = (int)(frames_forced & 1);
+            break;
+        default:
+            return -1;
+    }
+    frames_even = !(frames_forced & 1);
+    frames_forced++;
+    if (skip) {
+        frames_skipped++;
+    }
+    return skip;
+}
+
+/** \brief  Sample the end of a raster line for -benchframes
+ *
+ * \param[in]  sprite_sprite       sprite-sprite collisions ($D01E)
+ * \param[in]  sprite_background   sprite-background collisions ($D01F)
+ * \param[in]  light_pen_x         light pen X latch ($D013)
+ * \param[in]  light_pen_y         light pen Y latch ($D014)
+ * \param[in]  pixels              pixels of the line, NULL if not drawn
+ * \param[in]  size                number of pixels
+ */
+void bench_video_line(uint8_t sprite_sprite, uint8_t sprite_background,
+                      int light_pen_x, int light_pen_y,
+                      const uint8_t *pixels, int size)
+{
+    uint32_t hash;
+    int i;
+
+    if (frames_mode == BENCH_FRAMES_AUTO || frames_forced == 0) {
+        return;
+    }
+    frames_lines++;
+
+    hash = frames_collision_hash;
+    hash = frames_hash(hash, sprite_sprite);
+    hash = frames_hash(hash, sprite_background);
+    hash = frames_hash(hash, (uint8_t)light_pen_x);
+    hash = frames_hash(hash, (uint8_t)light_pen_y);
+    frames_collision_hash = hash;
+
+    if (pixels != NULL && frames_even) {
+        hash = frames_pixel_hash;
+        for (i = 0; i < size; i++) {
+            hash = frames_hash(hash, pixels[i]);
+        }
+        frames_pixel_hash = hash;
+    }
+}
+
+static void bench_frames_report(void)
+{
+    static const char * const mode_names[] = {
+        "auto", "draw", "skip", "alternate"
+    };
+
+    printf("vice-bench: frames=%s forced=%lu skipped=%lu lines=%lu collisions=%08x",
+           mode_names[frames_mode], frames_forced, frames_skipped, frames_lines,
+           (unsigned int)frames_collision_hash);
+    if (frames_mode != BENCH_FRAMES_SKIP) {
+        printf(" pixels=%08x", (unsigned int)frames_pixel_hash);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+void bench_vsync(void)
+{
+    int i;
+
+    if (!bench_enabled) {
+        return;
+    }
+
+    if (!started) {
+        for (i = 0; i < BENCH_SECTION_COUNT; i++) {
+            section_ticks[i] = 0;
+        }
+        bench_cpu_start();
+        start_tick = tick_now();
+        start_clk = maincpu_clk;
+        frames = 0;
+        frames_unchanged_start = video_canvas_frames_unchanged();
+#ifdef HAVE_DEBUG_ALARMS
+        if (alarm_passes > 0) {
+            bench_alarms_record();
+        }
+#endif
+        started = 1;
+        return;
+    }
+    frames++;
+}
+
+static double ticks_to_seconds(uint64_t ticks)
+{
+    return (double)ticks / tick_per_second();
+}
+
+/** \brief  Time the GCR codec
+ *
+ * Converts every sector of a 40 track D64 image to GCR the way true drive
+ * emulation does on attach, then reads every sector back from the tracks.
+ *
+ * \param[in]   passes  number of times to convert and read the image
+ */
+static void bench_gcr(int passes)
+{
+    gcr_t *gcr;
+    gcr_header_t header;
+    uint8_t sector_data[256];
+    uint8_t read_data[256];
+    uint8_t *ptr;
+    uint64_t convert_ticks = 0;
+    uint64_t read_ticks = 0;
+    unsigned int track, sector, sectors = 0;
+    unsigned int gap, headergap, synclen;
+    unsigned long errors = 0;
+    tick_t mark;
+    int pass, i;
+
+    gcr = gcr_create_image();
+    for (track = 1; track <= 40; track++) {
+        gcr->tracks[track * 2 - 2].size = disk_image_raw_track_size(DISK_IMAGE_TYPE_D64, track);
+        gcr->tracks[track * 2 - 2].data = lib_malloc(NUM_MAX_BYTES_TRACK);
+    }
+    header.id1 = 0xa0;
+    header.id2 = 0xa0;
+
+    for (pass = 0; pass < passes; pass++) {
+        for (track = 1; track <= 40; track++) {
+            disk_track_t *raw = &gcr->tracks[track * 2 - 2];
+
+            gap = disk_image_gap_size(DISK_IMAGE_TYPE_D64, track);
+            headergap = disk_image_header_gap_size(DISK_IMAGE_TYPE_D64, track);
+            synclen = disk_image_sync_size(DISK_IMAGE_TYPE_D64, track);
+            header.track = track;
+
+            mark = tick_now();
+            memset(raw->data, 0x55, raw->size);
+            ptr = raw->data;
+            for (sector = 0; sector < disk_image_sector_per_track(DISK_IMAGE_TYPE_D64, track); sector++) {
+                for (i = 0; i < 256; i++) {
+                    sector_data[i] = (uint8_t)(track * 7 + sector * 13 + i);
+                }
+                header.sector = sector;
+                gcr_convert_sector_to_GCR(sector_data, ptr, &header, headergap, synclen, CBMDOS_FDC_ERR_OK);
+                ptr += SECTOR_GCR_SIZE_WITH_HEADER + headergap + gap + (synclen * 2);
+            }
+            convert_ticks += tick_now_delta(mark);
+
+            for (sector = 0; sector < disk_image_sector_per_track(DISK_IMAGE_TYPE_D64, track); sector++) {
+                mark = tick_now();
+                if (gcr_read_sector(raw, read_data, sector) != CBMDOS_FDC_ERR_OK) {
+                    errors++;
+                }
+                read_ticks += tick_now_delta(mark);
+                for (i = 0; i < 256; i++) {
+                    if (read_data[i] != (uint8_t)(track * 7 + sector * 13 + i)) {
+                        errors++;
+                        break;
+                    }
+                }
+                sectors++;
+            }
+        }
+    }
+
+    printf("vice-bench: codec=gcr tracks=40 sectors=%u convert_us_per_sector=%.2f read_us_per_sector=%.2f errors=%lu\n",
+           sectors,
+           sectors ? ticks_to_seconds(convert_ticks) * 1000000.0 / sectors : 0.0,
+           sectors ? ticks_to_seconds(read_ticks) * 1000000.0 / sectors : 0.0,
+           errors);
+    fflush(stdout);
+
+    for (track = 1; track <= 40; track++) {
+        lib_free(gcr->tracks[track * 2 - 2].data);
+    }
+    gcr_destroy_image(gcr);
+}
+
+#ifdef HAVE_DEBUG_ALARMS
+/* id of the alarm dispatched last during a replay */
+static int replay_fired;
+
+static void bench_alarms_callback(CLOCK offset, void *data)
+{
+    replay_fired = *(int *)data;
+}
+
+/** \brief  Replay the recorded alarm trace in a new alarm context
+ *
+ * \param[out]  errors  incremented for each dispatch that differs from the
+ *                      recorded one
+ *
+ * \return  ticks spent replaying
+ */
+static uint64_t bench_alarms_replay(unsigned long *errors)
+{
+    alarm_context_t *context;
+    alarm_t *alarms[BENCH_ALARMS_MAX];
+    int ids[BENCH_ALARMS_MAX];
+    const bench_alarm_event_t *event;
+    unsigned int i;
+    tick_t mark;
+
+    context = alarm_context_new("BenchAlarms");
+    for (i = 0; i < num_recorded_alarms; i++) {
+        ids[i] = (int)i;
+        alarms[i] = alarm_new(context, recorded_alarms[i]->name,
+                              bench_alarms_callback, &ids[i]);
+    }
+
+    mark = tick_now();
+    for (i = 0; i < num_alarm_events; i++) {
+        event = &alarm_events[i];
+        switch (event->op) {
+            case ALARM_TRACE_SET:
+                alarm_set(alarms[event->id], event->clk);
+                break;
+            case ALARM_TRACE_UNSET:
+                alarm_unset(alarms[event->id]);
+                break;
+            case ALARM_TRACE_DISPATCH:
+                replay_fired = -1;
+                if (alarm_context_next_pending_clk(context) <= event->clk) {
+                    alarm_context_dispatch(context, event->clk);
+                }
+                if (replay_fired != (int)event->id) {
+                    (*errors)++;
+                }
+                break;
+            case ALARM_TRACE_WARP_FORWARD:
+                alarm_context_time_warp(context, event->clk, 1);
+                break;
+            case ALARM_TRACE_WARP_BACKWARD:
+                alarm_context_time_warp(context, event->clk, -1);
+                break;
+            case BENCH_ALARM_NEXT:
+                context->next_pending_alarm_idx = alarms[event->id]->pending_idx;
+                context->next_pending_alarm_clk
+                    = context->pending_alarms[context->next_pending_alarm_idx].clk;
+                break;
+            default:
+                break;
+        }
+    }
+    mark = tick_now_delta(mark);
+
+    alarm_context_destroy(context);
+    return mark;
+}
+
+/** \brief  Replay the alarm trace recorded during the benchmark
+ *
+ * Replays the main CPU alarm operations recorded since the first vsync in
+ * a new alarm context, and checks each dispatch against the recorded one.
+ *
+ * \param[in]   passes  number of times to replay the trace
+ */
+static void bench_alarms(int passes)
+{
+    uint64_t ticks = 0;
+    unsigned long errors = 0;
+    unsigned long dispatches = 0;
+    uint64_t events;
+    unsigned int i;
+    int pass;
+
+    alarm_trace_hook = NULL;
+    if (alarm_events == NULL) {
+        return;
+    }
+
+    for (i = 0; i < num_alarm_events; i++) {
+        if (alarm_events[i].op == ALARM_TRACE_DISPATCH) {
+            dispatches++;
+        }
+    }
+    for (pass = 0; pass < passes; pass++) {
+        ticks += bench_alarms_replay(&errors);
+    }
+    events = (uint64_t)num_alarm_events * passes;
+
+    printf("vice-bench: alarms=maincpu events=%u dispatches=%lu alarms_used=%u truncated=%d"
+           " ns_per_event=%.1f errors=%lu\n",
+           num_alarm_events, dispatches, num_recorded_alarms, alarm_events_truncated,
+           events ? ticks_to_seconds(ticks) * 1000000000.0 / events : 0.0,
+           errors);
+    fflush(stdout);
+
+    lib_free(alarm_events);
+    alarm_events = NULL;
+}
+#endif
+
+/** \brief  Print the results and exit the emulator
+ *
+ * Called from the main CPU loop once the cycle limit is reached.
+ */
+void bench_finish(void)
+{
+    uint64_t elapsed;
+    uint64_t accounted = 0;
+    double seconds;
+    CLOCK cycles;
+    int i;
+
+    if (!started) {
+        start_tick = tick_now();
+        start_clk = maincpu_clk;
+    }
+    elapsed = tick_now_delta(start_tick);
+    seconds = ticks_to_seconds(elapsed);
+    cycles = maincpu_clk - start_clk;
+    if (seconds <= 0.0) {
+        seconds = 1.0 / tick_per_second();
+    }
+
+    printf("vice-bench: workload=%s machine=%s cycles=%"PRIu64" seconds=%.3f"
+           " cycles_per_sec=%.0f frames=%lu frames_per_sec=%.2f frames_unchanged=%lu",
+           workload_name != NULL ? workload_name : "none",
+           machine_name,
+           (uint64_t)cycles,
+           seconds,
+           (double)cycles / seconds,
+           frames,
+           (double)frames / seconds,
+           video_canvas_frames_unchanged() - frames_unchanged_start);
+    for (i = 0; i < BENCH_SECTION_COUNT; i++) {
+        printf(" %s=%.3f", section_names[i], ticks_to_seconds(section_ticks[i]));
+        accounted += section_ticks[i];
+    }
+    printf(" cpu=%.3f\n",
+           accounted < elapsed ? ticks_to_seconds(elapsed - accounted) : 0.0);
+    fflush(stdout);
+
+    if (render_frames > 0) {
+        video_canvas_render_bench(render_frames);
+    }
+    if (gcr_passes > 0) {
+        bench_gcr(gcr_passes);
+    }
+    if (sid_checksums) {
+        bench_sid_report();
+    }
+    for (i = 0; i < num_reports; i++) {
+        reports[i]();
+    }
+    if (cpu_report) {
+        bench_cpu_report(seconds);
+    }
+    if (frames_mode != BENCH_FRAMES_AUTO) {
+        bench_frames_report();
+    }
+    if (alarm_passes > 0) {
+#ifdef HAVE_DEBUG_ALARMS
+        bench_alarms(alarm_passes);
+#else
+        printf("vice-bench: alarms=maincpu error=needs-debug-alarms\n");
+        fflush(stdout);
+#endif
+    }
+
+    lib_free(workload_name);
+    workload_name = NULL;
+
+    archdep_vice_exit(EXIT_SUCCESS);
+}
+
+static int set_bench(const char *param, void *extra_param)
+{
+    lib_free(workload_name);
+    workload_name = lib_strdup(param);
+    bench_enabled = 1;
+    return 0;
+}
+
+static int set_bench_render(const char *param, void *extra_param)
+{
+    render_frames = atoi(param);
+    return 0;
+}
+
+static int set_bench_gcr(const char *param, void *extra_param)
+{
+    gcr_passes = atoi(param);
+    return 0;
+}
+
+static int set_bench_alarms(const char *param, void *extra_param)
+{
+    alarm_passes = atoi(param);
+    return 0;
+}
+
+static int set_bench_sid(const char *param, void *extra_param)
+{
+    sid_checksums = 1;
+    return 0;
+}
+
+static int set_bench_cpu(const char *param, void *extra_param)
+{
+    cpu_report = 1;
+    return 0;
+}
+
+static int set_bench_frames(const char *param, void *extra_param)
+{
+    if (strcmp(param, "draw") == 0) {
+        frames_mode = BENCH_FRAMES_DRAW;
+    } else if (strcmp(param, "skip") == 0) {
+        frames_mode = BENCH_FRAMES_SKIP;
+    } else if (strcmp(param, "alternate") == 0) {
+        frames_mode = BENCH_FRAMES_ALTERNATE;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static const cmdline_option_t cmdline_options[] =
+{
+    { "-bench", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench, NULL, NULL, NULL,
+      "<name>", "Benchmark mode: time workload <name> and print the results when the -limitcycles limit is reached" },
+    { "-benchrender", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench_render, NULL, NULL, NULL,
+      "<frames>", "Benchmark mode: also render the last frame <frames> times with each PAL/NTSC CRT renderer" },
+    { "-benchgcr", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench_gcr, NULL, NULL, NULL,
+      "<passes>", "Benchmark mode: also convert every sector of a 40 track disk image to GCR and read it back <passes> times" },
+    { "-benchalarms", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench_alarms, NULL, NULL, NULL,
+      "<passes>", "Benchmark mode: also record the main CPU alarm operations and replay them <passes> times (needs --enable-debug-alarms)" },
+    { "-benchsid", CALL_FUNCTION, CMDLINE_ATTRIB_NONE,
+      set_bench_sid, NULL, NULL, NULL,
+      NULL, "Benchmark mode: also print checksums of the samples of each chip of a multi-SID setup" },
+    { "-benchcpu", CALL_FUNCTION, CMDLINE_ATTRIB_NONE,
+      set_bench_cpu, NULL, NULL, NULL,
+      NULL, "Benchmark mode: also print the opcodes executed by the main, drive and Z80 CPUs and a digest of their state" },
+    { "-benchframes", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench_frames, NULL, NULL, NULL,
+      "<mode>", "Benchmark mode: draw every frame (draw), only emulate the sprite collisions in every frame (skip) or in every other frame (alternate), and print checksums of the collision registers, the light pen latch and the drawn pixels (x64sc)" },
+    CMDLINE_LIST_END
+};
+
+int bench_cmdline_options_init(void)
+{
+    return cmdline_register_options(cmdline_options);
+}
@@ -0,0 +1,88 @@
+/** \file   bench.h
+ * \brief   Benchmark mode timing - header
+ */
+
+/*
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+#ifndef VICE_BENCH_H
+#define VICE_BENCH_H
+
+#include "types.h"
+
+/** \brief  Subsystems whose host time is accounted separately
+ *
+ * Whatever is not spent in one of these is reported as "cpu".
+ */
+typedef enum bench_section_e {
+    BENCH_SECTION_VIDEO = 0,    /**< raster line rendering */
+    BENCH_SECTION_SOUND,        /**< sound chip sample generation */
+    BENCH_SECTION_DRIVE,        /**< true drive emulation CPUs */
+    BENCH_SECTION_VSYNC,        /**< end of frame machine hooks */
+
+    BENCH_SECTION_COUNT
+} bench_section_t;
+
+typedef void (*bench_report_t)(void);
+
+extern int bench_enabled;
+
+/* opcodes dispatched by the main CPU, the 6502 drive CPUs and the Z80 of
+   x128 and the CP/M cartridge, see -benchcpu */
+#define BENCH_DRIVES    4
+
+extern CLOCK bench_maincpu_instructions;
+extern CLOCK bench_drivecpu_instructions[BENCH_DRIVES];
+extern CLOCK bench_z80_instructions;
+extern CLOCK bench_z80_cycles;
+
+int bench_cmdline_options_init(void);
+
+void bench_vsync(void);
+void bench_enter(bench_section_t section);
+void bench_leave(void);
+void bench_finish(void);
+void bench_register_report(bench_report_t report);
+
+void bench_sid_samples(int chip, const int16_t *buf, int nr, int interleave);
+void bench_sid_fragment(int workers);
+
+int bench_frame_skip(void);
+void bench_video_line(uint8_t sprite_sprite, uint8_t sprite_background,
+                      int light_pen_x, int light_pen_y,
+                      const uint8_t *pixels, int size);
+
+/* keep the overhead to a single test when benchmark mode is off */
+#define BENCH_ENTER(section)        \
+    do {                            \
+        if (bench_enabled) {        \
+            bench_enter(section);   \
+        }                           \
+    } while (0)
+
+#define BENCH_LEAVE()               \
+    do {                            \
+        if (bench_enabled) {        \
+            bench_leave();          \
+        }                           \
+    } while (0)
+
+#endif
@@ -1525,6 +1525,21 @@ int machine_read_snapshot(const char *name, int event_mode)
     return err;
 }
 
+const char *machine_state_unsupported(void)
+{
+    return "the VDC and Z80 state cannot be saved";
+}
+
+int machine_state_write(struct snapshot_s *s)
+{
+    return -1;
+}
+
+int machine_state_read(struct snapshot_s *s)
+{
+    return -1;
+}
+
 /* ------------------------------------------------------------------------- */
 
 int machine_autodetect_psid(const char *name)
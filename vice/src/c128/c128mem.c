@@ -266,6 +266,28 @@ void c128_mem_set_mmu_zp_sp_shared(uint8_t val)
     c128_mem_mmu_zp_sp_shared = val;
 }
 
+/* returns the RAM a page of the given area currently maps to, to be indexed
+   with the full address, or NULL if the page is subject to the MMU page 0/1
+   relocation or the cartridge replaces RAM accesses */
+uint8_t *c128_mem_ram_page_base(unsigned int page, int area)
+{
+    unsigned int addr = page << 8;
+
+    if (page <= 1 || page == c128_mem_mmu_page_0 || page == c128_mem_mmu_page_1) {
+        return NULL;
+    }
+
+    switch (area) {
+        case C128_RAM_AREA_BANK:
+            return c128cartridge_ram_hooked() ? NULL : ram_bank;
+        case C128_RAM_AREA_BOTTOM_SHARED:
+            return (addr < bottom_shared_limit) ? mem_ram : ram_bank;
+        case C128_RAM_AREA_TOP_SHARED:
+            return (addr > top_shared_limit) ? mem_ram : ram_bank;
+    }
+    return NULL;
+}
+
 /* returns 0x100 if normal read needs to be done, or <0x100 if the read was remapped */
 static uint16_t z80_mem_mmu_wrap_read_zero(uint16_t address)
 {
@@ -115,6 +115,13 @@ void basic_hi_store(uint16_t addr, uint8_t value);
 extern uint8_t *ram_bank;
 extern uint8_t *dma_bank;
 
+/* RAM areas for c128_mem_ram_page_base() */
+#define C128_RAM_AREA_BANK          0   /* ram_read() / ram_store() */
+#define C128_RAM_AREA_BOTTOM_SHARED 1   /* lo_read() / lo_store() */
+#define C128_RAM_AREA_TOP_SHARED    2   /* top_shared_read() / top_shared_store() */
+
+uint8_t *c128_mem_ram_page_base(unsigned int page, int area);
+
 extern uint8_t mem_chargen_rom[C128_CHARGEN_ROM_SIZE];
 
 uint8_t c128_c64io_d000_read(uint16_t addr);
@@ -410,6 +410,7 @@ static void mmu_update_config(void)
     } else {
         mmu_switch_to_c128mode();
     }
+    z80mem_update_direct_tabs();
 }
 
 void mmu_set_config64(int config)
@@ -701,4 +702,5 @@ void mmu_reset(void)
     force_c64_mode = force_c64_mode_res;
     /* tell carts we are in c128 mode, or c64 if forced */
     c128cartridge_switch_mode(force_c64_mode);
+    z80mem_update_direct_tabs();
 }
@@ -853,6 +853,20 @@ uint8_t c128cartridge_ram_read(uint16_t addr, uint8_t *value)
     return ret;
 }
 
+/* returns 1 if the cartridge replaces ram reads/stores, so they can not be done directly */
+int c128cartridge_ram_hooked(void)
+{
+    int type = cartridge_get_id(0);
+
+    switch(type) {
+        case CARTRIDGE_LT_KERNAL:
+            return 1;
+        default:
+            break;
+    }
+    return 0;
+}
+
 /* kernal replacement store at the cartridge port */
 uint8_t c128cartridge_ram_store(uint16_t addr, uint8_t value)
 {
@@ -30,6 +30,8 @@
 
 #include "6510core.h"
 #include "alarm.h"
+#include "archdep.h"
+#include "bench.h"
 #include "daa.h"
 #include "debug.h"
 #include "interrupt.h"
@@ -37,6 +39,7 @@
 #include "maincpu.h"
 #include "monitor.h"
 #include "types.h"
+#include "viciitypes.h"
 #include "z80.h"
 #include "z80mem.h"
 #include "z80regs.h"
@@ -85,9 +88,33 @@ inline static int z80mem_read_limit(int addr)
         z80_bank_limit = z80mem_read_limit(z80_reg_pc); \
     } while (0)
 
-#define LOAD(addr) ((uint32_t)(*_z80mem_read_tab_ptr[(addr) >> 8])((uint16_t)(addr)))
+/* Plain RAM pages are accessed through the direct tables of z80mem.c,
+   updating the VIC-II bus value like ram_read()/ram_store() do.  */
+inline static uint8_t z80_mem_read(uint32_t addr)
+{
+    uint8_t *p = z80mem_read_direct_tab[addr >> 8];
 
-#define STORE(addr, value) (*_z80mem_write_tab_ptr[(addr) >> 8])((uint16_t)(addr), (uint8_t)(value))
+    if (p != NULL) {
+        return vicii.last_cpu_val = p[addr];
+    }
+    return (*_z80mem_read_tab_ptr[addr >> 8])((uint16_t)addr);
+}
+
+inline static void z80_mem_store(uint32_t addr, uint8_t value)
+{
+    uint8_t *p = z80mem_write_direct_tab[addr >> 8];
+
+    if (p != NULL) {
+        vicii.last_cpu_val = value;
+        p[addr] = value;
+    } else {
+        (*_z80mem_write_tab_ptr[addr >> 8])((uint16_t)addr, value);
+    }
+}
+
+#define LOAD(addr) ((uint32_t)z80_mem_read((uint32_t)(addr)))
+
+#define STORE(addr, value) z80_mem_store((uint32_t)(addr), (uint8_t)(value))
 
 /* undefine IN and OUT first for platforms that have them already defined as something else */
 #undef IN
@@ -97,30 +124,16 @@ inline static int z80mem_read_limit(int addr)
 #define OUT(addr, value) (io_write_tab[(addr) >> 8])((uint16_t)(addr), (uint8_t)(value))
 
 #ifdef Z80_4MHZ
-static int z80_half_cycle = 0;
-
+/* Every started pair of Z80 cycles takes one main CPU cycle, an odd Z80
+   cycle is never carried over to the next addition.  */
 inline static CLOCK z80cpu_clock_add(CLOCK clock, int amount)
 {
-    CLOCK tmp_clock = clock;
-    int left = amount;
-
-    while (left > 0) {
-        if (left >= (2 - z80_half_cycle)) {
-            left -= (2 - z80_half_cycle);
-            z80_half_cycle = 0;
-            tmp_clock++;
-        } else {
-            z80_half_cycle += left;
-        }
-    }
-
-    return tmp_clock;
+    return clock + ((amount + 1) >> 1);
 }
 
 void z80_clock_stretch(void)
 {
     CLK++;
-    z80_half_cycle = 0;
 }
 #endif
 
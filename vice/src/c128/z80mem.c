@@ -77,6 +77,11 @@ static int mem_read_limit_tab[NUM_CONFIGS][0x101];
 store_func_ptr_t io_write_tab[0x101];
 read_func_ptr_t io_read_tab[0x101];
 
+/* Pages of the current config that are plain RAM, indexed with the full
+   address, NULL if the access has to go through the tables above.  */
+uint8_t *z80mem_read_direct_tab[0x101];
+uint8_t *z80mem_write_direct_tab[0x101];
+
 /* ------------------------------------------------------------------------- */
 
 /* Generic memory access.  */
@@ -1049,6 +1054,70 @@ void z80mem_initialize(void)
     io_write_tab[0xdf] = z80_c64io_df00_store;
 }
 
+/* Returns the RAM area the read handler of a page currently accesses, -1 if
+   it is not plain RAM.  The ROM area handlers depend on the MMU CR.  */
+static int z80mem_read_area(read_func_ptr_t read_func)
+{
+    if (read_func == ram_read
+        || (read_func == z80mem_lo_rom_area_read && (mmu[0] & 2))
+        || (read_func == z80mem_mid_rom_area_read && ((mmu[0] & 0xc) >> 2) == Z80_C128_RAM)) {
+        return C128_RAM_AREA_BANK;
+    }
+    if (read_func == lo_read) {
+        return C128_RAM_AREA_BOTTOM_SHARED;
+    }
+    if (read_func == top_shared_read
+        || ((read_func == z80mem_editor_rom_area_read
+            || read_func == z80mem_chargen_rom_area_read
+            || read_func == z80mem_hi_rom_area_read) && ((mmu[0] & 0x30) >> 4) == Z80_C128_RAM)) {
+        return C128_RAM_AREA_TOP_SHARED;
+    }
+    return -1;
+}
+
+/* Same for the store handler, note the editor and chargen area stores
+   check the mid area bits like their handlers do.  */
+static int z80mem_write_area(store_func_ptr_t store_func)
+{
+    if (store_func == ram_store
+        || (store_func == z80mem_lo_rom_area_store && (mmu[0] & 2))
+        || (store_func == z80mem_mid_rom_area_store && ((mmu[0] & 0xc) >> 2) == Z80_C128_RAM)) {
+        return C128_RAM_AREA_BANK;
+    }
+    if (store_func == lo_store) {
+        return C128_RAM_AREA_BOTTOM_SHARED;
+    }
+    if (store_func == top_shared_store
+        || ((store_func == z80mem_editor_rom_area_store
+            || store_func == z80mem_chargen_rom_area_store) && ((mmu[0] & 0xc) >> 2) == Z80_C128_RAM)
+        || (store_func == z80mem_hi_rom_area_store && ((mmu[0] & 0x30) >> 4) == Z80_C128_RAM)) {
+        return C128_RAM_AREA_TOP_SHARED;
+    }
+    return -1;
+}
+
+/* Rebuild the direct access tables, must be called whenever the config or
+   the MMU registers change.  */
+void z80mem_update_direct_tabs(void)
+{
+    int i, area;
+
+    if (_z80mem_read_tab_ptr == NULL) {
+        /* MMU reset before z80mem_initialize() */
+        return;
+    }
+
+    for (i = 0; i <= 0xff; i++) {
+        area = z80mem_read_area(_z80mem_read_tab_ptr[i]);
+        z80mem_read_direct_tab[i] = (area < 0) ? NULL : c128_mem_ram_page_base(i, area);
+        area = z80mem_write_area(_z80mem_write_tab_ptr[i]);
+        z80mem_write_direct_tab[i] = (area < 0) ? NULL : c128_mem_ram_page_base(i, area);
+    }
+    /* page $100 wraps around to the zero page */
+    z80mem_read_direct_tab[0x100] = NULL;
+    z80mem_write_direct_tab[0x100] = NULL;
+}
+
 static int c64mode_bit = 0;
 
 void z80mem_update_config(int config)
@@ -1074,6 +1143,7 @@ void z80mem_update_config(int config)
         c64mode_bit = 0;
     }
 
+    z80mem_update_direct_tabs();
     z80_resync_limits();
 }
 
@@ -59,4 +59,10 @@ uint8_t z80mem_peek_with_config(int config, uint16_t addr, void *context);
 extern store_func_ptr_t io_write_tab[];
 extern read_func_ptr_t io_read_tab[];
 
+/* Direct pointers for plain RAM pages of the current config.  */
+extern uint8_t *z80mem_read_direct_tab[];
+extern uint8_t *z80mem_write_direct_tab[];
+
+void z80mem_update_direct_tabs(void);
+
 #endif
@@ -37,6 +37,8 @@
 #include "cia.h"
 #include "drive-snapshot.h"
 #include "drive.h"
+#include "export.h"
+#include "resources.h"
 #include "serial.h"
 #include "joyport.h"
 #include "joystick.h"
@@ -152,3 +154,65 @@ fail:
 
     return -1;
 }
+
+/* ------------------------------------------------------------------------- */
+
+/* The in-memory machine state used by run-ahead only holds the chips; the
+   drives, tape and port devices are left alone.  Run-ahead checks that none
+   of them is in use before relying on it.  */
+
+const char *c64_state_unsupported(void)
+{
+    int memory_hack = MEMORY_HACK_NONE;
+
+    if (export_query_list(NULL) != NULL) {
+        return "a cartridge is attached";
+    }
+    resources_get_int("MemoryHack", &memory_hack);
+    if (memory_hack != MEMORY_HACK_NONE) {
+        return "a memory expansion hack is enabled";
+    }
+    return sid_state_unsupported();
+}
+
+int c64_state_write(snapshot_t *s)
+{
+    sound_snapshot_prepare();
+
+    if (maincpu_snapshot_write_module(s) < 0
+        || c64_state_write_module(s) < 0
+        || ciacore_snapshot_write_module(machine_context.cia1, s) < 0
+        || ciacore_snapshot_write_module(machine_context.cia2, s) < 0
+        || sid_state_write_module(s) < 0
+        || vicii_snapshot_write_module(s) < 0
+        || c64_glue_snapshot_write_module(s) < 0
+        || keyboard_snapshot_write_module(s) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int c64_state_read(snapshot_t *s)
+{
+    /* this fails without changing anything if the SID setup has changed */
+    if (sid_state_read_module(s) < 0) {
+        return -1;
+    }
+
+    vicii_snapshot_prepare();
+
+    if (maincpu_snapshot_read_module(s) < 0
+        || c64_state_read_module(s) < 0
+        || ciacore_snapshot_read_module(machine_context.cia1, s) < 0
+        || ciacore_snapshot_read_module(machine_context.cia2, s) < 0
+        || vicii_snapshot_read_module(s) < 0
+        || c64_glue_snapshot_read_module(s) < 0
+        || keyboard_snapshot_read_module(s) < 0) {
+        machine_trigger_reset(MACHINE_RESET_MODE_RESET_CPU);
+        return -1;
+    }
+
+    sound_snapshot_finish();
+
+    return 0;
+}
@@ -30,4 +30,9 @@
 int c64_snapshot_write(const char *name, int save_roms, int save_disks, int event_mode);
 int c64_snapshot_read(const char *name, int event_mode);
 
+struct snapshot_s;
+const char *c64_state_unsupported(void);
+int c64_state_write(struct snapshot_s *s);
+int c64_state_read(struct snapshot_s *s);
+
 #endif
@@ -1480,6 +1480,21 @@ int machine_read_snapshot(const char *name, int event_mode)
     return err;
 }
 
+const char *machine_state_unsupported(void)
+{
+    return c64_state_unsupported();
+}
+
+int machine_state_write(snapshot_t *s)
+{
+    return c64_state_write(s);
+}
+
+int machine_state_read(snapshot_t *s)
+{
+    return c64_state_read(s);
+}
+
 /* ------------------------------------------------------------------------- */
 /* FIXME: those two shouldnt be here anymore */
 int machine_autodetect_psid(const char *name)
@@ -78,6 +78,83 @@ static io_source_list_t c64io_dd00_head = { NULL, NULL, NULL };
 static io_source_list_t c64io_de00_head = { NULL, NULL, NULL };
 static io_source_list_t c64io_df00_head = { NULL, NULL, NULL };
 
+/* Per-address resolution of the I/O source lists, so the common case of no
+   or only one device at an address does not need to walk the list.  Each
+   entry holds the only device that can respond at that address (offset into
+   the page), NULL if there is none, or IO_SOURCE_MULTIPLE when more than one
+   device is mapped there and the list must be walked to resolve collisions.
+
+   Only the address ranges and handlers are taken into account, since the
+   io_source_valid flag is updated by the devices on every read. The maps are
+   rebuilt whenever a device is registered or unregistered, so devices that
+   change their address range must re-register (which they already do).  */
+typedef struct io_source_map_s {
+    io_source_t *read[0x100];
+    io_source_t *store[0x100];
+} io_source_map_t;
+
+static io_source_t io_source_multiple;
+#define IO_SOURCE_MULTIPLE (&io_source_multiple)
+
+static io_source_map_t c64io_d000_map;
+static io_source_map_t c64io_d100_map;
+static io_source_map_t c64io_d200_map;
+static io_source_map_t c64io_d300_map;
+static io_source_map_t c64io_d400_map;
+static io_source_map_t c64io_d500_map;
+static io_source_map_t c64io_d600_map;
+static io_source_map_t c64io_d700_map;
+static io_source_map_t c64io_dd00_map;
+static io_source_map_t c64io_de00_map;
+static io_source_map_t c64io_df00_map;
+
+static void io_source_map_build(io_source_map_t *map, io_source_list_t *list)
+{
+    io_source_list_t *current = list->next;
+    io_source_t *device;
+    unsigned int start, end, i;
+
+    memset(map, 0, sizeof(io_source_map_t));
+
+    while (current) {
+        device = current->device;
+        /* only the page the device was registered for is looked up here */
+        start = device->start_address & 0xff;
+        end = device->end_address;
+        if (end > (unsigned int)(device->start_address | 0xff)) {
+            end = device->start_address | 0xff;
+        }
+        end &= 0xff;
+        if (device->end_address >= device->start_address) {
+            for (i = start; i <= end; i++) {
+                if (device->read != NULL) {
+                    map->read[i] = (map->read[i] == NULL) ? device : IO_SOURCE_MULTIPLE;
+                }
+                if (device->store != NULL) {
+                    map->store[i] = (map->store[i] == NULL) ? device : IO_SOURCE_MULTIPLE;
+                }
+            }
+        }
+        current = current->next;
+    }
+}
+
+/* called by io_source_register(), io_source_unregister() */
+static void io_source_maps_update(void)
+{
+    io_source_map_build(&c64io_d000_map, &c64io_d000_head);
+    io_source_map_build(&c64io_d100_map, &c64io_d100_head);
+    io_source_map_build(&c64io_d200_map, &c64io_d200_head);
+    io_source_map_build(&c64io_d300_map, &c64io_d300_head);
+    io_source_map_build(&c64io_d400_map, &c64io_d400_head);
+    io_source_map_build(&c64io_d500_map, &c64io_d500_head);
+    io_source_map_build(&c64io_d600_map, &c64io_d600_head);
+    io_source_map_build(&c64io_d700_map, &c64io_d700_head);
+    io_source_map_build(&c64io_dd00_map, &c64io_dd00_head);
+    io_source_map_build(&c64io_de00_map, &c64io_de00_head);
+    io_source_map_build(&c64io_df00_map, &c64io_df00_head);
+}
+
 static void io_source_detach(io_source_detach_t *source)
 {
     switch (source->det_id) {
@@ -292,9 +369,10 @@ static void io_source_log_collisions(uint16_t addr, int amount, io_source_list_t
     }
 }
 
-static inline uint8_t io_read(io_source_list_t *list, uint16_t addr)
+static inline uint8_t io_read(io_source_list_t *list, io_source_map_t *map, uint16_t addr)
 {
     io_source_list_t *current = list->next;
+    io_source_t *device = map->read[addr & 0xff];
     int io_source_counter = 0;
     int io_source_valid = 0;
     uint8_t realval = 0;
@@ -304,6 +382,17 @@ static inline uint8_t io_read(io_source_list_t *list, uint16_t addr)
 
     vicii_handle_pending_alarms_external(0);
 
+    /* no or only one device mapped here, no collision handling needed */
+    if (device != IO_SOURCE_MULTIPLE) {
+        if (device != NULL) {
+            retval = device->read((uint16_t)(addr & device->address_mask));
+            if (device->io_source_valid) {
+                return retval;
+            }
+        }
+        return vicii_read_phi1();
+    }
+
     while (current) {
         if (current->device->read != NULL) {
             if ((addr >= current->device->start_address) && (addr <= current->device->end_address)) {
@@ -390,15 +479,24 @@ static inline uint8_t io_peek(io_source_list_t *list, uint16_t addr)
     return vicii_read_phi1();
 }
 
-static inline void io_store(io_source_list_t *list, uint16_t addr, uint8_t value)
+static inline void io_store(io_source_list_t *list, io_source_map_t *map, uint16_t addr, uint8_t value)
 {
     int writes = 0;
     uint16_t addy = 0xffff;
     io_source_list_t *current = list->next;
+    io_source_t *device = map->store[addr & 0xff];
     void (*store)(uint16_t address, uint8_t data) = NULL;
 
     vicii_handle_pending_alarms_external_write();
 
+    /* no or only one device mapped here, write directly */
+    if (device != IO_SOURCE_MULTIPLE) {
+        if (device != NULL) {
+            device->store((uint16_t)(addr & device->address_mask), value);
+        }
+        return;
+    }
+
     while (current) {
         if (current->device->store != NULL) {
             if (addr >= current->device->start_address && addr <= current->device->end_address) {
@@ -482,6 +580,8 @@ io_source_list_t *io_source_register(io_source_t *device)
     retval->next = NULL;
     retval->device->order = order++;
 
+    io_source_maps_update();
+
     return retval;
 }
 
@@ -506,6 +606,8 @@ void io_source_unregister(io_source_list_t *device)
     }
 
     lib_free(device);
+
+    io_source_maps_update();
 }
 
 void cartio_shutdown(void)
@@ -589,7 +691,7 @@ void cartio_set_highest_order(unsigned int nr)
 uint8_t c64io_d000_read(uint16_t addr)
 {
     DBGRW(("IO: io-d000 r %04x\n", addr));
-    return io_read(&c64io_d000_head, addr);
+    return io_read(&c64io_d000_head, &c64io_d000_map, addr);
 }
 
 uint8_t c64io_d000_peek(uint16_t addr)
@@ -601,13 +703,13 @@ uint8_t c64io_d000_peek(uint16_t addr)
 void c64io_d000_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d000 w %04x %02x\n", addr, value));
-    io_store(&c64io_d000_head, addr, value);
+    io_store(&c64io_d000_head, &c64io_d000_map, addr, value);
 }
 
 uint8_t c64io_d100_read(uint16_t addr)
 {
     DBGRW(("IO: io-d100 r %04x\n", addr));
-    return io_read(&c64io_d100_head, addr);
+    return io_read(&c64io_d100_head, &c64io_d100_map, addr);
 }
 
 uint8_t c64io_d100_peek(uint16_t addr)
@@ -619,13 +721,13 @@ uint8_t c64io_d100_peek(uint16_t addr)
 void c64io_d100_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d100 w %04x %02x\n", addr, value));
-    io_store(&c64io_d100_head, addr, value);
+    io_store(&c64io_d100_head, &c64io_d100_map, addr, value);
 }
 
 uint8_t c64io_d200_read(uint16_t addr)
 {
     DBGRW(("IO: io-d200 r %04x\n", addr));
-    return io_read(&c64io_d200_head, addr);
+    return io_read(&c64io_d200_head, &c64io_d200_map, addr);
 }
 
 uint8_t c64io_d200_peek(uint16_t addr)
@@ -637,13 +739,13 @@ uint8_t c64io_d200_peek(uint16_t addr)
 void c64io_d200_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d200 w %04x %02x\n", addr, value));
-    io_store(&c64io_d200_head, addr, value);
+    io_store(&c64io_d200_head, &c64io_d200_map, addr, value);
 }
 
 uint8_t c64io_d300_read(uint16_t addr)
 {
     DBGRW(("IO: io-d300 r %04x\n", addr));
-    return io_read(&c64io_d300_head, addr);
+    return io_read(&c64io_d300_head, &c64io_d300_map, addr);
 }
 
 uint8_t c64io_d300_peek(uint16_t addr)
@@ -655,13 +757,13 @@ uint8_t c64io_d300_peek(uint16_t addr)
 void c64io_d300_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d300 w %04x %02x\n", addr, value));
-    io_store(&c64io_d300_head, addr, value);
+    io_store(&c64io_d300_head, &c64io_d300_map, addr, value);
 }
 
 uint8_t c64io_d400_read(uint16_t addr)
 {
     DBGRW(("IO: io-d400 r %04x\n", addr));
-    return io_read(&c64io_d400_head, addr);
+    return io_read(&c64io_d400_head, &c64io_d400_map, addr);
 }
 
 uint8_t c64io_d400_peek(uint16_t addr)
@@ -673,13 +775,13 @@ uint8_t c64io_d400_peek(uint16_t addr)
 void c64io_d400_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d400 w %04x %02x\n", addr, value));
-    io_store(&c64io_d400_head, addr, value);
+    io_store(&c64io_d400_head, &c64io_d400_map, addr, value);
 }
 
 uint8_t c64io_d500_read(uint16_t addr)
 {
     DBGRW(("IO: io-d500 r %04x\n", addr));
-    return io_read(&c64io_d500_head, addr);
+    return io_read(&c64io_d500_head, &c64io_d500_map, addr);
 }
 
 uint8_t c64io_d500_peek(uint16_t addr)
@@ -691,13 +793,13 @@ uint8_t c64io_d500_peek(uint16_t addr)
 void c64io_d500_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d500 w %04x %02x\n", addr, value));
-    io_store(&c64io_d500_head, addr, value);
+    io_store(&c64io_d500_head, &c64io_d500_map, addr, value);
 }
 
 uint8_t c64io_d600_read(uint16_t addr)
 {
     DBGRW(("IO: io-d600 r %04x\n", addr));
-    return io_read(&c64io_d600_head, addr);
+    return io_read(&c64io_d600_head, &c64io_d600_map, addr);
 }
 
 uint8_t c64io_d600_peek(uint16_t addr)
@@ -709,13 +811,13 @@ uint8_t c64io_d600_peek(uint16_t addr)
 void c64io_d600_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d600 w %04x %02x\n", addr, value));
-    io_store(&c64io_d600_head, addr, value);
+    io_store(&c64io_d600_head, &c64io_d600_map, addr, value);
 }
 
 uint8_t c64io_d700_read(uint16_t addr)
 {
     DBGRW(("IO: io-d700 r %04x\n", addr));
-    return io_read(&c64io_d700_head, addr);
+    return io_read(&c64io_d700_head, &c64io_d700_map, addr);
 }
 
 uint8_t c64io_d700_peek(uint16_t addr)
@@ -727,13 +829,13 @@ uint8_t c64io_d700_peek(uint16_t addr)
 void c64io_d700_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-d700 w %04x %02x\n", addr, value));
-    io_store(&c64io_d700_head, addr, value);
+    io_store(&c64io_d700_head, &c64io_d700_map, addr, value);
 }
 
 uint8_t c64io_dd00_read(uint16_t addr)
 {
     DBGRW(("IO: io-dd00 r %04x\n", addr));
-    return io_read(&c64io_dd00_head, addr);
+    return io_read(&c64io_dd00_head, &c64io_dd00_map, addr);
 }
 
 uint8_t c64io_dd00_peek(uint16_t addr)
@@ -745,13 +847,13 @@ uint8_t c64io_dd00_peek(uint16_t addr)
 void c64io_dd00_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-dd00 w %04x %02x\n", addr, value));
-    io_store(&c64io_dd00_head, addr, value);
+    io_store(&c64io_dd00_head, &c64io_dd00_map, addr, value);
 }
 
 uint8_t c64io_de00_read(uint16_t addr)
 {
     DBGRW(("IO: io-de00 r %04x\n", addr));
-    return io_read(&c64io_de00_head, addr);
+    return io_read(&c64io_de00_head, &c64io_de00_map, addr);
 }
 
 uint8_t c64io_de00_peek(uint16_t addr)
@@ -763,13 +865,13 @@ uint8_t c64io_de00_peek(uint16_t addr)
 void c64io_de00_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-de00 w %04x %02x\n", addr, value));
-    io_store(&c64io_de00_head, addr, value);
+    io_store(&c64io_de00_head, &c64io_de00_map, addr, value);
 }
 
 uint8_t c64io_df00_read(uint16_t addr)
 {
     DBGRW(("IO: io-df00 r %04x\n", addr));
-    return io_read(&c64io_df00_head, addr);
+    return io_read(&c64io_df00_head, &c64io_df00_map, addr);
 }
 
 uint8_t c64io_df00_peek(uint16_t addr)
@@ -781,7 +883,7 @@ uint8_t c64io_df00_peek(uint16_t addr)
 void c64io_df00_store(uint16_t addr, uint8_t value)
 {
     DBGRW(("IO: io-df00 w %04x %02x\n", addr, value));
-    io_store(&c64io_df00_head, addr, value);
+    io_store(&c64io_df00_head, &c64io_df00_map, addr, value);
 }
 
 /* ---------------------------------------------------------------------------------------------------------- */
@@ -125,6 +125,11 @@ static int tape_motor_in = 0;
 */
 static int watchpoints_active = 0;
 
+/* Memory config and VIC bank the watch tables were built for, -1 if they must
+   be built again.  */
+static int watch_tabs_config = -1;
+static int watch_tabs_vbank = -1;
+
 /* ------------------------------------------------------------------------- */
 
 static uint8_t zero_read_watch(uint16_t addr)
@@ -153,10 +158,40 @@ static void store_watch(uint16_t addr, uint8_t value)
     mem_write_tab[vbank][mem_config][addr >> 8](addr, value);
 }
 
+/* Only route the pages that actually contain watchpoints through the watch
+   handlers, all other pages use the regular handlers of the current config.
+   The tables are only built again when the config or the checkpoints
+   change, not on every write to $00/$01.
+   called by mem_update_tab_ptrs() */
+static void mem_update_watch_tabs(void)
+{
+    int i;
+
+    if (mem_config == watch_tabs_config && vbank == watch_tabs_vbank) {
+        return;
+    }
+
+    for (i = 0; i <= 0x100; i++) {
+        if (monitor_watch_page_load_active(e_comp_space, (unsigned int)(i & 0xff))) {
+            mem_read_tab_watch[i] = (i == 0) ? zero_read_watch : read_watch;
+        } else {
+            mem_read_tab_watch[i] = mem_read_tab[mem_config][i];
+        }
+        if (monitor_watch_page_store_active(e_comp_space, (unsigned int)(i & 0xff))) {
+            mem_write_tab_watch[i] = (i == 0) ? zero_store_watch : store_watch;
+        } else {
+            mem_write_tab_watch[i] = mem_write_tab[vbank][mem_config][i];
+        }
+    }
+    watch_tabs_config = mem_config;
+    watch_tabs_vbank = vbank;
+}
+
 /* called by mem_pla_config_changed(), mem_toggle_watchpoints() */
 static void mem_update_tab_ptrs(int flag)
 {
     if (flag) {
+        mem_update_watch_tabs();
         _mem_read_tab_ptr = mem_read_tab_watch;
         _mem_write_tab_ptr = mem_write_tab_watch;
         if (flag > 1) {
@@ -178,6 +213,8 @@ static void mem_update_tab_ptrs(int flag)
 
 void mem_toggle_watchpoints(int flag, void *context)
 {
+    /* the checkpoints changed */
+    watch_tabs_config = -1;
     mem_update_tab_ptrs(flag);
     watchpoints_active = flag;
 }
@@ -694,6 +731,7 @@ void mem_set_write_hook(int config, int page, store_func_t *f)
 {
     int i;
 
+    watch_tabs_config = -1;
     for (i = 0; i < NUM_VBANKS; i++) {
         mem_write_tab[i][config][page] = f;
     }
@@ -701,6 +739,7 @@ void mem_set_write_hook(int config, int page, store_func_t *f)
 
 void mem_read_tab_set(unsigned int base, unsigned int index, read_func_ptr_t read_func)
 {
+    watch_tabs_config = -1;
     mem_read_tab[base][index] = read_func;
 }
 
@@ -719,6 +758,7 @@ void mem_initialize_memory(void)
     int i, j, k;
     int board;
 
+    watch_tabs_config = -1;
     mem_chargen_rom_ptr = mem_chargen_rom;
     mem_color_ram_cpu = mem_color_ram;
     mem_color_ram_vicii = mem_color_ram;
@@ -876,9 +916,12 @@ void mem_set_vbank(int new_vbank)
 {
     vbank = new_vbank;
 
-    /* Do not override watchpoints on vbank switches.  */
+    /* Do not override watchpoints on vbank switches, but update the
+       handlers of the pages without watchpoints.  */
     if (_mem_write_tab_ptr != mem_write_tab_watch) {
         _mem_write_tab_ptr = mem_write_tab[new_vbank][mem_config];
+    } else {
+        mem_update_tab_ptrs(watchpoints_active);
     }
 
     vicii_set_vbank(new_vbank);
@@ -201,7 +201,7 @@ static const char snap_mem_module_name[] = "C64MEM";
 #define SNAP_MAJOR 0
 #define SNAP_MINOR 1
 
-int c64_snapshot_write_module(snapshot_t *s, int save_roms)
+static int c64_snapshot_write_mem_module(snapshot_t *s)
 {
     snapshot_module_t *m;
 
@@ -232,7 +232,12 @@ int c64_snapshot_write_module(snapshot_t *s, int save_roms)
         return -1;
     }
 
-    if (snapshot_module_close(m) < 0) {
+    return snapshot_module_close(m);
+}
+
+int c64_snapshot_write_module(snapshot_t *s, int save_roms)
+{
+    if (c64_snapshot_write_mem_module(s) < 0) {
         return -1;
     }
 
@@ -243,7 +248,7 @@ int c64_snapshot_write_module(snapshot_t *s, int save_roms)
     return cartridge_snapshot_write_modules(s);
 }
 
-int c64_snapshot_read_module(snapshot_t *s)
+static int c64_snapshot_read_mem_module(snapshot_t *s)
 {
     uint8_t major_version, minor_version;
     snapshot_module_t *m;
@@ -299,7 +304,16 @@ int c64_snapshot_read_module(snapshot_t *s)
 
     mem_pla_config_changed();
 
-    if (snapshot_module_close(m) < 0) {
+    return snapshot_module_close(m);
+
+fail:
+    snapshot_module_close(m);
+    return -1;
+}
+
+int c64_snapshot_read_module(snapshot_t *s)
+{
+    if (c64_snapshot_read_mem_module(s) < 0) {
         return -1;
     }
 
@@ -312,8 +326,17 @@ int c64_snapshot_read_module(snapshot_t *s)
     }
 
     return 0;
+}
 
-fail:
-    snapshot_module_close(m);
-    return -1;
+/* The machine state for run-ahead only holds the RAM and the processor
+   port, the ROMs do not change and cartridges are not supported, see
+   c64_state_unsupported().  */
+int c64_state_write_module(snapshot_t *s)
+{
+    return c64_snapshot_write_mem_module(s);
+}
+
+int c64_state_read_module(snapshot_t *s)
+{
+    return c64_snapshot_read_mem_module(s);
 }
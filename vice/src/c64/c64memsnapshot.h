@@ -32,4 +32,7 @@ struct snapshot_s;
 int c64_snapshot_write_module(struct snapshot_s *s, int save_roms);
 int c64_snapshot_read_module(struct snapshot_s *s);
 
+int c64_state_write_module(struct snapshot_s *s);
+int c64_state_read_module(struct snapshot_s *s);
+
 #endif
@@ -54,6 +54,7 @@
 #include "mem.h"
 #include "monitor.h"
 #include "resources.h"
+#include "runahead.h"
 #include "util.h"
 
 #define CARTRIDGE_INCLUDE_PRIVATE_API
@@ -1151,6 +1152,9 @@ exiterror:
 
 void cart_power_off(void)
 {
+    /* the machine state kept by run-ahead does not cover cartridges */
+    runahead_cancel();
+
     if (c64cartridge_reset) {
         /* "Turn off machine before removing cartridge" */
         machine_trigger_reset(MACHINE_RESET_MODE_POWER_CYCLE);
@@ -33,6 +33,8 @@
 
 #include "6510core.h"
 #include "alarm.h"
+#include "archdep.h"
+#include "bench.h"
 #include "c64cia.h"
 #include "c64mem.h"
 #include "cartio.h"
@@ -0,0 +1,270 @@
+/** \file   vsid-bench.c
+ * \brief   VSID benchmark mode: HVSC lookups
+ *
+ * With `-benchhvsc <tunes>` vsid writes a synthetic HVSC database when the
+ * `-limitcycles` limit of benchmark mode (see bench.c) is reached and times
+ * song length and STIL lookups in it.  This lives with vsid because it is
+ * the only emulator that looks up tunes in the HVSC, and the only one that
+ * links the MD5 code the song length database needs.
+ */
+
+/*
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+#include "vice.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "archdep.h"
+#include "bench.h"
+#include "cmdline.h"
+#include "hvsc.h"
+#include "lib.h"
+#include "types.h"
+#include "util.h"
+
+#include "vsid-bench.h"
+
+
+/* number of tunes in the synthetic HVSC database */
+static unsigned int hvsc_tunes = 0;
+
+static double hvsc_ticks_to_seconds(uint64_t ticks)
+{
+    return (double)ticks / tick_per_second();
+}
+
+/* one in this many tunes of the synthetic HVSC has a STIL entry */
+#define BENCH_HVSC_STIL_EVERY   3
+
+/* number of lookups timed with a freshly built and with a cached index */
+#define BENCH_HVSC_LOOKUPS      2000
+
+/** \brief  Make up the MD5 digest of tune \a tune of the synthetic HVSC
+ *
+ * \param[in]   tune    tune number
+ * \param[out]  digest  32 hex digits and a terminating nul
+ */
+static void bench_hvsc_digest(unsigned int tune, char *digest)
+{
+    uint32_t x = tune * 2654435761U;   /* unique for every tune */
+
+    sprintf(digest, "%08x%08x%08x%08x",
+            (unsigned int)x,
+            (unsigned int)(x ^ 0x5bd1e995U) * 1540483477U,
+            (unsigned int)(x + 0x9e3779b9U) * 2246822519U,
+            (unsigned int)(x ^ tune) * 3266489917U);
+}
+
+/** \brief  Write the Songlengths.md5 and STIL.txt of a synthetic HVSC
+ *
+ * \param[in]   docs    DOCUMENTS directory
+ * \param[in]   tunes   number of tunes
+ *
+ * \return  0 on success, -1 on failure
+ */
+static int bench_hvsc_write(const char *docs, unsigned int tunes)
+{
+    char digest[33];
+    char *path;
+    FILE *sldb, *stil;
+    unsigned int tune;
+    int result = 0;
+
+    path = util_join_paths(docs, "Songlengths.md5", NULL);
+    sldb = fopen(path, "w");
+    lib_free(path);
+    path = util_join_paths(docs, "STIL.txt", NULL);
+    stil = fopen(path, "w");
+    lib_free(path);
+    if (sldb == NULL || stil == NULL) {
+        result = -1;
+    } else {
+        fprintf(sldb, "[Database]\n");
+        fprintf(stil, "### STIL\n\n");
+        for (tune = 0; tune < tunes; tune++) {
+            bench_hvsc_digest(tune, digest);
+            fprintf(sldb, "; /MUSICIANS/B/Bench_%u/Tune_%u.sid\n%s=%u:%02u 0:30\n",
+                    tune / 100, tune, digest, (tune % 600) / 60, tune % 60);
+            if (tune % BENCH_HVSC_STIL_EVERY == 0) {
+                fprintf(stil, "/MUSICIANS/B/Bench_%u/Tune_%u.sid\n"
+                        "   TITLE: Tune %u\n  ARTIST: Bench\n COMMENT: synthetic entry\n\n",
+                        tune / 100, tune, tune);
+            }
+        }
+    }
+    if (sldb != NULL && fclose(sldb) != 0) {
+        result = -1;
+    }
+    if (stil != NULL && fclose(stil) != 0) {
+        result = -1;
+    }
+    return result;
+}
+
+/** \brief  Look up tunes of the synthetic HVSC the way vsid does
+ *
+ * Gets the song lengths of each tune and, for the tunes that have one, reads
+ * its STIL entry.
+ *
+ * \param[in]       tunes   number of tunes in the database
+ * \param[in]       first   first lookup
+ * \param[in]       count   number of lookups
+ * \param[in,out]   errors  incremented for each wrong or missing result
+ */
+static void bench_hvsc_lookup(unsigned int tunes, unsigned int first,
+                              unsigned int count, unsigned long *errors)
+{
+    char digest[33];
+    hvsc_stil_t stil;
+    long *lengths;
+    unsigned int i, tune;
+
+    for (i = first; i < first + count; i++) {
+        tune = (unsigned int)(((uint64_t)i * 7919) % tunes);
+        bench_hvsc_digest(tune, digest);
+
+        if (hvsc_sldb_get_lengths_md5(digest, &lengths) != 2
+            || lengths[0] != (long)(tune % 600) * 1000) {
+            (*errors)++;
+        }
+        lib_free(lengths);
+
+        if (tune % BENCH_HVSC_STIL_EVERY == 0) {
+            if (!hvsc_stil_open_md5(digest, &stil)) {
+                (*errors)++;
+                continue;
+            }
+            if (!hvsc_stil_read_entry(&stil) || stil.entry_bufused != 3) {
+                (*errors)++;
+            }
+            hvsc_stil_close(&stil);
+        }
+    }
+}
+
+/** \brief  Time song length and STIL lookups in a synthetic HVSC
+ *
+ * Writes a Songlengths.md5 with \a tunes tunes and a STIL.txt with an entry
+ * for every third tune to a temporary directory, then times the lookups
+ * with the indexes built from the text files on first use and with the
+ * indexes loaded from the user cache dir, like on later runs of vsid.
+ *
+ * \param[in]   tunes   number of tunes
+ */
+static void bench_hvsc(unsigned int tunes)
+{
+    char *root, *docs;
+    char *path;
+    uint64_t build_ticks, load_ticks, lookup_ticks, cached_ticks;
+    unsigned long errors = 0;
+    tick_t mark;
+
+    /* archdep_tmpnam() creates a file, the database needs a directory */
+    root = archdep_tmpnam();
+    archdep_remove(root);
+    docs = util_join_paths(root, "DOCUMENTS", NULL);
+    if (archdep_mkdir(root, 0700) != 0 || archdep_mkdir(docs, 0700) != 0
+        || bench_hvsc_write(docs, tunes) != 0) {
+        printf("vice-bench: db=hvsc error=cannot-write-database\n");
+    } else {
+        /* the first lookup builds and saves both indexes */
+        hvsc_init(root);
+        mark = tick_now();
+        bench_hvsc_lookup(tunes, 0, 1, &errors);
+        build_ticks = tick_now_delta(mark);
+        mark = tick_now();
+        bench_hvsc_lookup(tunes, 1, BENCH_HVSC_LOOKUPS, &errors);
+        lookup_ticks = tick_now_delta(mark);
+        hvsc_exit();
+
+        /* a new session loads them from the cache */
+        hvsc_init(root);
+        mark = tick_now();
+        bench_hvsc_lookup(tunes, 0, 1, &errors);
+        load_ticks = tick_now_delta(mark);
+        mark = tick_now();
+        bench_hvsc_lookup(tunes, 1, BENCH_HVSC_LOOKUPS, &errors);
+        cached_ticks = tick_now_delta(mark);
+        hvsc_index_remove_cache();
+        hvsc_exit();
+
+        printf("vice-bench: db=hvsc tunes=%u stil_entries=%u lookups=%d"
+               " build_ms=%.1f lookup_us=%.1f load_ms=%.2f cached_lookup_us=%.1f errors=%lu\n",
+               tunes, (tunes + BENCH_HVSC_STIL_EVERY - 1) / BENCH_HVSC_STIL_EVERY,
+               BENCH_HVSC_LOOKUPS,
+               hvsc_ticks_to_seconds(build_ticks) * 1000.0,
+               hvsc_ticks_to_seconds(lookup_ticks) * 1000000.0 / BENCH_HVSC_LOOKUPS,
+               hvsc_ticks_to_seconds(load_ticks) * 1000.0,
+               hvsc_ticks_to_seconds(cached_ticks) * 1000000.0 / BENCH_HVSC_LOOKUPS,
+               errors);
+    }
+    fflush(stdout);
+
+    path = util_join_paths(docs, "Songlengths.md5", NULL);
+    archdep_remove(path);
+    lib_free(path);
+    path = util_join_paths(docs, "STIL.txt", NULL);
+    archdep_remove(path);
+    lib_free(path);
+    archdep_rmdir(docs);
+    archdep_rmdir(root);
+    lib_free(docs);
+    lib_free(root);
+}
+
+
+static void bench_hvsc_report(void)
+{
+    bench_hvsc(hvsc_tunes);
+}
+
+static int set_bench_hvsc(const char *param, void *extra_param)
+{
+    int tunes = atoi(param);
+
+    if (tunes <= 0) {
+        return -1;
+    }
+    if (hvsc_tunes == 0) {
+        bench_register_report(bench_hvsc_report);
+    }
+    hvsc_tunes = (unsigned int)tunes;
+    return 0;
+}
+
+static const cmdline_option_t cmdline_options[] =
+{
+    { "-benchhvsc", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench_hvsc, NULL, NULL, NULL,
+      "<tunes>", "Benchmark mode: also time song length and STIL lookups in a synthetic HVSC database of <tunes> tunes" },
+    CMDLINE_LIST_END
+};
+
+/** \brief  Register the VSID benchmark command line options
+ *
+ * \return  0 on success, < 0 on failure
+ */
+int vsid_bench_cmdline_options_init(void)
+{
+    return cmdline_register_options(cmdline_options);
+}
@@ -43,6 +43,7 @@
 #include "resources.h"
 #include "vicii.h"
 
+#include "vsid-bench.h"
 #include "vsid-cmdline-options.h"
 
 
@@ -63,5 +64,8 @@ static const cmdline_option_t cmdline_options[] =
  */
 int vsid_cmdline_options_init(void)
 {
+    if (vsid_bench_cmdline_options_init() < 0) {
+        return -1;
+    }
     return cmdline_register_options(cmdline_options);
 }
@@ -800,6 +800,26 @@ unsigned int disk_image_sector_per_track(unsigned int format, unsigned int track
     return 0;
 }
 
+unsigned int disk_image_raw_track_size(unsigned int format, unsigned int track)
+{
+    return 0;
+}
+
+unsigned int disk_image_gap_size(unsigned int format, unsigned int track)
+{
+    return 0;
+}
+
+unsigned int disk_image_header_gap_size(unsigned int format, unsigned int track)
+{
+    return 0;
+}
+
+unsigned int disk_image_sync_size(unsigned int format, unsigned int track)
+{
+    return 0;
+}
+
 int disk_image_write_p64_image(const disk_image_t *image)
 {
     return 0;
@@ -436,6 +436,21 @@ int machine_read_snapshot(const char *name, int event_mode)
     return c64_snapshot_read(name, event_mode);
 }
 
+const char *machine_state_unsupported(void)
+{
+    return "this emulator does not support it";
+}
+
+int machine_state_write(struct snapshot_s *s)
+{
+    return -1;
+}
+
+int machine_state_read(struct snapshot_s *s)
+{
+    return -1;
+}
+
 /* ------------------------------------------------------------------------- */
 
 int machine_autodetect_psid(const char *name)
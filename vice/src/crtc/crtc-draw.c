@@ -84,7 +84,24 @@ static inline void DRAW(int reverse_flag, int offset, int scr_rel,
     uint32_t *pw = (uint32_t *)p;
     uint8_t *chargen_ptr, *screen_ptr;
     int screen_rel;
-    int i, d;
+    int i, d, first, last;
+
+    /* Only draw the characters that are inside this line of the draw
+       buffer; while the CRTC is being set up the line can be moved far
+       enough to spill into the neighbouring lines.  */
+    first = xs;
+    if ((offset & ~3) < 0) {
+        first = xs + (7 - (offset & ~3)) / 8;
+    }
+    last = xs + ((int)crtc.screen_width
+                 - (offset & ~3)) / 8;
+    if (xc > last) {
+        xc = last;
+    }
+    if (xe > last) {
+        xe = last;
+    }
+
     /* pointer to current chargen line */
     chargen_ptr = crtc.chargen_base
                   + crtc.chargen_rel
@@ -101,6 +118,8 @@ static inline void DRAW(int reverse_flag, int offset, int scr_rel,
         screen_ptr = crtc.screen_base;
         screen_rel = scr_rel + xs;
     }
+    screen_rel += first - xs;
+    pw += 2 * (first - xs);
 
     if (crtc.crsrmode && crtc.cursor_lines && crtc.crsrstate) {
         /* Note: only the B series have a hardware cursor and there we have
@@ -113,7 +132,7 @@ static inline void DRAW(int reverse_flag, int offset, int scr_rel,
         }
 #endif
 
-        for (i = xs; i < xc; i++) {
+        for (i = first; i < xc; i++) {
             d = *(chargen_ptr
                   + (screen_ptr[screen_rel & crtc.vaddr_mask_eff] << 4));
 
@@ -132,7 +151,7 @@ static inline void DRAW(int reverse_flag, int offset, int scr_rel,
             *pw++ = dwg_table[d & 0x0f];
         }
     } else {
-        for (i = xs; i < xc; i++) {
+        for (i = first; i < xc; i++) {
             /* we use 16 bytes/char character generator */
             d = *(chargen_ptr
                   + (screen_ptr[screen_rel & crtc.vaddr_mask_eff] << 4));
@@ -167,7 +186,6 @@ static void draw_standard_line(void)
                rl_pos, crtc.screen_rel, crtc.hw_cols, crtc.rl_visible,
                crtc.rl_len);
 */
-    /* FIXME: check the ends against the maximum line length */
     /* the first part is left of rl_pos. Data is taken from prev. rl */
     if (rl_pos > 8) {
         DRAW(0,
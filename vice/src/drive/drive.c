@@ -48,6 +48,7 @@
 
 #include "attach.h"
 #include "archdep.h"
+#include "bench.h"
 #include "diskconstants.h"
 #include "diskimage.h"
 #include "drive-check.h"
@@ -998,6 +999,7 @@ void drive_cpu_execute_all(CLOCK clk_value)
 {
     unsigned int dnr;
 
+    BENCH_ENTER(BENCH_SECTION_DRIVE);
     for (dnr = 0; dnr < NUM_DISK_UNITS; dnr++) {
         diskunit_context_t *unit = diskunit_context[dnr];
 
@@ -1005,6 +1007,7 @@ void drive_cpu_execute_all(CLOCK clk_value)
             drive_cpu_execute_one(unit, clk_value);
         }
     }
+    BENCH_LEAVE();
 }
 
 void drive_cpu_set_overflow(diskunit_context_t *drv)
@@ -35,6 +35,7 @@
 
 #include "6510core.h"
 #include "alarm.h"
+#include "bench.h"
 #include "debug.h"
 #include "drive.h"
 #include "drivecpu.h"
@@ -432,6 +433,8 @@ void drivecpu_execute(diskunit_context_t *drv, CLOCK clk_value)
 #define bank_base (cpu->d_bank_base)
 
 #include "6510core.c"
+
+        bench_drivecpu_instructions[drv->mynumber]++;
     }
 
     cpu->last_clk = clk_value;
@@ -65,48 +65,34 @@ static const uint8_t From_GCR_conv_data[32] =
 };
 
 
+/* GCR groups are handled as one 40 bit word: 4 bytes are 8 nybbles of 5 bits */
+
 static void gcr_convert_4bytes_to_GCR(const uint8_t *source, uint8_t *dest)
 {
-    int i;
-    register unsigned int tdest = 0;    /* at least 16 bits for overflow shifting */
-
-    for (i = 2; i < 10; i += 2, source++, dest++)
-    {
-        tdest <<= 5;  /* make room for the upper nybble */
-        tdest |= GCR_conv_data[(*source) >> 4];
-
-        tdest <<= 5;  /* make room for the lower nybble */
-        tdest |= GCR_conv_data[(*source) & 0x0f];
-
-        *dest = (uint8_t)(tdest >> i);
-    }
-
-    *dest = (uint8_t)tdest;
+    uint64_t w;
+
+    w = ((uint64_t)GCR_conv_data[source[0] >> 4] << 35)
+        | ((uint64_t)GCR_conv_data[source[0] & 0x0f] << 30)
+        | ((uint64_t)GCR_conv_data[source[1] >> 4] << 25)
+        | ((uint64_t)GCR_conv_data[source[1] & 0x0f] << 20)
+        | ((uint64_t)GCR_conv_data[source[2] >> 4] << 15)
+        | ((uint64_t)GCR_conv_data[source[2] & 0x0f] << 10)
+        | ((uint64_t)GCR_conv_data[source[3] >> 4] << 5)
+        | (uint64_t)GCR_conv_data[source[3] & 0x0f];
+
+    dest[0] = (uint8_t)(w >> 32);
+    dest[1] = (uint8_t)(w >> 24);
+    dest[2] = (uint8_t)(w >> 16);
+    dest[3] = (uint8_t)(w >> 8);
+    dest[4] = (uint8_t)w;
 }
 
-static void gcr_convert_GCR_to_4bytes(const uint8_t *source, uint8_t *dest)
+static void gcr_convert_word_to_4bytes(uint64_t w, uint8_t *dest)
 {
-    int i;
-    /* at least 24 bits for shifting into bits 16...20 */
-    register uint32_t tdest = *source;
-
-    tdest <<= 13;
-
-    for (i = 5; i < 13; i += 2, dest++)
-    {
-        source++;
-        tdest |= ((uint32_t)(*source)) << i;
-
-        /*  "tdest >> 16" could be optimized to a word
-         *  aligned access, hopefully the compiler does
-         *  this for us (in a portable way)
-         */
-        *dest = From_GCR_conv_data[(tdest >> 16) & 0x1f] << 4;
-        tdest <<= 5;
-
-        *dest |= From_GCR_conv_data[(tdest >> 16) & 0x1f];
-        tdest <<= 5;
-    }
+    dest[0] = (From_GCR_conv_data[(w >> 35) & 0x1f] << 4) | From_GCR_conv_data[(w >> 30) & 0x1f];
+    dest[1] = (From_GCR_conv_data[(w >> 25) & 0x1f] << 4) | From_GCR_conv_data[(w >> 20) & 0x1f];
+    dest[2] = (From_GCR_conv_data[(w >> 15) & 0x1f] << 4) | From_GCR_conv_data[(w >> 10) & 0x1f];
+    dest[3] = (From_GCR_conv_data[(w >> 5) & 0x1f] << 4) | From_GCR_conv_data[w & 0x1f];
 }
 
 void gcr_convert_sector_to_GCR(const uint8_t *buffer, uint8_t *data, const gcr_header_t *header,
@@ -167,67 +153,80 @@ void gcr_convert_sector_to_GCR(const uint8_t *buffer, uint8_t *data, const gcr_h
     gcr_convert_4bytes_to_GCR(buf, data);
 }
 
+/* Sync marks are at least 10 one bits, the position returned is that of the
+   first zero bit after them. The track is scanned a byte at a time: only the
+   one bits at the start and the end of a byte can be part of a sync mark.  */
 static int gcr_find_sync(const disk_track_t *raw, int p, int s)
 {
-    unsigned int w;
-    int b;
+    int pos, n, run, lead;
+    unsigned int b;
 
     if (!raw->data || !raw->size) {
         return -CBMDOS_FDC_ERR_SYNC;
     }
 
-    w = 0;
-    b = raw->data[p >> 3] << (p & 7);
-    while (s--) {
-        if (b & 0x80) {
-            w = (w << 1) | 1;
+    pos = p >> 3;
+    /* bits before p are not looked at, treat them as zero */
+    b = raw->data[pos] & (0xff >> (p & 7));
+    run = 0;
+    /* n is the offset of the byte's first bit from p */
+    for (n = -(p & 7); n < s; n += 8) {
+        if (b == 0xff) {
+            run = (run < 10) ? run + 8 : run;
         } else {
-            if (~w & 0x3ff) {
-                w <<= 1;
-            } else {
-                return p;
+            /* at most 7 leading one bits, so 3 must come before this byte */
+            if (run >= 3) {
+                lead = 0;
+                while (b & (0x80 >> lead)) {
+                    lead++;
+                }
+                if (run + lead >= 10) {
+                    return (n + lead < s) ? (pos << 3) + lead : -CBMDOS_FDC_ERR_SYNC;
+                }
             }
-        }
-        if (~p & 7) {
-            p++;
-            b <<= 1;
-        } else {
-            p++;
-            if (p >= raw->size * 8) {
-                p = 0;
+            run = 0;
+            while (b & (1 << run)) {
+                run++;
             }
-            b = raw->data[p >> 3];
         }
+        if (++pos >= raw->size) {
+            pos = 0;
+        }
+        b = raw->data[pos];
     }
     return -CBMDOS_FDC_ERR_SYNC;
 }
 
+/* Decode num GCR groups starting at bit p, num is at most 65 */
 static void gcr_decode_block(const disk_track_t *raw, int p, uint8_t *buf, int num)
 {
-    int shift, i, j;
-    uint8_t gcr[5], b;
-    uint8_t *offset, *end = raw->data + raw->size;
+    uint8_t linear[65 * 5 + 1];
+    const uint8_t *src;
+    int shift, len, pos, i;
+    uint64_t w;
 
     shift = p & 7;
-    offset = raw->data + (p >> 3);
-
-    b = offset[0] << shift;
-    for (i = 0; i < num; i++, buf += 4) {
-        /* get 5 bytes of gcr data */
-        for (j = 0; j < 5; j++) {
-            offset++;
-            if (offset >= end) {
-                offset = raw->data;
-            }
-            if (shift) {
-                gcr[j] = b | ((offset[0] << shift) >> 8);
-                b = offset[0] << shift;
-            } else {
-                gcr[j] = b;
-                b = offset[0];
+    pos = p >> 3;
+    /* each group is read from the 6 bytes it overlaps */
+    len = num * 5 + 1;
+
+    if (pos + len <= raw->size) {
+        src = raw->data + pos;
+    } else {
+        /* the block wraps around the end of the track */
+        for (i = 0; i < len; i++) {
+            linear[i] = raw->data[pos];
+            if (++pos >= raw->size) {
+                pos = 0;
             }
         }
-        gcr_convert_GCR_to_4bytes(gcr, buf);
+        src = linear;
+    }
+
+    for (i = 0; i < num; i++, src += 5, buf += 4) {
+        w = ((uint64_t)src[0] << 40) | ((uint64_t)src[1] << 32) | ((uint64_t)src[2] << 24)
+            | ((uint64_t)src[3] << 16) | ((uint64_t)src[4] << 8) | src[5];
+        gcr_convert_word_to_4bytes(w >> (8 - shift), buf);
     }
 }
 
@@ -293,10 +292,10 @@ fdc_err_t gcr_read_sector(const disk_track_t *raw, uint8_t *data, uint8_t sector
 
 fdc_err_t gcr_write_sector(disk_track_t *raw, const uint8_t *data, uint8_t sector)
 {
-    uint8_t buffer[260], *offset, *buf;
+    uint8_t buffer[260], *offset;
     uint8_t *end = raw->data + raw->size;
-    uint8_t gcr[5], chksum, b;
-    int i, j, shift, p;
+    uint8_t gcr[65 * 5], chksum, b;
+    int i, shift, p;
 
     p = gcr_find_sector_header(raw, sector);
     if (p < 0) {
@@ -322,22 +321,20 @@ fdc_err_t gcr_write_sector(disk_track_t *raw, const uint8_t *data, uint8_t secto
     buffer[257] = chksum;
     buffer[258] = buffer[259] = 0;
 
-    buf = buffer;
-
     for (i = 0; i < 65; i++) {
-        gcr_convert_4bytes_to_GCR(buf, gcr);
-        buf += 4;
-        for (j = 0; j < 5; j++) {
-            if (shift) {
-                offset[0] = b | (gcr[j] >> shift);
-                b = (gcr[j] << 8) >> shift;
-            } else {
-                offset[0] = gcr[j];
-            }
-            offset++;
-            if (offset >= end) {
-                offset = raw->data;
-            }
+        gcr_convert_4bytes_to_GCR(buffer + i * 4, gcr + i * 5);
+    }
+
+    for (i = 0; i < 65 * 5; i++) {
+        if (shift) {
+            offset[0] = b | (gcr[i] >> shift);
+            b = (gcr[i] << 8) >> shift;
+        } else {
+            offset[0] = gcr[i];
+        }
+        offset++;
+        if (offset >= end) {
+            offset = raw->data;
         }
     }
     offset[0] = b | (offset[0] & (0xff >> shift));
@@ -36,6 +36,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#ifdef USE_VICE_THREAD
+#include <pthread.h>
+#endif
+
 #include "archdep.h"
 #include "cmdline.h"
 #include "ffmpegdrv.h"
@@ -168,6 +172,54 @@ static unsigned int framecounter;
 static struct SwsContext *sws_ctx;
 #endif
 
+/* encoder jobs
+ *
+ * The emulation thread only copies the palette indices of a frame or the
+ * samples of a full audio buffer into a job; palette lookup, scaling,
+ * encoding and muxing are done by the encoder thread (or right away when
+ * there is none). Jobs are processed in the order they were queued, so
+ * the audio and video packets are interleaved just like before.
+ */
+#define FFMPEGDRV_JOB_AUDIO     0
+#define FFMPEGDRV_JOB_VIDEO     1
+
+/* number of pooled jobs, i.e. how far the encoder may lag behind */
+#define FFMPEGDRV_QUEUE_SIZE    8
+
+/* number of recorded frames between two statistics reports */
+#define FFMPEGDRV_STATS_INTERVAL    250
+
+typedef struct ffmpegdrv_job_s {
+    int type;
+    int64_t pts;                /* video: frame number */
+    const int16_t *samples;     /* audio: interleaved S16 samples */
+    const uint8_t *pixels;      /* video: palette indices */
+    int pitch;                  /* video: bytes per line of pixels */
+    uint8_t rgb[256 * 3];       /* video: palette */
+    int16_t *sample_buf;        /* pooled buffers, only used when queued */
+    uint8_t *pixel_buf;
+} ffmpegdrv_job_t;
+
+static ffmpegdrv_job_t sync_job;
+
+#ifdef USE_VICE_THREAD
+static ffmpegdrv_job_t queue_jobs[FFMPEGDRV_QUEUE_SIZE];
+static int queue_head;
+static int queue_count;
+static int queue_quit;
+static int encoder_running;
+static pthread_t encoder_thread;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_filled = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queue_drained = PTHREAD_COND_INITIALIZER;
+#endif
+
+/* statistics, protected by queue_lock when the encoder thread runs */
+static unsigned int stats_frames;
+static unsigned int stats_dropped;
+static uint64_t stats_encode_usec;
+static int stats_queue_max;
+
 /* resources */
 static char *ffmpeg_format = NULL;
 static int format_index;
@@ -176,6 +228,7 @@ static int video_bitrate;
 static int audio_codec;
 static int video_codec;
 static int video_halve_framerate;
+static int drop_frames;
 
 static int ffmpegdrv_init_file(void);
 
@@ -253,6 +306,12 @@ static int set_video_halve_framerate(int value, void *param)
     return 0;
 }
 
+static int set_drop_frames(int value, void *param)
+{
+    drop_frames = value ? 1 : 0;
+    return 0;
+}
+
 /*---------- Resources ------------------------------------------------*/
 
 static const resource_string_t resources_string[] = {
@@ -274,6 +333,8 @@ static const resource_int_t resources_int[] = {
       &video_codec, set_video_codec, NULL },
     { "FFMPEGVideoHalveFramerate", 0, RES_EVENT_NO, NULL,
       &video_halve_framerate, set_video_halve_framerate, NULL },
+    { "FFMPEGDropFrames", 0, RES_EVENT_NO, NULL,
+      &drop_frames, set_drop_frames, NULL },
     RESOURCE_INT_LIST_END
 };
 
@@ -296,6 +357,12 @@ static const cmdline_option_t cmdline_options[] =
     { "-ffmpegvideobitrate", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
       NULL, NULL, "FFMPEGVideoBitrate", NULL,
       "<value>", "Set bitrate for video stream in media file" },
+    { "-ffmpegdropframes", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
+      NULL, NULL, "FFMPEGDropFrames", (resource_value_t)1,
+      NULL, "Drop video frames when the encoder cannot keep up" },
+    { "+ffmpegdropframes", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
+      NULL, NULL, "FFMPEGDropFrames", (resource_value_t)0,
+      NULL, "Slow down emulation when the encoder cannot keep up" },
     CMDLINE_LIST_END
 };
 
@@ -523,68 +590,89 @@ static int ffmpegmovie_init_audio(int speed, int channels, soundmovie_buffer_t *
     return 0;
 }
 
-/* triggered by soundffmpegaudio->write */
-static int ffmpegmovie_encode_audio(soundmovie_buffer_t *audio_in)
+/* encode one buffer of audio samples, called by the encoder */
+static int ffmpegdrv_encode_audio(const int16_t *samples)
 {
     int got_packet;
     int dst_nb_samples;
     AVPacket pkt = { 0 };
     AVCodecContext *c;
-    AVFrame *frame;
+    const uint8_t *in[1];
+    int nb_samples;
     int ret;
 
-    if (audio_st.st) {
-        audio_st.frame->pts = audio_st.next_pts;
-        audio_st.next_pts += audio_in->size;
+    VICE_P_AV_INIT_PACKET(&pkt);
+    c = audio_st.st->codec;
 
-        VICE_P_AV_INIT_PACKET(&pkt);
-        c = audio_st.st->codec;
-
-        frame = audio_st.tmp_frame;
+    /* convert samples from native format to destination codec format, using the resampler */
+    in[0] = (const uint8_t *)samples;
+    nb_samples = audio_st.tmp_frame->nb_samples;
 
-        if (frame) {
-            /* convert samples from native format to destination codec format, using the resampler */
-            /* compute destination number of samples */
+    /* compute destination number of samples */
 #ifndef HAVE_FFMPEG_AVRESAMPLE
-            dst_nb_samples = (int)VICE_P_AV_RESCALE_RND(VICE_P_SWR_GET_DELAY(swr_ctx, c->sample_rate) + frame->nb_samples, c->sample_rate, c->sample_rate, AV_ROUND_UP);
+    dst_nb_samples = (int)VICE_P_AV_RESCALE_RND(VICE_P_SWR_GET_DELAY(swr_ctx, c->sample_rate) + nb_samples, c->sample_rate, c->sample_rate, AV_ROUND_UP);
 #else
-            dst_nb_samples = (int)VICE_P_AV_RESCALE_RND(VICE_P_AVRESAMPLE_GET_DELAY(avr_ctx, c->sample_rate) + frame->nb_samples, c->sample_rate, c->sample_rate, AV_ROUND_UP);
+    dst_nb_samples = (int)VICE_P_AV_RESCALE_RND(VICE_P_AVRESAMPLE_GET_DELAY(avr_ctx, c->sample_rate) + nb_samples, c->sample_rate, c->sample_rate, AV_ROUND_UP);
 #endif
 
-            /* when we pass a frame to the encoder, it may keep a reference to it
-            * internally;
-            * make sure we do not overwrite it here
-            */
-            ret = VICE_P_AV_FRAME_MAKE_WRITABLE(audio_st.frame);
-            if (ret < 0)
-                return -1;
+    /* when we pass a frame to the encoder, it may keep a reference to it
+    * internally;
+    * make sure we do not overwrite it here
+    */
+    ret = VICE_P_AV_FRAME_MAKE_WRITABLE(audio_st.frame);
+    if (ret < 0)
+        return -1;
 
-            /* convert to destination format */
+    /* convert to destination format */
 #ifndef HAVE_FFMPEG_AVRESAMPLE
-            ret = VICE_P_SWR_CONVERT(swr_ctx, audio_st.frame->data, dst_nb_samples, (const uint8_t **)frame->data, frame->nb_samples);
+    ret = VICE_P_SWR_CONVERT(swr_ctx, audio_st.frame->data, dst_nb_samples, in, nb_samples);
 #else
-            ret = VICE_P_AVRESAMPLE_CONVERT(avr_ctx, audio_st.frame->data, 0, dst_nb_samples, (const uint8_t **)frame->data, 0, frame->nb_samples);
+    ret = VICE_P_AVRESAMPLE_CONVERT(avr_ctx, audio_st.frame->data, 0, dst_nb_samples, in, 0, nb_samples);
 #endif
-            if (ret < 0) {
-                log_debug("ffmpegdrv_encode_audio: Error while converting audio frame");
-                return -1;
-            }
-            frame = audio_st.frame;
-            frame->pts = VICE_P_AV_RESCALE_Q(audio_st.samples_count, (AVRational){ 1, c->sample_rate }, c->time_base);
-            audio_st.samples_count += dst_nb_samples;
+    if (ret < 0) {
+        log_debug("ffmpegdrv_encode_audio: Error while converting audio frame");
+        return -1;
+    }
+    audio_st.frame->pts = VICE_P_AV_RESCALE_Q(audio_st.samples_count, (AVRational){ 1, c->sample_rate }, c->time_base);
+    audio_st.samples_count += dst_nb_samples;
+
+    ret = VICE_P_AVCODEC_ENCODE_AUDIO2(audio_st.st->codec, &pkt, audio_st.frame, &got_packet);
+    if (got_packet) {
+        if (write_frame(ffmpegdrv_oc, &c->time_base, audio_st.st, &pkt)<0)
+        {
+            log_debug("ffmpegdrv_encode_audio: Error while writing audio frame");
         }
+    }
 
-        ret = VICE_P_AVCODEC_ENCODE_AUDIO2(audio_st.st->codec, &pkt, audio_st.frame, &got_packet);
-        if (got_packet) {
-            if (write_frame(ffmpegdrv_oc, &c->time_base, audio_st.st, &pkt)<0)
-            {
-                log_debug("ffmpegdrv_encode_audio: Error while writing audio frame");
-            }
+    return 0;
+}
+
+static ffmpegdrv_job_t *ffmpegdrv_job_get(int may_drop);
+static int ffmpegdrv_job_submit(ffmpegdrv_job_t *job);
+
+/* triggered by soundffmpegaudio->write */
+static int ffmpegmovie_encode_audio(soundmovie_buffer_t *audio_in)
+{
+    ffmpegdrv_job_t *job;
+    int ret = 0;
+
+    if (audio_st.st) {
+        audio_st.next_pts += audio_in->size;
+
+        /* audio is never dropped, that would break the A/V sync */
+        job = ffmpegdrv_job_get(0);
+        job->type = FFMPEGDRV_JOB_AUDIO;
+        if (job->sample_buf != NULL) {
+            memcpy(job->sample_buf, audio_in->buffer, audio_in->size * sizeof(int16_t));
+            job->samples = job->sample_buf;
+        } else {
+            job->samples = audio_in->buffer;
         }
+        ret = ffmpegdrv_job_submit(job);
     }
 
     audio_in->used = 0;
-    return 0;
+    return ret;
 }
 
 static void ffmpegmovie_close(void)
@@ -602,35 +690,93 @@ static soundmovie_funcs_t ffmpegdrv_soundmovie_funcs = {
 /*-----------------------*/
 /* video stream encoding */
 /*-----------------------*/
-static int ffmpegdrv_fill_rgb_image(screenshot_t *screenshot, AVFrame *pic)
+static int ffmpegdrv_fill_rgb_image(const ffmpegdrv_job_t *job, AVFrame *pic)
 {
     int x, y;
-    int dx, dy;
-    int colnum;
-    int bufferoffset;
-    int x_dim = screenshot->width;
-    int y_dim = screenshot->height;
     int pix = 0;
-    /* center the screenshot in the video */
-    dx = (video_width - x_dim) / 2;
-    dy = (video_height - y_dim) / 2;
-    bufferoffset = screenshot->x_offset + (dx < 0 ? -dx : 0)
-        + (screenshot->y_offset + (dy < 0 ? -dy : 0)) * screenshot->draw_buffer_line_size;
+    const uint8_t *src = job->pixels;
+    const uint8_t *rgb;
 
     for (y = 0; y < video_height; y++) {
         for (x = 0; x < video_width; x++) {
-            colnum = screenshot->draw_buffer[bufferoffset + x];
-            pic->data[0][pix + 3*x] = screenshot->palette->entries[colnum].red;
-            pic->data[0][pix + 3*x + 1] = screenshot->palette->entries[colnum].green;
-            pic->data[0][pix + 3*x + 2] = screenshot->palette->entries[colnum].blue;
+            rgb = &job->rgb[src[x] * 3];
+            pic->data[0][pix + 3*x] = rgb[0];
+            pic->data[0][pix + 3*x + 1] = rgb[1];
+            pic->data[0][pix + 3*x + 2] = rgb[2];
         }
-        bufferoffset += screenshot->draw_buffer_line_size;
+        src += job->pitch;
         pix += pic->linesize[0];
     }
 
     return 0;
 }
 
+/* convert and encode one frame, called by the encoder */
+static int ffmpegdrv_encode_video(const ffmpegdrv_job_t *job)
+{
+    AVCodecContext *c;
+    int ret;
+
+    c = video_st.st->codec;
+
+    if (c->pix_fmt != VICE_AV_PIX_FMT_RGB24) {
+        ffmpegdrv_fill_rgb_image(job, video_st.tmp_frame);
+
+        if (sws_ctx != NULL) {
+            VICE_P_SWS_SCALE(sws_ctx,
+                video_st.tmp_frame->data,
+                video_st.tmp_frame->linesize, 0, c->height,
+                video_st.frame->data, video_st.frame->linesize);
+        }
+    } else {
+        ffmpegdrv_fill_rgb_image(job, video_st.frame);
+    }
+
+    video_st.frame->pts = job->pts;
+
+#ifdef AVFMT_RAWPICTURE
+    if (ffmpegdrv_oc->oformat->flags & AVFMT_RAWPICTURE) {
+        AVPacket pkt;
+        VICE_P_AV_INIT_PACKET(&pkt);
+        pkt.flags |= AV_PKT_FLAG_KEY;
+        pkt.stream_index = video_st.st->index;
+        pkt.data = (uint8_t*)video_st.frame;
+        pkt.size = sizeof(AVPicture);
+        pkt.pts = pkt.dts = video_st.frame->pts;
+
+        ret = VICE_P_AV_INTERLEAVED_WRITE_FRAME(ffmpegdrv_oc, &pkt);
+    } else
+#endif
+    {
+        AVPacket pkt = { 0 };
+        int got_packet;
+
+        VICE_P_AV_INIT_PACKET(&pkt);
+
+        /* encode the image */
+        ret = VICE_P_AVCODEC_ENCODE_VIDEO2(c, &pkt, video_st.frame, &got_packet);
+        if (ret < 0) {
+            log_debug("Error while encoding video frame");
+            return -1;
+        }
+        /* if zero size, it means the image was buffered */
+        if (got_packet) {
+            if (write_frame(ffmpegdrv_oc, &c->time_base, video_st.st, &pkt)<0)
+            {
+                log_debug("ffmpegdrv_encode_audio: Error while writing audio frame");
+            }
+        } else {
+            ret = 0;
+        }
+    }
+    if (ret < 0) {
+        log_debug("Error while writing video frame");
+        return -1;
+    }
+
+    return 0;
+}
+
 static AVFrame* ffmpegdrv_alloc_picture(enum AVPixelFormat pix_fmt, int width, int height)
 {
     AVFrame *picture;
@@ -718,6 +864,225 @@ static void ffmpegdrv_close_video(void)
     }
 }
 
+/*---------- Encoder --------------------------------------------------*/
+
+static int ffmpegdrv_job_run(const ffmpegdrv_job_t *job, uint32_t *usec)
+{
+    tick_t start;
+    int ret;
+
+    if (job->type == FFMPEGDRV_JOB_AUDIO) {
+        return ffmpegdrv_encode_audio(job->samples);
+    }
+
+    start = tick_now();
+    ret = ffmpegdrv_encode_video(job);
+    *usec = TICK_TO_MICRO(tick_now_delta(start));
+
+    return ret;
+}
+
+static void ffmpegdrv_job_done(const ffmpegdrv_job_t *job, uint32_t usec)
+{
+    if (job->type == FFMPEGDRV_JOB_VIDEO) {
+        stats_frames++;
+        stats_encode_usec += usec;
+    }
+}
+
+#ifdef USE_VICE_THREAD
+static void *ffmpegdrv_encoder_main(void *unused)
+{
+    ffmpegdrv_job_t *job;
+    uint32_t usec;
+
+    pthread_mutex_lock(&queue_lock);
+    while (1) {
+        while (!queue_quit && queue_count == 0) {
+            pthread_cond_wait(&queue_filled, &queue_lock);
+        }
+        if (queue_count == 0) {
+            /* stopped, and all queued jobs are done */
+            break;
+        }
+        job = &queue_jobs[queue_head];
+        pthread_mutex_unlock(&queue_lock);
+
+        usec = 0;
+        ffmpegdrv_job_run(job, &usec);
+
+        pthread_mutex_lock(&queue_lock);
+        ffmpegdrv_job_done(job, usec);
+        queue_head = (queue_head + 1) % FFMPEGDRV_QUEUE_SIZE;
+        queue_count--;
+        pthread_cond_signal(&queue_drained);
+    }
+    pthread_mutex_unlock(&queue_lock);
+
+    return NULL;
+}
+
+static void ffmpegdrv_queue_free(void)
+{
+    int i;
+
+    for (i = 0; i < FFMPEGDRV_QUEUE_SIZE; i++) {
+        lib_free(queue_jobs[i].sample_buf);
+        queue_jobs[i].sample_buf = NULL;
+        lib_free(queue_jobs[i].pixel_buf);
+        queue_jobs[i].pixel_buf = NULL;
+    }
+}
+#endif
+
+/* Get the next free job, or NULL when the queue is full and may_drop is
+   set. Without the encoder thread the job is run right away on submit. */
+static ffmpegdrv_job_t *ffmpegdrv_job_get(int may_drop)
+{
+#ifdef USE_VICE_THREAD
+    ffmpegdrv_job_t *job;
+
+    if (encoder_running) {
+        pthread_mutex_lock(&queue_lock);
+        if (queue_count == FFMPEGDRV_QUEUE_SIZE && may_drop) {
+            stats_dropped++;
+            pthread_mutex_unlock(&queue_lock);
+            return NULL;
+        }
+        /* block emulation until the encoder caught up */
+        while (queue_count == FFMPEGDRV_QUEUE_SIZE) {
+            pthread_cond_wait(&queue_drained, &queue_lock);
+        }
+        job = &queue_jobs[(queue_head + queue_count) % FFMPEGDRV_QUEUE_SIZE];
+        pthread_mutex_unlock(&queue_lock);
+        return job;
+    }
+#endif
+    return &sync_job;
+}
+
+static int ffmpegdrv_job_submit(ffmpegdrv_job_t *job)
+{
+    uint32_t usec = 0;
+    int ret;
+
+#ifdef USE_VICE_THREAD
+    if (encoder_running) {
+        pthread_mutex_lock(&queue_lock);
+        queue_count++;
+        if (queue_count > stats_queue_max) {
+            stats_queue_max = queue_count;
+        }
+        pthread_cond_signal(&queue_filled);
+        pthread_mutex_unlock(&queue_lock);
+        return 0;
+    }
+#endif
+    ret = ffmpegdrv_job_run(job, &usec);
+    ffmpegdrv_job_done(job, usec);
+    return ret;
+}
+
+static void ffmpegdrv_encoder_start(void)
+{
+#ifdef USE_VICE_THREAD
+    int i;
+#endif
+
+    stats_frames = 0;
+    stats_dropped = 0;
+    stats_encode_usec = 0;
+    stats_queue_max = 0;
+
+#ifdef USE_VICE_THREAD
+    queue_head = 0;
+    queue_count = 0;
+    queue_quit = 0;
+
+    for (i = 0; i < FFMPEGDRV_QUEUE_SIZE; i++) {
+        if (audio_is_open) {
+            queue_jobs[i].sample_buf = lib_malloc(ffmpegdrv_audio_in.size * sizeof(int16_t));
+        }
+        if (video_is_open) {
+            queue_jobs[i].pixel_buf = lib_malloc((size_t)(video_width * video_height));
+        }
+    }
+
+    if (pthread_create(&encoder_thread, NULL, ffmpegdrv_encoder_main, NULL) != 0) {
+        log_error(LOG_DEFAULT, "ffmpegdrv: could not start encoder thread, encoding synchronously.");
+        ffmpegdrv_queue_free();
+        return;
+    }
+    encoder_running = 1;
+#endif
+}
+
+/* wait until all queued jobs are encoded and stop the encoder thread */
+static void ffmpegdrv_encoder_stop(void)
+{
+#ifdef USE_VICE_THREAD
+    if (!encoder_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue_lock);
+    queue_quit = 1;
+    pthread_cond_signal(&queue_filled);
+    pthread_mutex_unlock(&queue_lock);
+
+    pthread_join(encoder_thread, NULL);
+    encoder_running = 0;
+    ffmpegdrv_queue_free();
+#endif
+}
+
+/* Log, and show in the status bar, the encode time per frame since the last
+   report, the queue depth and the number of dropped frames. */
+static void ffmpegdrv_stats_report(int final)
+{
+    static unsigned int last_frames;
+    static uint64_t last_usec;
+    unsigned int frames;
+    unsigned int dropped;
+    uint64_t usec;
+    int depth = 0;
+    int depth_max;
+    char *text;
+
+#ifdef USE_VICE_THREAD
+    pthread_mutex_lock(&queue_lock);
+    depth = queue_count;
+#endif
+    frames = stats_frames;
+    dropped = stats_dropped;
+    usec = stats_encode_usec;
+    depth_max = stats_queue_max;
+#ifdef USE_VICE_THREAD
+    pthread_mutex_unlock(&queue_lock);
+#endif
+
+    if (final) {
+        /* average over the whole recording */
+        last_frames = 0;
+        last_usec = 0;
+    }
+
+    text = lib_msprintf("%u frames, %.1f ms/frame, queue %d/%d (max %d), %u dropped",
+                        frames,
+                        frames > last_frames
+                            ? (double)(usec - last_usec) / 1000.0 / (frames - last_frames)
+                            : 0.0,
+                        depth, FFMPEGDRV_QUEUE_SIZE, depth_max, dropped);
+    log_message(LOG_DEFAULT, "ffmpegdrv: %s%s", final ? "recorded " : "", text);
+    if (!final) {
+        ui_display_statustext(text, true);
+    }
+    lib_free(text);
+
+    last_frames = final ? 0 : frames;
+    last_usec = final ? 0 : usec;
+}
+
 static void ffmpegdrv_init_video(screenshot_t *screenshot)
 {
     AVCodecContext *c;
@@ -843,6 +1208,8 @@ static int ffmpegdrv_init_file(void)
 
     file_init_done = 1;
 
+    ffmpegdrv_encoder_start();
+
     return 0;
 }
 
@@ -903,6 +1270,8 @@ static int ffmpegdrv_close(screenshot_t *screenshot)
 
     /* write the trailer, if any */
     if (file_init_done) {
+        ffmpegdrv_encoder_stop();
+        ffmpegdrv_stats_report(1);
         VICE_P_AV_WRITE_TRAILER(ffmpegdrv_oc);
     }
 
@@ -937,8 +1306,11 @@ static int ffmpegdrv_close(screenshot_t *screenshot)
 /* triggered by screenshot_record */
 static int ffmpegdrv_record(screenshot_t *screenshot)
 {
-    AVCodecContext *c;
-    int ret;
+    ffmpegdrv_job_t *job;
+    const uint8_t *src;
+    int dx, dy;
+    int y;
+    unsigned int i;
 
     if (audio_init_done && video_init_done && !file_init_done) {
         ffmpegdrv_init_file();
@@ -959,64 +1331,48 @@ static int ffmpegdrv_record(screenshot_t *screenshot)
         return 0;
     }
 
-    c = video_st.st->codec;
-
-    if (c->pix_fmt != VICE_AV_PIX_FMT_RGB24) {
-        ffmpegdrv_fill_rgb_image(screenshot, video_st.tmp_frame);
-
-        if (sws_ctx != NULL) {
-            VICE_P_SWS_SCALE(sws_ctx,
-                video_st.tmp_frame->data,
-                video_st.tmp_frame->linesize, 0, c->height,
-                video_st.frame->data, video_st.frame->linesize);
-        }
-    } else {
-        ffmpegdrv_fill_rgb_image(screenshot, video_st.frame);
+    if (framecounter % FFMPEGDRV_STATS_INTERVAL == 0) {
+        ffmpegdrv_stats_report(0);
     }
 
-    video_st.frame->pts = video_st.next_pts++;
-
-#ifdef AVFMT_RAWPICTURE
-    if (ffmpegdrv_oc->oformat->flags & AVFMT_RAWPICTURE) {
-        AVPacket pkt;
-        VICE_P_AV_INIT_PACKET(&pkt);
-        pkt.flags |= AV_PKT_FLAG_KEY;
-        pkt.stream_index = video_st.st->index;
-        pkt.data = (uint8_t*)video_st.frame;
-        pkt.size = sizeof(AVPicture);
-        pkt.pts = pkt.dts = video_st.frame->pts;
-
-        ret = VICE_P_AV_INTERLEAVED_WRITE_FRAME(ffmpegdrv_oc, &pkt);
-    } else
-#endif
-    {
-        AVPacket pkt = { 0 };
-        int got_packet;
+    job = ffmpegdrv_job_get(drop_frames);
+    if (job == NULL) {
+        /* the encoder is behind, skip the frame but keep the following
+           ones in sync with the audio */
+        video_st.next_pts++;
+        return 0;
+    }
 
-        VICE_P_AV_INIT_PACKET(&pkt);
+    /* center the screenshot in the video */
+    dx = (video_width - (int)screenshot->width) / 2;
+    dy = (video_height - (int)screenshot->height) / 2;
+    src = screenshot->draw_buffer + screenshot->x_offset + (dx < 0 ? -dx : 0)
+        + (screenshot->y_offset + (dy < 0 ? -dy : 0)) * screenshot->draw_buffer_line_size;
 
-        /* encode the image */
-        ret = VICE_P_AVCODEC_ENCODE_VIDEO2(c, &pkt, video_st.frame, &got_packet);
-        if (ret < 0) {
-            log_debug("Error while encoding video frame");
-            return -1;
+    job->type = FFMPEGDRV_JOB_VIDEO;
+    if (job->pixel_buf != NULL) {
+        for (y = 0; y < video_height; y++) {
+            memcpy(job->pixel_buf + y * video_width, src, video_width);
+            src += screenshot->draw_buffer_line_size;
         }
-        /* if zero size, it means the image was buffered */
-        if (got_packet) {
-            if (write_frame(ffmpegdrv_oc, &c->time_base, video_st.st, &pkt)<0)
-            {
-                log_debug("ffmpegdrv_encode_audio: Error while writing audio frame");
-            }
+        job->pixels = job->pixel_buf;
+        job->pitch = video_width;
+    } else {
+        job->pixels = src;
+        job->pitch = (int)screenshot->draw_buffer_line_size;
+    }
+    for (i = 0; i < 256; i++) {
+        if (i < screenshot->palette->num_entries) {
+            job->rgb[i * 3] = screenshot->palette->entries[i].red;
+            job->rgb[i * 3 + 1] = screenshot->palette->entries[i].green;
+            job->rgb[i * 3 + 2] = screenshot->palette->entries[i].blue;
         } else {
-            ret = 0;
+            job->rgb[i * 3] = job->rgb[i * 3 + 1] = job->rgb[i * 3 + 2] = 0;
         }
     }
-    if (ret < 0) {
-        log_debug("Error while writing video frame");
-        return -1;
-    }
+    job->pts = video_st.next_pts++;
 
-    return 0;
+    return ffmpegdrv_job_submit(job);
 }
 
 static int ffmpegdrv_write(screenshot_t *screenshot)
@@ -66,6 +66,10 @@
 #include <inttypes.h>
 #include <unistd.h>
 
+#ifdef USE_VICE_THREAD
+#include <pthread.h>
+#endif
+
 #include "archdep.h"
 #include "cmdline.h"
 #include "coproc.h"
@@ -539,6 +543,208 @@ static int write_initial_audio_frames(void)
     return 0;
 }
 
+/*****************************************************************************
+   writer thread
+
+   Video frames are converted straight into a ring of preallocated slots and
+   audio buffers are copied into them; the writer thread sends the slots to
+   ffmpeg in the order they were filled, exactly like the synchronous code
+   did, so the A/V sync is not affected. A stalling ffmpeg only blocks the
+   emulation once the ring is full. The slots are allocated as one block, so
+   runs of consecutive video frames are sent with a single large send().
+ *****************************************************************************/
+
+#ifdef USE_VICE_THREAD
+
+#define WRITER_RING_SIZE    16
+
+#define WRITER_JOB_VIDEO    0
+#define WRITER_JOB_AUDIO    1
+
+typedef struct writer_job_s {
+    int type;
+    size_t len;
+    int repeat;     /* number of times a video frame is sent */
+} writer_job_t;
+
+static uint8_t *writer_ring = NULL;
+static size_t writer_slot_size;
+static writer_job_t writer_jobs[WRITER_RING_SIZE];
+static int writer_head;
+static int writer_count;
+static int writer_count_max;
+static int writer_quit;
+static int writer_error;
+static int writer_running = 0;
+static pthread_t writer_thread;
+static pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writer_filled = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t writer_drained = PTHREAD_COND_INITIALIZER;
+
+/* send all of data, the socket may accept less than asked for */
+static int writer_send(vice_network_socket_t *sock, const uint8_t *data, size_t len)
+{
+    int res;
+
+    while (len > 0) {
+        res = vice_network_send(sock, data, len, 0 /* flags */);
+        if (res <= 0) {
+            return -1;
+        }
+        data += res;
+        len -= (size_t)res;
+    }
+    return 0;
+}
+
+static void *writer_main(void *unused)
+{
+    writer_job_t *job;
+    const uint8_t *data;
+    size_t len;
+    int n;
+    int i;
+    int res;
+
+    pthread_mutex_lock(&writer_lock);
+    while (1) {
+        while (!writer_quit && writer_count == 0) {
+            pthread_cond_wait(&writer_filled, &writer_lock);
+        }
+        if (writer_count == 0) {
+            /* stopped, and everything is sent */
+            break;
+        }
+
+        /* merge a run of full video slots that don't wrap into one send */
+        job = &writer_jobs[writer_head];
+        len = job->len;
+        n = 1;
+        if (job->type == WRITER_JOB_VIDEO && job->repeat == 1 && job->len == writer_slot_size) {
+            while (n < writer_count && writer_head + n < WRITER_RING_SIZE
+                   && writer_jobs[writer_head + n].type == WRITER_JOB_VIDEO
+                   && writer_jobs[writer_head + n].repeat == 1
+                   && writer_jobs[writer_head + n].len == writer_slot_size) {
+                len += writer_slot_size;
+                n++;
+            }
+        }
+        pthread_mutex_unlock(&writer_lock);
+
+        data = writer_ring + writer_head * writer_slot_size;
+        res = 0;
+        if (job->type == WRITER_JOB_VIDEO) {
+            for (i = 0; i < job->repeat && res == 0; i++) {
+                res = writer_send(ffmpeg_video_socket, data, len);
+            }
+        } else {
+            res = writer_send(ffmpeg_audio_socket, data, len);
+        }
+
+        pthread_mutex_lock(&writer_lock);
+        if (res < 0 && !writer_error) {
+            log_error(LOG_DEFAULT, "ffmpegexedrv: Error writing to %s socket",
+                      job->type == WRITER_JOB_VIDEO ? "VIDEO" : "AUDIO");
+            writer_error = 1;
+        }
+        writer_head = (writer_head + n) % WRITER_RING_SIZE;
+        writer_count -= n;
+        pthread_cond_signal(&writer_drained);
+    }
+    pthread_mutex_unlock(&writer_lock);
+
+    return NULL;
+}
+
+/* wait until all queued data is sent and stop the writer thread */
+static void writer_stop(void)
+{
+    if (!writer_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&writer_lock);
+    writer_quit = 1;
+    pthread_cond_signal(&writer_filled);
+    pthread_mutex_unlock(&writer_lock);
+
+    pthread_join(writer_thread, NULL);
+    writer_running = 0;
+
+    log_message(LOG_DEFAULT, "ffmpegexedrv: writer queue depth max %d/%d",
+                writer_count_max, WRITER_RING_SIZE);
+
+    lib_free(writer_ring);
+    writer_ring = NULL;
+}
+
+/* called once the sockets to ffmpeg are connected */
+static void writer_start(void)
+{
+    size_t audio_len = AUDIO_BUFFER_SAMPLES * sizeof(int16_t) * AUDIO_BUFFER_MAX_CHANNELS;
+
+    /* the sound system may reinitialize the movie output */
+    writer_stop();
+
+    writer_slot_size = (size_t)(INPUT_VIDEO_BPP * video_width * video_height);
+    if (writer_slot_size < audio_len) {
+        writer_slot_size = audio_len;
+    }
+    writer_ring = lib_malloc(writer_slot_size * WRITER_RING_SIZE);
+
+    writer_head = 0;
+    writer_count = 0;
+    writer_count_max = 0;
+    writer_quit = 0;
+    writer_error = 0;
+
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        log_error(LOG_DEFAULT, "ffmpegexedrv: could not start writer thread, writing synchronously.");
+        lib_free(writer_ring);
+        writer_ring = NULL;
+        return;
+    }
+    writer_running = 1;
+}
+
+/* Get the next free slot, blocking emulation while the ring is full.
+   Returns NULL after a write error. */
+static uint8_t *writer_get_slot(void)
+{
+    uint8_t *slot = NULL;
+
+    pthread_mutex_lock(&writer_lock);
+    while (writer_count == WRITER_RING_SIZE && !writer_error) {
+        pthread_cond_wait(&writer_drained, &writer_lock);
+    }
+    if (!writer_error) {
+        slot = writer_ring + ((writer_head + writer_count) % WRITER_RING_SIZE) * writer_slot_size;
+    }
+    pthread_mutex_unlock(&writer_lock);
+
+    return slot;
+}
+
+/* queue the slot returned by writer_get_slot() */
+static void writer_submit(int type, size_t len, int repeat)
+{
+    writer_job_t *job;
+
+    pthread_mutex_lock(&writer_lock);
+    job = &writer_jobs[(writer_head + writer_count) % WRITER_RING_SIZE];
+    job->type = type;
+    job->len = len;
+    job->repeat = repeat;
+    writer_count++;
+    if (writer_count > writer_count_max) {
+        writer_count_max = writer_count;
+    }
+    pthread_cond_signal(&writer_filled);
+    pthread_mutex_unlock(&writer_lock);
+}
+
+#endif
+
 #ifdef VICE_IS_SERVER
 /* Try to find two ports that we can use. This doesn't work as expected :/ */
 static void find_ports(void)
@@ -803,6 +1009,9 @@ static int start_ffmpeg_executable(void)
 #endif
 
     log_message(LOG_DEFAULT, "ffmpegexedrv: pipes are ready");
+#ifdef USE_VICE_THREAD
+    writer_start();
+#endif
     return 0;
 }
 
@@ -952,6 +1161,24 @@ static int ffmpegexe_soundmovie_encode(soundmovie_buffer_t *audio_in)
     }
 
     if ((audio_has_codec > 0) && (audio_codec != AV_CODEC_ID_NONE)) {
+#ifdef USE_VICE_THREAD
+        if (writer_running) {
+            uint8_t *slot;
+
+            if (audio_input_channels != 1 && audio_input_channels != 2) {
+                return -1;
+            }
+            slot = writer_get_slot();
+            if (slot == NULL) {
+                return -1;
+            }
+            memcpy(slot, audio_in->buffer, audio_in->used * 2);
+            writer_submit(WRITER_JOB_AUDIO, audio_in->used * 2, 1);
+            audio_input_counter += audio_in->used / audio_input_channels;
+            audio_in->used = 0;
+            return 0;
+        }
+#endif
         /* FIXME: we might have an endianess problem here, we might have to swap lo/hi on BE machines */
         if (audio_input_channels == 1) {
             res = vice_network_send(ffmpeg_audio_socket, &audio_in->buffer[0], audio_in->used * 2, 0 /* flags */);
@@ -1191,6 +1418,11 @@ static int ffmpegexedrv_close(screenshot_t *screenshot)
 {
     DBG(("ffmpegexedrv_close"));
 
+#ifdef USE_VICE_THREAD
+    /* send what is still queued before the sockets are closed */
+    writer_stop();
+#endif
+
     soundmovie_stop();
 
     ffmpegexedrv_close_video();
@@ -1244,6 +1476,30 @@ static int ffmpegexedrv_record(screenshot_t *screenshot)
         return 0;
     }
 
+#ifdef USE_VICE_THREAD
+    if (writer_running && (video_has_codec > 0) && (video_codec != AV_CODEC_ID_NONE)) {
+        VIDEOFrame slot_frame;
+        int repeat = 1;
+
+        slot_frame.data = writer_get_slot();
+        if (slot_frame.data == NULL) {
+            return 0;
+        }
+        video_fill_rgb_image(screenshot, &slot_frame);
+
+        /* the video is late */
+        if (frametime < (audiotime - (time_base * 1.5f))) {
+            /* insert one frame */
+            framecounter++;
+            DBG(("video is late, inserting a frame (framecount:%lu, audiocount:%lu frametime:%f, audiotime:%f)",
+                framecounter, audio_input_counter, frametime, audiotime));
+            repeat = 2;
+        }
+        writer_submit(WRITER_JOB_VIDEO, (size_t)(INPUT_VIDEO_BPP * video_height * video_width), repeat);
+        return 0;
+    }
+#endif
+
     /*DBGFRAMES(("ffmpegexedrv_record (%u)", framecounter));*/
     video_fill_rgb_image(screenshot, video_st_frame);
 
@@ -327,6 +327,12 @@ int         hvsc_sldb_get_lengths     (const char *psid, long **lengths);
 int         hvsc_sldb_get_lengths_md5 (const char *digest, long **lengths);
 char *      hvsc_sldb_get_path_for_md5(const char *digest);
 
+/*
+ * index.c stuff
+ */
+
+void        hvsc_index_remove_cache(void);
+
 /*
  * stil.c stuff
  */
@@ -0,0 +1,753 @@
+/** \file   src/hvsc/index.c
+ * \brief   Indexes for the SLDB and STIL
+ *
+ * Looking up a tune by scanning the multi-megabyte Songlengths.md5 and
+ * STIL.txt files takes seconds per tune, so both files are indexed:
+ *
+ *  - the SLDB index is an array of MD5 digests sorted in byte order, each
+ *    with the file offsets of its entry and of the comment line with the
+ *    HVSC path above it
+ *  - the STIL index is an array of FNV-1a hashes of the HVSC paths of the
+ *    entries, sorted by hash, each with the file offset and line number of
+ *    the path line
+ *
+ * Lookups binary search the index and read only the matching line(s) from the
+ * text file.  An index is built on first use and rebuilt when the size or the
+ * modification time of its text file changes.  In VICE the index is stored in
+ * the user cache dir and mapped into memory on later runs.
+ */
+
+/*
+ *  HVSClib - a library to work with High Voltage SID Collection files
+ *
+ *  This file is part of VICE, the Versatile Commodore Emulator.
+ *  See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.*
+ */
+
+#undef HVSC_DEBUG
+
+#include "vice.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef HVSC_STANDALONE
+# include "archdep.h"
+# include "lib.h"
+# include "log.h"
+# include "util.h"
+# if defined(HAVE_SYS_MMAN_H) && defined(HAVE_UNISTD_H)
+#  define HVSC_INDEX_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+# endif
+#endif
+#include "hvsc.h"
+#include "hvsc_defs.h"
+#include "base.h"
+
+#include "index.h"
+
+
+/** \brief  Magic string at the start of an index file
+ */
+#define INDEX_MAGIC     "HVSClib index 1"
+
+/** \brief  Offset used for SLDB entries without a path comment
+ */
+#define INDEX_NO_OFFSET UINT32_MAX
+
+
+/** \brief  Index types
+ */
+enum {
+    INDEX_SLDB = 1, /**< Songlengths.md5 index */
+    INDEX_STIL = 2  /**< STIL.txt index */
+};
+
+/** \brief  Header of an index file, followed by the records
+ */
+typedef struct index_header_s {
+    char     magic[16]; /**< INDEX_MAGIC */
+    uint32_t type;      /**< index type */
+    uint32_t count;     /**< number of records */
+    int64_t  mtime;     /**< modification time of the text file */
+    int64_t  size;      /**< size of the text file */
+} index_header_t;
+
+/** \brief  SLDB index record
+ */
+typedef struct sldb_record_s {
+    uint8_t  digest[HVSC_DIGEST_SIZE];  /**< MD5 digest */
+    uint32_t entry_offset;              /**< offset of the digest=lengths line */
+    uint32_t path_offset;               /**< offset of the "; path" line */
+} sldb_record_t;
+
+/** \brief  STIL index record
+ */
+typedef struct stil_record_s {
+    uint32_t hash;      /**< FNV-1a hash of the path */
+    uint32_t offset;    /**< offset of the path line */
+    uint32_t lineno;    /**< line number of the path line */
+} stil_record_t;
+
+/** \brief  An index in memory
+ */
+typedef struct index_s {
+    uint32_t    type;           /**< index type */
+    const char *name;           /**< name used in the cache file name */
+    size_t      record_size;    /**< size of a record */
+    char       *source;         /**< path of the indexed text file */
+    const void *records;        /**< sorted records */
+    uint32_t    count;          /**< number of records */
+    void       *data;           /**< header and records */
+    size_t      data_size;      /**< size of \a data */
+    bool        mapped;         /**< \a data is mapped from the cache file */
+} index_t;
+
+
+static index_t sldb_index = {
+    INDEX_SLDB, "sldb", sizeof(sldb_record_t), NULL, NULL, 0, NULL, 0, false
+};
+
+static index_t stil_index = {
+    INDEX_STIL, "stil", sizeof(stil_record_t), NULL, NULL, 0, NULL, 0, false
+};
+
+
+/** \brief  FNV-1a hash of string \a s
+ *
+ * \param[in]   s   string
+ *
+ * \return  hash
+ */
+static uint32_t index_hash(const char *s)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*s != '\0') {
+        hash ^= (uint8_t)*s++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+/** \brief  Convert hexadecimal MD5 digest \a text to bytes
+ *
+ * \param[in]   text    32 hex digits, not necessarily nul-terminated
+ * \param[out]  digest  HVSC_DIGEST_SIZE bytes
+ *
+ * \return  false if \a text doesn't start with 32 hex digits
+ */
+static bool index_parse_digest(const char *text, uint8_t *digest)
+{
+    int i;
+
+    for (i = 0; i < HVSC_DIGEST_SIZE * 2; i++) {
+        int ch = (unsigned char)text[i];
+        int nybble;
+
+        if (ch >= '0' && ch <= '9') {
+            nybble = ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            nybble = ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            nybble = ch - 'A' + 10;
+        } else {
+            return false;
+        }
+        if (i & 1) {
+            digest[i >> 1] |= (uint8_t)nybble;
+        } else {
+            digest[i >> 1] = (uint8_t)(nybble << 4);
+        }
+    }
+    return true;
+}
+
+
+/** \brief  Get size and modification time of \a path
+ *
+ * \param[in]   path    path to file
+ * \param[out]  mtime   modification time
+ * \param[out]  size    size in bytes
+ *
+ * \return  bool
+ */
+static bool index_stat_source(const char *path, int64_t *mtime, int64_t *size)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0) {
+        hvsc_errno = HVSC_ERR_IO;
+        return false;
+    }
+    *mtime = (int64_t)st.st_mtime;
+    *size = (int64_t)st.st_size;
+    return true;
+}
+
+
+/** \brief  Free the data of \a index
+ *
+ * \param[in,out]   index   index
+ */
+static void index_release(index_t *index)
+{
+    if (index->data != NULL) {
+#ifdef HVSC_INDEX_MMAP
+        if (index->mapped) {
+            munmap(index->data, index->data_size);
+        } else {
+            hvsc_free(index->data);
+        }
+#else
+        hvsc_free(index->data);
+#endif
+    }
+    if (index->source != NULL) {
+        hvsc_free(index->source);
+    }
+    index->source = NULL;
+    index->records = NULL;
+    index->count = 0;
+    index->data = NULL;
+    index->data_size = 0;
+    index->mapped = false;
+}
+
+
+/** \brief  Check \a data of \a size bytes is a valid index for \a index
+ *
+ * \param[in]   index   index
+ * \param[in]   data    header and records
+ * \param[in]   size    size of \a data
+ * \param[in]   mtime   modification time of the text file
+ * \param[in]   fsize   size of the text file
+ *
+ * \return  bool
+ */
+static bool index_check(const index_t *index, const void *data, size_t size,
+                        int64_t mtime, int64_t fsize)
+{
+    const index_header_t *header = data;
+
+    return size >= sizeof *header
+        && memcmp(header->magic, INDEX_MAGIC, sizeof INDEX_MAGIC) == 0
+        && header->type == index->type
+        && header->mtime == mtime
+        && header->size == fsize
+        && size == sizeof *header + (size_t)header->count * index->record_size;
+}
+
+
+/** \brief  Set up \a index to use \a data
+ *
+ * \param[in,out]   index   index
+ * \param[in]       data    header and records, owned by \a index from now on
+ * \param[in]       size    size of \a data
+ * \param[in]       mapped  \a data was mapped from a file
+ */
+static void index_use(index_t *index, void *data, size_t size, bool mapped)
+{
+    const index_header_t *header = data;
+
+    index->data = data;
+    index->data_size = size;
+    index->mapped = mapped;
+    index->records = header + 1;
+    index->count = header->count;
+}
+
+
+static int sldb_record_cmp(const void *p1, const void *p2)
+{
+    return memcmp(((const sldb_record_t *)p1)->digest,
+                  ((const sldb_record_t *)p2)->digest,
+                  HVSC_DIGEST_SIZE);
+}
+
+
+static int stil_record_cmp(const void *p1, const void *p2)
+{
+    const stil_record_t *r1 = p1;
+    const stil_record_t *r2 = p2;
+
+    if (r1->hash != r2->hash) {
+        return r1->hash < r2->hash ? -1 : 1;
+    }
+    if (r1->offset != r2->offset) {
+        return r1->offset < r2->offset ? -1 : 1;
+    }
+    return 0;
+}
+
+
+/** \brief  Build \a index from its text file
+ *
+ * \param[in]   index   index
+ * \param[in]   mtime   modification time of the text file
+ * \param[in]   fsize   size of the text file
+ * \param[out]  size    size of the returned data
+ *
+ * \return  header and sorted records or `NULL` on failure
+ */
+static void *index_build(const index_t *index, int64_t mtime, int64_t fsize,
+                         size_t *size)
+{
+    hvsc_text_file_t  handle;
+    index_header_t   *header;
+    uint8_t          *data;
+    uint8_t          *records;
+    size_t            max = 1024;
+    uint32_t          count = 0;
+    long              offset;
+    long              prev_offset = -1;
+    const char       *line;
+
+    /* offsets are stored as 32-bit values */
+    if (fsize >= (int64_t)INDEX_NO_OFFSET) {
+        hvsc_errno = HVSC_ERR_FILE_TOO_LARGE;
+        return NULL;
+    }
+    if (!hvsc_text_file_open(index->source, &handle)) {
+        return NULL;
+    }
+
+    data = hvsc_malloc(sizeof *header + max * index->record_size);
+    records = data + sizeof *header;
+
+    while (true) {
+        offset = ftell(handle.fp);
+        line = hvsc_text_file_read(&handle);
+        if (line == NULL) {
+            break;
+        }
+
+        if (count == max) {
+            max *= 2;
+            data = hvsc_realloc(data, sizeof *header + max * index->record_size);
+            records = data + sizeof *header;
+        }
+
+        if (index->type == INDEX_SLDB) {
+            sldb_record_t *rec = (sldb_record_t *)(records + count * index->record_size);
+
+            if (handle.linelen > HVSC_DIGEST_SIZE * 2
+                    && line[HVSC_DIGEST_SIZE * 2] == '='
+                    && index_parse_digest(line, rec->digest)) {
+                rec->entry_offset = (uint32_t)offset;
+                if (prev_offset >= 0 && handle.prevbuf[0] == ';') {
+                    rec->path_offset = (uint32_t)prev_offset;
+                } else {
+                    rec->path_offset = INDEX_NO_OFFSET;
+                }
+                count++;
+            }
+        } else {
+            stil_record_t *rec = (stil_record_t *)(records + count * index->record_size);
+
+            if (*line == '/') {
+                rec->hash = index_hash(line);
+                rec->offset = (uint32_t)offset;
+                rec->lineno = (uint32_t)handle.lineno;
+                count++;
+            }
+        }
+        prev_offset = offset;
+    }
+
+    if (!feof(handle.fp)) {
+        /* I/O error, hvsc_errno is already set */
+        hvsc_text_file_close(&handle);
+        hvsc_free(data);
+        return NULL;
+    }
+    hvsc_text_file_close(&handle);
+
+    qsort(records, count, index->record_size,
+          index->type == INDEX_SLDB ? sldb_record_cmp : stil_record_cmp);
+
+    header = (index_header_t *)data;
+    memset(header, 0, sizeof *header);
+    memcpy(header->magic, INDEX_MAGIC, sizeof INDEX_MAGIC);
+    header->type = index->type;
+    header->count = count;
+    header->mtime = mtime;
+    header->size = fsize;
+
+    *size = sizeof *header + count * index->record_size;
+    return data;
+}
+
+
+#ifndef HVSC_STANDALONE
+
+/** \brief  Get path of the cache file for \a index
+ *
+ * The file name contains a hash of the path of the text file, so different
+ * HVSC copies get their own index.
+ *
+ * \param[in]   index   index
+ *
+ * \return  heap-allocated path, free with lib_free()
+ */
+static char *index_cache_path(const index_t *index)
+{
+    char *name;
+    char *path;
+
+    name = lib_msprintf("hvsc-%s-%08x.idx", index->name, index_hash(index->source));
+    path = util_join_paths(archdep_user_cache_path(), name, NULL);
+    lib_free(name);
+    return path;
+}
+
+
+/** \brief  Load \a index from its cache file
+ *
+ * \param[in,out]   index   index
+ * \param[in]       mtime   modification time of the text file
+ * \param[in]       fsize   size of the text file
+ *
+ * \return  bool
+ */
+static bool index_load(index_t *index, int64_t mtime, int64_t fsize)
+{
+    char *path = index_cache_path(index);
+    bool  result = false;
+#ifdef HVSC_INDEX_MMAP
+    struct stat st;
+    void       *data;
+    int         fd;
+
+    fd = open(path, O_RDONLY);
+    lib_free(path);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(index_header_t)) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            if (index_check(index, data, (size_t)st.st_size, mtime, fsize)) {
+                index_use(index, data, (size_t)st.st_size, true);
+                result = true;
+            } else {
+                munmap(data, (size_t)st.st_size);
+            }
+        }
+    }
+    close(fd);
+#else
+    uint8_t *data;
+    long     size;
+
+    size = hvsc_read_file(&data, path);
+    lib_free(path);
+    if (size < 0) {
+        return false;
+    }
+    if (index_check(index, data, (size_t)size, mtime, fsize)) {
+        index_use(index, data, (size_t)size, false);
+        result = true;
+    } else {
+        hvsc_free(data);
+    }
+#endif
+    return result;
+}
+
+
+/** \brief  Write \a index to its cache file
+ *
+ * \param[in]   index   index
+ */
+static void index_save(const index_t *index)
+{
+    char *path = index_cache_path(index);
+    char *tmp;
+    FILE *fp;
+    bool  ok;
+
+    /* write to a file of our own first, so concurrent instances never see a
+       partial file */
+#ifdef HVSC_INDEX_MMAP
+    tmp = lib_msprintf("%s.%ld", path, (long)getpid());
+#else
+    tmp = lib_msprintf("%s.%lu", path, (unsigned long)tick_now());
+#endif
+    fp = fopen(tmp, "wb");
+    if (fp != NULL) {
+        ok = fwrite(index->data, 1, index->data_size, fp) == index->data_size;
+        ok = (fclose(fp) == 0) && ok;
+        if (!ok || archdep_rename(tmp, path) != 0) {
+            log_warning(LOG_DEFAULT, "VSID: could not write HVSC index %s.", path);
+            archdep_remove(tmp);
+        }
+    }
+    lib_free(tmp);
+    lib_free(path);
+}
+
+#endif
+
+
+/** \brief  Make sure \a index is up to date with its text file \a source
+ *
+ * \param[in,out]   index   index
+ * \param[in]       source  path to the text file
+ *
+ * \return  bool
+ */
+static bool index_update(index_t *index, const char *source)
+{
+    int64_t mtime;
+    int64_t fsize;
+    void   *data;
+    size_t  size;
+#ifndef HVSC_STANDALONE
+    tick_t  start = tick_now();
+#endif
+
+    if (source == NULL || !index_stat_source(source, &mtime, &fsize)) {
+        index_release(index);
+        return false;
+    }
+
+    if (index->data != NULL
+            && strcmp(index->source, source) == 0
+            && index_check(index, index->data, index->data_size, mtime, fsize)) {
+        return true;
+    }
+
+    index_release(index);
+    index->source = hvsc_strdup(source);
+
+#ifndef HVSC_STANDALONE
+    if (index_load(index, mtime, fsize)) {
+        log_message(LOG_DEFAULT,
+                "VSID: Loaded index of '%s' (%lu entries) in %.1f ms.",
+                source, (unsigned long)index->count,
+                TICK_TO_MICRO(tick_now_delta(start)) / 1000.0);
+        return true;
+    }
+#endif
+
+    data = index_build(index, mtime, fsize, &size);
+    if (data == NULL) {
+        index_release(index);
+        return false;
+    }
+    index_use(index, data, size, false);
+
+#ifndef HVSC_STANDALONE
+    log_message(LOG_DEFAULT,
+            "VSID: Built index of '%s' (%lu entries) in %.1f ms.",
+            source, (unsigned long)index->count,
+            TICK_TO_MICRO(tick_now_delta(start)) / 1000.0);
+    index_save(index);
+#endif
+    return true;
+}
+
+
+/** \brief  Read the line at \a offset of the SLDB
+ *
+ * \param[in]   offset  file offset
+ *
+ * \return  heap-allocated line or `NULL` on failure
+ */
+static char *sldb_read_line(uint32_t offset)
+{
+    hvsc_text_file_t  handle;
+    const char       *line;
+    char             *s = NULL;
+
+    if (!hvsc_text_file_open(sldb_index.source, &handle)) {
+        return NULL;
+    }
+    if (fseek(handle.fp, (long)offset, SEEK_SET) == 0) {
+        line = hvsc_text_file_read(&handle);
+        if (line != NULL) {
+            s = hvsc_strdup(line);
+        }
+    } else {
+        hvsc_errno = HVSC_ERR_IO;
+    }
+    hvsc_text_file_close(&handle);
+    return s;
+}
+
+
+/** \brief  Find the SLDB index record for \a digest
+ *
+ * \param[in]   digest  string representation of the MD5 digest (32 bytes)
+ *
+ * \return  record or `NULL` when not found
+ */
+static const sldb_record_t *sldb_find(const char *digest)
+{
+    sldb_record_t key;
+
+    if (!index_update(&sldb_index, hvsc_sldb_path)) {
+        return NULL;
+    }
+    if (!index_parse_digest(digest, key.digest)) {
+        hvsc_errno = HVSC_ERR_INVALID;
+        return NULL;
+    }
+    return bsearch(&key, sldb_index.records, sldb_index.count,
+                   sizeof key, sldb_record_cmp);
+}
+
+
+/** \brief  Get the SLDB line for \a digest
+ *
+ * \param[in]   digest  string representation of the MD5 digest (32 bytes)
+ *
+ * \return  heap-allocated line of text from SLDB or `NULL` when not found
+ */
+char *hvsc_index_sldb_entry(const char *digest)
+{
+    const sldb_record_t *rec = sldb_find(digest);
+
+    if (rec == NULL) {
+        return NULL;
+    }
+    return sldb_read_line(rec->entry_offset);
+}
+
+
+/** \brief  Get the HVSC-relative path for \a digest from the SLDB
+ *
+ * \param[in]   digest  string representation of the MD5 digest (32 bytes)
+ *
+ * \return  heap-allocated path or `NULL` when not found
+ */
+char *hvsc_index_sldb_path(const char *digest)
+{
+    const sldb_record_t *rec = sldb_find(digest);
+    char                *line;
+    char                *path;
+
+    if (rec == NULL || rec->path_offset == INDEX_NO_OFFSET) {
+        return NULL;
+    }
+    line = sldb_read_line(rec->path_offset);
+    if (line == NULL || strlen(line) < 2) {
+        hvsc_free(line);
+        return NULL;
+    }
+    /* skip "; " */
+    path = hvsc_strdup(line + 2);
+    hvsc_free(line);
+    return path;
+}
+
+
+/** \brief  Position STIL \a handle after the line containing \a path
+ *
+ * \param[in,out]   handle  text file handle of the STIL
+ * \param[in]       path    HVSC-relative path of the entry
+ *
+ * \return  true when found, the next read from \a handle returns the first
+ *          line of the entry
+ */
+bool hvsc_index_stil_find(hvsc_text_file_t *handle, const char *path)
+{
+    const stil_record_t *records;
+    uint32_t             hash;
+    size_t               lo;
+    size_t               hi;
+
+    if (!index_update(&stil_index, hvsc_stil_path)) {
+        return false;
+    }
+
+    /* find the first record with a matching hash */
+    records = stil_index.records;
+    hash = index_hash(path);
+    lo = 0;
+    hi = stil_index.count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (records[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* check the candidates, hashes may collide */
+    for (; lo < stil_index.count && records[lo].hash == hash; lo++) {
+        const char *line;
+
+        if (fseek(handle->fp, (long)records[lo].offset, SEEK_SET) != 0) {
+            hvsc_errno = HVSC_ERR_IO;
+            return false;
+        }
+        handle->lineno = (long)records[lo].lineno - 1;
+        line = hvsc_text_file_read(handle);
+        if (line != NULL && strcmp(line, path) == 0) {
+            return true;
+        }
+    }
+
+    hvsc_errno = HVSC_ERR_NOT_FOUND;
+    return false;
+}
+
+
+/** \brief  Free the indexes
+ */
+void hvsc_index_free(void)
+{
+    index_release(&sldb_index);
+    index_release(&stil_index);
+}
+
+
+/** \brief  Remove the cache files of the indexes in use
+ *
+ * For throw-away databases, like the one of the HVSC benchmark, which would
+ * otherwise leave their indexes behind in the user cache dir.
+ */
+void hvsc_index_remove_cache(void)
+{
+#ifndef HVSC_STANDALONE
+    char *path;
+
+    if (sldb_index.source != NULL) {
+        path = index_cache_path(&sldb_index);
+        archdep_remove(path);
+        lib_free(path);
+    }
+    if (stil_index.source != NULL) {
+        path = index_cache_path(&stil_index);
+        archdep_remove(path);
+        lib_free(path);
+    }
+#endif
+}
@@ -0,0 +1,38 @@
+/** \file   src/hvsc/index.h
+ * \brief   Indexes for the SLDB and STIL - header
+ */
+
+/*
+ *  HVSClib - a library to work with High Voltage SID Collection files
+ *
+ *  This file is part of VICE, the Versatile Commodore Emulator.
+ *  See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.*
+ */
+
+#ifndef HVSC_INDEX_H
+#define HVSC_INDEX_H
+
+#include <stdbool.h>
+
+#include "hvsc_defs.h"
+
+char *      hvsc_index_sldb_entry(const char *digest);
+char *      hvsc_index_sldb_path(const char *digest);
+bool        hvsc_index_stil_find(hvsc_text_file_t *handle, const char *path);
+void        hvsc_index_free(void);
+
+#endif
@@ -43,6 +43,7 @@
 #include "hvsc.h"
 #include "hvsc_defs.h"
 #include "base.h"
+#include "index.h"
 
 #include "sldb.h"
 
@@ -96,40 +97,15 @@ static bool create_md5_hash(const char *psid, unsigned char *digest)
  * The \a digest has to be in the same string form as the SLDB. So 32 bytes
  * representing a 16-byte hex data, in lower case.
  *
+ * The entry is looked up in the SLDB index, see index.c.
+ *
  * \param[in]   digest  string representation of the MD5 digest (32 bytes)
  *
  * \return  line of text from SLDB or `NULL` when not found
  */
 static char *find_sldb_entry_md5(const char *digest)
 {
-    hvsc_text_file_t  handle;
-    const char       *line;
-
-    if (!hvsc_text_file_open(hvsc_sldb_path, &handle)) {
-        return NULL;
-    }
-
-    while (true) {
-        line = hvsc_text_file_read(&handle);
-        if (line == NULL) {
-            hvsc_text_file_close(&handle);
-            return NULL;
-        }
-#if 0
-        printf("%s\n", line);
-#endif
-        if (memcmp(digest, line, HVSC_DIGEST_SIZE * 2) == 0) {
-            /* copy the current line before closing the file */
-            char *s = hvsc_strdup(handle.buffer);
-            hvsc_text_file_close(&handle);
-            return s;
-        }
-    }
-/*
-    hvsc_text_file_close(&handle);
-    hvsc_errno = HVSC_ERR_NOT_FOUND;
-    return NULL;
-*/
+    return hvsc_index_sldb_entry(digest);
 }
 
 /** \brief  Find song length entry by PSID name in the comments
@@ -356,8 +332,8 @@ int hvsc_sldb_get_lengths(const char *psid, long **lengths)
 
 /** \brief  Get relative HVSC path for md5 digest in SLDB
  *
- * Iterate \c Songlengths.md5 looking for md5 \a digest and return the relative
- * path contained in the comment line just above the md5 line.
+ * Look up md5 \a digest in the SLDB index and return the relative path
+ * contained in the comment line just above the md5 line.
  *
  * \param[in]   digest  md5 digest (nul-terminated 32-byte hexadecimal literal)
  *
@@ -369,26 +345,10 @@ int hvsc_sldb_get_lengths(const char *psid, long **lengths)
  */
 char *hvsc_sldb_get_path_for_md5(const char *digest)
 {
-    hvsc_text_file_t handle;
-#ifdef HVSC_DEBUG
-    int              lineno = 1;
-#endif
+    char *path = hvsc_index_sldb_path(digest);
 
-    if (hvsc_text_file_open(hvsc_sldb_path, &handle)) {
-        const char *line;
-
-        while ((line = hvsc_text_file_read(&handle)) != NULL) {
-            if (isalnum((unsigned char)*line) &&
-                    strncmp(digest, line, HVSC_DIGEST_SIZE * 2u) == 0) {
-                hvsc_dbg("got matching md5 sum at line %d: %s\n",
-                         lineno, digest);
-                hvsc_dbg("HVSC path for md5 sum: %s\n", handle.prevbuf + 2);
-                return hvsc_strdup(handle.prevbuf + 2);
-            }
-#ifdef HVSC_DEBUG
-            lineno++;
-#endif
-        }
+    if (path != NULL) {
+        hvsc_dbg("HVSC path for md5 sum %s: %s\n", digest, path);
     }
-    return NULL;
+    return path;
 }
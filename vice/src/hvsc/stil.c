@@ -42,6 +42,7 @@
 #include "hvsc.h"
 #include "hvsc_defs.h"
 #include "base.h"
+#include "index.h"
 
 #include "stil.h"
 
@@ -433,8 +434,6 @@ static void stil_handle_add_block(hvsc_stil_t *handle, hvsc_stil_block_t *block)
  */
 bool hvsc_stil_open(const char *psid, hvsc_stil_t *handle)
 {
-    const char *line;
-
     stil_init_handle(handle);
     handle->entry_buffer = hvsc_malloc(HVSC_STIL_BUFFER_INIT *
                                        sizeof *(handle->entry_buffer));
@@ -486,29 +485,21 @@ bool hvsc_stil_open(const char *psid, hvsc_stil_t *handle)
     hvsc_dbg("stripped path is '%s'\n", handle->psid_path);
 
     /* find the entry */
-    while (true) {
-        line = hvsc_text_file_read(&(handle->stil));
-        if (line == NULL) {
-            if (feof(handle->stil.fp)) {
-                /* EOF, so simply not found */
-                hvsc_errno = HVSC_ERR_NOT_FOUND;
+    if (!hvsc_index_stil_find(&(handle->stil), handle->psid_path)) {
 #ifndef HVSC_STANDALONE
-                log_message(LOG_DEFAULT, "VSID: No STIL entry found.");
-#endif
-            }
-            hvsc_stil_close(handle);
-            /* I/O error is already set */
-            return false;
+        if (hvsc_errno == HVSC_ERR_NOT_FOUND) {
+            log_message(LOG_DEFAULT, "VSID: No STIL entry found.");
         }
-
-        if (strcmp(line, handle->psid_path) == 0) {
-#ifndef HVSC_STANDALONE
-            log_message(LOG_DEFAULT,
-                    "VSID: Found '%s' at line %ld.", line, handle->stil.lineno);
 #endif
-            return true;
-        }
+        hvsc_stil_close(handle);
+        /* I/O error is already set */
+        return false;
     }
+#ifndef HVSC_STANDALONE
+    log_message(LOG_DEFAULT, "VSID: Found '%s' at line %ld.",
+            handle->psid_path, handle->stil.lineno);
+#endif
+    return true;
 }
 
 
@@ -542,29 +533,20 @@ bool hvsc_stil_open_md5(const char *digest, hvsc_stil_t *handle)
     }
 
     /* look up entry */
-    while (true) {
-        const char *line = hvsc_text_file_read(&(handle->stil));
-
-        if (line == NULL) {
-            if (feof(handle->stil.fp)) {
-                /* EOF, OK */
-                hvsc_errno = HVSC_ERR_NOT_FOUND;
+    if (!hvsc_index_stil_find(&(handle->stil), handle->psid_path)) {
 #ifndef HVSC_STANDALONE
-                log_message(LOG_DEFAULT, "VSID: No STIL entry found.");
-#endif
-            }
-            hvsc_stil_close(handle);
-            return false;
+        if (hvsc_errno == HVSC_ERR_NOT_FOUND) {
+            log_message(LOG_DEFAULT, "VSID: No STIL entry found.");
         }
-
-        if (strcmp(line, handle->psid_path) == 0) {
-#ifndef HVSC_STANDALONE
-            log_message(LOG_DEFAULT,
-                    "VSID: Found '%s' at line %ld.", line, handle->stil.lineno);
 #endif
-            return true;
-        }
+        hvsc_stil_close(handle);
+        return false;
     }
+#ifndef HVSC_STANDALONE
+    log_message(LOG_DEFAULT, "VSID: Found '%s' at line %ld.",
+            handle->psid_path, handle->stil.lineno);
+#endif
+    return true;
 }
 
 
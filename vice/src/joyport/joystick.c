@@ -201,6 +201,13 @@ static void joystick_latch_matrix(CLOCK offset)
     }
 }
 
+/* re-apply the latched values after the machine state was rolled back, e.g.
+   by run-ahead, so the host joystick state is not lost */
+void joystick_relatch_matrix(void)
+{
+    joystick_latch_matrix(0);
+}
+
 /*-----------------------------------------------------------------------*/
 
 static void joystick_event_record(void)
@@ -55,6 +55,7 @@ void joystick_set_value_or(unsigned int joyport, uint16_t value);
 void joystick_set_value_and(unsigned int joyport, uint16_t value);
 void joystick_clear(unsigned int joyport);
 void joystick_clear_all(void);
+void joystick_relatch_matrix(void);
 
 void joystick_event_playback(CLOCK offset, void *data);
 void joystick_event_delayed_playback(void *data);
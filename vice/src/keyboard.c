@@ -333,6 +333,13 @@ static void keyboard_latch_matrix(CLOCK offset)
     }
 }
 
+/* re-apply the latched keyarr after the machine state was rolled back, e.g.
+   by run-ahead, so the host keyboard state is not lost */
+void keyboard_relatch_matrix(void)
+{
+    keyboard_latch_matrix(0);
+}
+
 /* update keyboard latch, returns 0 on success, -1 on error */
 static int keyboard_set_latch_keyarr(int row, int col, int pressed)
 {
@@ -62,6 +62,8 @@
 #include "printer.h"
 #include "profiler.h"
 #include "resources.h"
+#include "rewind.h"
+#include "runahead.h"
 #include "romset.h"
 #include "screenshot.h"
 #include "sound.h"
@@ -397,6 +399,10 @@ void machine_shutdown(void)
 
     event_shutdown();
 
+    rewind_shutdown();
+
+    runahead_shutdown();
+
     network_shutdown();
 
     autostart_resources_shutdown();
@@ -146,6 +146,18 @@ int machine_write_snapshot(const char *name, int save_roms, int save_disks, int
 /* Read a snapshot.  */
 int machine_read_snapshot(const char *name, int even_mode);
 
+/* Save and restore the state of the emulated chips to and from an in-memory
+   snapshot, for run-ahead.  Unlike machine_read_snapshot() this changes no
+   resources and attaches or detaches nothing.  machine_state_unsupported()
+   returns NULL if the current configuration is fully covered by the state,
+   otherwise the reason why it is not; its result may only change with the
+   resources or the attached cartridges.  Only x64 and x64sc implement them,
+   run-ahead is not available in the other emulators.  */
+struct snapshot_s;
+const char *machine_state_unsupported(void);
+int machine_state_write(struct snapshot_s *s);
+int machine_state_read(struct snapshot_s *s);
+
 /* handle pending interrupts - needed by libsid.a.  */
 void machine_handle_pending_alarms(CLOCK num_write_cycles);
 
@@ -34,6 +34,7 @@
 #include "alarm.h"
 #include "archdep.h"
 #include "autostart.h"
+#include "bench.h"
 #include "debug.h"
 #include "interrupt.h"
 #include "log.h"
@@ -351,6 +352,9 @@ void maincpu_mainloop(void)
         maincpu_int_status->num_dma_per_opcode = 0;
 
         if (maincpu_clk_limit && (maincpu_clk > maincpu_clk_limit)) {
+            if (bench_enabled) {
+                bench_finish();
+            }
             log_error(LOG_DEFAULT, "cycle limit reached.");
             archdep_vice_exit(EXIT_FAILURE);
         }
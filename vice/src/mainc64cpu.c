@@ -34,6 +34,7 @@
 #include "alarm.h"
 #include "archdep.h"
 #include "autostart.h"
+#include "bench.h"
 
 #ifdef FEATURE_CPUMEMHISTORY
 #include "c64pla.h"
@@ -738,8 +739,13 @@ void maincpu_mainloop(void)
 #include "6510dtvcore.c"
 
         maincpu_int_status->num_dma_per_opcode = 0;
+        bench_maincpu_instructions++;
 
         if (maincpu_clk_limit && (maincpu_clk > maincpu_clk_limit)) {
+            if (bench_enabled) {
+                EXPORT_REGISTERS();
+                bench_finish();
+            }
             log_error(LOG_DEFAULT, "cycle limit reached.");
             archdep_vice_exit(EXIT_FAILURE);
         }
@@ -191,6 +191,8 @@ void monitor_cpu_type_set_value(int searchcpu);
 
 void monitor_watch_push_load_addr(uint16_t addr, MEMSPACE mem);
 void monitor_watch_push_store_addr(uint16_t addr, MEMSPACE mem);
+bool monitor_watch_page_load_active(MEMSPACE mem, unsigned int page);
+bool monitor_watch_page_store_active(MEMSPACE mem, unsigned int page);
 
 monitor_interface_t *monitor_interface_new(void);
 void monitor_interface_destroy(monitor_interface_t *monitor_interface);
@@ -60,6 +60,23 @@ static checkpoint_list_t *breakpoints[NUM_MEMSPACES];
 static checkpoint_list_t *watchpoints_load[NUM_MEMSPACES];
 static checkpoint_list_t *watchpoints_store[NUM_MEMSPACES];
 
+/* Size of the checkpoint hit bitmaps, one bit per (16-bit) address.  */
+#define CHECKPOINT_MAP_SIZE   0x10000
+
+/* Hit bitmaps and per-page summaries for each memspace, rebuilt from the
+   checkpoint lists whenever those change.  A clear bit means no checkpoint
+   of that kind can possibly match the address, so the list walk can be
+   skipped entirely.  Addresses above $ffff share the bit of their low 16
+   bits, which only causes the (exact) list walk to run.  */
+typedef struct checkpoint_map_s {
+    uint8_t bits[CHECKPOINT_MAP_SIZE >> 3];
+    uint8_t pages[CHECKPOINT_MAP_SIZE >> 8];
+} checkpoint_map_t;
+
+static checkpoint_map_t breakpoints_map[NUM_MEMSPACES];
+static checkpoint_map_t watchpoints_load_map[NUM_MEMSPACES];
+static checkpoint_map_t watchpoints_store_map[NUM_MEMSPACES];
+
 
 void mon_breakpoint_init(void)
 {
@@ -148,8 +165,107 @@ mon_checkpoint_t *mon_breakpoint_find_checkpoint(int brknum)
     return NULL;
 }
 
+static void checkpoint_map_set_range(checkpoint_map_t *map,
+                                     unsigned int start, unsigned int end)
+{
+    unsigned int loc;
+
+    for (loc = start; loc <= end; loc++) {
+        map->bits[loc >> 3] |= (uint8_t)(1 << (loc & 7));
+        map->pages[loc >> 8] = 1;
+    }
+}
+
+static void checkpoint_map_build(checkpoint_map_t *map, checkpoint_list_t *head)
+{
+    checkpoint_list_t *ptr;
+    unsigned int start, end;
+
+    memset(map, 0, sizeof(checkpoint_map_t));
+
+    for (ptr = head; ptr != NULL; ptr = ptr->next) {
+        start = addr_location(ptr->checkpt->start_addr);
+
+        if (!mon_is_valid_addr(ptr->checkpt->end_addr)) {
+            end = start;
+        } else {
+            end = addr_location(ptr->checkpt->end_addr);
+        }
+
+        if (end < start || (end - start) >= (CHECKPOINT_MAP_SIZE - 1)) {
+            /* wraps around (see mon_is_in_range()) or covers everything */
+            checkpoint_map_set_range(map, 0, CHECKPOINT_MAP_SIZE - 1);
+            continue;
+        }
+
+        start &= (CHECKPOINT_MAP_SIZE - 1);
+        end &= (CHECKPOINT_MAP_SIZE - 1);
+        if (end < start) {
+            checkpoint_map_set_range(map, start, CHECKPOINT_MAP_SIZE - 1);
+            checkpoint_map_set_range(map, 0, end);
+        } else {
+            checkpoint_map_set_range(map, start, end);
+        }
+    }
+}
+
+inline static bool checkpoint_map_test(const checkpoint_map_t *map, unsigned int loc)
+{
+    loc &= (CHECKPOINT_MAP_SIZE - 1);
+    return (map->bits[loc >> 3] >> (loc & 7)) & 1;
+}
+
+/** \brief Check if any checkpoint could match an address
+ *
+ * \param[in]  mem     memspace
+ * \param[in]  addr    address (location) to check
+ * \param[in]  op      kind of checkpoint (load, store or exec)
+ *
+ * \return false if no checkpoint of that kind covers the address
+ */
+bool mon_breakpoint_has_checkpoint(MEMSPACE mem, unsigned int addr, MEMORY_OP op)
+{
+    switch (op) {
+        case e_load:
+            return checkpoint_map_test(&watchpoints_load_map[mem], addr);
+        case e_store:
+            return checkpoint_map_test(&watchpoints_store_map[mem], addr);
+        default: /* e_exec */
+            return checkpoint_map_test(&breakpoints_map[mem], addr);
+    }
+}
+
+/** \brief Check if any checkpoint covers a page of memory
+ *
+ * Used by the memory code to only route the pages that actually contain
+ * watchpoints through the (slow) watchpoint handlers.
+ *
+ * \param[in]  mem     memspace
+ * \param[in]  page    page (high byte of the address) to check
+ * \param[in]  op      kind of checkpoint (load, store or exec)
+ *
+ * \return false if no checkpoint of that kind covers the page
+ */
+bool mon_breakpoint_page_has_checkpoint(MEMSPACE mem, unsigned int page, MEMORY_OP op)
+{
+    page &= 0xff;
+
+    switch (op) {
+        case e_load:
+            return watchpoints_load_map[mem].pages[page] != 0;
+        case e_store:
+            return watchpoints_store_map[mem].pages[page] != 0;
+        default: /* e_exec */
+            return breakpoints_map[mem].pages[page] != 0;
+    }
+}
+
 static void update_checkpoint_state(MEMSPACE mem)
 {
+    checkpoint_map_build(&breakpoints_map[mem], breakpoints[mem]);
+    checkpoint_map_build(&watchpoints_load_map[mem], watchpoints_load[mem]);
+    checkpoint_map_build(&watchpoints_store_map[mem], watchpoints_store[mem]);
+
     /* calls mem_toggle_watchpoints() */
     if (watchpoints_load[mem] != NULL ||
         watchpoints_store[mem] != NULL) {
@@ -459,6 +575,11 @@ bool mon_breakpoint_check_checkpoint(MEMSPACE mem, unsigned int addr, unsigned i
     supported_cpu_type_list_t *cpulist;
     int monbank = mon_interfaces[mem]->current_bank;
 
+    /* Quickly reject addresses no checkpoint can match */
+    if (!mon_breakpoint_has_checkpoint(mem, addr, op)) {
+        return FALSE;
+    }
+
     monitor_cpu = monitor_cpu_for_memspace[mem];
     instpc = new_addr(mem, (monitor_cpu->mon_register_get_val)(mem, e_PC));
     loadstorepc = new_addr(mem, lastpc);
@@ -720,6 +841,7 @@ void mon_breakpoint_unset(MON_ADDR address)
         /* there's a breakpoint, so remove it */
         remove_checkpoint_from_list( &all_checkpoints, ptr->checkpt );
         remove_checkpoint_from_list( &breakpoints[mem], ptr->checkpt );
+        update_checkpoint_state(mem);
     }
 }
 
@@ -180,6 +180,14 @@ static const mon_cmds_t mon_cmd_array[] = {
       FILENAME_ARG
     },
 
+    { "rewind", "",
+      "[<count>]",
+      "Go back <count> (default 1) snapshots in the rewind buffer. Snapshots\n"
+      "are only taken when the RewindInterval resource is set. The restored\n"
+      "snapshot and all newer ones are dropped from the buffer.",
+      NO_FILENAME_ARG
+    },
+
     { "bank", "",
       "[<memspace>] [bankname]",
       "If bankname is not given, print the possible banks for the memspace.\n"
@@ -154,7 +154,7 @@ void set_yydebug(int val);
 %token CMD_CPUHISTORY CMD_MEMMAPZAP CMD_MEMMAPSHOW CMD_MEMMAPSAVE
 %token CMD_COMMENT CMD_LIST CMD_STOPWATCH RESET
 %token CMD_EXPORT CMD_AUTOSTART CMD_AUTOLOAD CMD_MAINCPU_TRACE
-%token CMD_WARP
+%token CMD_WARP CMD_REWIND
 %token CMD_PROFILE FLAT GRAPH FUNC DEPTH DISASS PROFILE_CONTEXT CLEAR
 %token<str> CMD_LABEL_ASGN
 %token<i> L_PAREN R_PAREN ARG_IMMEDIATE REG_A REG_X REG_Y COMMA INST_SEP
@@ -265,6 +265,10 @@ machine_state_rules: CMD_BANK end_cmd
                      { mon_write_snapshot($2,0,0,0); /* FIXME */ }
                    | CMD_UNDUMP filename end_cmd
                      { mon_read_snapshot($2, 0); }
+                   | CMD_REWIND end_cmd
+                     { mon_rewind(1); }
+                   | CMD_REWIND opt_sep expression end_cmd
+                     { mon_rewind($3); }
                    | CMD_STEP end_cmd
                      { mon_instructions_step(-1); }
                    | CMD_STEP opt_sep expression end_cmd
@@ -81,6 +81,7 @@
 #include "joyport.h"
 
 #include "resources.h"
+#include "rewind.h"
 #include "screenshot.h"
 #include "sysfile.h"
 #include "traps.h"
@@ -2756,6 +2757,21 @@ int mon_read_snapshot(const char *name, int even_mode)
     return ret;
 }
 
+void mon_rewind(int count)
+{
+    if (rewind_restore(count) < 0) {
+        mon_out("Cannot go back %d snapshot(s), %d in the rewind buffer.\n",
+                count, rewind_get_count());
+        return;
+    }
+
+    /* Reset the current address */
+    dot_addr[e_comp_space] = new_addr(e_comp_space, ((uint16_t)((monitor_cpu_for_memspace[e_comp_space]->mon_register_get_val)(e_comp_space, e_PC))));
+
+    mon_out("Went back %d snapshot(s), %d left in the rewind buffer.\n",
+            count, rewind_get_count());
+}
+
 
 /* *** WATCHPOINTS *** */
 
@@ -2766,6 +2782,10 @@ void monitor_watch_push_load_addr(uint16_t addr, MEMSPACE mem)
         return;
     }
 
+    if (!mon_breakpoint_has_checkpoint(mem, addr, e_load)) {
+        return;
+    }
+
     if (watch_load_count[mem] == MONITOR_MAX_CHECKPOINTS) {
         return;
     }
@@ -2781,6 +2801,10 @@ void monitor_watch_push_store_addr(uint16_t addr, MEMSPACE mem)
         return;
     }
 
+    if (!mon_breakpoint_has_checkpoint(mem, addr, e_store)) {
+        return;
+    }
+
     if (watch_store_count[mem] == MONITOR_MAX_CHECKPOINTS) {
         return;
     }
@@ -2790,6 +2814,17 @@ void monitor_watch_push_store_addr(uint16_t addr, MEMSPACE mem)
     watch_store_count[mem]++;
 }
 
+/* Used by the memory code to decide which pages need the watch handlers */
+bool monitor_watch_page_load_active(MEMSPACE mem, unsigned int page)
+{
+    return mon_breakpoint_page_has_checkpoint(mem, page, e_load);
+}
+
+bool monitor_watch_page_store_active(MEMSPACE mem, unsigned int page)
+{
+    return mon_breakpoint_page_has_checkpoint(mem, page, e_store);
+}
+
 static bool watchpoints_check_loads(MEMSPACE mem, unsigned int lastpc, unsigned int pc)
 {
     bool trap = false;
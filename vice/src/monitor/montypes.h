@@ -299,6 +299,7 @@ void mon_delete_conditional(cond_node_t *cnode);
 int mon_evaluate_conditional(cond_node_t *cnode);
 int mon_write_snapshot(const char* name, int save_roms, int save_disks, int even_mode);
 int mon_read_snapshot(const char* name, int even_mode);
+void mon_rewind(int count);
 bool mon_is_valid_addr(MON_ADDR a);
 bool mon_is_in_range(MON_ADDR start_addr, MON_ADDR end_addr, unsigned loc);
 void mon_print_bin(int val, char on, char off);
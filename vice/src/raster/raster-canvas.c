@@ -119,12 +119,18 @@ void raster_canvas_handle_end_of_frame(raster_t *raster)
         return;
     }
 
+    /* let the frontend skip the lines, or the whole frame, that did not change */
+    video_canvas_track_changes(raster->canvas);
+    raster->canvas->draw_buffer->track_refresh = 1;
+
     if (raster->dont_cache) {
         video_canvas_refresh_all(raster->canvas);
     } else {
         refresh_canvas(raster);
     }
 
+    raster->canvas->draw_buffer->track_refresh = 0;
+
     if (raster->canvas->videoconfig->interlaced) {
         /* swap the draw buffer pointers */
         raster->canvas->draw_buffer->draw_buffer = raster->canvas->draw_buffer->draw_buffer_non_padded[raster->canvas->videoconfig->interlace_field];
@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "bench.h"
 #include "raster-cache.h"
 #include "raster-canvas.h"
 #include "raster-changes.h"
@@ -41,6 +42,7 @@
 #include "raster-sprite-status.h"
 #include "raster-sprite.h"
 #include "raster.h"
+#include "video.h"
 #include "viewport.h"
 
 
@@ -53,10 +55,15 @@ unsigned int raster_line_get_real_mode(raster_t *raster)
     }
 }
 
-/* Increase `area' so that it also includes [xs; xe] at line y.  */
-inline static void add_line_to_area(raster_canvas_area_t *area, unsigned int y,
+/* Increase the update area so that it also includes [xs; xe] at line y,
+   and flag the current line as drawn.  */
+inline static void add_line_to_area(raster_t *raster, unsigned int y,
                                     unsigned int xs, unsigned int xe)
 {
+    raster_canvas_area_t *area = raster->update_area;
+
+    raster->line_updated = 1;
+
     if (area->is_null) {
         area->ys = area->ye = y;
         area->xs = xs;
@@ -121,7 +128,7 @@ inline static void handle_blank_line_cached(raster_t *raster)
 
         raster_line_draw_blank(raster, 0,
                                raster->geometry->screen_size.width - 1);
-        add_line_to_area(raster->update_area,
+        add_line_to_area(raster,
                          map_current_line_to_area(raster),
                          0, raster->geometry->screen_size.width - 1);
     }
@@ -164,7 +171,7 @@ static void handle_blank_line(raster_t *raster)
 
             raster_changes_remove_all(border_changes);
 
-            add_line_to_area(raster->update_area, map_current_line_to_area(raster),
+            add_line_to_area(raster, map_current_line_to_area(raster),
                              0, raster->geometry->screen_size.width - 1);
         } else {
             handle_blank_line_cached(raster);
@@ -387,10 +394,12 @@ static void handle_visible_line_with_cache(raster_t *raster)
         needs_update = update_for_minor_changes(raster,
                                                 &changed_start,
                                                 &changed_end);
+        /* the borders are drawn again in any case */
+        raster->line_updated = 1;
     }
 
     if (needs_update) {
-        add_line_to_area(raster->update_area, map_current_line_to_area(raster),
+        add_line_to_area(raster, map_current_line_to_area(raster),
                          changed_start, changed_end);
     }
 
@@ -434,12 +443,12 @@ static void handle_visible_line_without_cache(raster_t *raster)
         cache->xsmooth_color = raster->xsmooth_color;
         cache->idle_background_color = raster->idle_background_color;
 
-        add_line_to_area(raster->update_area, map_current_line_to_area(raster),
+        add_line_to_area(raster, map_current_line_to_area(raster),
                          0, raster->geometry->screen_size.width - 1);
     } else {
         /* Still do some minimal caching anyway.  */
         /* Only update the part between the borders.  */
-        add_line_to_area(raster->update_area, map_current_line_to_area(raster),
+        add_line_to_area(raster, map_current_line_to_area(raster),
                          geometry->gfx_position.x,
                          geometry->gfx_position.x
                          + geometry->gfx_size.width - 1);
@@ -625,7 +634,7 @@ static void handle_visible_line_with_changes(raster_t *raster)
     /* Do not cache this line at all.  */
     raster->cache[raster->current_line].is_dirty = 1;
 
-    add_line_to_area(raster->update_area, map_current_line_to_area(raster),
+    add_line_to_area(raster, map_current_line_to_area(raster),
                      0, raster->geometry->screen_size.width - 1);
 }
 
@@ -650,6 +659,8 @@ inline static void handle_visible_line(raster_t *raster)
 
 void raster_line_emulate(raster_t *raster)
 {
+    BENCH_ENTER(BENCH_SECTION_VIDEO);
+
     raster_draw_buffer_ptr_update(raster);
 
     /* Emulate the vertical blank flip-flops.  (Well, sort of.)  */
@@ -666,9 +677,13 @@ void raster_line_emulate(raster_t *raster)
         || (raster->current_line <= raster->geometry->last_displayed_line - raster->geometry->screen_size.height
             && raster->geometry->screen_size.height <= raster->geometry->last_displayed_line)
         ) {
+        raster->line_updated = 0;
+
         /* handle lines with no border or with changes that may affect
            the border as visible lines */
-        if (raster->can_disable_border && (raster->border_disable || raster->changes->have_on_this_line)) {
+        if (raster->skip_frame && !raster->changes->have_on_this_line) {
+            /* nothing to draw, see vsync_will_skip_frame() */
+        } else if (raster->can_disable_border && (raster->border_disable || raster->changes->have_on_this_line)) {
             handle_visible_line(raster);
         } else {
             if ((raster->blank_this_line || raster->blank_enabled)
@@ -679,6 +694,12 @@ void raster_line_emulate(raster_t *raster)
             }
         }
 
+        /* let the frontend skip the lines that did not change */
+        if (raster->line_updated) {
+            video_canvas_track_line(raster->canvas,
+                                    map_current_line_to_area(raster));
+        }
+
         if (++raster->num_cached_lines == (1
                                            + raster->geometry->last_displayed_line
                                            - raster->geometry->first_displayed_line)) {
@@ -735,4 +756,6 @@ void raster_line_emulate(raster_t *raster)
     }
 
     raster->blank_this_line = 0;
+
+    BENCH_LEAVE();
 }
@@ -121,6 +121,7 @@ static void raster_draw_buffer_clear(video_canvas_t *canvas, uint8_t value,
                                      unsigned int fb_pitch)
 {
     memset(canvas->draw_buffer->draw_buffer, value, fb_width * fb_height);
+    canvas->draw_buffer->track_invalid = 1;
 }
 
 void raster_draw_buffer_ptr_update(raster_t *raster)
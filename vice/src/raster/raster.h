@@ -134,6 +134,10 @@ struct raster_s {
     /* Flag: should we display the line in idle state? */
     int draw_idle_state;
 
+    /* If this is != 0, the current frame is not displayed and its lines are
+       not drawn, the draw buffer keeps the last displayed frame.  */
+    int skip_frame;
+
     /* Count character lines (i.e. RC on the VIC-II).  */
     unsigned int ycounter;
 
@@ -161,6 +165,9 @@ struct raster_s {
     /* Area to update.  */
     struct raster_canvas_area_s *update_area;
 
+    /* Set when the current line has been (re)drawn into the draw buffer.  */
+    int line_updated;
+
     /* This is a bit mask representing each pixel on the screen (1 =
        foreground, 0 = background) and is used both for sprite-background
        collision checking and background sprite drawing.  When cache is
@@ -28,6 +28,7 @@
 #include "dac.h"
 #include "spline.h"
 #include <math.h>
+#include <string.h>
 
 namespace reSID
 {
@@ -190,15 +191,83 @@ static double log1p(double x)
 #endif
 
 Filter::model_filter_t Filter::model_filter[2];
+bool Filter::class_init;
 
+// ----------------------------------------------------------------------------
+// Model table cache.
+// ----------------------------------------------------------------------------
+static unsigned int fnv1a(unsigned int h, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i])*16777619u;
+    }
+    return h;
+}
+
+// Identifies the model parameters and the layout of the tables.
+unsigned int Filter::class_tables_key()
+{
+    unsigned int h = 2166136261u;
+    unsigned int variant = 1;
+    size_t size = class_tables_size();
+
+    h = fnv1a(h, &variant, sizeof(variant));
+    h = fnv1a(h, &size, sizeof(size));
+    for (int m = 0; m < 2; m++) {
+        model_filter_init_t& fi = model_filter_init[m];
+        h = fnv1a(h, fi.opamp_voltage, fi.opamp_voltage_size*sizeof(*fi.opamp_voltage));
+        h = fnv1a(h, &fi.opamp_voltage_size, sizeof(fi.opamp_voltage_size));
+        h = fnv1a(h, &fi.voice_voltage_range,
+            offsetof(model_filter_init_t, dac_term) - offsetof(model_filter_init_t, voice_voltage_range));
+        h = fnv1a(h, &fi.dac_term, sizeof(fi.dac_term));
+    }
+    return h;
+}
+
+size_t Filter::class_tables_size()
+{
+    return sizeof(model_filter) + sizeof(vcr_kVg) + sizeof(vcr_n_Ids_term);
+}
+
+// Copy the tables to buf, which must hold class_tables_size() bytes.
+bool Filter::save_class_tables(void* buf)
+{
+    char* p = (char*)buf;
+
+    if (!class_init) {
+        return false;
+    }
+    memcpy(p, model_filter, sizeof(model_filter));
+    p += sizeof(model_filter);
+    memcpy(p, vcr_kVg, sizeof(vcr_kVg));
+    p += sizeof(vcr_kVg);
+    memcpy(p, vcr_n_Ids_term, sizeof(vcr_n_Ids_term));
+    return true;
+}
+
+// Take the tables from buf instead of building them.
+bool Filter::load_class_tables(const void* buf, size_t size)
+{
+    const char* p = (const char*)buf;
+
+    if (class_init || size != class_tables_size()) {
+        return false;
+    }
+    memcpy(model_filter, p, sizeof(model_filter));
+    p += sizeof(model_filter);
+    memcpy(vcr_kVg, p, sizeof(vcr_kVg));
+    p += sizeof(vcr_kVg);
+    memcpy(vcr_n_Ids_term, p, sizeof(vcr_n_Ids_term));
+    class_init = true;
+    return true;
+}
 
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
 Filter::Filter()
 {
-    static bool class_init;
-
     if (!class_init) {
         // Temporary table for op-amp transfer function.
         unsigned int* voltages = new unsigned int[1 << 16];
@@ -21,6 +21,7 @@
 #define RESID_FILTER_H
 
 #include "resid-config.h"
+#include <stddef.h>
 
 namespace reSID
 {
@@ -548,6 +549,14 @@ public:
   // SID audio output (16 bits).
   short output();
 
+  // Model tables, built by the first constructor. They depend only on
+  // constants compiled into reSID, so an application may store them and
+  // hand them back before the first Filter is created.
+  static unsigned int class_tables_key();
+  static size_t class_tables_size();
+  static bool save_class_tables(void* buf);
+  static bool load_class_tables(const void* buf, size_t size);
+
 protected:
   void set_sum_mix();
   void set_w0();
@@ -643,6 +652,7 @@ protected:
   static unsigned short vcr_n_Ids_term[1 << 16];
   // Common parameters.
   static model_filter_t model_filter[2];
+  static bool class_init;
 
 friend class SID;
 };
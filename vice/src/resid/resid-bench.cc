@@ -0,0 +1,238 @@
+//  ---------------------------------------------------------------------------
+//  This file is part of reSID, a MOS6581 SID emulator engine.
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//  ---------------------------------------------------------------------------
+
+// Sampling method benchmark.
+//
+// Replays a recording of SID register writes for a number of emulated
+// seconds with each sampling method and reports how many samples per second
+// are generated.  The recording is what the VICE "dump" sound device writes,
+// i.e. one "<cycles since last write> <register> <value>" line per write;
+// record a PSID with e.g.
+//
+//   vsid -sounddev dump -soundarg tune.dump -limitcycles 60000000 tune.sid
+//
+// Without a recording a fixed built-in pattern is played.
+//
+// Build with "make resid-bench".
+
+#include "sid.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+using namespace reSID;
+
+struct sid_write {
+  cycle_count delta;
+  reg8 offset;
+  reg8 value;
+};
+
+static const double clock_freq = 985248;
+
+static bool read_dump(const char* filename, std::vector<sid_write>& writes)
+{
+  FILE* f = fopen(filename, "r");
+  char line[256];
+
+  if (!f) {
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), f)) {
+    int delta, offset, value;
+
+    // The dump also holds chip state listings, skip those.
+    if (sscanf(line, "%d %d %d", &delta, &offset, &value) != 3
+        || delta < 0) {
+      continue;
+    }
+    sid_write w = { delta, reg8(offset & 0x1f), reg8(value & 0xff) };
+    writes.push_back(w);
+  }
+
+  fclose(f);
+  return !writes.empty();
+}
+
+// Three voices playing an arpeggio with filter sweeps, one write per frame
+// and voice.
+static void make_pattern(std::vector<sid_write>& writes)
+{
+  static const reg8 init[][2] = {
+    { 0x05, 0x09 }, { 0x06, 0xa0 }, { 0x0c, 0x09 }, { 0x0d, 0xa0 },
+    { 0x13, 0x09 }, { 0x14, 0xa0 }, { 0x02, 0x00 }, { 0x03, 0x08 },
+    { 0x17, 0xf7 }, { 0x18, 0x1f }
+  };
+  static const reg8 ctrl[3] = { 0x41, 0x21, 0x11 };
+  const cycle_count frame = 19656;
+
+  for (unsigned int i = 0; i < sizeof(init)/sizeof(init[0]); i++) {
+    sid_write w = { 0, init[i][0], init[i][1] };
+    writes.push_back(w);
+  }
+
+  for (int n = 0; n < 512; n++) {
+    for (int v = 0; v < 3; v++) {
+      reg8 base = reg8(v*7);
+      sid_write freq = { v ? 0 : frame, reg8(base + 1), reg8(0x08 + ((n*(v + 3)) & 0x1f)) };
+      sid_write gate = { 0, reg8(base + 4), reg8(ctrl[v] | ((n & 7) ? 1 : 0)) };
+      writes.push_back(freq);
+      writes.push_back(gate);
+    }
+    sid_write cutoff = { 0, 0x16, reg8(n & 0xff) };
+    writes.push_back(cutoff);
+  }
+}
+
+static double run(const std::vector<sid_write>& writes, sampling_method method,
+                  double sample_freq, int nsids, double seconds, long* samples)
+{
+  std::vector<SID*> sids(nsids);
+  short buf[8192];
+  cycle_count left = cycle_count(seconds*clock_freq);
+  size_t pos = 0;
+
+  *samples = 0;
+
+  for (int i = 0; i < nsids; i++) {
+    sids[i] = new SID();
+    sids[i]->set_chip_model(MOS6581);
+    if (!sids[i]->set_sampling_parameters(clock_freq, method, sample_freq)) {
+      for (int j = 0; j <= i; j++) {
+        delete sids[j];
+      }
+      return -1;
+    }
+  }
+
+  clock_t start = clock();
+
+  while (left > 0) {
+    const sid_write& w = writes[pos];
+    cycle_count delta = w.delta < left ? w.delta : left;
+
+    left -= delta;
+    for (int i = 0; i < nsids; i++) {
+      cycle_count dt = delta;
+      while (dt) {
+        *samples += sids[i]->clock(dt, buf, sizeof(buf)/sizeof(buf[0]));
+      }
+      sids[i]->write(w.offset, w.value);
+    }
+
+    if (++pos == writes.size()) {
+      pos = 0;
+    }
+  }
+
+  double elapsed = double(clock() - start)/CLOCKS_PER_SEC;
+
+  for (int i = 0; i < nsids; i++) {
+    delete sids[i];
+  }
+
+  return elapsed;
+}
+
+static void usage(const char* name)
+{
+  fprintf(stderr,
+          "Usage: %s [-s seconds] [-f sample_freq] [-n sids] [dumpfile]\n",
+          name);
+  exit(1);
+}
+
+int main(int argc, char** argv)
+{
+  static const struct {
+    const char* name;
+    sampling_method method;
+  } methods[] = {
+    { "fast", SAMPLE_FAST },
+    { "interpolate", SAMPLE_INTERPOLATE },
+    { "resample", SAMPLE_RESAMPLE },
+    { "resample fastmem", SAMPLE_RESAMPLE_FASTMEM }
+  };
+  double seconds = 60;
+  double sample_freq = 44100;
+  int nsids = 1;
+  const char* filename = 0;
+  std::vector<sid_write> writes;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+      sample_freq = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+      nsids = atoi(argv[++i]);
+    } else if (argv[i][0] != '-' && !filename) {
+      filename = argv[i];
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (seconds <= 0 || sample_freq <= 0 || nsids < 1) {
+    usage(argv[0]);
+  }
+
+  if (filename) {
+    if (!read_dump(filename, writes)) {
+      fprintf(stderr, "%s: cannot read SID writes from `%s'\n", argv[0], filename);
+      return 1;
+    }
+  } else {
+    make_pattern(writes);
+  }
+
+  // run() only advances time by the deltas, so it would never finish.
+  size_t timed = 0;
+  while (timed < writes.size() && !writes[timed].delta) {
+    timed++;
+  }
+  if (timed == writes.size()) {
+    fprintf(stderr, "%s: the SID writes in `%s' take no cycles\n", argv[0], filename);
+    return 1;
+  }
+
+  printf("reSID %s, %s convolution, %d SID(s), %.0f Hz, %.1f emulated seconds\n",
+         resid_version_string, SID::convolution_kernel(), nsids, sample_freq,
+         seconds);
+
+  for (unsigned int m = 0; m < sizeof(methods)/sizeof(methods[0]); m++) {
+    long samples;
+    double elapsed = run(writes, methods[m].method, sample_freq, nsids,
+                         seconds, &samples);
+
+    if (elapsed < 0) {
+      printf("%-17s: not supported at this sample rate\n", methods[m].name);
+    } else if (elapsed == 0) {
+      printf("%-17s: too fast to measure, increase -s\n", methods[m].name);
+    } else {
+      printf("%-17s: %10.0f samples/s, %6.1fx realtime\n", methods[m].name,
+             samples/elapsed, seconds/elapsed);
+    }
+    fflush(stdout);
+  }
+
+  return 0;
+}
@@ -26,11 +26,22 @@
 
 #include "sid.h"
 #include <cmath>
+#include <cstring>
 
 #include <iostream>
 #include <fstream>
 using namespace std;
 
+// SSE2/AVX2 convolution kernels are compiled with function target attributes
+// and selected at runtime, so no special compiler flags are needed.
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) \
+    && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define RESID_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define RESID_X86_SIMD 0
+#endif
+
 #ifndef round
 #define round(x) (x>=0.0?floor(x+0.5):ceil(x-0.5))
 #endif
@@ -50,6 +61,118 @@ inline short clip(int input)
     return (short)input;
 }
 
+
+// ----------------------------------------------------------------------------
+// FIR convolution kernels.
+// The inner product of a FIR table and the sample ring buffer is where
+// resampling spends most of its time. The sums are computed in 32 bit
+// integer arithmetic in all kernels, so they yield identical results.
+// ----------------------------------------------------------------------------
+typedef int (*convolve_func)(const short* a, const short* b, int n);
+
+static int convolve_scalar(const short* a, const short* b, int n)
+{
+  int out = 0;
+  for (int i = 0; i < n; i++) {
+    out += a[i]*b[i];
+  }
+  return out;
+}
+
+#if RESID_X86_SIMD
+__attribute__((target("sse2")))
+static int convolve_sse2(const short* a, const short* b, int n)
+{
+  __m128i acc = _mm_setzero_si128();
+  int i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(va, vb));
+  }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  int out = _mm_cvtsi128_si32(acc);
+
+  for (; i < n; i++) {
+    out += a[i]*b[i];
+  }
+  return out;
+}
+
+__attribute__((target("avx2")))
+static int convolve_avx2(const short* a, const short* b, int n)
+{
+  __m256i acc = _mm256_setzero_si256();
+  int i = 0;
+
+  for (; i + 16 <= n; i += 16) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+    __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+  }
+
+  __m128i acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                                 _mm256_extracti128_si256(acc, 1));
+  if (i + 8 <= n) {
+    __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+    acc128 = _mm_add_epi32(acc128, _mm_madd_epi16(va, vb));
+    i += 8;
+  }
+
+  acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+  int out = _mm_cvtsi128_si32(acc128);
+
+  for (; i < n; i++) {
+    out += a[i]*b[i];
+  }
+  return out;
+}
+#endif
+
+struct convolve_kernel {
+  const char* name;
+  convolve_func func;
+};
+
+static convolve_kernel select_convolve_kernel()
+{
+  convolve_kernel kernel = { "scalar", convolve_scalar };
+
+#if RESID_X86_SIMD
+  // May run from a static constructor, i.e. before the CPU model is known.
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    kernel.name = "avx2";
+    kernel.func = convolve_avx2;
+  } else if (__builtin_cpu_supports("sse2")) {
+    kernel.name = "sse2";
+    kernel.func = convolve_sse2;
+  }
+#endif
+
+  return kernel;
+}
+
+static const convolve_kernel convolve_selected = select_convolve_kernel();
+
+static inline int convolve(const short* a, const short* b, int n)
+{
+  return convolve_selected.func(a, b, n);
+}
+
+// ----------------------------------------------------------------------------
+// Name of the convolution kernel used for resampling.
+// ----------------------------------------------------------------------------
+const char* SID::convolution_kernel()
+{
+  return convolve_selected.name;
+}
+
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
@@ -923,6 +1046,23 @@ int SID::clock_interpolate(cycle_count& delta_t, short* buf, int n, int interlea
 }
 
 
+// ----------------------------------------------------------------------------
+// Copy COUNT samples written to the ring buffer starting at FIRST to the
+// overflow part, so the convolutions can read RINGSIZE samples contiguously.
+// ----------------------------------------------------------------------------
+void SID::mirror_samples(int first, int count)
+{
+  int n = RINGSIZE - first;
+
+  if (count <= n) {
+    memcpy(sample + RINGSIZE + first, sample + first, count*sizeof(short));
+  } else {
+    memcpy(sample + RINGSIZE + first, sample + first, n*sizeof(short));
+    memcpy(sample + RINGSIZE, sample, (count - n)*sizeof(short));
+  }
+}
+
+
 // ----------------------------------------------------------------------------
 // SID clocking with audio sampling - cycle based with audio resampling.
 //
@@ -971,11 +1111,13 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
       delta_t_sample = delta_t;
     }
 
+    int first = sample_index;
     for (int i = 0; i < delta_t_sample; i++) {
       clock();
-      sample[sample_index] = sample[sample_index + RINGSIZE] = clip(output());
+      sample[sample_index] = clip(output());
       ++sample_index &= RINGMASK;
     }
+    mirror_samples(first, delta_t_sample);
 
     if ((delta_t -= delta_t_sample) == 0) {
       sample_offset -= delta_t_sample << FIXP_SHIFT;
@@ -990,10 +1132,7 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
     short* sample_start = sample + sample_index - fir_N - 1 + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v1 = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v1 += sample_start[j]*fir_start[j];
-    }
+    int v1 = convolve(sample_start, fir_start, fir_N);
 
     // Use next FIR table, wrap around to first FIR table using
     // next sample.
@@ -1004,10 +1143,7 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
     fir_start = fir + fir_offset*fir_N;
 
     // Convolution with filter impulse response.
-    int v2 = 0;
-    for (int k = 0; k < fir_N; k++) {
-      v2 += sample_start[k]*fir_start[k];
-    }
+    int v2 = convolve(sample_start, fir_start, fir_N);
 
     // Linear interpolation.
     // fir_offset_rmd is equal for all samples, it can thus be factorized out:
@@ -1038,11 +1174,13 @@ int SID::clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int int
       delta_t_sample = delta_t;
     }
 
+    int first = sample_index;
     for (int i = 0; i < delta_t_sample; i++) {
       clock();
-      sample[sample_index] = sample[sample_index + RINGSIZE] = output();
+      sample[sample_index] = output();
       ++sample_index &= RINGMASK;
     }
+    mirror_samples(first, delta_t_sample);
 
     if ((delta_t -= delta_t_sample) == 0) {
       sample_offset -= delta_t_sample << FIXP_SHIFT;
@@ -1056,10 +1194,7 @@ int SID::clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int int
     short* sample_start = sample + sample_index - fir_N + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v += sample_start[j]*fir_start[j];
-    }
+    int v = convolve(sample_start, fir_start, fir_N);
 
     v >>= FIR_SHIFT;
 
@@ -103,12 +103,16 @@ public:
 
   void debugoutput(void);
 
+  // Name of the FIR convolution kernel selected for this CPU.
+  static const char* convolution_kernel();
+
  protected:
   static double I0(double x);
   int clock_fast(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_interpolate(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_resample(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int interleave);
+  void mirror_samples(int first, int count);
   void write();
 
   chip_model sid_model;
@@ -0,0 +1,554 @@
+/** \file   rewind.c
+ * \brief   Rewind buffer of in-memory machine snapshots
+ *
+ * Every `RewindInterval` frames a machine snapshot is written to memory and
+ * appended to a ring of at most `RewindDepth` entries.  The first entry of
+ * each group is a keyframe holding the complete snapshot, the others only
+ * hold the difference to that keyframe: the snapshot XOR'ed with the
+ * keyframe, with runs of zero bytes (unchanged data) squeezed out.  When the
+ * ring is full the oldest group is dropped as a whole.
+ *
+ * Snapshots are taken and restored from a CPU trap, so the machine is always
+ * between two instructions.  ROMs and disk images are not part of the
+ * snapshots, so going back does not undo writes to attached images.
+ */
+
+/*
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+/* #define DEBUG_REWIND */
+
+#include "vice.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cmdline.h"
+#include "interrupt.h"
+#include "lib.h"
+#include "log.h"
+#include "machine.h"
+#include "network.h"
+#include "resources.h"
+#include "snapshot.h"
+#include "sound.h"
+#include "types.h"
+#include "vice-event.h"
+#include "vsync.h"
+
+#include "rewind.h"
+
+#ifdef DEBUG_REWIND
+#define DBG(x)  log_debug x
+#else
+#define DBG(x)
+#endif
+
+/* Maximum number of entries in a group (keyframe + deltas).  */
+#define REWIND_GROUP_MAX        25
+
+/* Zero runs shorter than this are kept inside a literal run, a new record
+   would cost more than it saves.  */
+#define REWIND_MIN_ZERO_RUN     8
+
+typedef struct rewind_entry_s {
+    /* Complete snapshot (keyframe) or encoded difference to the keyframe.  */
+    uint8_t *data;
+
+    /* Size of `data'.  */
+    size_t size;
+
+    /* Size of the decoded snapshot.  */
+    size_t snapshot_size;
+
+    /* Flag: is this a keyframe?  */
+    int keyframe;
+} rewind_entry_t;
+
+static log_t rewind_log = LOG_DEFAULT;
+
+/* Resources.  */
+static int rewind_interval = 0;
+static int rewind_depth = 0;
+
+/* Ring of entries, `ring_first' is the oldest one.  */
+static rewind_entry_t *ring = NULL;
+static int ring_size = 0;
+static int ring_first = 0;
+static int ring_count = 0;
+
+/* Number of entries in the newest group.  */
+static int group_count = 0;
+
+/* Frames since the last snapshot.  */
+static int frame_counter = 0;
+
+/* Flag: a snapshot trap has been triggered but not run yet.  */
+static int capture_pending = 0;
+
+/* Arena the machine snapshots are written to and read from.  */
+static snapshot_memory_t *rewind_memory = NULL;
+
+/* Buffer for encoding/decoding the differences.  */
+static uint8_t *work_buffer = NULL;
+static size_t work_buffer_size = 0;
+
+/* ------------------------------------------------------------------------- */
+
+static rewind_entry_t *ring_entry(int n)
+{
+    return &ring[(ring_first + n) % ring_size];
+}
+
+static void entry_free(rewind_entry_t *e)
+{
+    lib_free(e->data);
+    e->data = NULL;
+    e->size = 0;
+}
+
+/* Number of entries in the group starting with the oldest entry.  */
+static int ring_first_group_count(void)
+{
+    int n = 1;
+
+    while (n < ring_count && !ring_entry(n)->keyframe) {
+        n++;
+    }
+    return n;
+}
+
+static void ring_drop_first_group(void)
+{
+    int n = ring_first_group_count();
+
+    while (n-- > 0) {
+        entry_free(ring_entry(0));
+        ring_first = (ring_first + 1) % ring_size;
+        ring_count--;
+    }
+    if (ring_count == 0) {
+        group_count = 0;
+    }
+}
+
+/* Drop the newest N entries.  */
+static void ring_drop_last(int n)
+{
+    int i;
+
+    while (n-- > 0 && ring_count > 0) {
+        entry_free(ring_entry(ring_count - 1));
+        ring_count--;
+    }
+
+    /* recount the newest group */
+    group_count = 0;
+    for (i = ring_count - 1; i >= 0; i--) {
+        group_count++;
+        if (ring_entry(i)->keyframe) {
+            break;
+        }
+    }
+}
+
+static void work_buffer_reserve(size_t size)
+{
+    if (size > work_buffer_size) {
+        work_buffer = lib_realloc(work_buffer, size);
+        work_buffer_size = size;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+static size_t put_varint(uint8_t *p, size_t value)
+{
+    size_t n = 0;
+
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+static int get_varint(const uint8_t *p, size_t size, size_t *pos, size_t *value)
+{
+    size_t result = 0;
+    unsigned int shift = 0;
+
+    while (*pos < size && shift < sizeof(size_t) * 8) {
+        uint8_t b = p[(*pos)++];
+
+        result |= (size_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *value = result;
+            return 0;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+/* Encode the difference between snapshot DATA and keyframe BASE as a list of
+   (zero run, literal run, literal bytes) records, the literals being DATA
+   XOR'ed with BASE.  BASE is taken to be zero past its end.  Returns a newly
+   allocated buffer.  */
+static uint8_t *delta_encode(const uint8_t *data, size_t size,
+                             const uint8_t *base, size_t base_size,
+                             size_t *size_return)
+{
+    size_t i = 0, out = 0;
+    uint8_t *result;
+
+    /* worst case: one record per REWIND_MIN_ZERO_RUN bytes */
+    work_buffer_reserve(size + (size / REWIND_MIN_ZERO_RUN + 1) * 20);
+
+    while (i < size) {
+        size_t zero_start = i, lit_start, lit_end, run;
+
+        /* zero run */
+        while (i < size && (i < base_size ? base[i] : 0) == data[i]) {
+            i++;
+        }
+        lit_start = i;
+
+        /* literal run, up to the next long enough zero run */
+        lit_end = i;
+        run = 0;
+        while (i < size) {
+            if ((i < base_size ? base[i] : 0) == data[i]) {
+                if (++run >= REWIND_MIN_ZERO_RUN) {
+                    break;
+                }
+            } else {
+                run = 0;
+                lit_end = i + 1;
+            }
+            i++;
+        }
+        i = lit_end;
+
+        out += put_varint(work_buffer + out, lit_start - zero_start);
+        out += put_varint(work_buffer + out, lit_end - lit_start);
+        for (; lit_start < lit_end; lit_start++) {
+            work_buffer[out++] = data[lit_start]
+                                 ^ (lit_start < base_size ? base[lit_start] : 0);
+        }
+    }
+
+    result = lib_malloc(out ? out : 1);
+    memcpy(result, work_buffer, out);
+    *size_return = out;
+    return result;
+}
+
+/* Decode DELTA against keyframe BASE into the work buffer.  */
+static int delta_decode(const uint8_t *delta, size_t delta_size,
+                        const uint8_t *base, size_t base_size, size_t size)
+{
+    size_t in = 0, out = 0;
+
+    work_buffer_reserve(size);
+
+    while (in < delta_size) {
+        size_t zeros, literals, end;
+
+        if (get_varint(delta, delta_size, &in, &zeros) < 0
+            || get_varint(delta, delta_size, &in, &literals) < 0
+            || zeros > size - out
+            || literals > size - out - zeros
+            || literals > delta_size - in) {
+            return -1;
+        }
+
+        for (end = out + zeros; out < end; out++) {
+            work_buffer[out] = out < base_size ? base[out] : 0;
+        }
+        for (end = out + literals; out < end; out++) {
+            work_buffer[out] = delta[in++] ^ (out < base_size ? base[out] : 0);
+        }
+    }
+
+    return out == size ? 0 : -1;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void rewind_capture(void)
+{
+    const uint8_t *data;
+    size_t size;
+    rewind_entry_t *e;
+    int ret;
+
+    snapshot_memory_select(rewind_memory);
+    /* the name is passed to archdep_remove() on failure, so keep it empty */
+    ret = machine_write_snapshot("", 0, 0, 0);
+    snapshot_memory_select(NULL);
+
+    if (ret < 0) {
+        log_error(rewind_log, "Cannot take snapshot (error %d), rewind buffer disabled.",
+                  snapshot_get_error());
+        snapshot_set_error(SNAPSHOT_NO_ERROR);
+        resources_set_int("RewindInterval", 0);
+        return;
+    }
+
+    data = snapshot_memory_get_data(rewind_memory, &size);
+
+    if (ring_count == ring_size) {
+        ring_drop_first_group();
+    }
+
+    e = ring_entry(ring_count);
+    e->snapshot_size = size;
+
+    if (group_count == 0 || group_count >= REWIND_GROUP_MAX
+        || group_count >= ring_size / 2) {
+        e->keyframe = 1;
+        e->data = lib_malloc(size);
+        memcpy(e->data, data, size);
+        e->size = size;
+        group_count = 1;
+    } else {
+        rewind_entry_t *key = ring_entry(ring_count - group_count);
+
+        e->keyframe = 0;
+        e->data = delta_encode(data, size, key->data, key->size, &e->size);
+        group_count++;
+    }
+    ring_count++;
+
+    DBG(("rewind: entry %d, %s, %lu/%lu bytes", ring_count,
+         e->keyframe ? "keyframe" : "delta",
+         (unsigned long)e->size, (unsigned long)size));
+}
+
+static void rewind_capture_trap(uint16_t addr, void *data)
+{
+    capture_pending = 0;
+
+    if (rewind_interval > 0) {
+        rewind_capture();
+    }
+}
+
+static void rewind_restore_trap(uint16_t addr, void *data)
+{
+    sound_suspend();
+
+    if (rewind_restore(vice_ptr_to_int(data)) < 0) {
+        snapshot_display_error();
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** \brief  Called once per emulated frame, takes a snapshot when due */
+void rewind_vsync_hook(void)
+{
+    if (rewind_interval <= 0 || capture_pending) {
+        return;
+    }
+
+    if (++frame_counter < rewind_interval) {
+        return;
+    }
+    frame_counter = 0;
+
+    /* states restored during netplay or event recording would go out of
+       sync, so don't bother taking them */
+    if (network_connected() || event_record_active() || event_playback_active()) {
+        return;
+    }
+
+    capture_pending = 1;
+    interrupt_maincpu_trigger_trap(rewind_capture_trap, NULL);
+}
+
+/** \brief  Go back COUNT snapshots
+ *
+ * Restores the COUNT-th newest snapshot and drops it and all newer ones, so
+ * going back again continues from there.  Must be called while the CPU is
+ * between instructions, i.e. from a CPU trap or from the monitor.
+ *
+ * \param[in]   count   number of snapshots to go back, at least 1
+ *
+ * \return  0 on success, -1 on error
+ */
+int rewind_restore(int count)
+{
+    rewind_entry_t *e, *key;
+    int n, k, ret;
+
+    if (count < 1 || count > ring_count) {
+        log_warning(rewind_log, "Cannot go back %d snapshots, only %d available.",
+                    count, ring_count);
+        return -1;
+    }
+
+    if (network_connected() || event_record_active() || event_playback_active()) {
+        log_warning(rewind_log, "Cannot go back during netplay or event recording/playback.");
+        return -1;
+    }
+
+    n = ring_count - count;
+    e = ring_entry(n);
+
+    if (e->keyframe) {
+        snapshot_memory_set_data(rewind_memory, e->data, e->size);
+    } else {
+        for (k = n - 1; !ring_entry(k)->keyframe; k--) {
+        }
+        key = ring_entry(k);
+        if (delta_decode(e->data, e->size, key->data, key->size, e->snapshot_size) < 0) {
+            log_error(rewind_log, "Corrupt rewind buffer entry.");
+            rewind_clear();
+            return -1;
+        }
+        snapshot_memory_set_data(rewind_memory, work_buffer, e->snapshot_size);
+    }
+
+    ring_drop_last(count);
+    frame_counter = 0;
+
+    vsync_suspend_speed_eval();
+
+    snapshot_memory_select(rewind_memory);
+    ret = machine_read_snapshot("", 0);
+    snapshot_memory_select(NULL);
+
+    if (ret < 0) {
+        log_error(rewind_log, "Cannot restore snapshot.");
+        return -1;
+    }
+
+    DBG(("rewind: went back %d snapshots, %d left", count, ring_count));
+    return 0;
+}
+
+/** \brief  Go back COUNT snapshots as soon as the CPU is between instructions
+ *
+ * \param[in]   count   number of snapshots to go back
+ */
+void rewind_trigger_restore(int count)
+{
+    interrupt_maincpu_trigger_trap(rewind_restore_trap, int_to_void_ptr(count));
+}
+
+/** \brief  Drop all snapshots */
+void rewind_clear(void)
+{
+    ring_drop_last(ring_count);
+    ring_first = 0;
+    frame_counter = 0;
+}
+
+/** \brief  Get number of snapshots in the rewind buffer */
+int rewind_get_count(void)
+{
+    return ring_count;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int set_rewind_interval(int val, void *param)
+{
+    if (val < 0) {
+        return -1;
+    }
+
+    if (val > 0 && rewind_memory == NULL) {
+        rewind_memory = snapshot_memory_new();
+    }
+    if (val == 0) {
+        rewind_clear();
+    }
+
+    rewind_interval = val;
+    frame_counter = 0;
+    return 0;
+}
+
+static int set_rewind_depth(int val, void *param)
+{
+    if (val < 2) {
+        return -1;
+    }
+
+    if (val != rewind_depth) {
+        rewind_clear();
+        lib_free(ring);
+        ring = lib_calloc((size_t)val, sizeof(rewind_entry_t));
+        ring_size = val;
+    }
+
+    rewind_depth = val;
+    return 0;
+}
+
+static const resource_int_t resources_int[] = {
+    { "RewindInterval", 0, RES_EVENT_NO, NULL,
+      &rewind_interval, set_rewind_interval, NULL },
+    { "RewindDepth", 64, RES_EVENT_NO, NULL,
+      &rewind_depth, set_rewind_depth, NULL },
+    RESOURCE_INT_LIST_END
+};
+
+int rewind_resources_init(void)
+{
+    rewind_log = log_open("Rewind");
+
+    return resources_register_int(resources_int);
+}
+
+static const cmdline_option_t cmdline_options[] =
+{
+    { "-rewindinterval", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
+      NULL, NULL, "RewindInterval", NULL,
+      "<frames>", "Take a rewind snapshot every <frames> frames (0: disabled)" },
+    { "-rewinddepth", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
+      NULL, NULL, "RewindDepth", NULL,
+      "<count>", "Keep up to <count> rewind snapshots" },
+    CMDLINE_LIST_END
+};
+
+int rewind_cmdline_options_init(void)
+{
+    return cmdline_register_options(cmdline_options);
+}
+
+void rewind_shutdown(void)
+{
+    rewind_clear();
+    lib_free(ring);
+    ring = NULL;
+    ring_size = 0;
+    snapshot_memory_free(rewind_memory);
+    rewind_memory = NULL;
+    lib_free(work_buffer);
+    work_buffer = NULL;
+    work_buffer_size = 0;
+}
@@ -0,0 +1,40 @@
+/** \file   rewind.h
+ * \brief   Rewind buffer of in-memory machine snapshots - header
+ */
+
+/*
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+#ifndef VICE_REWIND_H
+#define VICE_REWIND_H
+
+int rewind_resources_init(void);
+int rewind_cmdline_options_init(void);
+void rewind_shutdown(void);
+
+void rewind_vsync_hook(void);
+
+int rewind_restore(int count);
+void rewind_trigger_restore(int count);
+void rewind_clear(void);
+int rewind_get_count(void);
+
+#endif
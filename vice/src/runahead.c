@@ -0,0 +1,501 @@
+/** \file   runahead.c
+ * \brief   Run-ahead input latency reduction
+ *
+ * With `RunAheadFrames` set to N, every emulated frame is followed by N
+ * frames that are emulated as fast as possible, without sound and without
+ * being shown except for the last one, after which the machine state is
+ * rolled back to the end of the real frame.  Since many programs react to
+ * input only one or more frames later, what is shown is the effect of the
+ * current host input on the screen N frames into the future.
+ *
+ * The state is kept in an in-memory snapshot that is written and read from
+ * CPU traps, so the machine is always between two instructions.  It is not a
+ * regular snapshot but the lighter machine state of machine_state_write(),
+ * which only holds the emulated chips and is restored without changing any
+ * resources, devices or the sound setup:
+ *
+ *  - the vsync of a real frame triggers the save trap, which writes the
+ *    snapshot and starts the speculative frames
+ *  - the vsync of the last speculative frame triggers the restore trap,
+ *    which reads the snapshot back and re-applies the host input
+ *
+ * Speculative frames are neither synchronized to the host nor do they poll
+ * input, see vsync_do_end_of_line() and vsync_do_vsync().
+ *
+ * Only x64 and x64sc implement machine_state_write() and machine_state_read(),
+ * the other emulators have no `RunAheadFrames' resource.
+ *
+ * Run-ahead is suspended while it cannot work correctly or would be too
+ * expensive: with true drive emulation (the drive CPUs would have to be run
+ * ahead too), during netplay and event recording/playback, in warp mode, and
+ * while the machine state does not cover the setup, like with a cartridge, a
+ * tape or a port device other than a joystick.  Virtual devices (kernal
+ * traps, printers) see the speculative frames too.
+ */
+
+/*
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+/* #define DEBUG_RUNAHEAD */
+
+#include "vice.h"
+
+#include <stdio.h>
+
+#include "archdep.h"
+#include "cmdline.h"
+#include "drive.h"
+#include "interrupt.h"
+#include "joyport.h"
+#include "joystick.h"
+#include "keyboard.h"
+#include "lib.h"
+#include "log.h"
+#include "machine.h"
+#include "network.h"
+#include "resources.h"
+#include "snapshot.h"
+#include "sound.h"
+#include "tape.h"
+#include "tapeport.h"
+#include "types.h"
+#include "userport.h"
+#include "vice-event.h"
+#include "vsync.h"
+
+#include "runahead.h"
+
+#ifdef DEBUG_RUNAHEAD
+#define DBG(x)  log_debug x
+#else
+#define DBG(x)
+#endif
+
+/* Upper limit for `RunAheadFrames'.  */
+#define RUNAHEAD_FRAMES_MAX     6
+
+/* Version of the in-memory machine state, it never leaves the process.  */
+#define RUNAHEAD_SNAP_MAJOR     0
+#define RUNAHEAD_SNAP_MINOR     0
+
+typedef enum runahead_phase_e {
+    /* Not running ahead, frames are emulated and shown as usual.  */
+    RUNAHEAD_IDLE,
+
+    /* Emulating a real frame, which is not shown.  */
+    RUNAHEAD_REAL,
+
+    /* A real frame ended, the save trap is pending.  */
+    RUNAHEAD_SAVE_PENDING,
+
+    /* Emulating speculative frames.  */
+    RUNAHEAD_SPECULATING,
+
+    /* The last speculative frame ended, the restore trap is pending.  */
+    RUNAHEAD_RESTORE_PENDING
+} runahead_phase_t;
+
+static log_t runahead_log = LOG_DEFAULT;
+
+/* Resource.  */
+static int runahead_frames = 0;
+
+static runahead_phase_t phase = RUNAHEAD_IDLE;
+
+/* Speculative frames left to emulate, including the current one.  */
+static int frames_left = 0;
+
+/* Host time the save trap started at.  */
+static tick_t save_tick;
+
+/* Why run-ahead is currently suspended, NULL if it is not.  */
+static const char *suspend_reason = NULL;
+
+/* Cached result of get_setup_reason(), valid while `setup_reason_valid' is
+   set.  It is cleared when any resource changes and by runahead_cancel().  */
+static const char *setup_reason = NULL;
+static int setup_reason_valid = 0;
+
+/* The machine state at the end of the last real frame.  */
+static snapshot_memory_t *runahead_memory = NULL;
+
+/* ------------------------------------------------------------------------- */
+
+/* Drive CPUs are only synchronized when the main CPU accesses the bus, so
+   they would have to be rolled back too.  */
+static int true_drive_emulation_active(void)
+{
+    int unit, tde, type;
+
+    for (unit = DRIVE_UNIT_MIN; unit < DRIVE_UNIT_MIN + NUM_DISK_UNITS; unit++) {
+        if (resources_get_int_sprintf("Drive%iTrueEmulation", &tde, unit) == 0
+            && resources_get_int_sprintf("Drive%iType", &type, unit) == 0
+            && tde && type != DRIVE_TYPE_NONE) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* The machine state does not include the devices on the tape, user and
+   control ports, nor the tape position (see get_suspend_reason()).  */
+static const char *port_device_active(void)
+{
+    int port, device;
+
+    for (port = 0; port < TAPEPORT_MAX_PORTS; port++) {
+        if (resources_get_int_sprintf("TapePort%dDevice", &device, port + 1) == 0
+            && device != TAPEPORT_DEVICE_NONE && device != TAPEPORT_DEVICE_DATASETTE) {
+            return "a tape port device is active";
+        }
+    }
+    if (resources_get_int("UserportDevice", &device) == 0
+        && device != USERPORT_DEVICE_NONE) {
+        return "a user port device is active";
+    }
+    for (port = JOYPORT_1; port <= JOYPORT_2; port++) {
+        if (resources_get_int_sprintf("JoyPort%dDevice", &device, port + 1) == 0
+            && device != JOYPORT_ID_NONE && device != JOYPORT_ID_JOYSTICK) {
+            return "a control port device other than a joystick is active";
+        }
+    }
+    return NULL;
+}
+
+/* The reasons that only depend on the resources and the attached cartridges,
+   which take a dozen resource lookups.  */
+static const char *get_setup_reason(void)
+{
+    const char *reason;
+
+    if (true_drive_emulation_active()) {
+        return "true drive emulation is enabled";
+    }
+    reason = machine_state_unsupported();
+    if (reason != NULL) {
+        return reason;
+    }
+    return port_device_active();
+}
+
+static void setup_reason_invalidate(const char *name, void *param)
+{
+    setup_reason_valid = 0;
+}
+
+static const char *get_suspend_reason(void)
+{
+    int port;
+
+    if (network_connected()) {
+        return "netplay is active";
+    }
+    if (event_record_active() || event_playback_active()) {
+        return "events are recorded or played back";
+    }
+    if (vsync_get_warp_mode()) {
+        return "warp mode is enabled";
+    }
+    /* attaching a tape image changes no resource */
+    for (port = 0; port < TAPEPORT_MAX_PORTS; port++) {
+        const char *name = tape_get_file_name(port);
+
+        if (name != NULL && *name != '\0') {
+            return "a tape image is attached";
+        }
+    }
+    if (!setup_reason_valid) {
+        setup_reason = get_setup_reason();
+        setup_reason_valid = 1;
+    }
+    return setup_reason;
+}
+
+static void runahead_stop(void)
+{
+    phase = RUNAHEAD_IDLE;
+    frames_left = 0;
+    vsync_set_runahead_cost(0.0);
+}
+
+static void runahead_save_trap(uint16_t addr, void *data)
+{
+    snapshot_t *s;
+    const char *reason;
+    int ret;
+
+    if (phase != RUNAHEAD_SAVE_PENDING) {
+        /* cancelled meanwhile */
+        return;
+    }
+
+    if (runahead_frames <= 0) {
+        runahead_stop();
+        return;
+    }
+
+    reason = get_suspend_reason();
+    if (reason != suspend_reason) {
+        if (reason != NULL) {
+            log_message(runahead_log, "Suspended, %s.", reason);
+        } else if (suspend_reason != NULL) {
+            log_message(runahead_log, "Resumed.");
+        }
+        suspend_reason = reason;
+    }
+    if (reason != NULL) {
+        runahead_stop();
+        return;
+    }
+
+    save_tick = tick_now();
+
+    snapshot_memory_select(runahead_memory);
+    s = snapshot_create("", RUNAHEAD_SNAP_MAJOR, RUNAHEAD_SNAP_MINOR, machine_get_name());
+    snapshot_memory_select(NULL);
+    ret = -1;
+    if (s != NULL) {
+        ret = machine_state_write(s);
+        snapshot_close(s);
+    }
+
+    if (ret < 0) {
+        log_error(runahead_log, "Cannot save the machine state (error %d), run-ahead disabled.",
+                  snapshot_get_error());
+        snapshot_set_error(SNAPSHOT_NO_ERROR);
+        resources_set_int("RunAheadFrames", 0);
+        runahead_stop();
+        return;
+    }
+
+    sound_speculation_start();
+
+    frames_left = runahead_frames;
+    phase = RUNAHEAD_SPECULATING;
+}
+
+static void runahead_restore_trap(uint16_t addr, void *data)
+{
+    snapshot_t *s;
+    uint8_t major, minor;
+    double percent;
+    int ret;
+
+    if (phase != RUNAHEAD_RESTORE_PENDING) {
+        /* cancelled meanwhile */
+        return;
+    }
+
+    snapshot_memory_select(runahead_memory);
+    s = snapshot_open("", &major, &minor, machine_get_name());
+    snapshot_memory_select(NULL);
+    ret = -1;
+    if (s != NULL) {
+        ret = machine_state_read(s);
+        snapshot_close(s);
+    }
+
+    sound_speculation_end();
+
+    /* the snapshot holds the input state of the real frame */
+    keyboard_relatch_matrix();
+    joystick_relatch_matrix();
+
+    if (ret < 0) {
+        /* don't fail again each frame */
+        log_error(runahead_log, "Cannot restore the machine state, run-ahead disabled.");
+        snapshot_set_error(SNAPSHOT_NO_ERROR);
+        resources_set_int("RunAheadFrames", 0);
+        runahead_stop();
+        return;
+    }
+
+    /* time spent running ahead, relative to the duration of a frame */
+    percent = (double)tick_now_delta(save_tick) * vsync_get_refresh_frequency()
+              / tick_per_second() * 100.0;
+    vsync_set_runahead_cost(percent);
+
+    phase = RUNAHEAD_REAL;
+
+    DBG(("runahead: %d frames took %.1f%% of a frame", runahead_frames, percent));
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** \brief  Called at the start of vsync_do_vsync()
+ *
+ * \return  true if the frame that just ended was a speculative one, in which
+ *          case the remaining vsync handling must be skipped
+ */
+bool runahead_vsync_hook(void)
+{
+    switch (phase) {
+        case RUNAHEAD_IDLE:
+        case RUNAHEAD_REAL:
+            if (runahead_frames > 0) {
+                phase = RUNAHEAD_SAVE_PENDING;
+                interrupt_maincpu_trigger_trap(runahead_save_trap, NULL);
+            }
+            return false;
+        case RUNAHEAD_SPECULATING:
+            if (--frames_left <= 0) {
+                phase = RUNAHEAD_RESTORE_PENDING;
+                interrupt_maincpu_trigger_trap(runahead_restore_trap, NULL);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** \brief  Is run-ahead in progress, i.e. only the last speculative frame
+ *          should be shown?
+ */
+bool runahead_is_active(void)
+{
+    return phase != RUNAHEAD_IDLE;
+}
+
+/** \brief  Is the current frame a speculative one? */
+bool runahead_is_speculating(void)
+{
+    return phase == RUNAHEAD_SPECULATING || phase == RUNAHEAD_RESTORE_PENDING;
+}
+
+/** \brief  Is the current frame the one to be shown? */
+bool runahead_is_presenting(void)
+{
+    return phase == RUNAHEAD_SPECULATING && frames_left == 1;
+}
+
+/** \brief  Is the frame starting now certainly not shown?
+ *
+ * Called right after vsync, before a pending save or restore trap has run.
+ * The first speculative frame is not known yet at that point since the save
+ * trap can still fail.
+ */
+bool runahead_frame_is_hidden(void)
+{
+    switch (phase) {
+        case RUNAHEAD_SPECULATING:
+            return frames_left > 1;
+        case RUNAHEAD_RESTORE_PENDING:
+            /* the real frame after restoring */
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** \brief  Stop running ahead, the current machine state becomes the real one
+ *
+ * Called when the emulation is interrupted or the machine state is changed
+ * from outside, like a reset or a snapshot being loaded.  The next frame is
+ * shown, run-ahead starts again after it.
+ */
+void runahead_cancel(void)
+{
+    /* a reset may come with a cartridge change */
+    setup_reason_valid = 0;
+
+    if (phase == RUNAHEAD_IDLE) {
+        return;
+    }
+
+    if (runahead_is_speculating()) {
+        sound_speculation_end();
+    }
+
+    DBG(("runahead: cancelled"));
+    phase = RUNAHEAD_IDLE;
+    frames_left = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int set_runahead_frames(int val, void *param)
+{
+    if (val < 0 || val > RUNAHEAD_FRAMES_MAX) {
+        return -1;
+    }
+
+    if (val > 0 && runahead_memory == NULL) {
+        runahead_memory = snapshot_memory_new();
+    }
+    if (val == 0) {
+        vsync_set_runahead_cost(0.0);
+    }
+
+    /* a pending run stops by itself at the next save trap */
+    runahead_frames = val;
+    return 0;
+}
+
+static const resource_int_t resources_int[] = {
+    { "RunAheadFrames", 0, RES_EVENT_NO, NULL,
+      &runahead_frames, set_runahead_frames, NULL },
+    RESOURCE_INT_LIST_END
+};
+
+/* The emulated chips of the other machines are not covered by
+   machine_state_write() and machine_state_read().  */
+static int runahead_supported(void)
+{
+    return machine_class == VICE_MACHINE_C64 || machine_class == VICE_MACHINE_C64SC;
+}
+
+int runahead_resources_init(void)
+{
+    if (!runahead_supported()) {
+        return 0;
+    }
+
+    runahead_log = log_open("RunAhead");
+
+    if (resources_register_int(resources_int) < 0) {
+        return -1;
+    }
+    /* any resource may change the result of get_setup_reason() */
+    return resources_register_callback(NULL, setup_reason_invalidate, NULL);
+}
+
+static const cmdline_option_t cmdline_options[] =
+{
+    { "-runahead", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
+      NULL, NULL, "RunAheadFrames", NULL,
+      "<frames>", "Show the emulation <frames> frames ahead to hide input latency (0: disabled, max 6)" },
+    CMDLINE_LIST_END
+};
+
+int runahead_cmdline_options_init(void)
+{
+    if (!runahead_supported()) {
+        return 0;
+    }
+    return cmdline_register_options(cmdline_options);
+}
+
+void runahead_shutdown(void)
+{
+    runahead_cancel();
+    snapshot_memory_free(runahead_memory);
+    runahead_memory = NULL;
+}
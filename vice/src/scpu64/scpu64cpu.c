@@ -106,6 +106,13 @@ inline static void check_ba(void)
     }
 }
 
+inline static void check_ba_write(void)
+{
+    if (!scpu64_fastmode && !scpu64_emulation_mode && maincpu_ba_low_flags) {
+        maincpu_steal_cycles();
+    }
+}
+
 static inline void scpu64_maincpu_inc(void)
 {
     while (maincpu_clk >= alarm_context_next_pending_clk(maincpu_alarm_context)) {
@@ -334,29 +341,61 @@ void scpu64_clock_read_ioram(void) /* scpu64 v1 $d200-$d3ff one extra 20 Mhz cyc
 /* SCPU64 needs external reg_pc */
 #define NEED_REG_PC
 
-#define STORE(addr, value) \
-    do { \
-        uint32_t tmpx1 = (addr); \
-        uint8_t tmpx2 = (value); \
-        if (tmpx1 & ~0xffff) { \
-            mem_store2(tmpx1, tmpx2); \
-        } else { \
-            (*_mem_write_tab_ptr[tmpx1 >> 8])((uint16_t)tmpx1, tmpx2); \
-        } \
-    } while (0)
+/* Plain SRAM and SIMM RAM is accessed through the direct pointers of
+   scpu64mem.c, with the same BA checks and SIMM cycle stretching as the
+   handlers in mem_read_tab/mem_write_tab and mem_read2()/mem_store2().  */
+static inline void store_mem(uint32_t addr, uint8_t value)
+{
+    uint8_t *p;
 
-#define LOAD(addr) \
-    (((addr) & ~0xffff)?mem_read2(addr):(*_mem_read_tab_ptr[(addr) >> 8])((uint16_t)(addr)))
+    if (addr & ~0xffff) {
+        p = mem_bank_write_direct_tab[addr >> 16];
+        if (p != NULL) {
+            p[addr & 0xffff] = value;
+            scpu64_clock_write_stretch_simm(addr);
+        } else {
+            mem_store2(addr, value);
+        }
+    } else {
+        p = mem_write_direct_tab[addr >> 8];
+        if (p != NULL) {
+            check_ba_write();
+            p[addr] = value;
+        } else {
+            (*_mem_write_tab_ptr[addr >> 8])((uint16_t)addr, value);
+        }
+    }
+}
+
+static inline uint8_t load_mem(uint32_t addr)
+{
+    uint8_t *p;
+
+    if (addr & ~0xffff) {
+        p = mem_bank_read_direct_tab[addr >> 16];
+        if (p != NULL) {
+            scpu64_clock_read_stretch_simm(addr);
+            return p[addr & 0xffff];
+        }
+        return mem_read2(addr);
+    }
+    p = mem_read_direct_tab[addr >> 8];
+    if (p != NULL) {
+        check_ba();
+        return p[addr];
+    }
+    return (*_mem_read_tab_ptr[addr >> 8])((uint16_t)addr);
+}
+
+#define STORE(addr, value) store_mem((uint32_t)(addr), (uint8_t)(value))
+
+#define LOAD(addr) load_mem((uint32_t)(addr))
 
 #define STORE_LONG(addr, value) store_long((uint32_t)(addr), (uint8_t)(value))
 
 static inline void store_long(uint32_t addr, uint8_t value)
 {
-    if (addr & ~0xffff) {
-        mem_store2(addr, value);
-    } else {
-        (*_mem_write_tab_ptr[addr >> 8])((uint16_t)addr, value);
-    }
+    store_mem(addr, value);
     scpu64_clock_inc(1);
 }
 
@@ -366,11 +405,7 @@ static inline uint8_t load_long(uint32_t addr)
 {
     uint8_t tmp;
 
-    if ((addr) & ~0xffff) {
-        tmp = mem_read2(addr);
-    } else {
-        tmp = (*_mem_read_tab_ptr[(addr) >> 8])((uint16_t)addr);
-    }
+    tmp = load_mem(addr);
     scpu64_clock_inc(0);
     return tmp;
 }
@@ -121,6 +121,15 @@ static uint32_t mem_read_limit_tab[NUM_CONFIGS][0x101];
 static store_func_ptr_t mem_write_tab_watch[0x101];
 static read_func_ptr_t mem_read_tab_watch[0x101];
 
+/* Direct pointers for CPU accesses to plain RAM, NULL if the access has to
+   go through the tables above or mem_read2()/mem_store2().  The bank 0
+   tables are per page and indexed with the full address, the SIMM bank
+   tables are per bank and indexed with the bank offset.  */
+uint8_t *mem_read_direct_tab[0x100];
+uint8_t *mem_write_direct_tab[0x100];
+uint8_t *mem_bank_read_direct_tab[0x100];
+uint8_t *mem_bank_write_direct_tab[0x100];
+
 /* Current mirror config */
 static int mirror;
 
@@ -162,6 +171,55 @@ inline static void check_ba_write(void)
 }
 /* ------------------------------------------------------------------------- */
 
+/* Update the bank 0 direct pointers from the current read and write tables,
+   only the handlers that do nothing but the BA check and the access qualify.
+   The watchpoint tables never match, so watchpoints disable them.  */
+static void mem_update_direct_tabs(void)
+{
+    int i;
+
+    for (i = 0; i < 0x100; i++) {
+        read_func_ptr_t read_func = _mem_read_tab_ptr[i];
+
+        if (read_func == ram_read) {
+            mem_read_direct_tab[i] = mem_sram;
+        } else if (read_func == scpu64_kernalshadow_read) {
+            mem_read_direct_tab[i] = mem_sram + 0x8000;
+        } else if (read_func == ram1_read) {
+            mem_read_direct_tab[i] = mem_sram + 0x10000;
+        } else {
+            mem_read_direct_tab[i] = NULL;
+        }
+        mem_write_direct_tab[i] = (_mem_write_tab_ptr[i] == ram_store) ? mem_sram : NULL;
+    }
+}
+
+/* Update the SIMM bank direct pointers, only possible without page
+   translation.  Bank 1 is left to mem_read2()/mem_store2() for the
+   $0000/$0001 and trap RAM special cases, writes to $f6/$f7 for the
+   hardware enable check.  */
+static void mem_update_bank_direct_tabs(void)
+{
+    unsigned int bank;
+
+    for (bank = 0; bank < 0x100; bank++) {
+        uint32_t addr = bank << 16;
+        uint8_t *p = NULL;
+
+        if (mem_simm_ram_mask && mem_simm_page_size == mem_conf_page_size) {
+            if (bank == 0xf6 || bank == 0xf7) {
+                p = mem_simm_ram + (addr & 0x10000);
+            } else if (bank >= 2 && bank < 0xf6 && addr < (unsigned int)mem_conf_size) {
+                p = mem_simm_ram + (addr & mem_simm_ram_mask);
+            }
+        }
+        mem_bank_read_direct_tab[bank] = p;
+        mem_bank_write_direct_tab[bank] = (bank < 0xf6) ? p : NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
 static uint8_t zero_read_watch(uint16_t addr)
 {
     addr &= 0xff;
@@ -198,6 +256,7 @@ void mem_toggle_watchpoints(int flag, void *context)
         _mem_write_tab_ptr = mem_write_tab[mirror][mem_config];
     }
     watchpoints_active = flag;
+    mem_update_direct_tabs();
 }
 
 /* ------------------------------------------------------------------------- */
@@ -223,6 +282,7 @@ void mem_pla_config_changed(void)
 
     _mem_read_base_tab_ptr = mem_read_base_tab[mem_config];
     mem_read_limit_tab_ptr = mem_read_limit_tab[mem_config];
+    mem_update_direct_tabs();
 
     maincpu_resync_limits();
 }
@@ -1471,6 +1531,7 @@ void mem_set_mirroring(int new_mirroring)
     if (_mem_write_tab_ptr != mem_write_tab_watch) {
         _mem_write_tab_ptr = mem_write_tab[mirror][mem_config];
     }
+    mem_update_direct_tabs();
 }
 
 void mem_set_simm(int config)
@@ -1498,6 +1559,7 @@ void mem_set_simm(int config)
         break;
     }
     scpu64_set_simm_row_size(mem_conf_page_size);
+    mem_update_bank_direct_tabs();
 }
 
 void scpu64_hardware_reset(void)
@@ -2150,6 +2212,7 @@ void mem_set_simm_size(int val)
             mem_simm_page_size = 11 + 2;  /* 4,3 */
             break;
     }
+    mem_update_bank_direct_tabs();
     maincpu_resync_limits();
 }
 
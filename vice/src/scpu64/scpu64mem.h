@@ -53,6 +53,10 @@ extern int mem_reg_simm;               /* simm configuration */
 extern int mem_pport;                  /* processor "port" */
 
 extern unsigned int mem_simm_ram_mask;
+extern uint8_t *mem_read_direct_tab[];
+extern uint8_t *mem_write_direct_tab[];
+extern uint8_t *mem_bank_read_direct_tab[];
+extern uint8_t *mem_bank_write_direct_tab[];
 
 int c64_mem_init_resources(void);
 int c64_mem_init_cmdline_options(void);
@@ -35,15 +35,26 @@
 
 extern "C" {
 
+#include <stdio.h>
 #include <string.h>
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_UNISTD_H)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RESID_TABLES_MMAP
+#endif
 
 #include "sid/sid.h" /* sid_engine_t */
+#include "archdep.h"
 #include "lib.h"
 #include "log.h"
 #include "resid.h"
 #include "resources.h"
 #include "sid-snapshot.h"
 #include "types.h"
+#include "util.h"
+#include "version.h"
 
 } // extern "C"
 
@@ -61,26 +72,170 @@ struct sound_s
 
     /* resid sid implementation */
     reSID::SID *sid;
+
+    /* temporary buffer, per chip so chips can be rendered concurrently */
+    short *buf;
+    int blen;
 };
 
 typedef struct sound_s sound_t;
 
 /* manage temporary buffers. if the requested size is smaller or equal to the
  * size of the already allocated buffer, reuse it.  */
-static short *buf = NULL;
+static short *getbuf(sound_t *psid, int len)
+{
+    if ((psid->buf == NULL) || (psid->blen < len)) {
+        if (psid->buf) {
+            lib_free(psid->buf);
+        }
+        psid->blen = len;
+        psid->buf = (short *)lib_calloc(len, 1);
+    }
+    return psid->buf;
+}
+
+/* Building the reSID filter model tables takes a noticeable part of the
+   startup time. The tables are kept in the user cache dir, in a file named
+   after the VICE version and the key of the reSID model parameters, and are
+   loaded from there before the first chip is created.  */
+
+#define RESID_TABLES_MAGIC "VICE reSID filter tables"
+
+typedef struct resid_tables_header_s {
+    char magic[32];
+    uint32_t key;
+    uint32_t size;
+} resid_tables_header_t;
+
+static int resid_tables_done = 0;
+
+static char *resid_tables_path(void)
+{
+    char *name;
+    char *path;
+
+    name = lib_msprintf("resid-filter-%s-%08x.bin", VERSION,
+                        reSID::Filter::class_tables_key());
+    path = util_join_paths(archdep_user_cache_path(), name, NULL);
+    lib_free(name);
+
+    return path;
+}
+
+static int resid_tables_check(const resid_tables_header_t *header, size_t size)
+{
+    return size == sizeof(resid_tables_header_t) + reSID::Filter::class_tables_size()
+        && strcmp(header->magic, RESID_TABLES_MAGIC) == 0
+        && header->key == reSID::Filter::class_tables_key()
+        && header->size == reSID::Filter::class_tables_size();
+}
+
+static int resid_tables_load(const char *path)
+{
+    const resid_tables_header_t *header;
+    int retval = 0;
+#ifdef RESID_TABLES_MMAP
+    struct stat st;
+    void *data;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size > sizeof(resid_tables_header_t)) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            header = (const resid_tables_header_t *)data;
+            if (resid_tables_check(header, (size_t)st.st_size)) {
+                retval = reSID::Filter::load_class_tables(header + 1, header->size);
+            }
+            munmap(data, (size_t)st.st_size);
+        }
+    }
+    close(fd);
+#else
+    size_t size = sizeof(resid_tables_header_t) + reSID::Filter::class_tables_size();
+    char *data;
+    FILE *fd;
 
-static int blen = 0;
+    fd = fopen(path, MODE_READ);
+    if (fd == NULL) {
+        return 0;
+    }
+    data = (char *)lib_malloc(size);
+    if (fread(data, 1, size, fd) == size && fgetc(fd) == EOF) {
+        header = (const resid_tables_header_t *)data;
+        if (resid_tables_check(header, size)) {
+            retval = reSID::Filter::load_class_tables(header + 1, header->size);
+        }
+    }
+    lib_free(data);
+    fclose(fd);
+#endif
+    return retval;
+}
 
-static short *getbuf(int len)
+static void resid_tables_save(const char *path)
 {
-    if ((buf == NULL) || (blen < len)) {
-        if (buf) {
-            lib_free(buf);
+    resid_tables_header_t header;
+    size_t size = reSID::Filter::class_tables_size();
+    char *data;
+    char *tmp;
+    FILE *fd;
+    int ok;
+
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, RESID_TABLES_MAGIC);
+    header.key = reSID::Filter::class_tables_key();
+    header.size = (uint32_t)size;
+
+    data = (char *)lib_malloc(size);
+    if (!reSID::Filter::save_class_tables(data)) {
+        lib_free(data);
+        return;
+    }
+
+    /* write to a file of our own first, so concurrent instances never see a
+       partial file */
+#ifdef RESID_TABLES_MMAP
+    tmp = lib_msprintf("%s.%ld", path, (long)getpid());
+#else
+    tmp = lib_msprintf("%s.%lu", path, (unsigned long)tick_now());
+#endif
+    fd = fopen(tmp, MODE_WRITE);
+    if (fd != NULL) {
+        ok = fwrite(&header, sizeof(header), 1, fd) == 1
+            && fwrite(data, 1, size, fd) == size;
+        ok = (fclose(fd) == 0) && ok;
+        if (!ok || archdep_rename(tmp, path) != 0) {
+            log_warning(LOG_DEFAULT, "reSID: could not write filter table cache %s.", path);
+            archdep_remove(tmp);
         }
-        blen = len;
-        buf = (short *)lib_calloc(len, 1);
     }
-    return buf;
+    lib_free(tmp);
+    lib_free(data);
+}
+
+static void resid_tables_init(void)
+{
+    tick_t start = tick_now();
+    char *path;
+
+    resid_tables_done = 1;
+
+    path = resid_tables_path();
+    if (resid_tables_load(path)) {
+        log_message(LOG_DEFAULT, "reSID: filter tables loaded from cache in %.1f ms.",
+                    TICK_TO_MICRO(tick_now_delta(start)) / 1000.0);
+    } else {
+        /* the first filter builds the tables */
+        delete new reSID::Filter;
+        log_message(LOG_DEFAULT, "reSID: filter tables built in %.1f ms.",
+                    TICK_TO_MICRO(tick_now_delta(start)) / 1000.0);
+        resid_tables_save(path);
+    }
+    lib_free(path);
 }
 
 static sound_t *resid_open(uint8_t *sidstate)
@@ -88,8 +243,14 @@ static sound_t *resid_open(uint8_t *sidstate)
     sound_t *psid;
     int i;
 
+    if (!resid_tables_done) {
+        resid_tables_init();
+    }
+
     psid = new sound_t;
     psid->sid = new reSID::SID;
+    psid->buf = NULL;
+    psid->blen = 0;
 
     for (i = 0x00; i <= 0x18; i++) {
         psid->sid->write(i, sidstate[i]);
@@ -237,13 +398,11 @@ static int resid_init(sound_t *psid, int speed, int cycles_per_sec, int factor)
 
 static void resid_close(sound_t *psid)
 {
+    if (psid->buf) {
+        lib_free(psid->buf);
+    }
     delete psid->sid;
     delete psid;
-
-    if (buf) {
-        lib_free(buf);
-        buf = NULL;
-    }
 }
 
 static uint8_t resid_read(sound_t *psid, uint16_t addr)
@@ -274,7 +433,7 @@ static int resid_calculate_samples(sound_t *psid, float *pbuf, int nr, CLOCK *de
     /* Tried not to mess with resid during 64-bit conversion. clock(...) wants to modify *delta_t ... */
 
     if (psid->factor == 1000) {
-        tmp_buf = getbuf(2 * nr);
+        tmp_buf = getbuf(psid, 2 * nr);
         retval = psid->sid->clock(int_delta_t, tmp_buf, nr, 0);
         (*delta_t) += int_delta_t - int_delta_t_original;
         for (i = 0; i < nr; i++) {
@@ -283,7 +442,7 @@ static int resid_calculate_samples(sound_t *psid, float *pbuf, int nr, CLOCK *de
         return retval;
     }
 
-    tmp_buf = getbuf(2 * nr * psid->factor / 1000);
+    tmp_buf = getbuf(psid, 2 * nr * psid->factor / 1000);
     retval = psid->sid->clock(int_delta_t, tmp_buf, nr * psid->factor / 1000, 0) * 1000 / psid->factor;
     (*delta_t) += int_delta_t - int_delta_t_original;
     for (i = 0; i < nr; i++) {
@@ -308,7 +467,7 @@ static int resid_calculate_samples(sound_t *psid, short *pbuf, int nr, int inter
         return retval;
     }
 
-    tmp_buf = getbuf(2 * nr * psid->factor / 1000);
+    tmp_buf = getbuf(psid, 2 * nr * psid->factor / 1000);
     retval = psid->sid->clock(int_delta_t, tmp_buf, nr * psid->factor / 1000, interleave) * 1000 / psid->factor;
     (*delta_t) += int_delta_t - int_delta_t_original;
     memcpy(pbuf, tmp_buf, 2 * nr);
@@ -194,6 +194,9 @@ static const cmdline_option_t resid_cmdline_options[] =
     { "-resid8580filterbias", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
       NULL, NULL, "SidResid8580FilterBias", NULL,
       "<number>", "reSID 8580 filter bias setting, which can be used to adjust DAC bias in millivolts.", },
+    { "-residthreads", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
+      NULL, NULL, "SidResidThreads", NULL,
+      "<number>", "Number of extra threads used to render multiple reSID chips (0: render on the emulation thread only, max 7)" },
     { "-residrawoutput", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
       NULL, NULL, "SidResidEnableRawOutput", (void *)1, NULL, "Enable writing raw reSID output to resid.raw, 16bit little endian data (WARNING: 1MiB per second)." },
     { "+residrawoutput", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
@@ -62,6 +62,7 @@ static int sid_resid_8580_passband;
 static int sid_resid_8580_gain;
 static int sid_resid_8580_filter_bias;
 static int sid_resid_enable_raw_output;
+static int sid_resid_threads;
 #endif
 int sid_stereo = 0;
 int checking_sid_stereo;
@@ -334,6 +335,17 @@ static int set_sid_resid_8580_filter_bias(int i, void *param)
     return 0;
 }
 
+static int set_sid_resid_threads(int val, void *param)
+{
+    if (val < 0 || val >= SOUND_SIDS_MAX) {
+        return -1;
+    }
+
+    sid_resid_threads = val;
+    sid_set_worker_threads(val);
+    return 0;
+}
+
 #endif
 
 #ifdef HAVE_HARDSID
@@ -396,6 +408,8 @@ static const resource_int_t resid_resources_int[] = {
       &sid_resid_8580_gain, set_sid_resid_8580_gain, NULL },
     { "SidResid8580FilterBias", RESID_8580_FILTER_BIAS_DEFAULT, RES_EVENT_NO, NULL,
       &sid_resid_8580_filter_bias, set_sid_resid_8580_filter_bias, NULL },
+    { "SidResidThreads", 0, RES_EVENT_NO, NULL,
+      &sid_resid_threads, set_sid_resid_threads, NULL },
     RESOURCE_INT_LIST_END
 };
 #endif
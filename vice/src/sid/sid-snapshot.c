@@ -1156,3 +1156,155 @@ int sid_snapshot_read_module(snapshot_t *s)
     }
     return 0;
 }
+
+/* ---------------------------------------------------------------------*/
+
+/* SIDSTATE module format, only used for in-memory machine state snapshots
+   (see machine_state_write()):
+
+   type  | name     | description
+   ------------------------------
+   BYTE  | sids     | amount of extra sids
+   BYTE  | sound    | sound active flag
+   BYTE  | engine   | sound engine
+   ARRAY | sid data | 32 BYTES of SID registers for each SID
+
+   When sound is active, one SIDEXTENDED module per SID follows.  Unlike
+   sid_snapshot_read_module(), reading the state back never changes any
+   resources or reopens the sound device: it fails if the SID configuration
+   is not the one the state was taken with.
+ */
+
+static const char snap_module_name_state[] = "SIDSTATE";
+#define SNAP_MAJOR_STATE 1
+#define SNAP_MINOR_STATE 0
+
+/** \brief  Check whether the SID state can be saved with sid_state_write_module()
+ *
+ * \return  NULL if it can, otherwise the reason why not
+ */
+const char *sid_state_unsupported(void)
+{
+    int sid_engine = 0;
+    int sids = 0;
+
+    resources_get_int("SidEngine", &sid_engine);
+    resources_get_int("SidStereo", &sids);
+
+    if (sid_engine != SID_ENGINE_FASTSID && sid_engine != SID_ENGINE_RESID) {
+        return "a hardware SID is used";
+    }
+    /* there are only four SIDEXTENDED modules */
+    if (sids >= 4) {
+        return "more than four SIDs are emulated";
+    }
+    return NULL;
+}
+
+int sid_state_write_module(snapshot_t *s)
+{
+    snapshot_module_t *m;
+    int sound = 0;
+    int sid_engine = 0;
+    int sids = 0;
+    int i;
+
+    resources_get_int("Sound", &sound);
+    resources_get_int("SidEngine", &sid_engine);
+    resources_get_int("SidStereo", &sids);
+
+    m = snapshot_module_create(s, snap_module_name_state, SNAP_MAJOR_STATE, SNAP_MINOR_STATE);
+    if (m == NULL) {
+        return -1;
+    }
+
+    if (0
+        || SMW_B(m, (uint8_t)sids) < 0
+        || SMW_B(m, (uint8_t)sound) < 0
+        || SMW_B(m, (uint8_t)sid_engine) < 0) {
+        goto fail;
+    }
+    for (i = 0; i <= sids; i++) {
+        if (SMW_BA(m, sid_get_siddata(i), 32) < 0) {
+            goto fail;
+        }
+    }
+
+    if (snapshot_module_close(m) < 0) {
+        return -1;
+    }
+
+    /* without sound there is no engine state */
+    if (sound) {
+        for (i = 0; i <= sids; i++) {
+            if (sid_snapshot_write_module_extended(s, i) < 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+
+fail:
+    snapshot_module_close(m);
+    return -1;
+}
+
+int sid_state_read_module(snapshot_t *s)
+{
+    uint8_t major_version, minor_version;
+    snapshot_module_t *m;
+    int sound = 0;
+    int sid_engine = 0;
+    int sids = 0;
+    int snap_sound, snap_sid_engine, snap_sids;
+    int i;
+
+    resources_get_int("Sound", &sound);
+    resources_get_int("SidEngine", &sid_engine);
+    resources_get_int("SidStereo", &sids);
+
+    m = snapshot_module_open(s, snap_module_name_state, &major_version, &minor_version);
+    if (m == NULL) {
+        return -1;
+    }
+
+    if (!snapshot_version_is_equal(major_version, minor_version, SNAP_MAJOR_STATE, SNAP_MINOR_STATE)) {
+        snapshot_set_error(SNAPSHOT_MODULE_INCOMPATIBLE);
+        goto fail;
+    }
+
+    if (0
+        || SMR_B_INT(m, &snap_sids) < 0
+        || SMR_B_INT(m, &snap_sound) < 0
+        || SMR_B_INT(m, &snap_sid_engine) < 0) {
+        goto fail;
+    }
+    if (snap_sids != sids || snap_sound != sound || snap_sid_engine != sid_engine) {
+        snapshot_set_error(SNAPSHOT_MODULE_INCOMPATIBLE);
+        goto fail;
+    }
+    for (i = 0; i <= sids; i++) {
+        if (SMR_BA(m, sid_get_siddata(i), 32) < 0) {
+            goto fail;
+        }
+    }
+
+    if (snapshot_module_close(m) < 0) {
+        return -1;
+    }
+
+    if (sound) {
+        /* the engine is known to be the one the state was written with */
+        intended_sid_engine = sid_engine;
+        for (i = 0; i <= sids; i++) {
+            if (sid_snapshot_read_module_extended(s, i) < 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+
+fail:
+    snapshot_module_close(m);
+    return -1;
+}
@@ -127,4 +127,8 @@ typedef struct sid_parsid_snapshot_state_s {
 int sid_snapshot_write_module(struct snapshot_s *s);
 int sid_snapshot_read_module(struct snapshot_s *s);
 
+const char *sid_state_unsupported(void);
+int sid_state_write_module(struct snapshot_s *s);
+int sid_state_read_module(struct snapshot_s *s);
+
 #endif
@@ -33,13 +33,18 @@
 
 #include <stdio.h>
 #include <string.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include "alarm.h"
+#include "bench.h"
 #include "catweaselmkiii.h"
 #include "fastsid.h"
 #include "hardsid.h"
 #include "joyport.h"
 #include "lib.h"
+#include "log.h"
 #include "machine.h"
 #include "maincpu.h"
 #include "parsid.h"
@@ -486,6 +491,17 @@ void sid_reset(void)
 
 static int sidengine;
 
+/* can the chips of a fragment only be rendered one after another? */
+static int sid_jobs_serial = 0;
+
+/* number of worker threads used for rendering multiple SIDs */
+static int sid_workers_wanted = 0;
+
+void sid_set_worker_threads(int count)
+{
+    sid_workers_wanted = count;
+}
+
 bool sid_sound_machine_set_engine_hooks(void)
 {
     sidengine = -1;
@@ -564,15 +580,217 @@ GETBUFx(5)
 GETBUFx(6)
 GETBUFx(7)
 
+/* Rendering of several chips in one fragment.
+
+   The chips are independent while a fragment is rendered: register writes
+   are applied between fragments only, since sound_store() runs the sound up
+   to the time of the write first. Every chip of a fragment is queued as a
+   job writing to its own buffer (or its own lane of an interleaved buffer),
+   and the jobs are run either one after another or spread over a pool of
+   worker threads. Mixing is done afterwards, in the same order as before,
+   so the output does not depend on the number of workers.  */
+
+typedef struct sid_job_s {
+    sound_t *psid;
+    int16_t *pbuf;
+    int nr;
+    int interleave;
+    CLOCK delta_t;
+    int retval;
+} sid_job_t;
+
+static sid_job_t sid_jobs[SOUND_SIDS_MAX];
+static int sid_jobs_count = 0;
+
+static void sid_job_add(sound_t *psid, int16_t *pbuf, int nr, int interleave, CLOCK delta_t)
+{
+    sid_job_t *job = &sid_jobs[sid_jobs_count++];
+
+    job->psid = psid;
+    job->pbuf = pbuf;
+    job->nr = nr;
+    job->interleave = interleave;
+    job->delta_t = delta_t;
+}
+
+static void sid_job_run(sid_job_t *job)
+{
+    job->retval = sid_engine.calculate_samples(job->psid, job->pbuf, job->nr, job->interleave, &job->delta_t);
+}
+
+#ifdef HAVE_PTHREAD
+static pthread_t sid_workers[SOUND_SIDS_MAX];
+static int sid_workers_count = 0;
+static int sid_workers_quit = 0;
+
+/* jobs handed to the workers, next job to be taken, jobs not finished yet */
+static int sid_jobs_posted = 0;
+static int sid_jobs_next = 0;
+static int sid_jobs_pending = 0;
+
+static pthread_mutex_t sid_workers_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sid_workers_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sid_workers_done = PTHREAD_COND_INITIALIZER;
+
+static void *sid_worker_main(void *unused)
+{
+    sid_job_t *job;
+
+    pthread_mutex_lock(&sid_workers_lock);
+    while (1) {
+        while (!sid_workers_quit && sid_jobs_next >= sid_jobs_posted) {
+            pthread_cond_wait(&sid_workers_wake, &sid_workers_lock);
+        }
+        if (sid_workers_quit) {
+            break;
+        }
+        job = &sid_jobs[sid_jobs_next++];
+        pthread_mutex_unlock(&sid_workers_lock);
+
+        sid_job_run(job);
+
+        pthread_mutex_lock(&sid_workers_lock);
+        if (--sid_jobs_pending == 0) {
+            pthread_cond_signal(&sid_workers_done);
+        }
+    }
+    pthread_mutex_unlock(&sid_workers_lock);
+
+    return NULL;
+}
+
+static void sid_workers_stop(void)
+{
+    int i;
+
+    if (sid_workers_count == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&sid_workers_lock);
+    sid_workers_quit = 1;
+    pthread_cond_broadcast(&sid_workers_wake);
+    pthread_mutex_unlock(&sid_workers_lock);
+
+    for (i = 0; i < sid_workers_count; i++) {
+        pthread_join(sid_workers[i], NULL);
+    }
+    sid_workers_count = 0;
+    sid_workers_quit = 0;
+}
+
+static void sid_workers_start(int count)
+{
+    int i;
+
+    sid_workers_stop();
+
+    for (i = 0; i < count; i++) {
+        if (pthread_create(&sid_workers[i], NULL, sid_worker_main, NULL) != 0) {
+            log_error(LOG_DEFAULT, "SID: could not start worker thread %d.", i);
+            break;
+        }
+    }
+    sid_workers_count = i;
+}
+
+static void sid_jobs_run_parallel(void)
+{
+    sid_job_t *job;
+
+    pthread_mutex_lock(&sid_workers_lock);
+    sid_jobs_next = 0;
+    sid_jobs_posted = sid_jobs_count;
+    sid_jobs_pending = sid_jobs_count;
+    pthread_cond_broadcast(&sid_workers_wake);
+
+    /* the calling thread takes jobs as well */
+    while (sid_jobs_next < sid_jobs_posted) {
+        job = &sid_jobs[sid_jobs_next++];
+        pthread_mutex_unlock(&sid_workers_lock);
+
+        sid_job_run(job);
+
+        pthread_mutex_lock(&sid_workers_lock);
+        sid_jobs_pending--;
+    }
+    while (sid_jobs_pending > 0) {
+        pthread_cond_wait(&sid_workers_done, &sid_workers_lock);
+    }
+    sid_jobs_posted = 0;
+    pthread_mutex_unlock(&sid_workers_lock);
+}
 #endif
 
+/* Run the queued jobs. The last job queued is the one whose delta_t and
+   sample count are passed back to the caller.  */
+static int sid_jobs_run(CLOCK *delta_t)
+{
+    sid_job_t *last = &sid_jobs[sid_jobs_count - 1];
+    int i;
+
+#ifdef HAVE_PTHREAD
+    /* only reSID keeps all its state per chip */
+    if (sid_workers_wanted > 0 && sid_jobs_count > 1
+        && sidengine == SID_ENGINE_RESID && !sid_jobs_serial) {
+        if (sid_workers_count != sid_workers_wanted) {
+            sid_workers_start(sid_workers_wanted);
+        }
+    } else {
+        sid_workers_stop();
+    }
+
+    if (sid_workers_count > 0) {
+        sid_jobs_run_parallel();
+    } else
+#endif
+    {
+        for (i = 0; i < sid_jobs_count; i++) {
+            sid_job_run(&sid_jobs[i]);
+        }
+    }
+
+    if (bench_enabled) {
+        for (i = 0; i < sid_jobs_count; i++) {
+            bench_sid_samples(i, sid_jobs[i].pbuf, sid_jobs[i].retval, sid_jobs[i].interleave);
+        }
+#ifdef HAVE_PTHREAD
+        bench_sid_fragment(sid_workers_count);
+#else
+        bench_sid_fragment(0);
+#endif
+    }
+
+    *delta_t = last->delta_t;
+    sid_jobs_count = 0;
+
+    return last->retval;
+}
+
+#endif
+
+/* The resampling path of the variable rate setups copies whole buffers over
+   interleaved output, and the raw debug output of reSID goes to one shared
+   file. Both need the chips to be rendered in order.  */
+static void sid_jobs_check_serial(int factor)
+{
+    int rawoutput = 0;
+
+#ifdef HAVE_RESID
+    resources_get_int("SidResidEnableRawOutput", &rawoutput);
+#endif
+    sid_jobs_serial = (factor != 1000) || rawoutput;
+}
+
 int sid_sound_machine_init_vbr(sound_t *psid, int speed, int cycles_per_sec, int factor)
 {
+    sid_jobs_check_serial(factor);
     return sid_engine.init(psid, speed * factor / 1000, cycles_per_sec, factor);
 }
 
 int sid_sound_machine_init(sound_t *psid, int speed, int cycles_per_sec)
 {
+    sid_jobs_check_serial(1000);
     return sid_engine.init(psid, speed, cycles_per_sec, 1000);
 }
 
@@ -580,6 +798,9 @@ void sid_sound_machine_close(sound_t *psid)
 {
     sid_engine.close(psid);
 #ifndef SOUND_SYSTEM_FLOAT
+#ifdef HAVE_PTHREAD
+    sid_workers_stop();
+#endif
     /* free the temp. buffers */
     if (buf1) {
         lib_free(buf1);
@@ -652,15 +873,15 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
     int16_t *tmp_buf6;
     int16_t *tmp_buf7;
     int tmp_nr = 0;
-    CLOCK tmp_delta_t = *delta_t;
 
     if (soc == SOUND_OUTPUT_MONO && scc == SOUND_1_DEVICE) {
         return sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
     }
     if (soc == SOUND_OUTPUT_MONO && scc == SOUND_2_DEVICES) {
         tmp_buf1 = getbuf1(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
         }
@@ -669,10 +890,10 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
     if (soc == SOUND_OUTPUT_MONO && scc == SOUND_3_DEVICES) {
         tmp_buf1 = getbuf1(2 * nr);
         tmp_buf2 = getbuf2(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf2[i]);
@@ -683,12 +904,11 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf1 = getbuf1(2 * nr);
         tmp_buf2 = getbuf2(2 * nr);
         tmp_buf3 = getbuf3(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf2[i]);
@@ -701,14 +921,12 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf2 = getbuf2(2 * nr);
         tmp_buf3 = getbuf3(2 * nr);
         tmp_buf4 = getbuf4(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf2[i]);
@@ -723,16 +941,13 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf3 = getbuf3(2 * nr);
         tmp_buf4 = getbuf4(2 * nr);
         tmp_buf5 = getbuf5(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[5], tmp_buf5, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[5], tmp_buf5, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf2[i]);
@@ -749,18 +964,14 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf4 = getbuf4(2 * nr);
         tmp_buf5 = getbuf5(2 * nr);
         tmp_buf6 = getbuf6(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[5], tmp_buf5, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[6], tmp_buf6, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[5], tmp_buf5, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[6], tmp_buf6, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf2[i]);
@@ -779,20 +990,15 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf5 = getbuf5(2 * nr);
         tmp_buf6 = getbuf6(2 * nr);
         tmp_buf7 = getbuf7(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[5], tmp_buf5, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[6], tmp_buf6, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[7], tmp_buf7, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, delta_t);
+        sid_job_add(psid[0], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[2], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[3], tmp_buf3, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[4], tmp_buf4, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[5], tmp_buf5, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[6], tmp_buf6, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[7], tmp_buf7, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[1], pbuf, nr, SOUND_OUTPUT_MONO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf1[i]);
             pbuf[i] = sound_audio_mix(pbuf[i], tmp_buf2[i]);
@@ -812,16 +1018,17 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         return tmp_nr;
     }
     if (soc == SOUND_OUTPUT_STEREO && scc == SOUND_2_DEVICES) {
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         return tmp_nr;
     }
     if (soc == SOUND_OUTPUT_STEREO && scc == SOUND_3_DEVICES) {
         tmp_buf1 = getbuf1(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf1, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[2], tmp_buf1, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf1[i]);
             pbuf[(i * 2) + 1] = sound_audio_mix(pbuf[(i * 2) + 1], tmp_buf1[i]);
@@ -829,12 +1036,11 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
     }
     if (soc == SOUND_OUTPUT_STEREO && scc == SOUND_4_DEVICES) {
         tmp_buf1 = getbuf1(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf1[i * 2]);
             pbuf[(i * 2) + 1] = sound_audio_mix(pbuf[(i * 2) + 1], tmp_buf1[(i * 2) + 1]);
@@ -843,14 +1049,12 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
     if (soc == SOUND_OUTPUT_STEREO && scc == SOUND_5_DEVICES) {
         tmp_buf1 = getbuf1(2 * nr);
         tmp_buf2 = getbuf2(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf2, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[4], tmp_buf2, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf1[i * 2]);
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf2[i]);
@@ -861,16 +1065,13 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
     if (soc == SOUND_OUTPUT_STEREO && scc == SOUND_6_DEVICES) {
         tmp_buf1 = getbuf1(2 * nr);
         tmp_buf2 = getbuf2(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf2, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[5], tmp_buf2 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[4], tmp_buf2, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[5], tmp_buf2 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf1[i * 2]);
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf2[i * 2]);
@@ -882,18 +1083,14 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf1 = getbuf1(2 * nr);
         tmp_buf2 = getbuf2(2 * nr);
         tmp_buf3 = getbuf3(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf2, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[5], tmp_buf2 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[6], tmp_buf3, nr, SOUND_OUTPUT_MONO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[4], tmp_buf2, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[5], tmp_buf2 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[6], tmp_buf3, nr, SOUND_OUTPUT_MONO, *delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf1[i * 2]);
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf2[i * 2]);
@@ -907,20 +1104,15 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
         tmp_buf1 = getbuf1(2 * nr);
         tmp_buf2 = getbuf2(2 * nr);
         tmp_buf3 = getbuf3(2 * nr);
-        tmp_nr = sid_engine.calculate_samples(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[4], tmp_buf2, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[5], tmp_buf2 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[6], tmp_buf3, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[7], tmp_buf3 + 1, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_delta_t = *delta_t;
-        tmp_nr = sid_engine.calculate_samples(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, &tmp_delta_t);
-        tmp_nr = sid_engine.calculate_samples(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, delta_t);
+        sid_job_add(psid[2], tmp_buf1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[3], tmp_buf1 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[4], tmp_buf2, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[5], tmp_buf2 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[6], tmp_buf3, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[7], tmp_buf3 + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[0], pbuf, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        sid_job_add(psid[1], pbuf + 1, nr, SOUND_OUTPUT_STEREO, *delta_t);
+        tmp_nr = sid_jobs_run(delta_t);
         for (i = 0; i < tmp_nr; i++) {
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf1[i * 2]);
             pbuf[i * 2] = sound_audio_mix(pbuf[i * 2], tmp_buf2[i * 2]);
@@ -248,6 +248,7 @@ int sid_sound_machine_calculate_samples(sound_t **psid, int16_t *pbuf, int nr, i
 #endif
 
 void sid_set_enable(int value);
+void sid_set_worker_threads(int count);
 
 int sid_engine_get_max_sids(int engine);
 int sid_machine_get_max_sids(void);
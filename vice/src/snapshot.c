@@ -67,9 +67,30 @@ static const char snapshot_version_magic_string[] = "VICE Version\032";
 #define SNAPSHOT_MAGIC_LEN              19
 #define SNAPSHOT_VERSION_MAGIC_LEN      13
 
-struct snapshot_module_s {
-    /* File descriptor.  */
+/* Growable memory arena used instead of a file for in-memory snapshots.  */
+struct snapshot_memory_s {
+    /* Buffer holding the snapshot data.  */
+    uint8_t *data;
+
+    /* Number of valid bytes in the buffer.  */
+    size_t size;
+
+    /* Number of bytes allocated for the buffer.  */
+    size_t allocated;
+
+    /* Current read/write position.  */
+    size_t pos;
+};
+
+/* Either a file or a memory arena, whichever `file' or `mem' is set.  */
+typedef struct snapshot_stream_s {
     FILE *file;
+    snapshot_memory_t *mem;
+} snapshot_stream_t;
+
+struct snapshot_module_s {
+    /* Stream the module lives in.  */
+    snapshot_stream_t *stream;
 
     /* Flag: are we writing it?  */
     int write_mode;
@@ -85,8 +106,8 @@ struct snapshot_module_s {
 };
 
 struct snapshot_s {
-    /* File descriptor.  */
-    FILE *file;
+    /* Stream (file or memory) of the snapshot.  */
+    snapshot_stream_t stream;
 
     /* Offset of the first module.  */
     long first_module_offset;
@@ -95,12 +116,118 @@ struct snapshot_s {
     int write_mode;
 };
 
+/* Memory arena used by snapshot_create()/snapshot_open() instead of the
+   named file, if set.  */
+static snapshot_memory_t *selected_memory = NULL;
+
+/* Initial size of a memory arena, big enough for most machines.  */
+#define SNAPSHOT_MEMORY_INITIAL_SIZE    0x40000
+
+/* ------------------------------------------------------------------------- */
+
+static void snapshot_memory_reserve(snapshot_memory_t *mem, size_t size)
+{
+    size_t allocated;
+
+    if (size <= mem->allocated) {
+        return;
+    }
+
+    allocated = mem->allocated ? mem->allocated : SNAPSHOT_MEMORY_INITIAL_SIZE;
+    while (allocated < size) {
+        allocated *= 2;
+    }
+
+    mem->data = lib_realloc(mem->data, allocated);
+    mem->allocated = allocated;
+}
+
+static long snapshot_stream_tell(snapshot_stream_t *f)
+{
+    if (f->mem != NULL) {
+        return (long)f->mem->pos;
+    }
+    return ftell(f->file);
+}
+
+static int snapshot_stream_seek(snapshot_stream_t *f, long offset)
+{
+    if (f->mem != NULL) {
+        if (offset < 0) {
+            return -1;
+        }
+        f->mem->pos = (size_t)offset;
+        return 0;
+    }
+    return fseek(f->file, offset, SEEK_SET);
+}
+
+static int snapshot_stream_write(snapshot_stream_t *f, const uint8_t *data, size_t num)
+{
+    snapshot_memory_t *mem = f->mem;
+
+    if (mem == NULL) {
+        return fwrite(data, num, 1, f->file) < 1 ? -1 : 0;
+    }
+
+    snapshot_memory_reserve(mem, mem->pos + num);
+    if (mem->pos > mem->size) {
+        /* seeked past the end, fill the gap like a file would */
+        memset(mem->data + mem->size, 0, mem->pos - mem->size);
+    }
+    memcpy(mem->data + mem->pos, data, num);
+    mem->pos += num;
+    if (mem->pos > mem->size) {
+        mem->size = mem->pos;
+    }
+    return 0;
+}
+
+static int snapshot_stream_putc(snapshot_stream_t *f, uint8_t data)
+{
+    if (f->mem == NULL) {
+        return fputc(data, f->file) == EOF ? -1 : 0;
+    }
+    return snapshot_stream_write(f, &data, 1);
+}
+
+static int snapshot_stream_read(snapshot_stream_t *f, uint8_t *data, size_t num)
+{
+    snapshot_memory_t *mem = f->mem;
+
+    if (mem == NULL) {
+        return fread(data, num, 1, f->file) < 1 ? -1 : 0;
+    }
+
+    if (mem->pos > mem->size || num > mem->size - mem->pos) {
+        mem->pos = mem->size;
+        return -1;
+    }
+    memcpy(data, mem->data + mem->pos, num);
+    mem->pos += num;
+    return 0;
+}
+
+static int snapshot_stream_getc(snapshot_stream_t *f)
+{
+    snapshot_memory_t *mem = f->mem;
+
+    if (mem == NULL) {
+        return fgetc(f->file);
+    }
+
+    if (mem->pos >= mem->size) {
+        return EOF;
+    }
+    return mem->data[mem->pos++];
+}
+
 /* ------------------------------------------------------------------------- */
 
-static int snapshot_write_byte(FILE *f, uint8_t data)
+static int snapshot_write_byte(snapshot_stream_t *f, uint8_t data)
 {
-    current_fpos = ftell(f);
-    if (fputc(data, f) == EOF) {
+    current_fpos = snapshot_stream_tell(f);
+    if (snapshot_stream_putc(f, data) < 0) {
         snapshot_error = SNAPSHOT_WRITE_EOF_ERROR;
         return -1;
     }
@@ -108,9 +235,9 @@ static int snapshot_write_byte(FILE *f, uint8_t data)
     return 0;
 }
 
-static int snapshot_write_word(FILE *f, uint16_t data)
+static int snapshot_write_word(snapshot_stream_t *f, uint16_t data)
 {
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_write_byte(f, (uint8_t)(data & 0xff)) < 0
         || snapshot_write_byte(f, (uint8_t)(data >> 8)) < 0) {
         return -1;
@@ -119,9 +246,9 @@ static int snapshot_write_word(FILE *f, uint16_t data)
     return 0;
 }
 
-static int snapshot_write_dword(FILE *f, uint32_t data)
+static int snapshot_write_dword(snapshot_stream_t *f, uint32_t data)
 {
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_write_word(f, (uint16_t)(data & 0xffff)) < 0
         || snapshot_write_word(f, (uint16_t)(data >> 16)) < 0) {
         return -1;
@@ -130,9 +257,9 @@ static int snapshot_write_dword(FILE *f, uint32_t data)
     return 0;
 }
 
-static int snapshot_write_qword(FILE *f, uint64_t data)
+static int snapshot_write_qword(snapshot_stream_t *f, uint64_t data)
 {
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_write_dword(f, (uint32_t)(data & 0xffffffff)) < 0
         || snapshot_write_dword(f, (uint32_t)(data >> 32)) < 0) {
         return -1;
@@ -141,12 +268,12 @@ static int snapshot_write_qword(FILE *f, uint64_t data)
     return 0;
 }
 
-static int snapshot_write_double(FILE *f, double data)
+static int snapshot_write_double(snapshot_stream_t *f, double data)
 {
     uint8_t *byte_data = (uint8_t *)&data;
     int i;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = 0; i < sizeof(double); i++) {
         if (snapshot_write_byte(f, byte_data[i]) < 0) {
             return -1;
@@ -155,13 +282,13 @@ static int snapshot_write_double(FILE *f, double data)
     return 0;
 }
 
-static int snapshot_write_padded_string(FILE *f, const char *s, uint8_t pad_char,
+static int snapshot_write_padded_string(snapshot_stream_t *f, const char *s, uint8_t pad_char,
                                         int len)
 {
     int i, found_zero;
     uint8_t c;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = found_zero = 0; i < len; i++) {
         if (!found_zero && s[i] == 0) {
             found_zero = 1;
@@ -175,10 +302,10 @@ static int snapshot_write_padded_string(FILE *f, const char *s, uint8_t pad_char
     return 0;
 }
 
-static int snapshot_write_byte_array(FILE *f, const uint8_t *data, unsigned int num)
+static int snapshot_write_byte_array(snapshot_stream_t *f, const uint8_t *data, unsigned int num)
 {
-    current_fpos = ftell(f);
-    if (num > 0 && fwrite(data, (size_t)num, 1, f) < 1) {
+    current_fpos = snapshot_stream_tell(f);
+    if (num > 0 && snapshot_stream_write(f, data, (size_t)num) < 0) {
         snapshot_error = SNAPSHOT_WRITE_BYTE_ARRAY_ERROR;
         return -1;
     }
@@ -186,11 +313,11 @@ static int snapshot_write_byte_array(FILE *f, const uint8_t *data, unsigned int
     return 0;
 }
 
-static int snapshot_write_word_array(FILE *f, const uint16_t *data, unsigned int num)
+static int snapshot_write_word_array(snapshot_stream_t *f, const uint16_t *data, unsigned int num)
 {
     unsigned int i;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = 0; i < num; i++) {
         if (snapshot_write_word(f, data[i]) < 0) {
             return -1;
@@ -200,11 +327,11 @@ static int snapshot_write_word_array(FILE *f, const uint16_t *data, unsigned int
     return 0;
 }
 
-static int snapshot_write_dword_array(FILE *f, const uint32_t *data, unsigned int num)
+static int snapshot_write_dword_array(snapshot_stream_t *f, const uint32_t *data, unsigned int num)
 {
     unsigned int i;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = 0; i < num; i++) {
         if (snapshot_write_dword(f, data[i]) < 0) {
             return -1;
@@ -215,13 +342,13 @@ static int snapshot_write_dword_array(FILE *f, const uint32_t *data, unsigned in
 }
 
 
-static int snapshot_write_string(FILE *f, const char *s)
+static int snapshot_write_string(snapshot_stream_t *f, const char *s)
 {
     size_t len, i;
 
     len = s ? (strlen(s) + 1) : 0;      /* length includes nullbyte */
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_write_word(f, (uint16_t)len) < 0) {
         return -1;
     }
@@ -235,12 +362,12 @@ static int snapshot_write_string(FILE *f, const char *s)
     return (int)(len + sizeof(uint16_t));
 }
 
-static int snapshot_read_byte(FILE *f, uint8_t *b_return)
+static int snapshot_read_byte(snapshot_stream_t *f, uint8_t *b_return)
 {
     int c;
 
-    current_fpos = ftell(f);
-    c = fgetc(f);
+    current_fpos = snapshot_stream_tell(f);
+    c = snapshot_stream_getc(f);
     if (c == EOF) {
         snapshot_error = SNAPSHOT_READ_EOF_ERROR;
         return -1;
@@ -249,11 +376,11 @@ static int snapshot_read_byte(FILE *f, uint8_t *b_return)
     return 0;
 }
 
-static int snapshot_read_word(FILE *f, uint16_t *w_return)
+static int snapshot_read_word(snapshot_stream_t *f, uint16_t *w_return)
 {
     uint8_t lo, hi;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_read_byte(f, &lo) < 0 || snapshot_read_byte(f, &hi) < 0) {
         return -1;
     }
@@ -262,11 +389,11 @@ static int snapshot_read_word(FILE *f, uint16_t *w_return)
     return 0;
 }
 
-static int snapshot_read_dword(FILE *f, uint32_t *dw_return)
+static int snapshot_read_dword(snapshot_stream_t *f, uint32_t *dw_return)
 {
     uint16_t lo, hi;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_read_word(f, &lo) < 0 || snapshot_read_word(f, &hi) < 0) {
         return -1;
     }
@@ -275,11 +402,11 @@ static int snapshot_read_dword(FILE *f, uint32_t *dw_return)
     return 0;
 }
 
-static int snapshot_read_qword(FILE *f, uint64_t *qw_return)
+static int snapshot_read_qword(snapshot_stream_t *f, uint64_t *qw_return)
 {
     uint32_t lo, hi;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_read_dword(f, &lo) < 0 || snapshot_read_dword(f, &hi) < 0) {
         return -1;
     }
@@ -288,16 +415,16 @@ static int snapshot_read_qword(FILE *f, uint64_t *qw_return)
     return 0;
 }
 
-static int snapshot_read_double(FILE *f, double *d_return)
+static int snapshot_read_double(snapshot_stream_t *f, double *d_return)
 {
     int i;
     int c;
     double val;
     uint8_t *byte_val = (uint8_t *)&val;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = 0; i < sizeof(double); i++) {
-        c = fgetc(f);
+        c = snapshot_stream_getc(f);
         if (c == EOF) {
             snapshot_error = SNAPSHOT_READ_EOF_ERROR;
             return -1;
@@ -308,10 +435,10 @@ static int snapshot_read_double(FILE *f, double *d_return)
     return 0;
 }
 
-static int snapshot_read_byte_array(FILE *f, uint8_t *b_return, unsigned int num)
+static int snapshot_read_byte_array(snapshot_stream_t *f, uint8_t *b_return, unsigned int num)
 {
-    current_fpos = ftell(f);
-    if (num > 0 && fread(b_return, (size_t)num, 1, f) < 1) {
+    current_fpos = snapshot_stream_tell(f);
+    if (num > 0 && snapshot_stream_read(f, b_return, (size_t)num) < 0) {
         snapshot_error = SNAPSHOT_READ_BYTE_ARRAY_ERROR;
         return -1;
     }
@@ -319,11 +446,11 @@ static int snapshot_read_byte_array(FILE *f, uint8_t *b_return, unsigned int num
     return 0;
 }
 
-static int snapshot_read_word_array(FILE *f, uint16_t *w_return, unsigned int num)
+static int snapshot_read_word_array(snapshot_stream_t *f, uint16_t *w_return, unsigned int num)
 {
     unsigned int i;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = 0; i < num; i++) {
         if (snapshot_read_word(f, w_return + i) < 0) {
             return -1;
@@ -333,11 +460,11 @@ static int snapshot_read_word_array(FILE *f, uint16_t *w_return, unsigned int nu
     return 0;
 }
 
-static int snapshot_read_dword_array(FILE *f, uint32_t *dw_return, unsigned int num)
+static int snapshot_read_dword_array(snapshot_stream_t *f, uint32_t *dw_return, unsigned int num)
 {
     unsigned int i;
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     for (i = 0; i < num; i++) {
         if (snapshot_read_dword(f, dw_return + i) < 0) {
             return -1;
@@ -347,7 +474,7 @@ static int snapshot_read_dword_array(FILE *f, uint32_t *dw_return, unsigned int
     return 0;
 }
 
-static int snapshot_read_string(FILE *f, char **s)
+static int snapshot_read_string(snapshot_stream_t *f, char **s)
 {
     int i, len;
     uint16_t w;
@@ -357,7 +484,7 @@ static int snapshot_read_string(FILE *f, char **s)
     lib_free(*s);
     *s = NULL;      /* don't leave a bogus pointer */
 
-    current_fpos = ftell(f);
+    current_fpos = snapshot_stream_tell(f);
     if (snapshot_read_word(f, &w) < 0) {
         return -1;
     }
@@ -383,7 +510,7 @@ static int snapshot_read_string(FILE *f, char **s)
 
 int snapshot_module_write_byte(snapshot_module_t *m, uint8_t b)
 {
-    if (snapshot_write_byte(m->file, b) < 0) {
+    if (snapshot_write_byte(m->stream, b) < 0) {
         return -1;
     }
 
@@ -393,7 +520,7 @@ int snapshot_module_write_byte(snapshot_module_t *m, uint8_t b)
 
 int snapshot_module_write_word(snapshot_module_t *m, uint16_t w)
 {
-    if (snapshot_write_word(m->file, w) < 0) {
+    if (snapshot_write_word(m->stream, w) < 0) {
         return -1;
     }
 
@@ -403,7 +530,7 @@ int snapshot_module_write_word(snapshot_module_t *m, uint16_t w)
 
 int snapshot_module_write_dword(snapshot_module_t *m, uint32_t dw)
 {
-    if (snapshot_write_dword(m->file, dw) < 0) {
+    if (snapshot_write_dword(m->stream, dw) < 0) {
         return -1;
     }
 
@@ -413,7 +540,7 @@ int snapshot_module_write_dword(snapshot_module_t *m, uint32_t dw)
 
 int snapshot_module_write_qword(snapshot_module_t *m, uint64_t qw)
 {
-    if (snapshot_write_qword(m->file, qw) < 0) {
+    if (snapshot_write_qword(m->stream, qw) < 0) {
         return -1;
     }
 
@@ -423,7 +550,7 @@ int snapshot_module_write_qword(snapshot_module_t *m, uint64_t qw)
 
 int snapshot_module_write_double(snapshot_module_t *m, double db)
 {
-    if (snapshot_write_double(m->file, db) < 0) {
+    if (snapshot_write_double(m->stream, db) < 0) {
         return -1;
     }
 
@@ -433,7 +560,7 @@ int snapshot_module_write_double(snapshot_module_t *m, double db)
 
 int snapshot_module_write_padded_string(snapshot_module_t *m, const char *s, uint8_t pad_char, int len)
 {
-    if (snapshot_write_padded_string(m->file, s, (uint8_t)pad_char, len) < 0) {
+    if (snapshot_write_padded_string(m->stream, s, (uint8_t)pad_char, len) < 0) {
         return -1;
     }
 
@@ -443,7 +570,7 @@ int snapshot_module_write_padded_string(snapshot_module_t *m, const char *s, uin
 
 int snapshot_module_write_byte_array(snapshot_module_t *m, const uint8_t *b, unsigned int num)
 {
-    if (snapshot_write_byte_array(m->file, b, num) < 0) {
+    if (snapshot_write_byte_array(m->stream, b, num) < 0) {
         return -1;
     }
 
@@ -453,7 +580,7 @@ int snapshot_module_write_byte_array(snapshot_module_t *m, const uint8_t *b, uns
 
 int snapshot_module_write_word_array(snapshot_module_t *m, const uint16_t *w, unsigned int num)
 {
-    if (snapshot_write_word_array(m->file, w, num) < 0) {
+    if (snapshot_write_word_array(m->stream, w, num) < 0) {
         return -1;
     }
 
@@ -463,7 +590,7 @@ int snapshot_module_write_word_array(snapshot_module_t *m, const uint16_t *w, un
 
 int snapshot_module_write_dword_array(snapshot_module_t *m, const uint32_t *dw, unsigned int num)
 {
-    if (snapshot_write_dword_array(m->file, dw, num) < 0) {
+    if (snapshot_write_dword_array(m->stream, dw, num) < 0) {
         return -1;
     }
 
@@ -474,7 +601,7 @@ int snapshot_module_write_dword_array(snapshot_module_t *m, const uint32_t *dw,
 int snapshot_module_write_string(snapshot_module_t *m, const char *s)
 {
     int len;
-    len = snapshot_write_string(m->file, s);
+    len = snapshot_write_string(m->stream, s);
     if (len < 0) {
         snapshot_error = SNAPSHOT_ILLEGAL_STRING_LENGTH_ERROR;
         return -1;
@@ -488,100 +615,100 @@ int snapshot_module_write_string(snapshot_module_t *m, const char *s)
 
 int snapshot_module_read_byte(snapshot_module_t *m, uint8_t *b_return)
 {
-    current_fpos = ftell(m->file);
-    if (ftell(m->file) + sizeof(uint8_t) > m->offset + m->size) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if (snapshot_stream_tell(m->stream) + sizeof(uint8_t) > m->offset + m->size) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_byte(m->file, b_return);
+    return snapshot_read_byte(m->stream, b_return);
 }
 
 int snapshot_module_read_word(snapshot_module_t *m, uint16_t *w_return)
 {
-    current_fpos = ftell(m->file);
-    if (ftell(m->file) + sizeof(uint16_t) > m->offset + m->size) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if (snapshot_stream_tell(m->stream) + sizeof(uint16_t) > m->offset + m->size) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_word(m->file, w_return);
+    return snapshot_read_word(m->stream, w_return);
 }
 
 int snapshot_module_read_dword(snapshot_module_t *m, uint32_t *dw_return)
 {
-    current_fpos = ftell(m->file);
-    if (ftell(m->file) + sizeof(uint32_t) > m->offset + m->size) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if (snapshot_stream_tell(m->stream) + sizeof(uint32_t) > m->offset + m->size) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_dword(m->file, dw_return);
+    return snapshot_read_dword(m->stream, dw_return);
 }
 
 int snapshot_module_read_qword(snapshot_module_t *m, uint64_t *qw_return)
 {
-    current_fpos = ftell(m->file);
-    if (ftell(m->file) + sizeof(uint64_t) > m->offset + m->size) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if (snapshot_stream_tell(m->stream) + sizeof(uint64_t) > m->offset + m->size) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_qword(m->file, qw_return);
+    return snapshot_read_qword(m->stream, qw_return);
 }
 
 int snapshot_module_read_double(snapshot_module_t *m, double *db_return)
 {
-    current_fpos = ftell(m->file);
-    if (ftell(m->file) + sizeof(double) > m->offset + m->size) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if (snapshot_stream_tell(m->stream) + sizeof(double) > m->offset + m->size) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_double(m->file, db_return);
+    return snapshot_read_double(m->stream, db_return);
 }
 
 int snapshot_module_read_byte_array(snapshot_module_t *m, uint8_t *b_return, unsigned int num)
 {
-    current_fpos = ftell(m->file);
-    if ((long)(ftell(m->file) + num) > (long)(m->offset + m->size)) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if ((long)(snapshot_stream_tell(m->stream) + num) > (long)(m->offset + m->size)) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_byte_array(m->file, b_return, num);
+    return snapshot_read_byte_array(m->stream, b_return, num);
 }
 
 int snapshot_module_read_word_array(snapshot_module_t *m, uint16_t *w_return, unsigned int num)
 {
-    if ((long)(ftell(m->file) + num * sizeof(uint16_t)) > (long)(m->offset + m->size)) {
+    if ((long)(snapshot_stream_tell(m->stream) + num * sizeof(uint16_t)) > (long)(m->offset + m->size)) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_word_array(m->file, w_return, num);
+    return snapshot_read_word_array(m->stream, w_return, num);
 }
 
 int snapshot_module_read_dword_array(snapshot_module_t *m, uint32_t *dw_return, unsigned int num)
 {
-    current_fpos = ftell(m->file);
-    if ((long)(ftell(m->file) + num * sizeof(uint32_t)) > (long)(m->offset + m->size)) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if ((long)(snapshot_stream_tell(m->stream) + num * sizeof(uint32_t)) > (long)(m->offset + m->size)) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_dword_array(m->file, dw_return, num);
+    return snapshot_read_dword_array(m->stream, dw_return, num);
 }
 
 int snapshot_module_read_string(snapshot_module_t *m, char **charp_return)
 {
-    current_fpos = ftell(m->file);
-    if (ftell(m->file) + sizeof(uint16_t) > m->offset + m->size) {
+    current_fpos = snapshot_stream_tell(m->stream);
+    if (snapshot_stream_tell(m->stream) + sizeof(uint16_t) > m->offset + m->size) {
         snapshot_error = SNAPSHOT_READ_OUT_OF_BOUNDS_ERROR;
         return -1;
     }
 
-    return snapshot_read_string(m->file, charp_return);
+    return snapshot_read_string(m->stream, charp_return);
 }
 
 int snapshot_module_read_byte_into_int(snapshot_module_t *m, int *value_return)
@@ -681,8 +808,8 @@ snapshot_module_t *snapshot_module_create(snapshot_t *s, const char *name, uint8
     current_module = (char *)name;
 
     m = lib_malloc(sizeof(snapshot_module_t));
-    m->file = s->file;
-    m->offset = ftell(s->file);
+    m->stream = &s->stream;
+    m->offset = snapshot_stream_tell(&s->stream);
     if (m->offset == -1) {
         snapshot_error = SNAPSHOT_ILLEGAL_OFFSET_ERROR;
         lib_free(m);
@@ -690,15 +817,15 @@ snapshot_module_t *snapshot_module_create(snapshot_t *s, const char *name, uint8
     }
     m->write_mode = 1;
 
-    if (snapshot_write_padded_string(s->file, name, (uint8_t)0, SNAPSHOT_MODULE_NAME_LEN) < 0
-        || snapshot_write_byte(s->file, major_version) < 0
-        || snapshot_write_byte(s->file, minor_version) < 0
-        || snapshot_write_dword(s->file, 0) < 0) {
+    if (snapshot_write_padded_string(&s->stream, name, (uint8_t)0, SNAPSHOT_MODULE_NAME_LEN) < 0
+        || snapshot_write_byte(&s->stream, major_version) < 0
+        || snapshot_write_byte(&s->stream, minor_version) < 0
+        || snapshot_write_dword(&s->stream, 0) < 0) {
         return NULL;
     }
 
-    m->size = (uint32_t)(ftell(s->file) - m->offset);
-    m->size_offset = ftell(s->file) - sizeof(uint32_t);
+    m->size = (uint32_t)(snapshot_stream_tell(&s->stream) - m->offset);
+    m->size_offset = snapshot_stream_tell(&s->stream) - sizeof(uint32_t);
 
     return m;
 }
@@ -711,14 +838,14 @@ snapshot_module_t *snapshot_module_open(snapshot_t *s, const char *name, uint8_t
 
     current_module = (char *)name;
 
-    if (fseek(s->file, s->first_module_offset, SEEK_SET) < 0) {
+    if (snapshot_stream_seek(&s->stream, s->first_module_offset) < 0) {
         snapshot_error = SNAPSHOT_FIRST_MODULE_NOT_FOUND_ERROR;
         DBG(("snapshot_module_open error: name: '%s' NOT found\n", name));
         return NULL;
     }
 
     m = lib_malloc(sizeof(snapshot_module_t));
-    m->file = s->file;
+    m->stream = &s->stream;
     m->write_mode = 0;
 
     m->offset = s->first_module_offset;
@@ -728,11 +855,11 @@ snapshot_module_t *snapshot_module_open(snapshot_t *s, const char *name, uint8_t
     /* Search for the module name.  This is quite inefficient, but I don't
        think we care.  */
     while (1) {
-        if (snapshot_read_byte_array(s->file, (uint8_t *)n,
+        if (snapshot_read_byte_array(&s->stream, (uint8_t *)n,
                                      SNAPSHOT_MODULE_NAME_LEN) < 0
-            || snapshot_read_byte(s->file, major_version_return) < 0
-            || snapshot_read_byte(s->file, minor_version_return) < 0
-            || snapshot_read_dword(s->file, &m->size)) {
+            || snapshot_read_byte(&s->stream, major_version_return) < 0
+            || snapshot_read_byte(&s->stream, minor_version_return) < 0
+            || snapshot_read_dword(&s->stream, &m->size)) {
             snapshot_error = SNAPSHOT_MODULE_HEADER_READ_ERROR;
             goto fail;
         }
@@ -744,13 +871,13 @@ snapshot_module_t *snapshot_module_open(snapshot_t *s, const char *name, uint8_t
         }
 
         m->offset += m->size;
-        if (fseek(s->file, m->offset, SEEK_SET) < 0) {
+        if (snapshot_stream_seek(&s->stream, m->offset) < 0) {
             snapshot_error = SNAPSHOT_MODULE_NOT_FOUND_ERROR;
             goto fail;
         }
     }
 
-    m->size_offset = ftell(s->file) - sizeof(uint32_t);
+    m->size_offset = snapshot_stream_tell(&s->stream) - sizeof(uint32_t);
 #if 0
     /* HACK: if any of the errors *this* function can produce is still pending
              in snapshot_error, clear it out - else we might fail for no reason
@@ -766,7 +893,7 @@ snapshot_module_t *snapshot_module_open(snapshot_t *s, const char *name, uint8_t
     return m;
 
 fail:
-    fseek(s->file, s->first_module_offset, SEEK_SET);
+    snapshot_stream_seek(&s->stream, s->first_module_offset);
     lib_free(m);
     DBG(("snapshot_module_open error: name: '%s' NOT found\n", name));
     return NULL;
@@ -777,15 +904,15 @@ int snapshot_module_close(snapshot_module_t *m)
     DBG(("snapshot_module_close name: '%s'\n", current_module));
     /* Backpatch module size if writing.  */
     if (m->write_mode
-        && (fseek(m->file, m->size_offset, SEEK_SET) < 0
-            || snapshot_write_dword(m->file, m->size) < 0)) {
+        && (snapshot_stream_seek(m->stream, m->size_offset) < 0
+            || snapshot_write_dword(m->stream, m->size) < 0)) {
         snapshot_error = SNAPSHOT_MODULE_CLOSE_ERROR;
         DBG(("snapshot_module_close error\n"));
         return -1;
     }
 
     /* Skip module.  */
-    if (fseek(m->file, m->offset + m->size, SEEK_SET) < 0) {
+    if (snapshot_stream_seek(m->stream, m->offset + m->size) < 0) {
         snapshot_error = SNAPSHOT_MODULE_SKIP_ERROR;
         DBG(("snapshot_module_close error\n"));
         return -1;
@@ -800,16 +927,23 @@ int snapshot_module_close(snapshot_module_t *m)
 
 snapshot_t *snapshot_create(const char *filename, uint8_t major_version, uint8_t minor_version, const char *snapshot_machine_name)
 {
-    FILE *f;
+    snapshot_stream_t stream = { NULL, NULL };
+    snapshot_stream_t *f = &stream;
     snapshot_t *s;
     unsigned char viceversion[4] = { VERSION_RC_NUMBER };
 
     current_filename = (char *)filename;
 
-    f = fopen(filename, MODE_WRITE);
-    if (f == NULL) {
-        snapshot_error = SNAPSHOT_CANNOT_CREATE_SNAPSHOT_ERROR;
-        return NULL;
+    if (selected_memory != NULL) {
+        stream.mem = selected_memory;
+        stream.mem->size = 0;
+        stream.mem->pos = 0;
+    } else {
+        stream.file = fopen(filename, MODE_WRITE);
+        if (stream.file == NULL) {
+            snapshot_error = SNAPSHOT_CANNOT_CREATE_SNAPSHOT_ERROR;
+            return NULL;
+        }
     }
 
     /* Magic string.  */
@@ -851,15 +985,17 @@ snapshot_t *snapshot_create(const char *filename, uint8_t major_version, uint8_t
     }
 
     s = lib_malloc(sizeof(snapshot_t));
-    s->file = f;
-    s->first_module_offset = ftell(f);
+    s->stream = stream;
+    s->first_module_offset = snapshot_stream_tell(f);
     s->write_mode = 1;
 
     return s;
 
 fail:
-    fclose(f);
-    archdep_remove(filename);
+    if (stream.file != NULL) {
+        fclose(stream.file);
+        archdep_remove(filename);
+    }
     return NULL;
 }
 
@@ -869,7 +1005,8 @@ static uint32_t snapshot_vicerevision;
 
 snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, uint8_t *minor_version_return, const char *snapshot_machine_name)
 {
-    FILE *f;
+    snapshot_stream_t stream = { NULL, NULL };
+    snapshot_stream_t *f = &stream;
     char magic[SNAPSHOT_MAGIC_LEN];
     snapshot_t *s = NULL;
     int machine_name_len;
@@ -879,10 +1016,15 @@ snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, u
     current_filename = (char *)filename;
     current_module = NULL;
 
-    f = zfile_fopen(filename, MODE_READ);
-    if (f == NULL) {
-        snapshot_error = SNAPSHOT_CANNOT_OPEN_FOR_READ_ERROR;
-        return NULL;
+    if (selected_memory != NULL) {
+        stream.mem = selected_memory;
+        stream.mem->pos = 0;
+    } else {
+        stream.file = zfile_fopen(filename, MODE_READ);
+        if (stream.file == NULL) {
+            snapshot_error = SNAPSHOT_CANNOT_OPEN_FOR_READ_ERROR;
+            return NULL;
+        }
     }
 
     /* Magic string.  */
@@ -917,12 +1059,12 @@ snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, u
     /* VICE version and revision */
     memset(snapshot_viceversion, 0, 4);
     snapshot_vicerevision = 0;
-    offs = ftell(f);
+    offs = snapshot_stream_tell(f);
 
     if (snapshot_read_byte_array(f, (uint8_t *)magic, SNAPSHOT_VERSION_MAGIC_LEN) < 0
         || memcmp(magic, snapshot_version_magic_string, SNAPSHOT_VERSION_MAGIC_LEN) != 0) {
         /* old snapshots do not contain VICE version */
-        fseek(f, offs, SEEK_SET);
+        snapshot_stream_seek(f, (long)offs);
         log_warning(LOG_DEFAULT, "attempting to load pre 2.4.30 snapshot");
     } else {
         /* actually read the version */
@@ -937,15 +1079,21 @@ snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, u
     }
 
     s = lib_malloc(sizeof(snapshot_t));
-    s->file = f;
-    s->first_module_offset = ftell(f);
+    s->stream = stream;
+    s->first_module_offset = snapshot_stream_tell(f);
     s->write_mode = 0;
 
-    vsync_suspend_speed_eval();
+    /* in-memory snapshots are restored without breaking the timing, their
+       users resynchronize themselves when needed */
+    if (stream.mem == NULL) {
+        vsync_suspend_speed_eval();
+    }
     return s;
 
 fail:
-    fclose(f);
+    if (stream.file != NULL) {
+        fclose(stream.file);
+    }
     return NULL;
 }
 
@@ -953,15 +1101,18 @@ int snapshot_close(snapshot_t *s)
 {
     int retval;
 
-    if (!s->write_mode) {
-        if (zfile_fclose(s->file) == EOF) {
+    if (s->stream.mem != NULL) {
+        /* the arena belongs to the caller */
+        retval = 0;
+    } else if (!s->write_mode) {
+        if (zfile_fclose(s->stream.file) == EOF) {
             snapshot_error = SNAPSHOT_READ_CLOSE_EOF_ERROR;
             retval = -1;
         } else {
             retval = 0;
         }
     } else {
-        if (fclose(s->file) == EOF) {
+        if (fclose(s->stream.file) == EOF) {
             snapshot_error = SNAPSHOT_WRITE_CLOSE_EOF_ERROR;
             retval = -1;
         } else {
@@ -973,6 +1124,53 @@ int snapshot_close(snapshot_t *s)
     return retval;
 }
 
+/* ------------------------------------------------------------------------- */
+
+/* Create an empty memory arena for in-memory snapshots.  */
+snapshot_memory_t *snapshot_memory_new(void)
+{
+    return lib_calloc(1, sizeof(snapshot_memory_t));
+}
+
+void snapshot_memory_free(snapshot_memory_t *mem)
+{
+    if (mem == NULL) {
+        return;
+    }
+    if (selected_memory == mem) {
+        selected_memory = NULL;
+    }
+    lib_free(mem->data);
+    lib_free(mem);
+}
+
+/* Return the snapshot data held by MEM, and its size in *SIZE_RETURN.  The
+   pointer is valid until MEM is written to or freed.  */
+const uint8_t *snapshot_memory_get_data(snapshot_memory_t *mem, size_t *size_return)
+{
+    *size_return = mem->size;
+    return mem->data;
+}
+
+/* Replace the contents of MEM with a copy of DATA.  */
+void snapshot_memory_set_data(snapshot_memory_t *mem, const uint8_t *data, size_t size)
+{
+    snapshot_memory_reserve(mem, size);
+    if (size > 0) {
+        memcpy(mem->data, data, size);
+    }
+    mem->size = size;
+    mem->pos = 0;
+}
+
+/* Make snapshot_create() and snapshot_open() use MEM instead of the file
+   they are given, so any existing machine snapshot code can write to or
+   read from memory.  Pass NULL to go back to files.  */
+void snapshot_memory_select(snapshot_memory_t *mem)
+{
+    selected_memory = mem;
+}
+
 static void display_error_with_vice_version(char *text, char *filename)
 {
     char *vmessage = lib_malloc(0x100);
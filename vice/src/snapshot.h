@@ -67,6 +67,7 @@
 
 typedef struct snapshot_module_s snapshot_module_t;
 typedef struct snapshot_s snapshot_t;
+typedef struct snapshot_memory_s snapshot_memory_t;
 
 void snapshot_display_error(void);
 
@@ -136,6 +137,12 @@ snapshot_t *snapshot_create(const char *filename, uint8_t major_version, uint8_t
 snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, uint8_t *minor_version_return, const char *snapshot_machine_name);
 int snapshot_close(snapshot_t *s);
 
+snapshot_memory_t *snapshot_memory_new(void);
+void snapshot_memory_free(snapshot_memory_t *mem);
+const uint8_t *snapshot_memory_get_data(snapshot_memory_t *mem, size_t *size_return);
+void snapshot_memory_set_data(snapshot_memory_t *mem, const uint8_t *data, size_t size);
+void snapshot_memory_select(snapshot_memory_t *mem);
+
 void snapshot_set_error(int error);
 int snapshot_get_error(void);
 
@@ -41,6 +41,7 @@
 #endif
 
 #include "archdep.h"
+#include "bench.h"
 #include "cmdline.h"
 #include "debug.h"
 #include "fixpoint.h"
@@ -222,6 +223,13 @@ typedef struct {
 
 static snddata_t snddata;
 
+/* Run-ahead state: are generated samples dropped, and where was the buffer
+   when dropping started.  */
+static int speculating = 0;
+static int speculation_bufptr;
+static soundclk_t speculation_fclk;
+static CLOCK speculation_clk;
+
 static sound_t *sound_machine_open(int chipno)
 {
     sound_t *retval = NULL;
@@ -1174,6 +1182,7 @@ int sound_open(void)
         snddata.fragnr = fragnr;
         snddata.bufsize = fragsize * fragnr;
         snddata.bufptr = 0;
+        speculation_bufptr = 0;
 
         if (pdev->init) {
             channels_cap = channels;
@@ -1191,6 +1200,9 @@ int sound_open(void)
             } else {
                 snddata.sound_output_channels = channels;
             }
+        } else {
+            /* like the dummy device, which takes whatever it gets */
+            snddata.sound_output_channels = channels;
         }
         if (snddata.buffer) {
             lib_free(snddata.buffer);
@@ -1360,12 +1372,24 @@ static int sound_run_sound(void)
     if (cycle_based) {
         delta_t = maincpu_clk - snddata.lastclk;
         bufferptr = snddata.buffer + snddata.bufptr * snddata.sound_output_channels;
+        BENCH_ENTER(BENCH_SECTION_SOUND);
         nr = sound_machine_calculate_samples(snddata.psid,
                                              bufferptr,
                                              snddata.bufsize - snddata.bufptr,
                                              snddata.sound_output_channels,
                                              snddata.sound_chip_channels,
                                              &delta_t);
+        /* samples of run-ahead frames are thrown away anyway, so keep
+           reusing the same part of the buffer until the chips caught up */
+        while (speculating && delta_t && nr > 0) {
+            nr = sound_machine_calculate_samples(snddata.psid,
+                                                 bufferptr,
+                                                 snddata.bufsize - snddata.bufptr,
+                                                 snddata.sound_output_channels,
+                                                 snddata.sound_chip_channels,
+                                                 &delta_t);
+        }
+        BENCH_LEAVE();
         if (delta_t && !archdep_is_exiting()) {
 #if 0
             sound_error_log_only("Sound buffer overflow (cycle based)");
@@ -1393,12 +1417,14 @@ static int sound_run_sound(void)
              nr = snddata.bufsize - snddata.bufptr;
          }
          bufferptr = snddata.buffer + snddata.bufptr * snddata.sound_output_channels;
+         BENCH_ENTER(BENCH_SECTION_SOUND);
          sound_machine_calculate_samples(snddata.psid,
                                          bufferptr,
                                          nr,
                                          snddata.sound_output_channels,
                                          snddata.sound_chip_channels,
                                          &delta_t);
+         BENCH_LEAVE();
          snddata.fclk += nr * snddata.clkstep;
      }
 
@@ -1415,6 +1441,11 @@ static int sound_run_sound(void)
     snddata.bufptr += nr;
     snddata.lastclk = maincpu_clk;
 
+    if (speculating) {
+        /* the chips keep running, but nothing is heard */
+        snddata.bufptr = speculation_bufptr;
+    }
+
     return 0;
 }
 
@@ -1427,6 +1458,7 @@ void sound_reset(void)
     snddata.wclk = maincpu_clk;
     snddata.lastclk = maincpu_clk;
     snddata.bufptr = 0;         /* ugly hack! */
+    speculation_bufptr = 0;
     for (c = 0; c < snddata.sound_chip_channels; c++) {
         if (snddata.psid[c]) {
             sound_machine_reset(snddata.psid[c], maincpu_clk);
@@ -1722,7 +1754,7 @@ void sound_store(uint16_t addr, uint8_t val, int chipno)
 
     sound_machine_store(snddata.psid[chipno], addr, val);
 
-    if (!snddata.playdev->dump) {
+    if (!snddata.playdev->dump || speculating) {
         return;
     }
 
@@ -1778,6 +1810,37 @@ void sound_snapshot_finish(void)
     snddata.lastclk = maincpu_clk;
 }
 
+/* Start emulating frames that are not heard (run-ahead): the sound chips
+   keep running, but the samples they generate from now on are dropped.  */
+void sound_speculation_start(void)
+{
+    sound_run_sound();
+
+    speculation_bufptr = snddata.bufptr;
+    speculation_fclk = snddata.fclk;
+    speculation_clk = maincpu_clk;
+    speculating = 1;
+}
+
+/* Stop dropping samples.  Either the machine has been rolled back to where
+   sound_speculation_start() was called, or the speculative state has become
+   the real one; in both cases the chips continue from the current clock.  */
+void sound_speculation_end(void)
+{
+    if (!speculating) {
+        return;
+    }
+
+    speculating = 0;
+    snddata.bufptr = speculation_bufptr;
+    if (maincpu_clk == speculation_clk) {
+        snddata.fclk = speculation_fclk;
+    } else {
+        snddata.fclk = SOUNDCLK_CONSTANT(maincpu_clk);
+    }
+    snddata.lastclk = maincpu_clk;
+}
+
 void sound_dac_init(sound_dac_t *dac, int speed)
 {
     /* 20 dB/Decade high pass filter, cutoff at 5 Hz. For DC offset filtering. */
@@ -259,6 +259,8 @@ void sound_set_warp_mode(int value);
 void sound_set_machine_parameter(long clock_rate, long ticks_per_frame);
 void sound_snapshot_prepare(void);
 void sound_snapshot_finish(void);
+void sound_speculation_start(void);
+void sound_speculation_end(void);
 
 int sound_resources_init(void);
 void sound_resources_shutdown(void);
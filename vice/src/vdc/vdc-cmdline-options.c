@@ -29,13 +29,38 @@
 #include "vice.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
+#include "bench.h"
 #include "cmdline.h"
 #include "raster-cmdline-options.h"
 #include "resources.h"
 #include "vdc-cmdline-options.h"
+#include "vdc-draw.h"
 #include "vdctypes.h"
 
+/* number of random lines for each mode of -benchvdc, see vdc_draw_bench() */
+static int bench_lines = 0;
+
+static void bench_vdc_report(void)
+{
+    vdc_draw_bench(bench_lines);
+}
+
+static int set_bench_vdc(const char *param, void *extra_param)
+{
+    int lines = atoi(param);
+
+    if (lines <= 0) {
+        return -1;
+    }
+    if (bench_lines == 0) {
+        bench_register_report(bench_vdc_report);
+    }
+    bench_lines = lines;
+    return 0;
+}
+
 /* VDC command-line options.  */
 static const cmdline_option_t cmdline_options[] =
 {
@@ -54,6 +79,9 @@ static const cmdline_option_t cmdline_options[] =
     { "-VDCRevision", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
       NULL, NULL, "VDCRevision", NULL,
       "<number>", "Set VDC revision (0..2)" },
+    { "-benchvdc", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
+      set_bench_vdc, NULL, NULL, NULL,
+      "<lines>", "Benchmark mode: also draw <lines> lines of random VDC cells and attributes in each mode with and without SSE2 and compare them" },
     CMDLINE_LIST_END
 };
 
@@ -31,6 +31,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "archdep.h"
+#include "lib.h"
 #include "raster-cache-const.h"
 #include "raster-cache-fill.h"
 #include "raster-cache.h"
@@ -42,6 +44,13 @@
 #include "vdc.h"
 #include "vdctypes.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VDC_DRAW_X86
+#include <immintrin.h>
+
+#define VDC_DRAW_SSE2 __attribute__((target("sse2")))
+#endif
+
 /* The following tables are used to speed up the drawing.  We do not use
    multi-dimensional arrays as we can optimize better this way...  */
 
@@ -497,6 +506,489 @@ inline static int cache_data_fill(uint8_t *dest,
 
 /*-----------------------------------------------------------------------*/
 
+/* draw_std_text() and draw_std_bitmap() work in three steps: fetch the
+   character or bitmap data of a raster line, apply the masks and
+   attributes with decode_cells(), then expand the cells to pixels with
+   draw_cells(). Where SSE2 is available the last two steps handle 16
+   cells at a time, the result is identical to the plain C code.  */
+
+/* One decoded raster line. This is local to the draw functions so the
+   compiler knows that filling it in does not change the vdc state. */
+typedef struct vdc_cells_s {
+    /* the displayed bits of the character, with all attributes applied */
+    uint8_t data[VDC_SCREEN_MAX_TEXTCOLS];
+    /* the displayed bits of the inter character gap */
+    uint8_t gap_data[VDC_SCREEN_MAX_TEXTCOLS];
+    /* foreground(4) | background(4), like register 26 */
+    uint8_t colors[VDC_SCREEN_MAX_TEXTCOLS];
+} vdc_cells_t;
+
+/* The attribute bits that take effect on the current raster line, 0 if none
+   does, see decode_cells() */
+static unsigned int underline_attr;  /* VDC_UNDERLINE_ATTR on the underline scan line */
+static unsigned int blink_attr;      /* VDC_FLASH_ATTR while blinking characters are off */
+static unsigned int reverse_attr;    /* VDC_REVERSE_ATTR in text attribute mode */
+static unsigned int screen_reverse;  /* 0xFF for whole screen reverse */
+
+#ifdef VDC_DRAW_X86
+static int draw_cells_sse2_supported = 0;
+#endif
+
+/* Turn the fetched data of cells `start' to `end' - 1 into the displayed
+   bits and colors. `attr_ptr' is NULL in monochrome mode. In bitmap mode the
+   attribute holds the background color in the high nibble instead of the
+   alternate charset, blink, underline and reverse bits. */
+static void decode_cells_c(vdc_cells_t *cells, const uint8_t *attr_ptr, int bitmap,
+                           unsigned int start, unsigned int end)
+{
+    unsigned int i, d, d2, attr, invert;
+
+    for (i = start; i < end; i++) {
+        attr = (attr_ptr != NULL) ? attr_ptr[i] : 0;
+
+        d = cells->data[i] & dmask; /* mask off to active pixels only */
+        d2 = 0x00;
+
+        /* set underline if the underline attrib is set for this char */
+        /* Pixels per char does not apply to the underline but the underline does blink, reverse and extend through inter-character spacing */
+        if (attr & underline_attr) {
+            d = 0xFF;
+            d2 = 0xFF;
+        }
+
+        /* blink if the blink attribute is set for this char */
+        if (attr & blink_attr) {
+            d = 0x00;
+            d2 = 0x00;
+        }
+
+        /* Handle semi-graphics mode. Note semi_gfx_test doubles as a flag, if it's 0 this just falls through */
+        if (d & semi_gfx_test) { /* if the far right pixel is on.. */
+            d |= semi_gfx_mask;  /* .. mask the rest of the right hand side on */
+            d2 = semi_gfx_type;  /* this will get masked off later on, so we just set all (or none) inter-char pixels on for now */
+        }
+
+        /* reverse if the reverse attribute is set for this char, and whole screen reverse */
+        invert = screen_reverse;
+        if (attr & reverse_attr) {
+            invert ^= 0xFF;
+        }
+
+        cells->data[i] = (uint8_t)(d ^ invert);
+        cells->gap_data[i] = (uint8_t)((d2 ^ invert) & d2mask);    /* Mask off any extra "on" pixels from the inter-character gap */
+
+        if (attr_ptr == NULL) {
+            /* monochrome mode - foreground & background colours both from register 26 */
+            cells->colors[i] = (uint8_t)vdc.regs[26];
+        } else if (bitmap) {
+            cells->colors[i] = (uint8_t)(((attr & 0x0F) << 4) | (attr >> 4));
+        } else {
+            /* background colour from regs[26] but foreground from attribute ram */
+            cells->colors[i] = (uint8_t)(((attr & 0x0F) << 4) | (vdc.regs[26] & 0x0F));
+        }
+    }
+}
+
+/* Expand cells `start' to `end' - 1 with the lookup tables */
+static void draw_cells_c(const vdc_cells_t *cells, uint8_t *p, unsigned int start,
+                         unsigned int end)
+{
+    uint8_t *q;
+    unsigned int i, d, d2;
+    int icsi = -1;  /* Inter Character Spacing Index - used as a combo flag/index as to whether there is any intercharacter gap to render */
+
+    if (vdc.regs[25] & 0x10) { /* double pixel a.k.a 40column mode */
+        if (vdc.charwidth > 16) {   /* Is there inter character spacing to render? */
+            icsi = vdc.charwidth / 2 - 8;
+        }
+    } else { /* 80 column mode */
+        if (vdc.charwidth > 8) {    /* Is there inter character spacing to render? */
+            icsi = vdc.charwidth - 8;
+        }
+    }
+
+    p += start * vdc.charwidth;
+
+    if (vdc.regs[25] & 0x10) { /* double pixel mode */
+        for (i = start; i < end; i++, p += vdc.charwidth) {
+            uint32_t *pdwl = pdl_table + (cells->colors[i] << 4);
+            uint32_t *pdwh = pdh_table + (cells->colors[i] << 4);
+            d = cells->data[i];
+            *((uint32_t *)p) = *(pdwh + (d >> 4));
+            *((uint32_t *)p + 1) = *(pdwl + (d >> 4));
+            *((uint32_t *)p + 2) = *(pdwh + (d & 0x0F));
+            *((uint32_t *)p + 3) = *(pdwl + (d & 0x0F));
+            if (icsi >= 0) {    /* if there's inter character spacing, then render it */
+                q = p + 16;
+                d2 = cells->gap_data[i];
+                *((uint32_t *)q) = *(pdwh + (d2 >> 4));
+                *((uint32_t *)q + 1) = *(pdwl + (d2 >> 4));
+                *((uint32_t *)q + 2) = *(pdwh + (d2 & 0x0F));
+                *((uint32_t *)q + 3) = *(pdwl + (d2 & 0x0F));
+            }
+        }
+    } else { /* normal text size */
+        for (i = start; i < end; i++, p += vdc.charwidth) {
+            uint32_t *ptr = hr_table + (cells->colors[i] << 4);
+            d = cells->data[i];
+            *((uint32_t *)p) = *(ptr + (d >> 4));
+            *((uint32_t *)p + 1) = *(ptr + (d & 0x0F));
+            if (icsi >= 0) {    /* if there's inter character spacing, then render it */
+                q = p + 8;
+                d2 = cells->gap_data[i];
+                *((uint32_t *)q) = *(ptr + (d2 >> 4));
+                *((uint32_t *)q + 1) = *(ptr + (d2 & 0x0F));
+            }
+        }
+    }
+}
+
+#ifdef VDC_DRAW_X86
+/* 0xFF in each byte where `a & bits' is not zero */
+VDC_DRAW_SSE2
+inline static __m128i test_bits_sse2(__m128i a, __m128i bits)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    return _mm_andnot_si128(_mm_cmpeq_epi8(_mm_and_si128(a, bits), zero),
+                            _mm_cmpeq_epi8(zero, zero));
+}
+
+/* decode_cells_c() for 16 cells at a time. Returns the number of cells
+   done, the rest is left to decode_cells_c(). */
+VDC_DRAW_SSE2
+static unsigned int decode_cells_sse2(vdc_cells_t *cells, const uint8_t *attr_ptr,
+                                      int bitmap, unsigned int end)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i data_mask = _mm_set1_epi8((char)dmask);
+    const __m128i gap_mask = _mm_set1_epi8((char)d2mask);
+    const __m128i underline = _mm_set1_epi8((char)underline_attr);
+    const __m128i blink = _mm_set1_epi8((char)blink_attr);
+    const __m128i reverse = _mm_set1_epi8((char)reverse_attr);
+    const __m128i screen = _mm_set1_epi8((char)screen_reverse);
+    const __m128i gfx_test = _mm_set1_epi8((char)semi_gfx_test);
+    const __m128i gfx_mask = _mm_set1_epi8((char)semi_gfx_mask);
+    const __m128i gfx_type = _mm_set1_epi8((char)semi_gfx_type);
+    __m128i attr = _mm_setzero_si128();
+    __m128i colors = _mm_set1_epi8((char)vdc.regs[26]);
+    __m128i background = _mm_set1_epi8((char)(vdc.regs[26] & 0x0F));
+    __m128i d, d2, m, invert;
+    unsigned int i;
+
+    for (i = 0; i + 16 <= end; i += 16) {
+        if (attr_ptr != NULL) {
+            attr = _mm_loadu_si128((const __m128i *)(attr_ptr + i));
+            if (bitmap) {
+                background = _mm_and_si128(_mm_srli_epi16(attr, 4), nibble);
+            }
+            colors = _mm_or_si128(_mm_andnot_si128(nibble, _mm_slli_epi16(attr, 4)),
+                                  background);
+        }
+
+        d = _mm_and_si128(_mm_loadu_si128((const __m128i *)(cells->data + i)), data_mask);
+
+        /* underline, then blink */
+        d2 = test_bits_sse2(attr, underline);
+        d = _mm_or_si128(d, d2);
+        m = test_bits_sse2(attr, blink);
+        d = _mm_andnot_si128(m, d);
+        d2 = _mm_andnot_si128(m, d2);
+
+        /* semi-graphics */
+        m = test_bits_sse2(d, gfx_test);
+        d = _mm_or_si128(d, _mm_and_si128(m, gfx_mask));
+        d2 = _mm_or_si128(_mm_and_si128(m, gfx_type), _mm_andnot_si128(m, d2));
+
+        /* reverse attribute and whole screen reverse */
+        invert = _mm_xor_si128(screen, test_bits_sse2(attr, reverse));
+
+        _mm_storeu_si128((__m128i *)(cells->data + i), _mm_xor_si128(d, invert));
+        _mm_storeu_si128((__m128i *)(cells->gap_data + i),
+                         _mm_and_si128(_mm_xor_si128(d2, invert), gap_mask));
+        _mm_storeu_si128((__m128i *)(cells->colors + i), colors);
+    }
+    return i;
+}
+
+/* Spread each of the 16 bytes of `v' over 8 bytes, two cells per vector */
+VDC_DRAW_SSE2
+inline static void spread_cells_sse2(__m128i v, __m128i *out)
+{
+    __m128i w[2], x[4];
+    int k;
+
+    w[0] = _mm_unpacklo_epi8(v, v);
+    w[1] = _mm_unpackhi_epi8(v, v);
+    for (k = 0; k < 2; k++) {
+        x[k * 2] = _mm_unpacklo_epi16(w[k], w[k]);
+        x[k * 2 + 1] = _mm_unpackhi_epi16(w[k], w[k]);
+    }
+    for (k = 0; k < 4; k++) {
+        out[k * 2] = _mm_unpacklo_epi32(x[k], x[k]);
+        out[k * 2 + 1] = _mm_unpackhi_epi32(x[k], x[k]);
+    }
+}
+
+/* draw_cells_c() for 16 cells at a time, only for cells without inter
+   character gap. Returns the number of cells done, the rest is left to
+   draw_cells_c(). */
+VDC_DRAW_SSE2
+static unsigned int draw_cells_sse2(const vdc_cells_t *cells, uint8_t *p,
+                                    unsigned int end)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    /* the bit of the cell data that selects each pixel, leftmost first */
+    const __m128i bits = _mm_setr_epi8(
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i bits2 = _mm_setr_epi8(
+        (char)0x80, (char)0x80, 0x40, 0x40, 0x20, 0x20, 0x10, 0x10,
+        0x08, 0x08, 0x04, 0x04, 0x02, 0x02, 0x01, 0x01);
+    int double_pixel = (vdc.regs[25] & 0x10) ? 1 : 0;
+    __m128i data[8], bg[8], fgbg[8];
+    __m128i d, c, b, m;
+    unsigned int i;
+    int k, h;
+
+    for (i = 0; i + 16 <= end; i += 16) {
+        d = _mm_loadu_si128((const __m128i *)(cells->data + i));
+        c = _mm_loadu_si128((const __m128i *)(cells->colors + i));
+        b = _mm_and_si128(c, nibble);
+        spread_cells_sse2(d, data);
+        spread_cells_sse2(b, bg);
+        /* pixel = bg ^ ((fg ^ bg) & mask) */
+        spread_cells_sse2(_mm_xor_si128(_mm_and_si128(_mm_srli_epi16(c, 4), nibble), b), fgbg);
+
+        if (double_pixel) {
+            /* one cell of 16 pixels per vector */
+            for (k = 0; k < 8; k++) {
+                for (h = 0; h < 2; h++) {
+                    if (h == 0) {
+                        d = _mm_unpacklo_epi64(data[k], data[k]);
+                        b = _mm_unpacklo_epi64(bg[k], bg[k]);
+                        c = _mm_unpacklo_epi64(fgbg[k], fgbg[k]);
+                    } else {
+                        d = _mm_unpackhi_epi64(data[k], data[k]);
+                        b = _mm_unpackhi_epi64(bg[k], bg[k]);
+                        c = _mm_unpackhi_epi64(fgbg[k], fgbg[k]);
+                    }
+                    m = _mm_cmpeq_epi8(_mm_and_si128(d, bits2), bits2);
+                    _mm_storeu_si128((__m128i *)(p + (i + k * 2 + h) * 16),
+                                     _mm_xor_si128(b, _mm_and_si128(c, m)));
+                }
+            }
+        } else {
+            /* two cells of 8 pixels per vector */
+            for (k = 0; k < 8; k++) {
+                m = _mm_cmpeq_epi8(_mm_and_si128(data[k], bits), bits);
+                _mm_storeu_si128((__m128i *)(p + (i + k * 2) * 8),
+                                 _mm_xor_si128(bg[k], _mm_and_si128(fgbg[k], m)));
+            }
+        }
+    }
+    return i;
+}
+#endif
+
+/* Apply the masks and attributes to the fetched data of cells 0 to `end' - 1 */
+static void decode_cells(vdc_cells_t *cells, const uint8_t *attr_ptr, int bitmap,
+                         unsigned int end)
+{
+    unsigned int start = 0;
+
+#ifdef VDC_DRAW_X86
+    if (draw_cells_sse2_supported) {
+        start = decode_cells_sse2(cells, attr_ptr, bitmap, end);
+    }
+#endif
+    decode_cells_c(cells, attr_ptr, bitmap, start, end);
+}
+
+/* Expand the decoded cells 0 to `end' - 1 into pixels at `p' */
+static void draw_cells(const vdc_cells_t *cells, uint8_t *p, unsigned int end)
+{
+    unsigned int start = 0;
+
+#ifdef VDC_DRAW_X86
+    if (draw_cells_sse2_supported
+        && vdc.charwidth == ((vdc.regs[25] & 0x10) ? 16 : 8)) {
+        start = draw_cells_sse2(cells, p, end);
+    }
+#endif
+    draw_cells_c(cells, p, start, end);
+}
+
+static void init_draw_cells(void)
+{
+#ifdef VDC_DRAW_X86
+    __builtin_cpu_init();
+    draw_cells_sse2_supported = __builtin_cpu_supports("sse2") ? 1 : 0;
+#endif
+}
+
+/*-----------------------------------------------------------------------*/
+
+/* Benchmark mode (-benchvdc): lines of random cell data and attributes,
+   drawn with random register 22, 24, 25 and 26 contents by decode_cells()
+   and draw_cells() with and without SSE2.  */
+
+#define VDC_BENCH_COLS      80
+#define VDC_BENCH_PITCH     (VDC_BENCH_COLS * 16 + 32)
+
+typedef struct vdc_bench_line_s {
+    uint8_t data[VDC_BENCH_COLS];
+    uint8_t attr[VDC_BENCH_COLS];
+    uint8_t regs22, regs24, regs25, regs26;
+    uint8_t underline, blink;
+} vdc_bench_line_t;
+
+typedef struct vdc_bench_mode_s {
+    const char *name;
+    uint8_t regs25;     /* bitmap, attribute and double pixel bits */
+    unsigned int cols;
+} vdc_bench_mode_t;
+
+static const vdc_bench_mode_t vdc_bench_modes[] = {
+    { "text80", 0x40, 80 },
+    { "text80mono", 0x00, 80 },
+    { "bitmap80", 0xc0, 80 },
+    { "bitmap80mono", 0x80, 80 },
+    { "text40", 0x50, 40 },
+    { "bitmap40", 0xd0, 40 },
+};
+
+static void vdc_bench_fill(vdc_bench_line_t *lines, int num, const vdc_bench_mode_t *mode)
+{
+    int i;
+    unsigned int j;
+
+    for (i = 0; i < num; i++) {
+        for (j = 0; j < mode->cols; j++) {
+            lines[i].data[j] = (uint8_t)lib_unsigned_rand(0, 255);
+            lines[i].attr[j] = (uint8_t)lib_unsigned_rand(0, 255);
+        }
+        lines[i].regs22 = (uint8_t)lib_unsigned_rand(0, 255);
+        /* mostly the usual character width, which SSE2 can expand */
+        if (lib_unsigned_rand(0, 3) != 0) {
+            lines[i].regs22 = (uint8_t)((lines[i].regs22 & 0x0f)
+                                        | ((mode->regs25 & 0x10) ? 0x80 : 0x70));
+        }
+        lines[i].regs24 = (uint8_t)lib_unsigned_rand(0, 255);
+        /* random semi-graphics bit */
+        lines[i].regs25 = (uint8_t)(mode->regs25 | (lib_unsigned_rand(0, 255) & 0x20));
+        lines[i].regs26 = (uint8_t)lib_unsigned_rand(0, 255);
+        lines[i].underline = (lib_unsigned_rand(0, 3) == 0);
+        lines[i].blink = (lib_unsigned_rand(0, 1) == 0);
+    }
+}
+
+static void vdc_bench_draw(const vdc_bench_line_t *lines, int num,
+                           const vdc_bench_mode_t *mode, uint8_t *trg)
+{
+    vdc_cells_t cells;
+    int bitmap = (mode->regs25 & 0x80) ? 1 : 0;
+    int i;
+
+    for (i = 0; i < num; i++) {
+        vdc.regs[22] = lines[i].regs22;
+        vdc.regs[24] = lines[i].regs24;
+        vdc.regs[25] = lines[i].regs25;
+        vdc.regs[26] = lines[i].regs26;
+        if (vdc.regs[25] & 0x10) {
+            vdc.charwidth = 2 * (vdc.regs[22] >> 4);
+        } else {
+            vdc.charwidth = 1 + (vdc.regs[22] >> 4);
+        }
+        calculate_draw_masks();
+
+        /* the same attribute setup as draw_std_text() and draw_std_bitmap() */
+        if (!bitmap && (vdc.regs[25] & 0x40)) {
+            underline_attr = lines[i].underline ? VDC_UNDERLINE_ATTR : 0;
+            blink_attr = lines[i].blink ? VDC_FLASH_ATTR : 0;
+            reverse_attr = VDC_REVERSE_ATTR;
+        } else {
+            underline_attr = 0;
+            blink_attr = 0;
+            reverse_attr = 0;
+        }
+        screen_reverse = (vdc.regs[24] & VDC_REVERSE_ATTR) ? 0xFF : 0x00;
+
+        memcpy(cells.data, lines[i].data, mode->cols);
+        decode_cells(&cells, (vdc.regs[25] & 0x40) ? lines[i].attr : NULL, bitmap,
+                     mode->cols);
+        draw_cells(&cells, trg + (size_t)i * VDC_BENCH_PITCH, mode->cols);
+    }
+}
+
+/** \brief  Compare and time the SSE2 and lookup table cell drawing
+ *
+ * Draws \a num lines of random cells for each mode in vdc_bench_modes[]
+ * with the lookup tables and, where available, with SSE2, and prints one
+ * "vice-bench:" line for each. The SSE2 output is compared against the
+ * lookup table one. The VDC registers are restored afterwards.
+ *
+ * \param[in]  num  number of lines to draw for each mode
+ */
+void vdc_draw_bench(int num)
+{
+    vdc_bench_line_t *lines;
+    uint8_t *reference, *trg;
+    uint8_t regs[sizeof(vdc.regs)];
+    unsigned int charwidth = vdc.charwidth;
+    size_t size = (size_t)num * VDC_BENCH_PITCH;
+    unsigned int m;
+    int impl, impls = 1;
+    tick_t start;
+    double usecs;
+#ifdef VDC_DRAW_X86
+    int sse2_supported = draw_cells_sse2_supported;
+
+    impls = sse2_supported ? 2 : 1;
+#endif
+
+    if (num <= 0) {
+        return;
+    }
+
+    memcpy(regs, vdc.regs, sizeof(regs));
+    lines = lib_malloc(sizeof(vdc_bench_line_t) * (size_t)num);
+    reference = lib_malloc(size);
+    trg = lib_malloc(size);
+
+    for (m = 0; m < sizeof(vdc_bench_modes) / sizeof(vdc_bench_modes[0]); m++) {
+        vdc_bench_fill(lines, num, &vdc_bench_modes[m]);
+        for (impl = 0; impl < impls; impl++) {
+#ifdef VDC_DRAW_X86
+            draw_cells_sse2_supported = impl;
+#endif
+            memset(trg, 0, size);
+            start = tick_now();
+            vdc_bench_draw(lines, num, &vdc_bench_modes[m], trg);
+            usecs = (double)TICK_TO_MICRO(tick_now_delta(start)) / num;
+
+            if (impl == 0) {
+                memcpy(reference, trg, size);
+            }
+            printf("vice-bench: vdc=%s impl=%s lines=%d us_per_line=%.3f identical=%s\n",
+                   vdc_bench_modes[m].name, impl ? "sse2" : "table", num, usecs,
+                   memcmp(reference, trg, size) == 0 ? "yes" : "NO");
+        }
+    }
+    fflush(stdout);
+
+#ifdef VDC_DRAW_X86
+    draw_cells_sse2_supported = sse2_supported;
+#endif
+    memcpy(vdc.regs, regs, sizeof(regs));
+    vdc.charwidth = charwidth;
+    lib_free(trg);
+    lib_free(reference);
+    lib_free(lines);
+}
+
+/*-----------------------------------------------------------------------*/
+
 static int get_std_text(raster_cache_t *cache, unsigned int *xs, unsigned int *xe, int rr)
 /* aka raster_modes_fill_cache() in raster */
 {
@@ -657,26 +1149,16 @@ static void draw_std_text(void)
    (vdc.raster.draw_buffer_ptr), which is one byte per pixel, based on the VDC
    screen, attr(ibute) and char(set) ram (which are one byte per 8 pixels */
 {
-    uint8_t *p, *q;
-    uint32_t *table_ptr, *pdl_ptr, *pdh_ptr, char_index;
+    uint8_t *p;
+    uint32_t char_index;
     uint8_t *attr_ptr, *screen_ptr;
+    vdc_cells_t cells;
 
-    unsigned int i, d, d2;
+    unsigned int i, n;
     unsigned int cpos = 0xFFFF;
-    int icsi = -1;  /* Inter Character Spacing Index - used as a combo flag/index as to whether there is any intercharacter gap to render */
 
     cpos = vdc.crsrpos - vdc.screen_adr - vdc.mem_counter;
 
-    if(vdc.regs[25] & 0x10) { /* double pixel a.k.a 40column mode */
-        if (vdc.charwidth > 16) {   /* Is there inter character spacing to render? */
-            icsi = vdc.charwidth / 2 - 8;
-        }
-    } else { /* 80 column mode */
-        if (vdc.charwidth > 8) {    /* Is there inter character spacing to render? */
-            icsi = vdc.charwidth - 8;
-        }
-    }
-
     p = vdc.raster.draw_buffer_ptr
         + vdc.border_width
         + ((vdc.regs[25] & 0x10) ? 2 : 0)
@@ -691,170 +1173,64 @@ static void draw_std_text(void)
 
     calculate_draw_masks();
 
-    /* Now actually render everything */
-    if (vdc.regs[25] & 0x40) {  /* Attribute mode - background colour from regs[26] but foreground from attribute ram */
-        table_ptr = hr_table + ((vdc.regs[26] & 0x0F) << 4);    /* regs[26] & 0xF is the background colour */
-        pdl_ptr = pdl_table + ((vdc.regs[26] & 0x0F) << 4);
-        pdh_ptr = pdh_table + ((vdc.regs[26] & 0x0F) << 4);
-        for (i = 0; i < vdc.screen_text_cols; i++, p += vdc.charwidth) {
-            if (vdc.raster.ycounter > (signed)vdc.regs[23]) {
-                /* Return nothing if > Vertical Character Size */
-                d = 0x00;
-            } else {
-                d = vdc_ram_read(char_index
-                  + ((*(attr_ptr + i) & VDC_ALTCHARSET_ATTR) ? 0x100 * vdc.bytes_per_char : 0) /* the offset to the alternate character set is either 0x1000 or 0x2000, depending on the character size (16 or 32) */
-                  + (*(screen_ptr + i) * vdc.bytes_per_char));
-            }
-            d &= dmask; /* mask off to active pixels only */
-            d2 = 0x00;
-
-            /* set underline if the underline attrib is set for this char */
-            /* Pixels per char does not apply to the underline but the underline does blink, reverse and extend through inter-character spacing */
-            if ((vdc.raster.ycounter == vdc.regs[29]) && (*(attr_ptr + i) & VDC_UNDERLINE_ATTR)) {
-                d = 0xFF;
-                d2 = 0xFF;
-            }
-
-            /* blink if the blink attribute is set for this char */
-            if (vdc.attribute_blink && (*(attr_ptr + i) & VDC_FLASH_ATTR)) {
-                d = 0x00;
-                d2 = 0x00;
-            }
+    n = vdc.screen_text_cols;
 
-            /* Handle semi-graphics mode. Note semi_gfx_test doubles as a flag, if it's 0 this just falls through */
-            if (d & semi_gfx_test) { /* if the far right pixel is on.. */
-                d |= semi_gfx_mask;  /* .. mask the rest of the right hand side on */
-                d2 = semi_gfx_type;  /* this will get masked off later on, so we just set all (or none) inter-char pixels on for now */
-            }
-
-            /* reverse if the reverse attribute is set for this char */
-            if (*(attr_ptr + i) & VDC_REVERSE_ATTR) {
-                d ^= 0xFF;
-                d2 ^= 0xFF;
-            }
-
-            if (cpos == i) { /* handle cursor if this is the cursor */
-                if ((vdc.frame_counter | 1) & crsrblink[(vdc.regs[10] >> 5) & 3]) {
-                    /* invert current byte of the character if we are within the cursor area */
-                    if (
-                    ((vdc.raster.ycounter >= (vdc.regs[10] & 0x1F)) && (vdc.raster.ycounter < (vdc.regs[11] & 0x1F)))
-                    || ((vdc.raster.ycounter == (vdc.regs[10] & 0x1F)) && (vdc.raster.ycounter == (vdc.regs[11] & 0x1F)))
-                    || (((vdc.regs[10] & 0x1F) > (vdc.regs[11] & 0x1F)) && ((vdc.raster.ycounter >= (vdc.regs[10] & 0x1F)) || (vdc.raster.ycounter < (vdc.regs[11] & 0x1F))))
-                    ) {
-                        /* The VDC cursor reverses the char */
-                        d ^= 0xFF;
-                        d2 ^= 0xFF;
-                    }
-                }
-            }
-
-            if (vdc.regs[24] & VDC_REVERSE_ATTR) { /* whole screen reverse */
-                d ^= 0xFF;
-                d2 ^= 0xFF;
-            }
-
-            d2 &= d2mask;   /* Mask off any extra "on" pixels from the inter-character gap */
-
-            /* actually render the byte into 8 bytes of colour pixels using the lookup tables */
-            if (vdc.regs[25] & 0x10) { /* double pixel mode */
-                uint32_t *pdwl = pdl_ptr + ((*(attr_ptr + i) & 0x0F) << 8);
-                uint32_t *pdwh = pdh_ptr + ((*(attr_ptr + i) & 0x0F) << 8);
-                *((uint32_t *)p) = *(pdwh + (d >> 4));
-                *((uint32_t *)p + 1) = *(pdwl + (d >> 4));
-                *((uint32_t *)p + 2) = *(pdwh + (d & 0x0F));
-                *((uint32_t *)p + 3) = *(pdwl + (d & 0x0F));
-                if (icsi >= 0) {    /* if there's inter character spacing, then render it */
-                    q = p + 16;
-                    *((uint32_t *)q) = *(pdwh + (d2 >> 4));
-                    *((uint32_t *)q + 1) = *(pdwl + (d2 >> 4));
-                    *((uint32_t *)q + 2) = *(pdwh + (d2 & 0x0F));
-                    *((uint32_t *)q + 3) = *(pdwl + (d2 & 0x0F));
-                }
-            } else { /* normal text size */
-                uint32_t *ptr = table_ptr + ((*(attr_ptr + i) & 0x0F) << 8);
-                *((uint32_t *)p) = *(ptr + (d >> 4));
-                *((uint32_t *)p + 1) = *(ptr + (d & 0x0F));
-                if (icsi >= 0) {    /* if there's inter character spacing, then render it */
-                    q = p + 8;
-                    *((uint32_t *)q) = *(ptr + (d2 >> 4));
-                    *((uint32_t *)q + 1) = *(ptr + (d2 & 0x0F));
-                }
-            }
+    /* fetch the character data */
+    if (vdc.raster.ycounter > (signed)vdc.regs[23]) {
+        /* Return nothing if > Vertical Character Size */
+        memset(cells.data, 0, n);
+    } else if (vdc.regs[25] & 0x40) {
+        for (i = 0; i < n; i++) {
+            cells.data[i] = vdc.ram[vdc_ram_address(char_index
+              + ((*(attr_ptr + i) & VDC_ALTCHARSET_ATTR) ? 0x100 * vdc.bytes_per_char : 0) /* the offset to the alternate character set is either 0x1000 or 0x2000, depending on the character size (16 or 32) */
+              + (*(screen_ptr + i) * vdc.bytes_per_char))];
         }
-    } else {    /* Monochrome mode - foreground & background colours both from register 26 */
-        uint32_t *ptr = hr_table + (vdc.regs[26] << 4);
-        uint32_t *pdwl = pdl_table + (vdc.regs[26] << 4);  /* Pointers into the lookup tables */
-        uint32_t *pdwh = pdh_table + (vdc.regs[26] << 4);
-        for (i = 0; i < vdc.screen_text_cols; i++, p += vdc.charwidth) {
-            if (vdc.raster.ycounter > (signed)vdc.regs[23]) {
-                /* Return nothing if > Vertical Character Size */
-                d = 0x00;
-            } else {
-                d = vdc_ram_read(char_index
-                  + (*(screen_ptr + i) * vdc.bytes_per_char));
-            }
-            d &= dmask; /* mask off to active pixels only */
-            d2 = 0x00;
-
-            /* Handle semi-graphics mode. Note semi_gfx_test doubles as a flag, if it's 0 this just falls through */
-            if (d & semi_gfx_test) { /* if the far right pixel is on.. */
-                d |= semi_gfx_mask;  /* .. mask the rest of the right hand side on */
-                d2 = semi_gfx_type;  /* this will get masked off later on, so we just set all (or none) inter-char pixels on for now */
-            }
-
-            if (cpos == i) { /* handle cursor if this is the cursor */
-                if ((vdc.frame_counter | 1) & crsrblink[(vdc.regs[10] >> 5) & 3]) {
-                    /* invert current byte of the character if we are within the cursor area */
-                    if (
-                    ((vdc.raster.ycounter >= (vdc.regs[10] & 0x1F)) && (vdc.raster.ycounter < (vdc.regs[11] & 0x1F)))
-                    || ((vdc.raster.ycounter == (vdc.regs[10] & 0x1F)) && (vdc.raster.ycounter == (vdc.regs[11] & 0x1F)))
-                    || (((vdc.regs[10] & 0x1F) > (vdc.regs[11] & 0x1F)) && ((vdc.raster.ycounter >= (vdc.regs[10] & 0x1F)) || (vdc.raster.ycounter < (vdc.regs[11] & 0x1F))))
-                    ) {
-                        /* The VDC cursor reverses the char */
-                        d ^= 0xFF;
-                        d2 ^= 0xFF;
-                    }
-                }
-            }
-
-            if (vdc.regs[24] & VDC_REVERSE_ATTR) { /* whole screen reverse */
-                d ^= 0xFF;
-                d2 ^= 0xFF;
-            }
+    } else {
+        for (i = 0; i < n; i++) {
+            cells.data[i] = vdc.ram[vdc_ram_address(char_index
+              + (*(screen_ptr + i) * vdc.bytes_per_char))];
+        }
+    }
 
-            d2 &= d2mask;   /* Mask off any extra "on" pixels from the inter-character gap */
+    /* Now apply the attributes */
+    if (vdc.regs[25] & 0x40) {  /* Attribute mode - background colour from regs[26] but foreground from attribute ram */
+        underline_attr = (vdc.raster.ycounter == vdc.regs[29]) ? VDC_UNDERLINE_ATTR : 0;
+        blink_attr = vdc.attribute_blink ? VDC_FLASH_ATTR : 0;
+        reverse_attr = VDC_REVERSE_ATTR;
+    } else {    /* Monochrome mode - foreground & background colours both from register 26 */
+        attr_ptr = NULL;
+        underline_attr = 0;
+        blink_attr = 0;
+        reverse_attr = 0;
+    }
+    screen_reverse = (vdc.regs[24] & VDC_REVERSE_ATTR) ? 0xFF : 0x00;
+    decode_cells(&cells, attr_ptr, 0, n);
 
-            /* actually render the byte into 8 bytes of colour pixels using the lookup tables */
-            if (vdc.regs[25] & 0x10) { /* double pixel mode */
-                *((uint32_t *)p) = *(pdwh + (d >> 4));
-                *((uint32_t *)p + 1) = *(pdwl + (d >> 4));
-                *((uint32_t *)p + 2) = *(pdwh + (d & 0x0F));
-                *((uint32_t *)p + 3) = *(pdwl + (d & 0x0F));
-                if (icsi >= 0) {    /* if there's inter character spacing, then render it */
-                    q = p + 16;
-                    *((uint32_t *)q) = *(pdwh + (d2 >> 4));
-                    *((uint32_t *)q + 1) = *(pdwl + (d2 >> 4));
-                    *((uint32_t *)q + 2) = *(pdwh + (d2 & 0x0F));
-                    *((uint32_t *)q + 3) = *(pdwl + (d2 & 0x0F));
-                }
-            } else { /* normal text size */
-                *((uint32_t *)p) = *(ptr + (d >> 4));
-                *((uint32_t *)p + 1) = *(ptr + (d & 0x0F));
-                if (icsi >= 0) {    /* if there's inter character spacing, then render it */
-                    q = p + 8;
-                    *((uint32_t *)q) = *(ptr + (d2 >> 4));
-                    *((uint32_t *)q + 1) = *(ptr + (d2 & 0x0F));
-                }
+    if (cpos < n) { /* handle cursor if it is on this line */
+        if ((vdc.frame_counter | 1) & crsrblink[(vdc.regs[10] >> 5) & 3]) {
+            /* invert current byte of the character if we are within the cursor area */
+            if (
+            ((vdc.raster.ycounter >= (vdc.regs[10] & 0x1F)) && (vdc.raster.ycounter < (vdc.regs[11] & 0x1F)))
+            || ((vdc.raster.ycounter == (vdc.regs[10] & 0x1F)) && (vdc.raster.ycounter == (vdc.regs[11] & 0x1F)))
+            || (((vdc.regs[10] & 0x1F) > (vdc.regs[11] & 0x1F)) && ((vdc.raster.ycounter >= (vdc.regs[10] & 0x1F)) || (vdc.raster.ycounter < (vdc.regs[11] & 0x1F))))
+            ) {
+                /* The VDC cursor reverses the char */
+                cells.data[cpos] ^= 0xFF;
+                cells.gap_data[cpos] ^= d2mask;
             }
         }
     }
+
+    /* actually render the cells into colour pixels */
+    draw_cells(&cells, p, n);
+    p += n * vdc.charwidth;
+
     /* fill the last few pixels of the display with bg colour if smooth scroll != 0 */
     for (i = vdc.xsmooth; i < (unsigned)(vdc.regs[22] >> 4); i++, p++) {
         *p = (vdc.regs[26] & 0x0F);
     }
 }
 
-
 static int get_std_bitmap(raster_cache_t *cache, unsigned int *xs,
                           unsigned int *xe, int rr)
 /* aka raster_modes_fill_cache() in raster */
@@ -988,21 +1364,11 @@ static void draw_std_bitmap(void)
 /* raster_modes_draw_line() in raster - draw bitmap mode when cache is not used
    See draw_std_text(), this is for bitmap mode. */
 {
-    uint8_t *p, *q;
+    uint8_t *p;
     uint8_t *attr_ptr;
+    vdc_cells_t cells;
 
-    unsigned int i, d, d2, j, fg, bg, bitmap_index;
-    int icsi = -1;  /* Inter Character Spacing Index - used as a combo flag/index as to whether there is any intercharacter gap to render */
-
-    if(vdc.regs[25] & 0x10) { /* double pixel a.k.a 40column mode */
-        if (vdc.charwidth > 16) {   /* Is there inter character spacing to render? */
-            icsi = vdc.charwidth / 2 - 8;
-        }
-    } else { /* 80 column mode */
-        if (vdc.charwidth > 8) {    /* Is there inter character spacing to render? */
-            icsi = vdc.charwidth - 8;
-        }
-    }
+    unsigned int i, d, j, fg, bg, bitmap_index, n;
 
     p = vdc.raster.draw_buffer_ptr
         + vdc.border_width
@@ -1016,66 +1382,30 @@ static void draw_std_bitmap(void)
 
     calculate_draw_masks();
 
-    for (i = 0; i < vdc.mem_counter_inc; i++, p += vdc.charwidth) {
-        uint32_t *ptr, *pdwl, *pdwh;
-
-        if (vdc.regs[25] & 0x40) {
-            /* attribute mode */
-            ptr = hr_table + (*(attr_ptr + i) & 0xf0) + ((*(attr_ptr + i) & 0x0f) << 8);
-            pdwl = pdl_table + (*(attr_ptr + i) & 0xf0) + ((*(attr_ptr + i) & 0x0f) << 8);
-            pdwh = pdh_table + (*(attr_ptr + i) & 0xf0) + ((*(attr_ptr + i) & 0x0f) << 8);
-        } else {
-            /* monochrome mode - attributes from register 26 */
-            ptr = hr_table + (vdc.regs[26] << 4);
-            pdwl = pdl_table + (vdc.regs[26] << 4);  /* Pointers into the lookup tables */
-            pdwh = pdh_table + (vdc.regs[26] << 4);
-        }
+    n = vdc.mem_counter_inc;
 
-        if (vdc.raster.ycounter > (signed)vdc.regs[23]) {
-            /* Return nothing if > Vertical Character Size */
-            d = 0x00;
-        } else {
-            d = vdc_ram_read(bitmap_index + i); /* grab the data byte from the bitmap */
-        }
-        d &= dmask; /* mask off to active pixels only */
-        d2 = 0x00;
-
-        /* Handle semi-graphics mode. Note semi_gfx_test doubles as a flag, if it's 0 this just falls through */
-        if (d & semi_gfx_test) { /* if the far right pixel is on.. */
-            d |= semi_gfx_mask;  /* .. mask the rest of the right hand side on */
-            d2 = semi_gfx_type;  /* this will get masked off later on, so we just set all (or none) inter-char pixels on for now */
-        }
-
-        if (vdc.regs[24] & VDC_REVERSE_ATTR) { /* whole screen reverse */
-            d ^= 0xff;
-            d2 ^= 0xFF;
+    /* fetch the bitmap data */
+    if (vdc.raster.ycounter > (signed)vdc.regs[23]) {
+        /* Return nothing if > Vertical Character Size */
+        memset(cells.data, 0, n);
+    } else {
+        for (i = 0; i < n; i++) {
+            cells.data[i] = vdc.ram[vdc_ram_address(bitmap_index + i)];
         }
+    }
 
-        d2 &= d2mask;   /* Mask off any extra "on" pixels from the inter-character gap */
+    /* attribute mode has colours per cell, monochrome mode from register 26.
+       There are no underline, blink or reverse attributes */
+    underline_attr = 0;
+    blink_attr = 0;
+    reverse_attr = 0;
+    screen_reverse = (vdc.regs[24] & VDC_REVERSE_ATTR) ? 0xFF : 0x00;
+    decode_cells(&cells, (vdc.regs[25] & 0x40) ? attr_ptr : NULL, 1, n);
 
-        /* actually render the byte into 8 bytes of colour pixels using the lookup tables */
-        if (vdc.regs[25] & 0x10) { /* double pixel mode */
-            *((uint32_t *)p) = *(pdwh + (d >> 4));
-            *((uint32_t *)p + 1) = *(pdwl + (d >> 4));
-            *((uint32_t *)p + 2) = *(pdwh + (d & 0x0f));
-            *((uint32_t *)p + 3) = *(pdwl + (d & 0x0f));
-            if (icsi >= 0) {    /* if there's inter character spacing, then render it */
-                q = p + 16;
-                *((uint32_t *)q) = *(pdwh + (d2 >> 4));
-                *((uint32_t *)q + 1) = *(pdwl + (d2 >> 4));
-                *((uint32_t *)q + 2) = *(pdwh + (d2 & 0x0F));
-                *((uint32_t *)q + 3) = *(pdwl + (d2 & 0x0F));
-            }
-        } else { /* normal pixel size */
-            *((uint32_t *)p) = *(ptr + (d >> 4));
-            *((uint32_t *)p + 1) = *(ptr + (d & 0x0f));
-            if (icsi >= 0) {    /* if there's inter character spacing, then render it */
-                q = p + 8;
-                *((uint32_t *)q) = *(ptr + (d2 >> 4));
-                *((uint32_t *)q + 1) = *(ptr + (d2 & 0x0F));
-            }
-        }
-    }
+    /* actually render the cells into colour pixels */
+    draw_cells(&cells, p, n);
+    p += n * vdc.charwidth;
+    i = n;
 
     /* fill the last few pixels of the display with bg colour if xsmooth scroll != maximum  */
     d = vdc_ram_read(bitmap_index + i); /* grab the data byte from the bitmap */
@@ -1188,6 +1518,7 @@ static void setup_modes(void)
 void vdc_draw_init(void)
 {
     init_drawing_tables();
+    init_draw_cells();
 
     setup_modes();
 }
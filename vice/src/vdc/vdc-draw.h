@@ -30,5 +30,6 @@
 #define VICE_VDC_DRAW_H
 
 void vdc_draw_init(void);
+void vdc_draw_bench(int num);
 
 #endif
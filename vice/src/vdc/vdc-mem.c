@@ -601,35 +601,14 @@ uint8_t vdc_peek(uint16_t addr)    /* No sidefx read of external VDC registers *
     }
 }
 
-/* address translation function for a 64KB VDC in 16KB mode, used by below 2 functions */
-static uint16_t vdc_64k_to_16k_map(uint16_t address)
-{
-    uint16_t new_address = address & 0x80ff;
-    uint16_t tmp = address & 0x3f00;
-    uint16_t low_bit = address & 0x0100;
-
-    tmp <<= 1;
-    tmp |= low_bit;
-    new_address |= tmp;
-    return new_address;
-}
-
 uint8_t vdc_ram_read(uint16_t addr)
 {
-    /* Use 16KB memory map when the RAM chip type register #28 bit 4 is 0 for 4416 chips */
-    if (!(vdc.regs[28] & 0x10)) {
-        return vdc.ram[vdc_64k_to_16k_map(addr & vdc.vdc_address_mask)];
-    }
-    /* otherwise return the default linear memory layout for the 4464 chip setting */
-    return vdc.ram[addr & vdc.vdc_address_mask];
+    return vdc.ram[vdc_ram_address(addr)];
 }
 
 void vdc_ram_store(uint16_t addr, uint8_t value)
 {   /* as above but for storing to VDC ram with appropriate address translation*/
-    if (!(vdc.regs[28] & 0x10)) {
-        vdc.ram[vdc_64k_to_16k_map(addr & vdc.vdc_address_mask)] = value;
-    } else
-    vdc.ram[addr & vdc.vdc_address_mask] = value;
+    vdc.ram[vdc_ram_address(addr)] = value;
 }
 
 
@@ -57,6 +57,7 @@
 #include "video.h"
 #include "videoarch.h"
 #include "viewport.h"
+#include "vsync.h"
 
 vdc_t vdc;
 
@@ -626,6 +627,9 @@ static void vdc_raster_draw_alarm_handler(CLOCK offset, void *data)
             vdc.raster.current_line = 0;
             raster_canvas_handle_end_of_frame(&vdc.raster);
 
+            /* don't draw frames that are not displayed, e.g. while only the VIC-II window is shown */
+            vdc.raster.skip_frame = video_disabled_mode || vsync_will_skip_frame(vdc.raster.canvas);
+
             vdc.frame_counter++;    /* As far as the frame counter is concerned, we are now on a new frame */
 
             if (vdc.interlaced) {
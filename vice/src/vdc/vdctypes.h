@@ -260,6 +260,30 @@ typedef struct vdc_s vdc_t;
 
 extern vdc_t vdc;
 
+/* address translation function for a 64KB VDC in 16KB mode */
+inline static uint16_t vdc_64k_to_16k_map(uint16_t address)
+{
+    uint16_t new_address = address & 0x80ff;
+    uint16_t tmp = address & 0x3f00;
+    uint16_t low_bit = address & 0x0100;
+
+    tmp <<= 1;
+    tmp |= low_bit;
+    new_address |= tmp;
+    return new_address;
+}
+
+/* Offset of VDC address `addr' in vdc.ram.  Use 16KB memory map when the RAM
+   chip type register #28 bit 4 is 0 for 4416 chips, otherwise the default
+   linear memory layout for the 4464 chip setting.  */
+inline static uint16_t vdc_ram_address(uint16_t addr)
+{
+    if (!(vdc.regs[28] & 0x10)) {
+        return vdc_64k_to_16k_map(addr & vdc.vdc_address_mask);
+    }
+    return addr & vdc.vdc_address_mask;
+}
+
 /* Private function calls, used by the other VDC modules.  */
 int vdc_load_palette(const char *name);
 void vdc_fetch_matrix(int offs, int num);
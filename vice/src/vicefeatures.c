@@ -49,12 +49,25 @@ static const feature_list_t featurelist[] = {
 #else
         0 },
 #endif
+/* all */
+    { "HAVE_DEBUG_ALARMS", "Enable recording alarm operations for -benchalarms",
+#ifdef HAVE_DEBUG_ALARMS
+        1 },
+#else
+        0 },
+#endif
 /* (all) */
     { "FEATURE_CPUMEMHISTORY", "Enable the memmap/chis feature in the monitor.",
 #ifndef FEATURE_CPUMEMHISTORY
         0 },
 #else
         1 },
+#endif
+    { "USE_COMPUTED_GOTO_DISPATCH", "Use computed goto opcode dispatch in the 65xx cpu cores.",
+#ifndef USE_COMPUTED_GOTO_DISPATCH
+        0 },
+#else
+        1 },
 #endif
 #ifdef MACOS_COMPILE /* (osx) */
     { "HAS_HIDMGR", "Enable Mac IOHIDManager Joystick driver.",
@@ -275,6 +288,14 @@ static const feature_list_t featurelist[] = {
         1 },
 #endif
 
+/* (all) */
+    { "HAVE_PTHREAD", "Use POSIX threads for emulation worker threads.",
+#ifndef HAVE_PTHREAD
+        0 },
+#else
+        1 },
+#endif
+
 /* (all) */
     { "HAVE_FASTSID", "Enable FASTSID support. (deprecated)",
 #ifndef HAVE_FASTSID
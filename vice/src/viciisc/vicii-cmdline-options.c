@@ -152,6 +152,12 @@ static const cmdline_option_t cmdline_options[] =
     { "+VICIIvspbug", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
       NULL, NULL, "VICIIVSPBug", (void *)0,
       NULL, "Disable VSP bug emulation" },
+    { "-VICIIquietcycles", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
+      NULL, NULL, "VICIIQuietCycles", (void *)1,
+      NULL, "Render cycles without sprite, border or mode changes in one pass" },
+    { "+VICIIquietcycles", SET_RESOURCE, CMDLINE_ATTRIB_NONE,
+      NULL, NULL, "VICIIQuietCycles", (void *)0,
+      NULL, "Render every cycle with the full pixel pipeline" },
     /* NOTE: although we use CALL_FUNCTION, we put the resource that will be
              modified into the array - this helps reconstructing the cmdline */
     { "-VICIImodel", CALL_FUNCTION, CMDLINE_ATTRIB_NEED_ARGS,
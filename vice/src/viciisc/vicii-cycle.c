@@ -33,6 +33,7 @@
 
 #include <string.h>
 
+#include "bench.h"
 #include "debug.h"
 #include "lib.h"
 #include "log.h"
@@ -219,7 +220,9 @@ static inline void vicii_cycle_start_of_frame(void)
 
 static inline void vicii_cycle_end_of_line(void)
 {
+    BENCH_ENTER(BENCH_SECTION_VIDEO);
     vicii_raster_draw_handler();
+    BENCH_LEAVE();
     if (vicii.raster_line == vicii.screen_height - 1) {
         vicii.start_of_frame = 1;
     }
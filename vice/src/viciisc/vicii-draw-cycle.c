@@ -32,6 +32,7 @@
 #include "snapshot.h"
 #include "vicii-chip-model.h"
 #include "vicii-draw-cycle.h"
+#include "vicii-resources.h"
 #include "viciitypes.h"
 
 /* disable for debugging */
@@ -141,7 +142,7 @@ static const uint8_t colors[] = {
     COL_NONE, COL_NONE, COL_NONE, COL_NONE          /* ECM=1 BMM=1 MCM=1 */
 };
 
-static DRAW_INLINE void draw_graphics(int i)
+static DRAW_INLINE void draw_graphics(int i, int render)
 {
     uint8_t px;
     uint8_t cc;
@@ -191,9 +192,15 @@ static DRAW_INLINE void draw_graphics(int i)
     gbuf_reg <<= 1;
     gbuf_mc_flop ^= 1;
 
-    /* Determine pixel color and priority */
-    vmode = vmode11_pipe | vmode16_pipe;
+    /* Determine pixel priority, all that is needed for the collisions */
     pixel_pri = (px & 0x2);
+    pri_buffer[i] = pixel_pri;
+    if (!render) {
+        return;
+    }
+
+    /* Determine pixel color */
+    vmode = vmode11_pipe | vmode16_pipe;
     cc = colors[vmode | px];
 
     /* lookup colors and render pixel */
@@ -221,10 +228,40 @@ static DRAW_INLINE void draw_graphics(int i)
     }
 
     render_buffer[i] = cc;
-    pri_buffer[i] = pixel_pri;
 }
 
-static DRAW_INLINE void draw_graphics8(unsigned int cycle_flags)
+static DRAW_INLINE void update_graphics_pipe(int vis_en)
+{
+    /* shift and put the next data into the pipe. */
+    vbuf_pipe1_reg = vbuf_pipe0_reg;
+    cbuf_pipe1_reg = cbuf_pipe0_reg;
+    gbuf_pipe1_reg = gbuf_pipe0_reg;
+
+    /* this makes sure gbuf is 0 outside the visible area
+       It should probably be done somewhere around the fetch instead */
+    if (vis_en && vicii.vborder == 0) {
+        gbuf_pipe0_reg = vicii.gbuf;
+        xscroll_pipe = vicii.regs[0x16] & 0x07;
+    } else {
+        gbuf_pipe0_reg = 0;
+    }
+
+    /* Only update vbuf and cbuf registers in the display state. */
+    if (vis_en && vicii.vborder == 0) {
+        if (!vicii.idle_state) {
+            vbuf_pipe0_reg = vicii.vbuf[dmli];
+            cbuf_pipe0_reg = vicii.cbuf[dmli];
+            dmli++;
+        } else {
+            vbuf_pipe0_reg = 0;
+            cbuf_pipe0_reg = 0;
+        }
+    } else {
+        dmli = 0;
+    }
+}
+
+static DRAW_INLINE void draw_graphics8(unsigned int cycle_flags, int render)
 {
     int vis_en;
 
@@ -232,70 +269,97 @@ static DRAW_INLINE void draw_graphics8(unsigned int cycle_flags)
 
     /* render pixels */
     /* pixel 0 */
-    draw_graphics(0);
+    draw_graphics(0, render);
     /* pixel 1 */
-    draw_graphics(1);
+    draw_graphics(1, render);
     /* pixel 2 */
-    draw_graphics(2);
+    draw_graphics(2, render);
     /* pixel 3 */
-    draw_graphics(3);
+    draw_graphics(3, render);
     /* pixel 4 */
     vmode16_pipe = ( vicii.regs[0x16] & 0x10 ) >> 2;
     if (vicii.color_latency) {
         /* handle rising edge of internal signal */
         vmode11_pipe |= ( vicii.regs[0x11] & 0x60 ) >> 2;
     }
-    draw_graphics(4);
+    draw_graphics(4, render);
     /* pixel 5 */
-    draw_graphics(5);
+    draw_graphics(5, render);
     /* pixel 6 */
     if (vicii.color_latency) {
         /* handle falling edge of internal signal */
         vmode11_pipe &= ( vicii.regs[0x11] & 0x60 ) >> 2;
     }
-    draw_graphics(6);
+    draw_graphics(6, render);
     /* pixel 7 */
     if (vmode16_pipe && !vmode16_pipe2) {
         gbuf_mc_flop = 0;
     }
     vmode16_pipe2 = vmode16_pipe;
-    draw_graphics(7);
+    draw_graphics(7, render);
 
     if (!vicii.color_latency) {
         vmode11_pipe = ( vicii.regs[0x11] & 0x60 ) >> 2;
     }
 
-    /* shift and put the next data into the pipe. */
-    vbuf_pipe1_reg = vbuf_pipe0_reg;
-    cbuf_pipe1_reg = cbuf_pipe0_reg;
-    gbuf_pipe1_reg = gbuf_pipe0_reg;
+    update_graphics_pipe(vis_en);
+}
 
-    /* this makes sure gbuf is 0 outside the visible area
-       It should probably be done somewhere around the fetch instead */
-    if (vis_en && vicii.vborder == 0) {
-        gbuf_pipe0_reg = vicii.gbuf;
-        xscroll_pipe = vicii.regs[0x16] & 0x07;
-    } else {
-        gbuf_pipe0_reg = 0;
-    }
+/* the video mode pipeline does not change during this cycle */
+static DRAW_INLINE int graphics_mode_is_stable(void)
+{
+    return vmode16_pipe == ((vicii.regs[0x16] & 0x10) >> 2)
+           && vmode16_pipe2 == vmode16_pipe
+           && vmode11_pipe == ((vicii.regs[0x11] & 0x60) >> 2);
+}
 
-    /* Only update vbuf and cbuf registers in the display state. */
-    if (vis_en && vicii.vborder == 0) {
-        if (!vicii.idle_state) {
-            vbuf_pipe0_reg = vicii.vbuf[dmli];
-            cbuf_pipe0_reg = vicii.cbuf[dmli];
-            dmli++;
+/* draw_graphics8() for a cycle with a stable video mode whose pixels are not
+   needed, only the state it latches is updated */
+static DRAW_INLINE void update_graphics8(unsigned int cycle_flags)
+{
+    uint8_t gbuf = gbuf_reg;
+    uint8_t mc_flop = gbuf_mc_flop;
+    uint8_t px = gbuf_pixel_reg;
+    uint8_t cbuf = cbuf_reg;
+    int mc, start, end, n, k;
+
+    /* the pixels before and from xscroll_pipe on, see draw_graphics() */
+    for (start = 0; start < 8; start = end) {
+        if (start == xscroll_pipe) {
+            vbuf_reg = vbuf_pipe1_reg;
+            cbuf = cbuf_pipe1_reg;
+            gbuf = gbuf_pipe1_reg;
+            mc_flop = 1;
+        }
+        end = (start < xscroll_pipe) ? xscroll_pipe : 8;
+        n = end - start;
+        mc = (vmode11_pipe & 0x08) || (cbuf & 0x08);
+
+        /* only the last pixel fetched is kept */
+        if (vmode16_pipe2 && mc) {
+            /* mc pixels are fetched when the flop is set */
+            k = (mc_flop ^ ((n - 1) & 1)) ? n - 1 : n - 2;
+            if (k >= 0) {
+                px = (uint8_t)(gbuf << k) >> 6;
+            }
         } else {
-            vbuf_pipe0_reg = 0;
-            cbuf_pipe0_reg = 0;
+            px = ((uint8_t)(gbuf << (n - 1)) & 0x80) ? (vmode16_pipe2 || !mc ? 3 : 2) : 0;
         }
-    } else {
-        dmli = 0;
+        gbuf <<= n;
+        mc_flop ^= n & 1;
     }
+
+    gbuf_reg = gbuf;
+    gbuf_mc_flop = mc_flop;
+    gbuf_pixel_reg = px;
+    cbuf_reg = cbuf;
+
+    update_graphics_pipe(cycle_is_visible(cycle_flags));
 }
 
 
 
+
 /**************************************************************************
  *
  * SECTION  draw_sprites()
@@ -339,7 +403,7 @@ static DRAW_INLINE void trigger_sprites(int xpos, uint8_t candidate_bits)
     }
 }
 
-static DRAW_INLINE void draw_sprites(int i)
+static DRAW_INLINE void draw_sprites(int i, int render)
 {
     int s;
     int active_sprite;
@@ -402,7 +466,7 @@ static DRAW_INLINE void draw_sprites(int i)
         uint8_t pixel_pri = pri_buffer[i];
         int as = active_sprite;
         uint8_t spri = sprite_pri_bits & (1 << as);
-        if (!(pixel_pri && spri)) {
+        if (render && !(pixel_pri && spri)) {
             switch (sbuf_pixel_reg[as]) {
                 case 1:
                     render_buffer[i] = COL_D025;
@@ -466,7 +530,7 @@ static DRAW_INLINE void update_sprite_xpos(void)
 
 
 
-static DRAW_INLINE void draw_sprites8(unsigned int cycle_flags)
+static DRAW_INLINE void draw_sprites8(unsigned int cycle_flags, int render)
 {
     uint8_t candidate_bits;
     uint8_t dma_cycle_0 = 0;
@@ -489,28 +553,28 @@ static DRAW_INLINE void draw_sprites8(unsigned int cycle_flags)
     /* process and render sprites */
     /* pixel 0 */
     trigger_sprites(xpos + 0, candidate_bits);
-    draw_sprites(0);
+    draw_sprites(0, render);
     /* pixel 1 */
     trigger_sprites(xpos + 1, candidate_bits);
-    draw_sprites(1);
+    draw_sprites(1, render);
     /* pixel 2 */
     sprite_active_bits &= ~dma_cycle_2;
     trigger_sprites(xpos + 2, candidate_bits);
-    draw_sprites(2);
+    draw_sprites(2, render);
     /* pixel 3 */
     sprite_halt_bits |= dma_cycle_0;
     trigger_sprites(xpos + 3, candidate_bits);
-    draw_sprites(3);
+    draw_sprites(3, render);
     /* pixel 4 */
     if (spr_en) {
         sprite_pending_bits = vicii.sprite_display_bits;
     }
     update_sprite_data(cycle_flags);
     trigger_sprites(xpos + 4, candidate_bits);
-    draw_sprites(4);
+    draw_sprites(4, render);
     /* pixel 5 */
     trigger_sprites(xpos + 5, candidate_bits);
-    draw_sprites(5);
+    draw_sprites(5, render);
     /* pixel 6 */
     if (!vicii.color_latency) {
         update_sprite_mc_bits_8565();
@@ -518,19 +582,49 @@ static DRAW_INLINE void draw_sprites8(unsigned int cycle_flags)
     sprite_pri_bits = vicii.regs[0x1b];
     sprite_expx_bits = vicii.regs[0x1d];
     trigger_sprites(xpos + 6, candidate_bits);
-    draw_sprites(6);
+    draw_sprites(6, render);
     /* pixel 7 */
     if (vicii.color_latency) {
         update_sprite_mc_bits_6569();
     }
     sprite_halt_bits &= ~dma_cycle_2;
     trigger_sprites(xpos + 7, candidate_bits);
-    draw_sprites(7);
+    draw_sprites(7, render);
 
     /* pipe xpos */
     update_sprite_xpos();
 }
 
+/* draw_sprites8() for a cycle without displayed or pending sprites, only
+   the state it latches is updated */
+static DRAW_INLINE void update_sprites8(unsigned int cycle_flags)
+{
+    if (cycle_is_sprite_ptr_dma0(cycle_flags)) {
+        sprite_halt_bits |= 1 << cycle_get_sprite_num(cycle_flags);
+    }
+    update_sprite_data(cycle_flags);
+    if (!vicii.color_latency) {
+        update_sprite_mc_bits_8565();
+    }
+    sprite_pri_bits = vicii.regs[0x1b];
+    sprite_expx_bits = vicii.regs[0x1d];
+    if (vicii.color_latency) {
+        update_sprite_mc_bits_6569();
+    }
+    if (cycle_is_sprite_dma1_dma2(cycle_flags)) {
+        sprite_halt_bits &= ~(1 << cycle_get_sprite_num(cycle_flags));
+    }
+
+    update_sprite_xpos();
+}
+
+/* no sprite is displayed or pending, and none becomes pending in this cycle */
+static DRAW_INLINE int sprites_are_idle(unsigned int cycle_flags)
+{
+    return !(sprite_active_bits | sprite_pending_bits)
+           && !(cycle_is_check_spr_disp(cycle_flags) && vicii.sprite_display_bits);
+}
+
 
 /**************************************************************************
  *
@@ -663,6 +757,182 @@ static DRAW_INLINE void draw_colors8(void)
 }
 
 
+/**************************************************************************
+ *
+ * SECTION  draw_quiet8()
+ *
+ ******/
+
+/*
+ * Most cycles of a typical frame are "quiet": no sprite is displayed or
+ * about to be, the video mode and the border flag are stable and no color
+ * register write is pending. The pipeline above then reduces to shifting
+ * out the graphics and resolving the colors, which is done here in one
+ * pass with the shift register state kept in locals. Anything else, like a
+ * register store, sprite DMA or a border or mode transition, makes the
+ * next cycles take the full per pixel pipeline again.
+ */
+static DRAW_INLINE int draw_is_quiet(unsigned int cycle_flags)
+{
+    return sprites_are_idle(cycle_flags)
+           && last_color_reg == 0xff
+           && !border_state == !vicii.main_border
+           && graphics_mode_is_stable();
+}
+
+static DRAW_INLINE uint8_t quiet_color(uint8_t vmode, uint8_t px, uint8_t vbuf, uint8_t cbuf)
+{
+    uint8_t cc = colors[vmode | px];
+
+    switch (cc) {
+        case COL_NONE:
+            return 0;
+        case COL_VBUF_L:
+            return vbuf & 0x0f;
+        case COL_VBUF_H:
+            return vbuf >> 4;
+        case COL_CBUF:
+            return cbuf;
+        case COL_CBUF_MC:
+            return cbuf & 0x07;
+        case COL_D02X_EXT:
+            return COL_D021 + (vbuf >> 6);
+        default:
+            return cc;
+    }
+}
+
+static DRAW_INLINE void draw_quiet8(unsigned int cycle_flags)
+{
+    uint8_t gbuf = gbuf_reg;
+    uint8_t mc_flop = gbuf_mc_flop;
+    uint8_t px = gbuf_pixel_reg;
+    uint8_t vbuf = vbuf_reg;
+    uint8_t cbuf = cbuf_reg;
+    uint8_t vmode = vmode11_pipe | vmode16_pipe;
+    uint8_t render[8];
+    uint8_t px_set, c0, c1;
+    int offs = vicii.dbuf_offset;
+    int start, end, i;
+
+    /* the pixels before and from xscroll_pipe on, where the next
+       gbuf/vbuf/cbuf values are latched */
+    for (start = 0; start < 8; start = end) {
+        if (start == xscroll_pipe) {
+            vbuf = vbuf_pipe1_reg;
+            cbuf = cbuf_pipe1_reg;
+            gbuf = gbuf_pipe1_reg;
+            mc_flop = 1;
+        }
+        end = (start < xscroll_pipe) ? xscroll_pipe : 8;
+
+        if (!vmode16_pipe2) {
+            /* hires pixels, each either background or foreground color */
+            px_set = ((vmode11_pipe & 0x08) || (cbuf & 0x08)) ? 2 : 3;
+            c0 = border_state ? COL_D020 : quiet_color(vmode, 0, vbuf, cbuf);
+            c1 = border_state ? COL_D020 : quiet_color(vmode, px_set, vbuf, cbuf);
+            for (i = start; i < end; i++) {
+                if (gbuf & 0x80) {
+                    px = px_set;
+                    render[i] = c1;
+                } else {
+                    px = 0;
+                    render[i] = c0;
+                }
+                pri_buffer[i] = px & 0x2;
+                gbuf <<= 1;
+            }
+            mc_flop ^= (end - start) & 1;
+        } else {
+            /* same pixel selection as draw_graphics() */
+            for (i = start; i < end; i++) {
+                if ((vmode11_pipe & 0x08) || (cbuf & 0x08)) {
+                    if (mc_flop) {
+                        px = gbuf >> 6;
+                    }
+                } else {
+                    px = (gbuf & 0x80) ? 3 : 0;
+                }
+                gbuf <<= 1;
+                mc_flop ^= 1;
+                pri_buffer[i] = px & 0x2;
+                render[i] = border_state ? COL_D020 : quiet_color(vmode, px, vbuf, cbuf);
+            }
+        }
+    }
+
+    gbuf_reg = gbuf;
+    gbuf_mc_flop = mc_flop;
+    gbuf_pixel_reg = px;
+    vbuf_reg = vbuf;
+    cbuf_reg = cbuf;
+    memcpy(render_buffer, render, 8);
+
+    update_graphics_pipe(cycle_is_visible(cycle_flags));
+
+    update_sprites8(cycle_flags);
+
+    /* same as draw_colors8() without a pending color register write */
+    if (offs <= VICII_DRAW_BUFFER_SIZE - 8) {
+        uint8_t *dbuf = vicii.dbuf + offs;
+
+        /* no grey dot for 8565 as no register was written */
+        for (i = 0; i < 8; i++) {
+            dbuf[i] = cregs[pixel_buffer[i]];
+        }
+        if (vicii.color_latency) {
+            /* 6569: the first pixel was resolved in the previous cycle */
+            dbuf[0] = pixel_buffer[0];
+            memcpy(pixel_buffer, render, 8);
+            pixel_buffer[0] = cregs[render[0]];
+        } else {
+            memcpy(pixel_buffer, render, 8);
+        }
+        vicii.dbuf_offset += 8;
+
+        update_cregs();
+    }
+}
+
+
+/**************************************************************************
+ *
+ * SECTION  draw_collisions8()
+ *
+ ******/
+
+/*
+ * Frames that are not displayed, like most frames in warp mode, only need
+ * the sprite collisions. These depend on the graphics and sprite shift
+ * registers but not on the colors, so the color lookups and the draw
+ * buffer are skipped and only the state they latch is kept up to date.
+ */
+static DRAW_INLINE void draw_collisions8(unsigned int cycle_flags)
+{
+    if (sprites_are_idle(cycle_flags) && graphics_mode_is_stable()) {
+        /* no sprite to collide with */
+        update_graphics8(cycle_flags);
+        update_sprites8(cycle_flags);
+    } else {
+        draw_graphics8(cycle_flags, 0);
+        draw_sprites8(cycle_flags, 0);
+    }
+
+    /* what draw_border8() latches */
+    border_state = vicii.main_border;
+
+    /* what draw_colors8() latches */
+    if (vicii.dbuf_offset <= VICII_DRAW_BUFFER_SIZE - 8) {
+        if (last_color_reg != 0xff) {
+            cregs[last_color_reg] = last_color_value;
+        }
+        vicii.dbuf_offset += 8;
+
+        update_cregs();
+    }
+}
+
+
 /**************************************************************************
  *
  * SECTION  vicii_draw_cycle()
@@ -676,13 +946,22 @@ void vicii_draw_cycle(void)
         vicii.dbuf_offset = 0;
     }
 
-    draw_graphics8(cycle_flags_pipe);
+    /* The pixels of a cycle are output in the next one, so the last cycle
+       of a line is drawn in full: the end of line may start a displayed
+       frame, which then begins with these pixels.  */
+    if (vicii.raster.skip_frame && vicii.raster_cycle != VICII_PAL_CYCLE(1)) {
+        draw_collisions8(cycle_flags_pipe);
+    } else if (vicii_resources.quiet_cycles_enabled && draw_is_quiet(cycle_flags_pipe)) {
+        draw_quiet8(cycle_flags_pipe);
+    } else {
+        draw_graphics8(cycle_flags_pipe, 1);
 
-    draw_sprites8(cycle_flags_pipe);
+        draw_sprites8(cycle_flags_pipe, 1);
 
-    draw_border8();
+        draw_border8();
 
-    draw_colors8();
+        draw_colors8();
+    }
 
     cycle_flags_pipe = vicii.cycle_flags;
 }
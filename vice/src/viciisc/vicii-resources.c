@@ -92,6 +92,12 @@ static int set_vsp_bug_enabled(int val, void *param)
     return 0;
 }
 
+static int set_quiet_cycles_enabled(int val, void *param)
+{
+    vicii_resources.quiet_cycles_enabled = val ? 1 : 0;
+    return 0;
+}
+
 struct vicii_model_info_s {
     int video;
     int luma;
@@ -162,6 +168,9 @@ static const resource_int_t resources_int[] =
     { "VICIIVSPBug", 0, RES_EVENT_SAME, NULL,
       &vicii_resources.vsp_bug_enabled,
       set_vsp_bug_enabled, NULL },
+    { "VICIIQuietCycles", 1, RES_EVENT_NO, NULL,
+      &vicii_resources.quiet_cycles_enabled,
+      set_quiet_cycles_enabled, NULL },
     RESOURCE_INT_LIST_END
 };
 
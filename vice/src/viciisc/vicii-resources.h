@@ -45,6 +45,9 @@ struct vicii_resources_s {
 
     /* Flag: Do we emulate the "VSP bug" behaviour? */
     int vsp_bug_enabled;
+
+    /* Flag: Do we render quiet cycles in one pass? (see vicii-draw-cycle.c) */
+    int quiet_cycles_enabled;
 };
 typedef struct vicii_resources_s vicii_resources_t;
 
@@ -33,6 +33,7 @@
 
 #include "videoarch.h"
 
+#include "bench.h"
 #include "c64cart.h"
 #include "c64cartmem.h"
 #include "lib.h"
@@ -413,6 +414,14 @@ void vicii_update_memory_ptrs_external(void)
 {
 }
 
+/* Called after vsync: frames that are not displayed are not drawn, only
+   their sprite collisions are emulated, see vicii_draw_cycle().  */
+static void vicii_start_frame(void)
+{
+    vicii.raster.skip_frame = video_disabled_mode
+                              || vsync_will_skip_frame(vicii.raster.canvas);
+}
+
 /* Redraw the current raster line.  This happens after the last cycle
    of each line.  */
 void vicii_raster_draw_handler(void)
@@ -431,6 +440,14 @@ void vicii_raster_draw_handler(void)
                            <= ((unsigned int)vicii.last_displayed_line - vicii.screen_height);
     }
 #endif
+    if (bench_enabled) {
+        bench_video_line(vicii.sprite_sprite_collisions,
+                         vicii.sprite_background_collisions,
+                         vicii.light_pen.x, vicii.light_pen.y,
+                         vicii.raster.skip_frame ? NULL : vicii.dbuf,
+                         VICII_DRAW_BUFFER_SIZE);
+    }
+
     raster_line_emulate(&vicii.raster);
 
     vsync_do_end_of_line();
@@ -439,6 +456,7 @@ void vicii_raster_draw_handler(void)
         /* no vsync here for NTSC  */
         if ((unsigned int)vicii.last_displayed_line < vicii.screen_height) {
             vsync_do_vsync(vicii.raster.canvas);
+            vicii_start_frame();
         }
 
     }
@@ -447,6 +465,7 @@ void vicii_raster_draw_handler(void)
     if ((unsigned int)vicii.last_displayed_line >= vicii.screen_height
         && vicii.raster.current_line == vicii.last_displayed_line - vicii.screen_height + 1) {
         vsync_do_vsync(vicii.raster.canvas);
+        vicii_start_frame();
     }
 }
 
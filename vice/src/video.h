@@ -114,6 +114,23 @@ struct draw_buffer_s {
     unsigned int visible_width;
     /* Height of the visible subset of draw_buffer, in pixels */
     unsigned int visible_height;
+    /* Frame-diff tracking, see video_canvas_track_line().
+       Copy of each line of draw_buffer as of when it last changed */
+    uint8_t *track_buffer;
+    /* Number of the frame in which each line of draw_buffer last changed */
+    unsigned int *track_line_frame;
+    /* Size of track_buffer, in pixels and lines */
+    unsigned int track_width;
+    unsigned int track_height;
+    /* Number of the last tracked frame and of the last one that changed */
+    unsigned int track_frame;
+    unsigned int track_frame_changed;
+    /* Set when all lines must count as changed in the next tracked frame */
+    int track_invalid;
+    /* Set while the end of frame refresh of the last tracked frame runs */
+    int track_refresh;
+    /* Number of tracked frames in which no line changed */
+    unsigned long track_frames_unchanged;
 };
 typedef struct draw_buffer_s draw_buffer_t;
 
@@ -153,6 +170,7 @@ typedef struct video_chip_cap_s video_chip_cap_t;
 
 struct video_render_color_tables_s {
     int updated;                /* tables here are up to date */
+    unsigned int generation;    /* changed whenever the tables are changed */
     uint32_t physical_colors[256];
     int32_t ytableh[256];        /* y for current pixel */
     int32_t ytablel[256];        /* y for neighbouring pixels */
@@ -171,6 +189,10 @@ struct video_render_color_tables_s {
     int32_t line_yuv_0[VIDEO_MAX_OUTPUT_WIDTH * 3];
     int16_t prevrgbline[VIDEO_MAX_OUTPUT_WIDTH * 3];
     uint8_t rgbscratchbuffer[VIDEO_MAX_OUTPUT_WIDTH * 4];
+    /* Y, U and V of one output line of the CRT renderers, see rendercrt.c */
+    int32_t crt_y[VIDEO_MAX_OUTPUT_WIDTH + 1];
+    int32_t crt_u[VIDEO_MAX_OUTPUT_WIDTH + 1];
+    int32_t crt_v[VIDEO_MAX_OUTPUT_WIDTH + 1];
 
     /*
      * All values below here formerly were globals in video-color.h.
@@ -263,9 +285,11 @@ void video_shutdown(void);
 struct video_canvas_s *video_canvas_create(struct video_canvas_s *canvas, unsigned int *width, unsigned int *height, int mapped);
 void video_arch_canvas_init(struct video_canvas_s *canvas);
 int video_arch_get_active_chip(void);
+int video_arch_canvas_is_hidden(struct video_canvas_s *canvas);
 void video_canvas_shutdown(struct video_canvas_s *canvas);
 struct video_canvas_s *video_canvas_init(void);
 void video_canvas_refresh_all_tracked(void);
+void video_canvas_render_bench(int frames);
 void video_canvas_refresh(struct video_canvas_s *canvas, unsigned int xs, unsigned int ys, unsigned int xi, unsigned int yi,
                           unsigned int w, unsigned int h);
 int video_canvas_set_palette(struct video_canvas_s *canvas, struct palette_s *palette);
@@ -278,6 +302,11 @@ void video_canvas_map(struct video_canvas_s *canvas);
 void video_canvas_unmap(struct video_canvas_s *canvas);
 void video_canvas_resize(struct video_canvas_s *canvas, char resize_canvas);
 void video_canvas_render(struct video_canvas_s *canvas, uint8_t *trg, int width, int height, int xs, int ys, int xt, int yt, int pitcht);
+unsigned int video_canvas_render_changed(struct video_canvas_s *canvas, uint8_t *trg, int width, int height, int xs, int ys, int xt, int yt, int pitcht, unsigned int since);
+void video_canvas_track_line(struct video_canvas_s *canvas, unsigned int y);
+void video_canvas_track_changes(struct video_canvas_s *canvas);
+int video_canvas_frame_unchanged(struct video_canvas_s *canvas, unsigned int since);
+unsigned long video_canvas_frames_unchanged(void);
 void video_canvas_refresh_all(struct video_canvas_s *canvas);
 char video_canvas_can_resize(struct video_canvas_s *canvas);
 void video_viewport_get(struct video_canvas_s *canvas, struct viewport_s **viewport, struct geometry_s **geometry);
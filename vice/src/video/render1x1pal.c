@@ -27,47 +27,10 @@
 #include "vice.h"
 
 #include "render1x1pal.h"
+#include "rendercrt.h"
 #include "types.h"
 #include "video-color.h"
 
-/*
-    YUV to RGB
-
-    R = Y + V
-    G = Y - (0.1953 * U + 0.5078 * V)
-    B = Y + U
-*/
-static inline
-void yuv_to_rgb(int32_t y, int32_t u, int32_t v,
-                int32_t *red, int32_t *grn, int32_t *blu)
-{
-    *red = (y + v) >> 16;
-    *blu = (y + u) >> 16;
-    *grn = (y - ((50 * u + 130 * v) >> 8)) >> 16;
-}
-
-static inline
-void store_pixel_4(video_render_color_tables_t *color_tab, uint8_t *trg, int32_t y1, int32_t u1, int32_t v1, int32_t y2, int32_t u2, int32_t v2)
-{
-    uint32_t *tmp;
-    int32_t red;
-    int32_t grn;
-    int32_t blu;
-
-    yuv_to_rgb(y1, u1, v1, &red, &grn, &blu);
-    tmp = (uint32_t *) trg;
-    tmp[0] = color_tab->gamma_red[256 + red]
-             | color_tab->gamma_grn[256 + grn]
-             | color_tab->gamma_blu[256 + blu]
-             | color_tab->alpha;
-
-    yuv_to_rgb(y2, u2, v2, &red, &grn, &blu);
-    tmp[1] = color_tab->gamma_red[256 + red]
-             | color_tab->gamma_grn[256 + grn]
-             | color_tab->gamma_blu[256 + blu]
-             | color_tab->alpha;
-}
-
 /* PAL 1x1 renderers */
 static inline void
 render_generic_1x1_pal(video_render_color_tables_t *color_tab, const uint8_t *src, uint8_t *trg,
@@ -85,7 +48,7 @@ render_generic_1x1_pal(video_render_color_tables_t *color_tab, const uint8_t *sr
     const uint8_t *tmpsrc;
     uint8_t *tmptrg;
     unsigned int x, y;
-    int32_t *line, l1, l2, u1, u2, v1, v2, unew, vnew;
+    int32_t *line, unew, vnew;
     uint8_t cl0, cl1, cl2, cl3;
     int off, off_flip;
 
@@ -145,38 +108,22 @@ render_generic_1x1_pal(video_render_color_tables_t *color_tab, const uint8_t *sr
         }
 
         /* one scanline */
-        for (x = 0; x < width; x++) {
+        for (x = 0; x < width * 2; x++) {
             cl0 = tmpsrc[0];
             cl1 = tmpsrc[1];
             cl2 = tmpsrc[2];
             cl3 = tmpsrc[3];
             tmpsrc += 1;
-            l1 = ytablel[cl1] + ytableh[cl2] + ytablel[cl3];
             unew = cbtable[cl0] + cbtable[cl1] + cbtable[cl2] + cbtable[cl3];
             vnew = crtable[cl0] + crtable[cl1] + crtable[cl2] + crtable[cl3];
-            u1 = (unew + line[0]) * off_flip;
-            v1 = (vnew + line[1]) * off_flip;
+            color_tab->crt_y[x] = ytablel[cl1] + ytableh[cl2] + ytablel[cl3];
+            color_tab->crt_u[x] = (unew + line[0]) * off_flip;
+            color_tab->crt_v[x] = (vnew + line[1]) * off_flip;
             line[0] = unew;
             line[1] = vnew;
             line += 2;
-
-            cl0 = tmpsrc[0];
-            cl1 = tmpsrc[1];
-            cl2 = tmpsrc[2];
-            cl3 = tmpsrc[3];
-            tmpsrc += 1;
-            l2 = ytablel[cl1] + ytableh[cl2] + ytablel[cl3];
-            unew = cbtable[cl0] + cbtable[cl1] + cbtable[cl2] + cbtable[cl3];
-            vnew = crtable[cl0] + crtable[cl1] + crtable[cl2] + crtable[cl3];
-            u2 = (unew + line[0]) * off_flip;
-            v2 = (vnew + line[1]) * off_flip;
-            line[0] = unew;
-            line[1] = vnew;
-            line += 2;
-
-            store_pixel_4(color_tab, tmptrg, l1, u1, v1, l2, u2, v2);
-            tmptrg += pixelstride;
         }
+        render_crt_line_1x(color_tab, RENDER_CRT_DECODER_PAL, width * 2, (uint32_t *)tmptrg);
 
         src += pitchs;
         trg += pitcht;
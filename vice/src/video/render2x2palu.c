@@ -30,6 +30,7 @@
 
 #include "render2x2.h"
 #include "render2x2palu.h"
+#include "rendercrt.h"
 #include "types.h"
 #include "video-color.h"
 
@@ -231,31 +232,39 @@ void render_generic_2x2_pal_u(video_render_color_tables_t *color_tab,
             u = u2;
             v = v2;
         }
-        for (x = 0; x < width; x++) {
-            store_line_and_scanline_4(color_tab, tmptrg, tmptrgscanline, prevrgblineptr, shade, l, u, v);
-            tmptrgscanline += pixelstride;
-            tmptrg += pixelstride;
-            prevrgblineptr += 3;
-
-            l2 = ytablel[tmpsrc[1]] + ytableh[tmpsrc[2]] + ytablel[tmpsrc[3]];
+        /* collect the Y/U/V of all steps first, the RGB conversion of the
+           whole line is done by render_crt_line_2x() */
+        color_tab->crt_y[0] = l;
+        color_tab->crt_u[0] = u;
+        color_tab->crt_v[0] = v;
+        for (x = 1; x <= width; x++) {
+            l = ytablel[tmpsrc[1]] + ytableh[tmpsrc[2]] + ytablel[tmpsrc[3]];
             unew += cbtable[tmpsrc[3]];
             vnew += crtable[tmpsrc[3]];
-            get_yuv_from_video(unew, vnew, line, off_flip, &u2, &v2);
+            get_yuv_from_video(unew, vnew, line, off_flip, &u, &v);
             unew -= cbtable[tmpsrc[0]];
             vnew -= crtable[tmpsrc[0]];
             tmpsrc += 1;
             line += 2;
 
-            if (write_interpolated_pixels) {
-                store_line_and_scanline_4(color_tab, tmptrg, tmptrgscanline, prevrgblineptr, shade, (l + l2) >> 1, (u + u2) >> 1, (v + v2) >> 1);
+            color_tab->crt_y[x] = l;
+            color_tab->crt_u[x] = u;
+            color_tab->crt_v[x] = v;
+        }
+        if (write_interpolated_pixels) {
+            render_crt_line_2x(color_tab, RENDER_CRT_DECODER_PAL, width,
+                               (uint32_t *)tmptrg, (uint32_t *)tmptrgscanline, prevrgblineptr);
+            tmptrgscanline += width * 2 * pixelstride;
+            tmptrg += width * 2 * pixelstride;
+            prevrgblineptr += width * 2 * 3;
+        } else {
+            for (x = 0; x < width; x++) {
+                store_line_and_scanline_4(color_tab, tmptrg, tmptrgscanline, prevrgblineptr, shade,
+                                          color_tab->crt_y[x], color_tab->crt_u[x], color_tab->crt_v[x]);
                 tmptrgscanline += pixelstride;
                 tmptrg += pixelstride;
                 prevrgblineptr += 3;
             }
-
-            l = l2;
-            u = u2;
-            v = v2;
         }
         if (wlast) {
             store_line_and_scanline_4(color_tab, tmptrg, tmptrgscanline, prevrgblineptr, shade, l, u, v);
@@ -0,0 +1,492 @@
+/*
+ * rendercrt.c - PAL/NTSC CRT emulation line output
+ *
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+/*
+    The PAL/NTSC renderers first calculate the blurred Y, U and V values of
+    one output line into color_tab->crt_y/crt_u/crt_v, and then convert them
+    to RGB, apply gamma and the scanline shade here.
+
+    Besides the plain C version there are SSE2 and AVX2 versions, selected at
+    runtime. All of them use the same integer arithmetic, so their output is
+    bit-identical to the C version (see video_render_pal_ntsc_bench()).
+*/
+
+#include "vice.h"
+
+#include <stdio.h>
+
+#include "log.h"
+#include "rendercrt.h"
+#include "types.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RENDER_CRT_X86
+#endif
+
+#ifdef RENDER_CRT_X86
+#include <immintrin.h>
+
+#define RENDER_CRT_SSE2 __attribute__((target("sse2")))
+#define RENDER_CRT_AVX2 __attribute__((target("avx2")))
+#endif
+
+static int render_crt_impl = -1;
+
+static const char * const render_crt_impl_names[RENDER_CRT_IMPL_NUM] = {
+    "c", "sse2", "avx2"
+};
+
+/*
+    YUV to RGB (PAL)
+
+    R = Y + V
+    G = Y - (0.1953 * U + 0.5078 * V)
+    B = Y + U
+
+    YIQ to RGB (NTSC, Sony CXA2025AS US decoder matrix)
+
+    R = Y + (1.630 * I + 0.317 * Q)
+    G = Y - (0.378 * I + 0.466 * Q)
+    B = Y - (1.089 * I - 1.677 * Q)
+*/
+static inline
+void yuv_to_rgb(int decoder, int32_t y, int32_t u, int32_t v,
+                int32_t *red, int32_t *grn, int32_t *blu)
+{
+    if (decoder == RENDER_CRT_DECODER_PAL) {
+        *red = (y + v) >> 16;
+        *blu = (y + u) >> 16;
+        *grn = (y - ((50 * u + 130 * v) >> 8)) >> 16;
+    } else {
+        *red = (y + ((209 * u +  41 * v) >> 7)) >> 15;
+        *grn = (y - (( 48 * u +  69 * v) >> 7)) >> 15;
+        *blu = (y - ((139 * u - 215 * v) >> 7)) >> 15;
+    }
+}
+
+/* Stores the gamma-corrected pixel to the current line, averages the rgb
+   with the previous line into the scanline and updates the prevline buffer. */
+static inline
+void store_line_and_scanline(const video_render_color_tables_t *color_tab,
+                             uint32_t *line, uint32_t *scanline, int16_t *prevline,
+                             int32_t red, int32_t grn, int32_t blu)
+{
+    *scanline = color_tab->gamma_red_fac[512 + red + prevline[0]]
+                | color_tab->gamma_grn_fac[512 + grn + prevline[1]]
+                | color_tab->gamma_blu_fac[512 + blu + prevline[2]]
+                | color_tab->alpha;
+    *line = color_tab->gamma_red[256 + red]
+            | color_tab->gamma_grn[256 + grn]
+            | color_tab->gamma_blu[256 + blu]
+            | color_tab->alpha;
+
+    prevline[0] = (int16_t)red;
+    prevline[1] = (int16_t)grn;
+    prevline[2] = (int16_t)blu;
+}
+
+static inline
+void store_line(const video_render_color_tables_t *color_tab, uint32_t *line,
+                int32_t red, int32_t grn, int32_t blu)
+{
+    *line = color_tab->gamma_red[256 + red]
+            | color_tab->gamma_grn[256 + grn]
+            | color_tab->gamma_blu[256 + blu]
+            | color_tab->alpha;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static inline void line_2x_c(video_render_color_tables_t *color_tab, int decoder,
+                             unsigned int first, unsigned int steps,
+                             uint32_t *line, uint32_t *scanline, int16_t *prevline)
+{
+    const int32_t *y = color_tab->crt_y;
+    const int32_t *u = color_tab->crt_u;
+    const int32_t *v = color_tab->crt_v;
+    int32_t red, grn, blu;
+    unsigned int i, o;
+
+    for (i = first; i < steps; i++) {
+        o = i * 2;
+        yuv_to_rgb(decoder, y[i], u[i], v[i], &red, &grn, &blu);
+        store_line_and_scanline(color_tab, line + o, scanline + o, prevline + o * 3,
+                                red, grn, blu);
+        yuv_to_rgb(decoder, (y[i] + y[i + 1]) >> 1, (u[i] + u[i + 1]) >> 1,
+                   (v[i] + v[i + 1]) >> 1, &red, &grn, &blu);
+        store_line_and_scanline(color_tab, line + o + 1, scanline + o + 1, prevline + o * 3 + 3,
+                                red, grn, blu);
+    }
+}
+
+static inline void line_1x_c(video_render_color_tables_t *color_tab, int decoder,
+                             unsigned int first, unsigned int pixels, uint32_t *line)
+{
+    int32_t red, grn, blu;
+    unsigned int i;
+
+    for (i = first; i < pixels; i++) {
+        yuv_to_rgb(decoder, color_tab->crt_y[i], color_tab->crt_u[i], color_tab->crt_v[i],
+                   &red, &grn, &blu);
+        store_line(color_tab, line + i, red, grn, blu);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+#ifdef RENDER_CRT_X86
+
+/* SSE2 has no 32 bit multiply, the low 32 bits of the unsigned products are
+   the same as those of the signed ones though. */
+RENDER_CRT_SSE2 static inline __m128i mullo_sse2(__m128i a, int32_t c)
+{
+    __m128i b = _mm_set1_epi32(c);
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+RENDER_CRT_SSE2 static inline
+void yuv_to_rgb_sse2(int decoder, __m128i y, __m128i u, __m128i v,
+                     __m128i *red, __m128i *grn, __m128i *blu)
+{
+    __m128i t;
+
+    if (decoder == RENDER_CRT_DECODER_PAL) {
+        *red = _mm_srai_epi32(_mm_add_epi32(y, v), 16);
+        *blu = _mm_srai_epi32(_mm_add_epi32(y, u), 16);
+        t = _mm_srai_epi32(_mm_add_epi32(mullo_sse2(u, 50), mullo_sse2(v, 130)), 8);
+        *grn = _mm_srai_epi32(_mm_sub_epi32(y, t), 16);
+    } else {
+        t = _mm_srai_epi32(_mm_add_epi32(mullo_sse2(u, 209), mullo_sse2(v, 41)), 7);
+        *red = _mm_srai_epi32(_mm_add_epi32(y, t), 15);
+        t = _mm_srai_epi32(_mm_add_epi32(mullo_sse2(u, 48), mullo_sse2(v, 69)), 7);
+        *grn = _mm_srai_epi32(_mm_sub_epi32(y, t), 15);
+        t = _mm_srai_epi32(_mm_sub_epi32(mullo_sse2(u, 139), mullo_sse2(v, 215)), 7);
+        *blu = _mm_srai_epi32(_mm_sub_epi32(y, t), 15);
+    }
+}
+
+/* SSE2 has no gather, so only the color conversion is done in vector
+   registers and the gamma tables are read per pixel. */
+RENDER_CRT_SSE2 static void line_2x_sse2(video_render_color_tables_t *color_tab, int decoder,
+                                         unsigned int steps, uint32_t *line, uint32_t *scanline,
+                                         int16_t *prevline)
+{
+    const int32_t *y = color_tab->crt_y;
+    const int32_t *u = color_tab->crt_u;
+    const int32_t *v = color_tab->crt_v;
+    int32_t red[8], grn[8], blu[8];
+    __m128i y0, u0, v0, yi, ui, vi, r, g, b;
+    unsigned int i, k, o;
+
+    for (i = 0; i + 4 <= steps; i += 4) {
+        y0 = _mm_loadu_si128((const __m128i *)(y + i));
+        u0 = _mm_loadu_si128((const __m128i *)(u + i));
+        v0 = _mm_loadu_si128((const __m128i *)(v + i));
+        yi = _mm_srai_epi32(_mm_add_epi32(y0, _mm_loadu_si128((const __m128i *)(y + i + 1))), 1);
+        ui = _mm_srai_epi32(_mm_add_epi32(u0, _mm_loadu_si128((const __m128i *)(u + i + 1))), 1);
+        vi = _mm_srai_epi32(_mm_add_epi32(v0, _mm_loadu_si128((const __m128i *)(v + i + 1))), 1);
+
+        yuv_to_rgb_sse2(decoder, _mm_unpacklo_epi32(y0, yi), _mm_unpacklo_epi32(u0, ui),
+                        _mm_unpacklo_epi32(v0, vi), &r, &g, &b);
+        _mm_storeu_si128((__m128i *)red, r);
+        _mm_storeu_si128((__m128i *)grn, g);
+        _mm_storeu_si128((__m128i *)blu, b);
+        yuv_to_rgb_sse2(decoder, _mm_unpackhi_epi32(y0, yi), _mm_unpackhi_epi32(u0, ui),
+                        _mm_unpackhi_epi32(v0, vi), &r, &g, &b);
+        _mm_storeu_si128((__m128i *)(red + 4), r);
+        _mm_storeu_si128((__m128i *)(grn + 4), g);
+        _mm_storeu_si128((__m128i *)(blu + 4), b);
+
+        o = i * 2;
+        for (k = 0; k < 8; k++) {
+            store_line_and_scanline(color_tab, line + o + k, scanline + o + k,
+                                    prevline + (o + k) * 3, red[k], grn[k], blu[k]);
+        }
+    }
+    line_2x_c(color_tab, decoder, i, steps, line, scanline, prevline);
+}
+
+RENDER_CRT_SSE2 static void line_1x_sse2(video_render_color_tables_t *color_tab, int decoder,
+                                         unsigned int pixels, uint32_t *line)
+{
+    int32_t red[4], grn[4], blu[4];
+    __m128i r, g, b;
+    unsigned int i, k;
+
+    for (i = 0; i + 4 <= pixels; i += 4) {
+        yuv_to_rgb_sse2(decoder,
+                        _mm_loadu_si128((const __m128i *)(color_tab->crt_y + i)),
+                        _mm_loadu_si128((const __m128i *)(color_tab->crt_u + i)),
+                        _mm_loadu_si128((const __m128i *)(color_tab->crt_v + i)),
+                        &r, &g, &b);
+        _mm_storeu_si128((__m128i *)red, r);
+        _mm_storeu_si128((__m128i *)grn, g);
+        _mm_storeu_si128((__m128i *)blu, b);
+        for (k = 0; k < 4; k++) {
+            store_line(color_tab, line + i + k, red[k], grn[k], blu[k]);
+        }
+    }
+    line_1x_c(color_tab, decoder, i, pixels, line);
+}
+
+/* ------------------------------------------------------------------------- */
+
+RENDER_CRT_AVX2 static inline
+void yuv_to_rgb_avx2(int decoder, __m256i y, __m256i u, __m256i v,
+                     __m256i *red, __m256i *grn, __m256i *blu)
+{
+    __m256i t;
+
+    if (decoder == RENDER_CRT_DECODER_PAL) {
+        *red = _mm256_srai_epi32(_mm256_add_epi32(y, v), 16);
+        *blu = _mm256_srai_epi32(_mm256_add_epi32(y, u), 16);
+        t = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(50)),
+                                               _mm256_mullo_epi32(v, _mm256_set1_epi32(130))), 8);
+        *grn = _mm256_srai_epi32(_mm256_sub_epi32(y, t), 16);
+    } else {
+        t = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(209)),
+                                               _mm256_mullo_epi32(v, _mm256_set1_epi32(41))), 7);
+        *red = _mm256_srai_epi32(_mm256_add_epi32(y, t), 15);
+        t = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(48)),
+                                               _mm256_mullo_epi32(v, _mm256_set1_epi32(69))), 7);
+        *grn = _mm256_srai_epi32(_mm256_sub_epi32(y, t), 15);
+        t = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(139)),
+                                               _mm256_mullo_epi32(v, _mm256_set1_epi32(215))), 7);
+        *blu = _mm256_srai_epi32(_mm256_sub_epi32(y, t), 15);
+    }
+}
+
+/* one value of 4 steps and the 4 values interpolated with the next steps,
+   in output order */
+RENDER_CRT_AVX2 static inline __m256i interleave_2x_avx2(const int32_t *p)
+{
+    __m128i s = _mm_loadu_si128((const __m128i *)p);
+    __m128i i = _mm_srai_epi32(_mm_add_epi32(s, _mm_loadu_si128((const __m128i *)(p + 1))), 1);
+
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi32(s, i)),
+                                   _mm_unpackhi_epi32(s, i), 1);
+}
+
+RENDER_CRT_AVX2 static inline
+__m256i gamma_avx2(const uint32_t *red_tab, const uint32_t *grn_tab, const uint32_t *blu_tab,
+                   __m256i r, __m256i g, __m256i b, __m256i alpha)
+{
+    __m256i c;
+
+    c = _mm256_i32gather_epi32((const int *)red_tab, r, 4);
+    c = _mm256_or_si256(c, _mm256_i32gather_epi32((const int *)grn_tab, g, 4));
+    c = _mm256_or_si256(c, _mm256_i32gather_epi32((const int *)blu_tab, b, 4));
+
+    return _mm256_or_si256(c, alpha);
+}
+
+/* prevline holds int16 r, g, b triplets; gather 32 bits and sign extend the
+   lower half. For the last pixel of a full width line this reads 2 bytes past
+   prevrgbline, which is followed by rgbscratchbuffer in the color tables. */
+RENDER_CRT_AVX2 static inline __m256i prevline_avx2(const int16_t *prevline, __m256i idx)
+{
+    __m256i p = _mm256_i32gather_epi32((const int *)prevline, idx, 2);
+
+    return _mm256_srai_epi32(_mm256_slli_epi32(p, 16), 16);
+}
+
+RENDER_CRT_AVX2 static void line_2x_avx2(video_render_color_tables_t *color_tab, int decoder,
+                                         unsigned int steps, uint32_t *line, uint32_t *scanline,
+                                         int16_t *prevline)
+{
+    const __m256i alpha = _mm256_set1_epi32((int)color_tab->alpha);
+    const __m256i off256 = _mm256_set1_epi32(256);
+    const __m256i off512 = _mm256_set1_epi32(512);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i triplets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    int32_t red[8], grn[8], blu[8];
+    __m256i r, g, b, idx;
+    unsigned int i, k, o;
+
+    for (i = 0; i + 4 <= steps; i += 4) {
+        o = i * 2;
+        yuv_to_rgb_avx2(decoder, interleave_2x_avx2(color_tab->crt_y + i),
+                        interleave_2x_avx2(color_tab->crt_u + i),
+                        interleave_2x_avx2(color_tab->crt_v + i), &r, &g, &b);
+
+        _mm256_storeu_si256((__m256i *)(line + o),
+                            gamma_avx2(color_tab->gamma_red, color_tab->gamma_grn, color_tab->gamma_blu,
+                                       _mm256_add_epi32(r, off256), _mm256_add_epi32(g, off256),
+                                       _mm256_add_epi32(b, off256), alpha));
+
+        idx = _mm256_add_epi32(triplets, _mm256_set1_epi32((int)(o * 3)));
+        _mm256_storeu_si256((__m256i *)(scanline + o),
+                            gamma_avx2(color_tab->gamma_red_fac, color_tab->gamma_grn_fac,
+                                       color_tab->gamma_blu_fac,
+                                       _mm256_add_epi32(_mm256_add_epi32(r, off512),
+                                                        prevline_avx2(prevline, idx)),
+                                       _mm256_add_epi32(_mm256_add_epi32(g, off512),
+                                                        prevline_avx2(prevline, _mm256_add_epi32(idx, one))),
+                                       _mm256_add_epi32(_mm256_add_epi32(b, off512),
+                                                        prevline_avx2(prevline, _mm256_add_epi32(idx, _mm256_add_epi32(one, one)))),
+                                       alpha));
+
+        _mm256_storeu_si256((__m256i *)red, r);
+        _mm256_storeu_si256((__m256i *)grn, g);
+        _mm256_storeu_si256((__m256i *)blu, b);
+        for (k = 0; k < 8; k++) {
+            prevline[(o + k) * 3 + 0] = (int16_t)red[k];
+            prevline[(o + k) * 3 + 1] = (int16_t)grn[k];
+            prevline[(o + k) * 3 + 2] = (int16_t)blu[k];
+        }
+    }
+    line_2x_c(color_tab, decoder, i, steps, line, scanline, prevline);
+}
+
+RENDER_CRT_AVX2 static void line_1x_avx2(video_render_color_tables_t *color_tab, int decoder,
+                                         unsigned int pixels, uint32_t *line)
+{
+    const __m256i alpha = _mm256_set1_epi32((int)color_tab->alpha);
+    const __m256i off256 = _mm256_set1_epi32(256);
+    __m256i r, g, b;
+    unsigned int i;
+
+    for (i = 0; i + 8 <= pixels; i += 8) {
+        yuv_to_rgb_avx2(decoder,
+                        _mm256_loadu_si256((const __m256i *)(color_tab->crt_y + i)),
+                        _mm256_loadu_si256((const __m256i *)(color_tab->crt_u + i)),
+                        _mm256_loadu_si256((const __m256i *)(color_tab->crt_v + i)),
+                        &r, &g, &b);
+        _mm256_storeu_si256((__m256i *)(line + i),
+                            gamma_avx2(color_tab->gamma_red, color_tab->gamma_grn, color_tab->gamma_blu,
+                                       _mm256_add_epi32(r, off256), _mm256_add_epi32(g, off256),
+                                       _mm256_add_epi32(b, off256), alpha));
+    }
+    line_1x_c(color_tab, decoder, i, pixels, line);
+}
+
+#endif /* RENDER_CRT_X86 */
+
+/* ------------------------------------------------------------------------- */
+
+int render_crt_impl_supported(int impl)
+{
+    switch (impl) {
+        case RENDER_CRT_IMPL_C:
+            return 1;
+#ifdef RENDER_CRT_X86
+        case RENDER_CRT_IMPL_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") ? 1 : 0;
+        case RENDER_CRT_IMPL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+        default:
+            break;
+    }
+    return 0;
+}
+
+/* use the best supported implementation */
+static void render_crt_impl_select(void)
+{
+    int impl;
+
+    for (impl = RENDER_CRT_IMPL_NUM - 1; impl > RENDER_CRT_IMPL_C; impl--) {
+        if (render_crt_impl_supported(impl)) {
+            break;
+        }
+    }
+    render_crt_impl = impl;
+    log_message(LOG_DEFAULT, "CRT emulation: using %s line output.",
+                render_crt_impl_names[impl]);
+}
+
+int render_crt_impl_get(void)
+{
+    if (render_crt_impl < 0) {
+        render_crt_impl_select();
+    }
+    return render_crt_impl;
+}
+
+int render_crt_impl_set(int impl)
+{
+    if (!render_crt_impl_supported(impl)) {
+        return -1;
+    }
+    render_crt_impl = impl;
+    return 0;
+}
+
+const char *render_crt_impl_name(int impl)
+{
+    if (impl < 0 || impl >= RENDER_CRT_IMPL_NUM) {
+        return "unknown";
+    }
+    return render_crt_impl_names[impl];
+}
+
+/** \brief  Output one line of the 2x2 renderers
+ *
+ * Writes 2 * \a steps pixels to \a line and \a scanline: the color of each
+ * step followed by the average of it and the next step, so crt_y/crt_u/crt_v
+ * must hold \a steps + 1 values.
+ */
+void render_crt_line_2x(video_render_color_tables_t *color_tab, int decoder,
+                        unsigned int steps, uint32_t *line, uint32_t *scanline,
+                        int16_t *prevline)
+{
+    switch (render_crt_impl_get()) {
+#ifdef RENDER_CRT_X86
+        case RENDER_CRT_IMPL_AVX2:
+            line_2x_avx2(color_tab, decoder, steps, line, scanline, prevline);
+            break;
+        case RENDER_CRT_IMPL_SSE2:
+            line_2x_sse2(color_tab, decoder, steps, line, scanline, prevline);
+            break;
+#endif
+        default:
+            line_2x_c(color_tab, decoder, 0, steps, line, scanline, prevline);
+            break;
+    }
+}
+
+/** \brief  Output one line of the 1x1 renderers, one pixel per value */
+void render_crt_line_1x(video_render_color_tables_t *color_tab, int decoder,
+                        unsigned int pixels, uint32_t *line)
+{
+    switch (render_crt_impl_get()) {
+#ifdef RENDER_CRT_X86
+        case RENDER_CRT_IMPL_AVX2:
+            line_1x_avx2(color_tab, decoder, pixels, line);
+            break;
+        case RENDER_CRT_IMPL_SSE2:
+            line_1x_sse2(color_tab, decoder, pixels, line);
+            break;
+#endif
+        default:
+            line_1x_c(color_tab, decoder, 0, pixels, line);
+            break;
+    }
+}
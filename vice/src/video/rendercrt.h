@@ -0,0 +1,51 @@
+/*
+ * rendercrt.h - PAL/NTSC CRT emulation line output
+ *
+ * This file is part of VICE, the Versatile Commodore Emulator.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+#ifndef VICE_RENDERCRT_H
+#define VICE_RENDERCRT_H
+
+#include "types.h"
+#include "video.h"
+
+/* color decoders of the CRT renderers, see yuv_to_rgb() in rendercrt.c */
+#define RENDER_CRT_DECODER_PAL   0
+#define RENDER_CRT_DECODER_NTSC  1
+
+/* implementations of the line output, in order of preference */
+#define RENDER_CRT_IMPL_C        0
+#define RENDER_CRT_IMPL_SSE2     1
+#define RENDER_CRT_IMPL_AVX2     2
+#define RENDER_CRT_IMPL_NUM      3
+
+void render_crt_line_2x(video_render_color_tables_t *color_tab, int decoder,
+                        unsigned int steps, uint32_t *line, uint32_t *scanline,
+                        int16_t *prevline);
+void render_crt_line_1x(video_render_color_tables_t *color_tab, int decoder,
+                        unsigned int pixels, uint32_t *line);
+
+int render_crt_impl_supported(int impl);
+int render_crt_impl_get(void);
+int render_crt_impl_set(int impl);
+const char *render_crt_impl_name(int impl);
+
+#endif
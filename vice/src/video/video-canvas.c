@@ -38,6 +38,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "lib.h"
 #include "log.h"
@@ -104,6 +105,8 @@ void video_canvas_shutdown(video_canvas_t *canvas)
         }
 
         lib_free(canvas->videoconfig);
+        lib_free(canvas->draw_buffer->track_buffer);
+        lib_free(canvas->draw_buffer->track_line_frame);
         lib_free(canvas->draw_buffer);
         lib_free(canvas->viewport);
         lib_free(canvas->geometry);
@@ -111,11 +114,14 @@ void video_canvas_shutdown(video_canvas_t *canvas)
     }
 }
 
-void video_canvas_render(video_canvas_t *canvas, uint8_t *trg, int width,
-                         int height, int xs, int ys, int xt, int yt,
-                         int pitcht)
+/* Render the draw buffer, only the lines that changed after frame \a since
+   unless that is 0, see video_render_main_changed(). */
+static void canvas_render(video_canvas_t *canvas, uint8_t *trg, int width,
+                          int height, int xs, int ys, int xt, int yt,
+                          int pitcht, unsigned int since)
 {
     viewport_t *viewport = canvas->viewport;
+    draw_buffer_t *draw_buffer = canvas->draw_buffer;
 #ifdef VIDEO_SCALE_SOURCE
     xs /= canvas->videoconfig->scalex;
     ys /= canvas->videoconfig->scaley;
@@ -129,11 +135,192 @@ void video_canvas_render(video_canvas_t *canvas, uint8_t *trg, int width,
 
     if (!canvas->videoconfig->color_tables.updated) { /* update colors as necessary */
         video_color_update_palette(canvas);
+        /* the output of earlier frames is outdated everywhere */
+        draw_buffer->track_invalid = 1;
+        since = 0;
+    }
+    if (since != 0) {
+        video_render_main_changed(canvas->videoconfig, draw_buffer->draw_buffer,
+                                  trg, width, height, xs, ys, xt, yt,
+                                  draw_buffer->draw_buffer_width, pitcht,
+                                  viewport, draw_buffer->track_line_frame,
+                                  draw_buffer->track_height, since);
+    } else {
+        video_render_main(canvas->videoconfig, draw_buffer->draw_buffer,
+                          trg, width, height, xs, ys, xt, yt,
+                          draw_buffer->draw_buffer_width, pitcht,
+                          viewport);
+    }
+}
+
+void video_canvas_render(video_canvas_t *canvas, uint8_t *trg, int width,
+                         int height, int xs, int ys, int xt, int yt,
+                         int pitcht)
+{
+    canvas_render(canvas, trg, width, height, xs, ys, xt, yt, pitcht, 0);
+}
+
+/** \brief  Render only what changed since an earlier frame
+ *
+ * Like video_canvas_render(), for targets that keep their contents. During
+ * the refresh at the end of a frame only the lines are rendered that changed
+ * after frame \a since, the rest of \a trg must still hold the output of
+ * that frame, rendered with the same area. Otherwise, or when \a since is 0,
+ * everything is rendered.
+ *
+ * \return the frame \a trg holds the output of, to be passed as \a since
+ *         next time, or 0 if it holds no tracked frame
+ */
+unsigned int video_canvas_render_changed(video_canvas_t *canvas, uint8_t *trg,
+                                         int width, int height, int xs, int ys,
+                                         int xt, int yt, int pitcht,
+                                         unsigned int since)
+{
+    draw_buffer_t *draw_buffer = canvas->draw_buffer;
+
+    if (!draw_buffer->track_refresh) {
+        canvas_render(canvas, trg, width, height, xs, ys, xt, yt, pitcht, 0);
+        return 0;
+    }
+    canvas_render(canvas, trg, width, height, xs, ys, xt, yt, pitcht, since);
+    return draw_buffer->track_frame;
+}
+
+/* Number of the frame the raster is drawing, frame 0 stands for "no frame" */
+static inline unsigned int track_next_frame(draw_buffer_t *draw_buffer)
+{
+    unsigned int frame = draw_buffer->track_frame + 1;
+
+    return frame != 0 ? frame : 1;
+}
+
+/** \brief  Check if a line the raster code has drawn changed
+ *
+ * Called by the raster code for each line of the draw buffer it has drawn,
+ * lines it skipped because they did not change are not passed. The line is
+ * compared with the copy taken when it last changed, if it differs it gets
+ * the number of the frame being drawn.
+ *
+ * \param[in]  canvas  video canvas
+ * \param[in]  y       line of the draw buffer
+ */
+void video_canvas_track_line(video_canvas_t *canvas, unsigned int y)
+{
+    draw_buffer_t *draw_buffer = canvas->draw_buffer;
+    unsigned int width = draw_buffer->track_width;
+    uint8_t *line, *copy;
+
+    /* not set up yet or resized, video_canvas_track_changes() takes the
+       whole frame then */
+    if (draw_buffer->track_invalid
+        || width != draw_buffer->draw_buffer_width
+        || y >= draw_buffer->track_height
+        || draw_buffer->track_height != draw_buffer->draw_buffer_height) {
+        return;
+    }
+
+    line = draw_buffer->draw_buffer + y * width;
+    copy = draw_buffer->track_buffer + y * width;
+    if (memcmp(line, copy, width) != 0) {
+        memcpy(copy, line, width);
+        draw_buffer->track_line_frame[y] = track_next_frame(draw_buffer);
+        draw_buffer->track_frame_changed = draw_buffer->track_line_frame[y];
+    }
+}
+
+/** \brief  Finish the tracking of the lines that changed in the last frame
+ *
+ * Called by the raster code at the end of each frame that is refreshed,
+ * right before the refresh. The changed lines have been recorded by
+ * video_canvas_track_line() while the frame was drawn; after a resize, a
+ * palette change or with interlace all lines count as changed.
+ *
+ * \param[in]  canvas  video canvas
+ */
+void video_canvas_track_changes(video_canvas_t *canvas)
+{
+    draw_buffer_t *draw_buffer = canvas->draw_buffer;
+    unsigned int width = draw_buffer->draw_buffer_width;
+    unsigned int height = draw_buffer->draw_buffer_height;
+    unsigned int y;
+
+    if (draw_buffer->draw_buffer == NULL || width == 0 || height == 0) {
+        return;
+    }
+
+    if (width != draw_buffer->track_width || height != draw_buffer->track_height) {
+        lib_free(draw_buffer->track_buffer);
+        lib_free(draw_buffer->track_line_frame);
+        draw_buffer->track_buffer = lib_malloc(width * height);
+        draw_buffer->track_line_frame = lib_malloc(height * sizeof(unsigned int));
+        draw_buffer->track_width = width;
+        draw_buffer->track_height = height;
+        draw_buffer->track_invalid = 1;
+    }
+
+    /* the raster code only draws one of the two interlaced draw buffers per
+       frame, lines it skips may differ in the other one */
+    if (canvas->videoconfig->interlaced) {
+        draw_buffer->track_invalid = 1;
+    }
+
+    draw_buffer->track_frame = track_next_frame(draw_buffer);
+
+    if (draw_buffer->track_invalid) {
+        memcpy(draw_buffer->track_buffer, draw_buffer->draw_buffer, width * height);
+        for (y = 0; y < height; y++) {
+            draw_buffer->track_line_frame[y] = draw_buffer->track_frame;
+        }
+        draw_buffer->track_frame_changed = draw_buffer->track_frame;
+        draw_buffer->track_invalid = 0;
+    }
+
+    if (draw_buffer->track_frame_changed != draw_buffer->track_frame) {
+        draw_buffer->track_frames_unchanged++;
+    }
+}
+
+/** \brief  Check if the frame being refreshed is the same as an earlier one
+ *
+ * Lets frontends skip rendering, uploading and encoding a frame when they
+ * still show the output of frame \a since, as returned by
+ * video_canvas_render_changed().
+ *
+ * \param[in]  canvas  video canvas
+ * \param[in]  since   frame shown by the frontend, 0 if none
+ *
+ * \return nonzero if no line changed after frame \a since and the colors
+ *         are unchanged, always 0 outside of the refresh at the end of a frame
+ */
+int video_canvas_frame_unchanged(video_canvas_t *canvas, unsigned int since)
+{
+    draw_buffer_t *draw_buffer = canvas->draw_buffer;
+
+    return since != 0
+           && draw_buffer->track_refresh
+           && !draw_buffer->track_invalid
+           && canvas->videoconfig->color_tables.updated
+           && canvas->viewport->crt_type == canvas->crt_type
+           && (int)(draw_buffer->track_frame_changed - since) <= 0;
+}
+
+/** \brief  Get the number of tracked frames in which nothing changed
+ *
+ * Summed over all tracked canvases, used by benchmark mode.
+ *
+ * \return number of frames
+ */
+unsigned long video_canvas_frames_unchanged(void)
+{
+    unsigned long frames = 0;
+    int i;
+
+    for (i = 0; i < TRACKED_CANVAS_MAX; i++) {
+        if (tracked_canvas[i]) {
+            frames += tracked_canvas[i]->draw_buffer->track_frames_unchanged;
+        }
     }
-    video_render_main(canvas->videoconfig, canvas->draw_buffer->draw_buffer,
-                      trg, width, height, xs, ys, xt, yt,
-                      canvas->draw_buffer->draw_buffer_width, pitcht,
-                      viewport);
+    return frames;
 }
 
 /** \brief Force refresh all tracked canvases.
@@ -152,6 +339,52 @@ void video_canvas_refresh_all_tracked(void)
     }
 }
 
+/** \brief  Time the CRT renderers on the current frame of all canvases
+ *
+ * Used by benchmark mode (-benchrender), see video_render_pal_ntsc_bench()
+ * and video_render_bench_threads().
+ *
+ * \param[in]  frames  number of times to render the frame with each renderer
+ */
+void video_canvas_render_bench(int frames)
+{
+    video_canvas_t *canvas;
+    viewport_t *viewport;
+    geometry_t *geometry;
+    int i;
+
+    for (i = 0; i < TRACKED_CANVAS_MAX; i++) {
+        canvas = tracked_canvas[i];
+        if (canvas == NULL || canvas->draw_buffer->draw_buffer == NULL
+            || canvas->videoconfig->cap == NULL
+            || !canvas->videoconfig->cap->video_has_palntsc) {
+            continue;
+        }
+        viewport = canvas->viewport;
+        geometry = canvas->geometry;
+
+        if (!canvas->videoconfig->color_tables.updated) {
+            video_color_update_palette(canvas);
+        }
+        video_render_pal_ntsc_bench(canvas->videoconfig, canvas->videoconfig->chip_name,
+                                    canvas->draw_buffer->draw_buffer,
+                                    (int)(geometry->screen_size.width - viewport->first_x),
+                                    (int)(viewport->last_line - viewport->first_line + 1),
+                                    (int)(viewport->first_x + geometry->extra_offscreen_border_left),
+                                    (int)viewport->first_line,
+                                    (int)canvas->draw_buffer->draw_buffer_width,
+                                    viewport->first_line, viewport->last_line, frames);
+        video_render_bench_threads(canvas->videoconfig, canvas->videoconfig->chip_name,
+                                   canvas->draw_buffer->draw_buffer,
+                                   (int)(geometry->screen_size.width - viewport->first_x),
+                                   (int)(viewport->last_line - viewport->first_line + 1),
+                                   (int)(viewport->first_x + geometry->extra_offscreen_border_left),
+                                   (int)viewport->first_line,
+                                   (int)canvas->draw_buffer->draw_buffer_width,
+                                   viewport, frames);
+    }
+}
+
 void video_canvas_refresh_all(video_canvas_t *canvas)
 {
     viewport_t *viewport;
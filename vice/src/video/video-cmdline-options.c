@@ -36,8 +36,19 @@
 #include "util.h"
 #include "video.h"
 
+static const cmdline_option_t cmdline_options[] =
+{
+    { "-renderthreads", SET_RESOURCE, CMDLINE_ATTRIB_NEED_ARGS,
+      NULL, NULL, "RenderThreads", NULL,
+      "<count>", "Number of extra threads rendering the PAL/NTSC video modes in bands (0: none)" },
+    CMDLINE_LIST_END
+};
+
 int video_cmdline_options_init(void)
 {
+    if (cmdline_register_options(cmdline_options) < 0) {
+        return -1;
+    }
     return video_arch_cmdline_options_init();
 }
 
@@ -76,11 +76,13 @@ void video_render_setrawrgb(video_render_color_tables_t *color_tab, unsigned int
     color_tab->color_red[index] = r;
     color_tab->color_grn[index] = g;
     color_tab->color_blu[index] = b;
+    color_tab->generation++;
 }
 
 void video_render_setrawalpha(video_render_color_tables_t *color_tab, uint32_t a)
 {
     color_tab->alpha = a;
+    color_tab->generation++;
 }
 
 static video_ycbcr_palette_t *video_ycbcr_palette_create(unsigned int num_entries)
@@ -898,6 +900,7 @@ int video_color_update_palette(struct video_canvas_s *canvas)
         return 0;
     }
     canvas->videoconfig->color_tables.updated = 1;
+    canvas->videoconfig->color_tables.generation++;
 
     DBG(("video_color_update_palette cbm palette:%d extern: %d",
          canvas->videoconfig->cbm_palette ? 1 : 0, canvas->videoconfig->external_palette ? 1 : 0));
@@ -989,4 +992,5 @@ void video_render_initraw(struct video_render_config_s *videoconfig)
     int video;
     resources_get_int("MachineVideoStandard", &video);
     video_calc_gammatable(&videoconfig->color_tables, &videoconfig->video_resources, video);
+    videoconfig->color_tables.generation++;
 }
@@ -29,7 +29,10 @@
 #include "vice.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#include "archdep.h"
+#include "lib.h"
 #include "log.h"
 #include "machine.h"
 #include "render1x1.h"
@@ -40,6 +43,7 @@
 #include "render2x2pal.h"
 #include "render2x2palu.h"
 #include "render2x2ntsc.h"
+#include "rendercrt.h"
 #include "renderscale2x.h"
 #include "resources.h"
 #include "types.h"
@@ -134,3 +138,120 @@ void video_render_pal_ntsc_main(video_render_config_t *config,
     }
     log_debug("video_render_pal_ntsc_main unsupported rendermode (%d)\n", rendermode);
 }
+
+/* the CRT renderers timed by video_render_pal_ntsc_bench() */
+enum {
+    BENCH_1X1_PAL = 0,
+    BENCH_1X1_NTSC,
+    BENCH_2X2_PAL,
+    BENCH_2X2_PAL_U,
+    BENCH_2X2_NTSC,
+    BENCH_NUM
+};
+
+static const char * const bench_names[BENCH_NUM] = {
+    "1x1pal", "1x1ntsc", "2x2pal", "2x2palu", "2x2ntsc"
+};
+
+static void bench_render(int renderer, video_render_config_t *config, uint8_t *src, uint8_t *trg,
+                         int width, int height, int xs, int ys, int pitchs, int pitcht,
+                         unsigned int viewport_first_line, unsigned int viewport_last_line)
+{
+    video_render_color_tables_t *colortab = &config->color_tables;
+
+    switch (renderer) {
+        case BENCH_1X1_PAL:
+            render_32_1x1_pal(colortab, src, trg, width, height, xs, ys, 0, 0,
+                              pitchs, pitcht, config);
+            break;
+        case BENCH_1X1_NTSC:
+            render_32_1x1_ntsc(colortab, src, trg, width, height, xs, ys, 0, 0,
+                               pitchs, pitcht);
+            break;
+        case BENCH_2X2_PAL:
+            render_32_2x2_pal(colortab, src, trg, width * 2, height * 2, xs, ys, 0, 0,
+                              pitchs, pitcht, viewport_first_line, viewport_last_line, config);
+            break;
+        case BENCH_2X2_PAL_U:
+            render_32_2x2_pal_u(colortab, src, trg, width * 2, height * 2, xs, ys, 0, 0,
+                                pitchs, pitcht, viewport_first_line, viewport_last_line, config);
+            break;
+        case BENCH_2X2_NTSC:
+            render_32_2x2_ntsc(colortab, src, trg, width * 2, height * 2, xs, ys, 0, 0,
+                               pitchs, pitcht, viewport_first_line, viewport_last_line, config);
+            break;
+    }
+}
+
+/** \brief  Time the CRT renderers on a captured frame
+ *
+ * Renders the frame in \a src \a frames times with every CRT renderer and
+ * every supported line output implementation (see rendercrt.c), and prints
+ * one "vice-bench:" line for each. The output of each implementation is
+ * compared against the plain C one.
+ *
+ * \param[in]  config  render config of the canvas (color tables, CRT settings)
+ * \param[in]  chip    name of the video chip, for the output
+ * \param[in]  src     draw buffer
+ * \param[in]  width   width of the frame in source pixels
+ * \param[in]  height  height of the frame in source lines
+ * \param[in]  xs      first source pixel
+ * \param[in]  ys      first source line
+ * \param[in]  pitchs  pitch of the draw buffer
+ * \param[in]  viewport_first_line first visible line
+ * \param[in]  viewport_last_line  last visible line
+ * \param[in]  frames  number of times to render each frame
+ */
+void video_render_pal_ntsc_bench(video_render_config_t *config, const char *chip,
+                                 uint8_t *src, int width, int height, int xs, int ys,
+                                 int pitchs, unsigned int viewport_first_line,
+                                 unsigned int viewport_last_line, int frames)
+{
+    int old_impl = render_crt_impl_get();
+    int pitcht, renderer, impl, i;
+    size_t size;
+    uint8_t *reference;
+    uint8_t *trg;
+    tick_t start;
+    double usecs;
+
+    if (width > VIDEO_MAX_OUTPUT_WIDTH / 2) {
+        width = VIDEO_MAX_OUTPUT_WIDTH / 2;
+    }
+    if (width <= 0 || height <= 0 || frames <= 0) {
+        return;
+    }
+
+    /* 2x2 output, plus the scanline the 2x2 renderers write after the last line */
+    pitcht = width * 2 * 4;
+    size = (size_t)pitcht * (height * 2 + 2);
+    reference = lib_malloc(size);
+    trg = lib_malloc(size);
+
+    for (renderer = 0; renderer < BENCH_NUM; renderer++) {
+        for (impl = 0; impl < RENDER_CRT_IMPL_NUM; impl++) {
+            if (render_crt_impl_set(impl) < 0) {
+                continue;
+            }
+            memset(trg, 0, size);
+            start = tick_now();
+            for (i = 0; i < frames; i++) {
+                bench_render(renderer, config, src, trg, width, height, xs, ys, pitchs, pitcht,
+                             viewport_first_line, viewport_last_line);
+            }
+            usecs = (double)TICK_TO_MICRO(tick_now_delta(start)) / frames;
+
+            if (impl == RENDER_CRT_IMPL_C) {
+                memcpy(reference, trg, size);
+            }
+            printf("vice-bench: render=%s chip=%s impl=%s size=%dx%d us_per_frame=%.1f identical=%s\n",
+                   bench_names[renderer], chip, render_crt_impl_name(impl), width, height, usecs,
+                   memcmp(reference, trg, size) == 0 ? "yes" : "NO");
+        }
+    }
+    fflush(stdout);
+
+    render_crt_impl_set(old_impl);
+    lib_free(trg);
+    lib_free(reference);
+}
@@ -27,8 +27,16 @@
 
 #include "vice.h"
 
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "archdep.h"
+#include "lib.h"
 #include "log.h"
 #include "types.h"
 #include "video-render.h"
@@ -67,28 +75,280 @@ void video_render_setphysicalcolor(video_render_config_t *config, int index,
             break;
     }
     config->color_tables.physical_colors[index] = color;
+    config->color_tables.generation++;
 }
 
 static int rendermode_error = -1;
 
-void video_render_main(video_render_config_t *config, uint8_t *src, uint8_t *trg,
-                       int width, int height, int xs, int ys, int xt, int yt,
-                       int pitchs, int pitcht, viewport_t *viewport)
+/* Rendering of the PAL/NTSC modes in horizontal bands.
+
+   Every band is rendered with a complete call of the renderer for its
+   lines, so each band needs its own copy of the render config: the
+   renderers keep the delay line, the previous RGB line and other scratch
+   data in the color tables. The copies are only refreshed completely when
+   the color tables changed, see render_band_config_update(). The PAL/NTSC CRT renderers initialize the delay
+   line from the source line above the band themselves, and the 2x2 ones
+   write the scanline below the last line of a band in the extra iteration
+   at its end, while the next band does not write the one above its first
+   line. The output is therefore the same as with a single call, with one
+   exception handled by render_bands_split(): the extra iteration also
+   writes the scanline right below the viewport, which a single call skips.
+
+   The bands are spread over a pool of worker threads, the calling thread
+   takes bands as well. */
+
+/* number of worker threads, "RenderThreads" resource */
+static int render_threads_wanted = 0;
+
+#ifdef HAVE_PTHREAD
+/* source lines a band must have at least */
+#define RENDER_BAND_LINES_MIN   16
+
+typedef struct render_band_s {
+    video_render_config_t *config;
+    uint8_t *src;
+    uint8_t *trg;
+    int width, height, xs, ys, xt, yt, pitchs, pitcht;
+    int crt_type;
+    unsigned int viewport_first_line, viewport_last_line;
+} render_band_t;
+
+static render_band_t render_bands[VIDEO_RENDER_THREADS_MAX + 1];
+static int render_bands_count = 0;
+
+/* private render configs of the bands except the first */
+static video_render_config_t *render_band_config[VIDEO_RENDER_THREADS_MAX + 1];
+
+/* Bring the private config of a band up to date with \a config. The color
+   tables are most of its size and only change with the palette, the
+   scratch data in them is initialized by the renderers. */
+static void render_band_config_update(video_render_config_t *band_config,
+                                      const video_render_config_t *config)
 {
-    int rendermode;
+    size_t tables = offsetof(video_render_config_t, color_tables);
+    size_t rest = tables + sizeof(video_render_color_tables_t);
 
-#if 0
-    log_debug("w:%i h:%i xs:%i ys:%i xt:%i yt:%i ps:%i pt:%i d%i",
-              width, height, xs, ys, xt, yt, pitchs, pitcht, depth);
+    if (band_config->color_tables.generation != config->color_tables.generation) {
+        memcpy(band_config, config, sizeof(video_render_config_t));
+        return;
+    }
+    memcpy(band_config, config, tables);
+    memcpy((uint8_t *)band_config + rest, (const uint8_t *)config + rest,
+           sizeof(video_render_config_t) - rest);
+}
 
-#endif
-    if (width <= 0) {
-        return; /* some render routines don't like invalid width */
+static void render_band_run(render_band_t *band)
+{
+    render_pal_ntsc_func(band->config, band->src, band->trg,
+                         band->width, band->height, band->xs, band->ys,
+                         band->xt, band->yt, band->pitchs, band->pitcht,
+                         band->crt_type, band->viewport_first_line, band->viewport_last_line);
+}
+
+static pthread_t render_workers[VIDEO_RENDER_THREADS_MAX];
+static int render_workers_count = 0;
+static int render_workers_quit = 0;
+
+/* bands handed to the workers, next band to be taken, bands not finished yet */
+static int render_bands_posted = 0;
+static int render_bands_next = 0;
+static int render_bands_pending = 0;
+
+static pthread_mutex_t render_workers_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t render_workers_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t render_workers_done = PTHREAD_COND_INITIALIZER;
+
+/* held while rendering with the pool, canvases rendered at the same time
+   from other threads are rendered in one go */
+static pthread_mutex_t render_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *render_worker_main(void *unused)
+{
+    render_band_t *band;
+
+    pthread_mutex_lock(&render_workers_lock);
+    while (1) {
+        while (!render_workers_quit && render_bands_next >= render_bands_posted) {
+            pthread_cond_wait(&render_workers_wake, &render_workers_lock);
+        }
+        if (render_workers_quit) {
+            break;
+        }
+        band = &render_bands[render_bands_next++];
+        pthread_mutex_unlock(&render_workers_lock);
+
+        render_band_run(band);
+
+        pthread_mutex_lock(&render_workers_lock);
+        if (--render_bands_pending == 0) {
+            pthread_cond_signal(&render_workers_done);
+        }
     }
+    pthread_mutex_unlock(&render_workers_lock);
 
-    video_sound_update(config, src, width, height, xs, ys, pitchs, viewport);
+    return NULL;
+}
 
-    rendermode = config->rendermode;
+static void render_workers_stop(void)
+{
+    int i;
+
+    if (render_workers_count == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&render_workers_lock);
+    render_workers_quit = 1;
+    pthread_cond_broadcast(&render_workers_wake);
+    pthread_mutex_unlock(&render_workers_lock);
+
+    for (i = 0; i < render_workers_count; i++) {
+        pthread_join(render_workers[i], NULL);
+    }
+    render_workers_count = 0;
+    render_workers_quit = 0;
+}
+
+static void render_workers_start(int count)
+{
+    int i;
+
+    render_workers_stop();
+
+    for (i = 0; i < count; i++) {
+        if (pthread_create(&render_workers[i], NULL, render_worker_main, NULL) != 0) {
+            log_error(LOG_DEFAULT, "Video: could not start render thread %d.", i);
+            break;
+        }
+    }
+    render_workers_count = i;
+}
+
+static void render_bands_run_parallel(void)
+{
+    render_band_t *band;
+
+    pthread_mutex_lock(&render_workers_lock);
+    render_bands_next = 0;
+    render_bands_posted = render_bands_count;
+    render_bands_pending = render_bands_count;
+    pthread_cond_broadcast(&render_workers_wake);
+
+    /* the calling thread takes bands as well */
+    while (render_bands_next < render_bands_posted) {
+        band = &render_bands[render_bands_next++];
+        pthread_mutex_unlock(&render_workers_lock);
+
+        render_band_run(band);
+
+        pthread_mutex_lock(&render_workers_lock);
+        render_bands_pending--;
+    }
+    while (render_bands_pending > 0) {
+        pthread_cond_wait(&render_workers_done, &render_workers_lock);
+    }
+    render_bands_posted = 0;
+    pthread_mutex_unlock(&render_workers_lock);
+}
+
+/* Split the area into at most \a count bands of whole source lines, returns
+   the number of bands. */
+static int render_bands_split(video_render_config_t *config, uint8_t *src, uint8_t *trg,
+                              int width, int height, int xs, int ys, int xt, int yt,
+                              int pitchs, int pitcht, viewport_t *viewport, int count)
+{
+    render_band_t *band;
+    int scale = (config->rendermode == VIDEO_RENDER_PAL_NTSC_2X2) ? 2 : 1;
+    int lines = height / scale;
+    int first, next, i, n;
+
+    if (count > lines / RENDER_BAND_LINES_MIN) {
+        count = lines / RENDER_BAND_LINES_MIN;
+    }
+    if (count < 1) {
+        count = 1;
+    }
+
+    first = 0;
+    n = 0;
+    for (i = 0; i < count; i++) {
+        next = (i == count - 1) ? lines : lines * (i + 1) / count;
+        /* see above, no band may start right below the viewport */
+        if (scale == 2 && next < lines && ys + next == (int)viewport->last_line + 1) {
+            next++;
+        }
+        if (next <= first) {
+            continue;
+        }
+
+        band = &render_bands[n];
+        if (n == 0) {
+            band->config = config;
+        } else {
+            if (render_band_config[n] == NULL) {
+                render_band_config[n] = lib_malloc(sizeof(video_render_config_t));
+                memcpy(render_band_config[n], config, sizeof(video_render_config_t));
+            } else {
+                render_band_config_update(render_band_config[n], config);
+            }
+            band->config = render_band_config[n];
+        }
+        band->src = src;
+        band->trg = trg;
+        band->width = width;
+        band->height = (next == lines) ? height - first * scale : (next - first) * scale;
+        band->xs = xs;
+        band->ys = ys + first;
+        band->xt = xt;
+        band->yt = yt + first * scale;
+        band->pitchs = pitchs;
+        band->pitcht = pitcht;
+        band->crt_type = viewport->crt_type;
+        band->viewport_first_line = viewport->first_line;
+        band->viewport_last_line = viewport->last_line;
+        n++;
+
+        first = next;
+    }
+    return n;
+}
+#endif
+
+/* Render the PAL/NTSC modes with \a threads worker threads, returns the
+   number of bands rendered at the same time. */
+static int render_pal_ntsc(video_render_config_t *config, uint8_t *src, uint8_t *trg,
+                           int width, int height, int xs, int ys, int xt, int yt,
+                           int pitchs, int pitcht, viewport_t *viewport, int threads)
+{
+#ifdef HAVE_PTHREAD
+    int bands;
+
+    if (threads > 0 && pthread_mutex_trylock(&render_pool_lock) == 0) {
+        if (render_workers_count != threads) {
+            render_workers_start(threads);
+        }
+        render_bands_count = render_bands_split(config, src, trg, width, height, xs, ys, xt, yt,
+                                                pitchs, pitcht, viewport, render_workers_count + 1);
+        if (render_bands_count > 1) {
+            render_bands_run_parallel();
+        } else if (render_bands_count == 1) {
+            render_band_run(&render_bands[0]);
+        }
+        bands = render_bands_count;
+        pthread_mutex_unlock(&render_pool_lock);
+        return bands;
+    }
+#endif
+    render_pal_ntsc_func(config, src, trg, width, height, xs, ys, xt, yt, pitchs, pitcht,
+                         viewport->crt_type, viewport->first_line, viewport->last_line);
+    return 1;
+}
+
+static void render_area(video_render_config_t *config, uint8_t *src, uint8_t *trg,
+                        int width, int height, int xs, int ys, int xt, int yt,
+                        int pitchs, int pitcht, viewport_t *viewport)
+{
+    int rendermode = config->rendermode;
 
     switch (rendermode) {
         case VIDEO_RENDER_NULL:
@@ -97,8 +357,8 @@ void video_render_main(video_render_config_t *config, uint8_t *src, uint8_t *trg
 
         case VIDEO_RENDER_PAL_NTSC_1X1:
         case VIDEO_RENDER_PAL_NTSC_2X2:
-            render_pal_ntsc_func(config, src, trg, width, height, xs, ys, xt, yt, pitchs, pitcht,
-                                 viewport->crt_type, viewport->first_line, viewport->last_line);
+            render_pal_ntsc(config, src, trg, width, height, xs, ys, xt, yt, pitchs, pitcht,
+                            viewport, render_threads_wanted);
             return;
 
         case VIDEO_RENDER_CRT_MONO_1X1:
@@ -123,6 +383,102 @@ void video_render_main(video_render_config_t *config, uint8_t *src, uint8_t *trg
     rendermode_error = rendermode;
 }
 
+void video_render_main(video_render_config_t *config, uint8_t *src, uint8_t *trg,
+                       int width, int height, int xs, int ys, int xt, int yt,
+                       int pitchs, int pitcht, viewport_t *viewport)
+{
+#if 0
+    log_debug("w:%i h:%i xs:%i ys:%i xt:%i yt:%i ps:%i pt:%i d%i",
+              width, height, xs, ys, xt, yt, pitchs, pitcht, depth);
+
+#endif
+    if (width <= 0) {
+        return; /* some render routines don't like invalid width */
+    }
+
+    video_sound_update(config, src, width, height, xs, ys, pitchs, viewport);
+
+    render_area(config, src, trg, width, height, xs, ys, xt, yt, pitchs, pitcht, viewport);
+}
+
+/* Nonzero if one of the source lines \a first to \a last changed after frame
+   \a since, lines without a frame number count as changed. */
+static int render_lines_changed(const unsigned int *line_frame, unsigned int lines,
+                                int first, int last, unsigned int since)
+{
+    int y;
+
+    for (y = first; y <= last; y++) {
+        if (y < 0 || y >= (int)lines || (int)(line_frame[y] - since) > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Like video_render_main(), but in the PAL/NTSC modes only the source lines
+   are rendered that changed after frame \a since, according to \a line_frame
+   which holds the frame in which each of the \a lines source lines last
+   changed. The target must still hold the output of frame \a since.
+
+   The output of a line also depends on the lines around it (delay line,
+   scanline blending, scale2x), and with an odd \a yt the two target lines of
+   a source line are half a line off, so a line is rendered again when one of
+   the two lines above or below it changed. The runs are rendered like the bands in
+   render_pal_ntsc(), and the same restriction at the bottom of the viewport
+   applies, so the output is the same as with video_render_main(). */
+void video_render_main_changed(video_render_config_t *config, uint8_t *src, uint8_t *trg,
+                               int width, int height, int xs, int ys, int xt, int yt,
+                               int pitchs, int pitcht, viewport_t *viewport,
+                               const unsigned int *line_frame, unsigned int lines,
+                               unsigned int since)
+{
+    int scale, count, first, y, wanted;
+    int below_viewport;
+
+    if (width <= 0) {
+        return; /* some render routines don't like invalid width */
+    }
+
+    video_sound_update(config, src, width, height, xs, ys, pitchs, viewport);
+
+    if (config->rendermode != VIDEO_RENDER_PAL_NTSC_1X1
+        && config->rendermode != VIDEO_RENDER_PAL_NTSC_2X2) {
+        render_area(config, src, trg, width, height, xs, ys, xt, yt, pitchs, pitcht, viewport);
+        return;
+    }
+
+    scale = (config->rendermode == VIDEO_RENDER_PAL_NTSC_2X2) ? 2 : 1;
+    count = (height + scale - 1) / scale;
+    /* no run may start right below the viewport, the two lines around that
+       border are rendered together */
+    below_viewport = (scale == 2) ? (int)viewport->last_line + 1 - ys : -1;
+
+    first = -1;
+    for (y = 0; y <= count; y++) {
+        wanted = 0;
+        if (y < count) {
+            if (y == below_viewport - 1 || y == below_viewport) {
+                wanted = render_lines_changed(line_frame, lines, ys + below_viewport - 3,
+                                              ys + below_viewport + 2, since);
+            } else {
+                wanted = render_lines_changed(line_frame, lines, ys + y - 2, ys + y + 2, since);
+            }
+        }
+        if (wanted) {
+            if (first < 0) {
+                first = y;
+            }
+        } else if (first >= 0) {
+            render_pal_ntsc(config, src, trg, width,
+                            (y == count) ? height - first * scale : (y - first) * scale,
+                            xs, ys + first, xt, yt + first * scale, pitchs, pitcht,
+                            viewport, render_threads_wanted);
+            first = -1;
+        }
+    }
+}
+
 void video_render_palntscfunc_set(render_pal_ntsc_func_t func)
 {
     render_pal_ntsc_func = func;
@@ -137,3 +493,106 @@ void video_render_rgbifunc_set(render_rgbi_func_t func)
 {
     render_rgbi_func = func;
 }
+
+/** \brief  Set the number of render worker threads
+ *
+ * \param[in]  count   number of threads besides the calling one, 0 renders
+ *                     in the calling thread only
+ */
+void video_render_set_threads(int count)
+{
+    render_threads_wanted = count;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&render_pool_lock);
+    if (render_workers_count != count) {
+        render_workers_stop();
+    }
+    pthread_mutex_unlock(&render_pool_lock);
+#endif
+}
+
+/** \brief  Compare banded rendering against rendering in one go
+ *
+ * Renders the frame \a frames times in 2x2 PAL/NTSC mode with CRT emulation,
+ * first in the calling thread only and then with 1, 3 and
+ * VIDEO_RENDER_THREADS_MAX worker threads, and prints the time per frame,
+ * the number of bands and whether the output is identical to that of the
+ * calling thread only. An error is printed instead when the frame was not
+ * split into bands, as without POSIX threads, since nothing was compared.
+ * Used by benchmark mode (-benchrender).
+ */
+void video_render_bench_threads(video_render_config_t *config, const char *chip,
+                                uint8_t *src, int width, int height, int xs, int ys,
+                                int pitchs, viewport_t *viewport, int frames)
+{
+    static const int threads_list[] = { 0, 1, 3, VIDEO_RENDER_THREADS_MAX };
+    int rendermode = config->rendermode;
+    int filter = config->filter;
+    int pitcht, t, i, bands;
+    size_t size;
+    uint8_t *reference;
+    uint8_t *trg;
+    tick_t start;
+    double usecs;
+
+    if (width > VIDEO_MAX_OUTPUT_WIDTH / 2) {
+        width = VIDEO_MAX_OUTPUT_WIDTH / 2;
+    }
+    if (width <= 0 || height <= 0 || frames <= 0) {
+        return;
+    }
+
+    config->rendermode = VIDEO_RENDER_PAL_NTSC_2X2;
+    config->filter = VIDEO_FILTER_CRT;
+    pitcht = width * 2 * 4;
+    size = (size_t)pitcht * (height * 2 + 2);
+    reference = lib_malloc(size);
+    trg = lib_malloc(size);
+
+    for (t = 0; t < (int)(sizeof(threads_list) / sizeof(threads_list[0])); t++) {
+        memset(trg, 0, size);
+        bands = 1;
+        start = tick_now();
+        for (i = 0; i < frames; i++) {
+            bands = render_pal_ntsc(config, src, trg, width * 2, height * 2, xs, ys, 0, 0,
+                                    pitchs, pitcht, viewport, threads_list[t]);
+        }
+        usecs = (double)TICK_TO_MICRO(tick_now_delta(start)) / frames;
+
+        if (t == 0) {
+            memcpy(reference, trg, size);
+        } else if (bands < 2) {
+            /* the workers did not start, nothing was compared */
+            printf("vice-bench: render=bands chip=%s threads=%d error=no-worker-threads\n",
+                   chip, threads_list[t]);
+            continue;
+        }
+        printf("vice-bench: render=bands chip=%s threads=%d bands=%d size=%dx%d us_per_frame=%.1f identical=%s\n",
+               chip, threads_list[t], bands, width, height, usecs,
+               memcmp(reference, trg, size) == 0 ? "yes" : "NO");
+    }
+    fflush(stdout);
+
+    config->rendermode = rendermode;
+    config->filter = filter;
+#ifdef HAVE_PTHREAD
+    if (render_workers_count != render_threads_wanted) {
+        render_workers_stop();
+    }
+#endif
+    lib_free(trg);
+    lib_free(reference);
+}
+
+void video_render_shutdown(void)
+{
+#ifdef HAVE_PTHREAD
+    int i;
+
+    render_workers_stop();
+    for (i = 0; i <= VIDEO_RENDER_THREADS_MAX; i++) {
+        lib_free(render_band_config[i]);
+        render_band_config[i] = NULL;
+    }
+#endif
+}
@@ -56,8 +56,24 @@ void video_render_main(struct video_render_config_s *config, uint8_t *src,
                        int xs, int ys, int xt, int yt,
                        int pitchs, int pitcht,
                        viewport_t *viewport);
+void video_render_main_changed(struct video_render_config_s *config, uint8_t *src,
+                               uint8_t *trg, int width, int height,
+                               int xs, int ys, int xt, int yt,
+                               int pitchs, int pitcht,
+                               viewport_t *viewport,
+                               const unsigned int *line_frame, unsigned int lines,
+                               unsigned int since);
 void video_render_update_palette(struct video_canvas_s *canvas);
 
+/* maximum for the "RenderThreads" resource */
+#define VIDEO_RENDER_THREADS_MAX    15
+
+void video_render_set_threads(int count);
+void video_render_bench_threads(video_render_config_t *config, const char *chip,
+                                uint8_t *src, int width, int height, int xs, int ys,
+                                int pitchs, viewport_t *viewport, int frames);
+void video_render_shutdown(void);
+
 void video_render_palntscfunc_set(render_pal_ntsc_func_t func);
 void video_render_crtmonofunc_set(render_crt_mono_func_t func);
 void video_render_rgbifunc_set(render_rgbi_func_t func);
@@ -70,6 +86,10 @@ void video_render_pal_ntsc_main(video_render_config_t *config,
                                 int yt, int pitchs, int pitcht,
                                 int crt_type,
                                 unsigned int viewport_first_line, unsigned int viewport_last_line);
+void video_render_pal_ntsc_bench(video_render_config_t *config, const char *chip,
+                                 uint8_t *src, int width, int height, int xs, int ys,
+                                 int pitchs, unsigned int viewport_first_line,
+                                 unsigned int viewport_last_line, int frames);
 
 void video_render_rgbi_main(video_render_config_t *config,
                             uint8_t *src, uint8_t *trg,
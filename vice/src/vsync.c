@@ -50,6 +50,7 @@
 #endif
 
 #include "archdep.h"
+#include "bench.h"
 #include "cmdline.h"
 #include "debug.h"
 #include "joystick.h"
@@ -64,8 +65,11 @@
 #endif
 #include "network.h"
 #include "resources.h"
+#include "rewind.h"
+#include "runahead.h"
 #include "sound.h"
 #include "types.h"
+#include "video.h"
 #include "videoarch.h"
 #include "vsync.h"
 #include "vsyncapi.h"
@@ -79,6 +83,8 @@
 /* public metrics, updated every vsync */
 static double vsync_metric_cpu_percent;
 static double vsync_metric_emulated_fps;
+static double vsync_metric_runahead_percent;
+static vsync_present_metrics_t vsync_metric_present;
 
 #ifdef USE_VICE_THREAD
 #   include <pthread.h>
@@ -358,6 +364,7 @@ void vsync_suspend_speed_eval(void)
     /* TODO - Is this needed any more now that late vsync is detected
        in vsync_do_vsync() */
     network_suspend();
+    runahead_cancel();
     sync_reset = true;
 }
 
@@ -368,13 +375,18 @@ void vsync_reset_hook(void)
     vsync_suspend_speed_eval();
 }
 
-void vsyncarch_get_metrics(double *cpu_percent, double *emulated_fps, int *is_warp_enabled)
+void vsyncarch_get_metrics(double *cpu_percent, double *emulated_fps, int *is_warp_enabled, double *runahead_percent,
+                           vsync_present_metrics_t *present_metrics)
 {
     METRIC_LOCK();
 
     *cpu_percent = vsync_metric_cpu_percent;
     *emulated_fps = vsync_metric_emulated_fps;
+    *runahead_percent = vsync_metric_runahead_percent;
     *is_warp_enabled = warp_enabled;
+    if (present_metrics != NULL) {
+        *present_metrics = vsync_metric_present;
+    }
 
     METRIC_UNLOCK();
 }
@@ -483,6 +495,32 @@ static void update_performance_metrics(tick_t frame_tick)
     }
 }
 
+/* Host time spent on run-ahead in the last frame, in percent of the duration
+   of a frame.  0 means run-ahead is off.  */
+void vsync_set_runahead_cost(double percent)
+{
+    METRIC_LOCK();
+
+    if (percent <= 0.0 || vsync_metric_runahead_percent <= 0.0) {
+        vsync_metric_runahead_percent = percent;
+    } else {
+        vsync_metric_runahead_percent = (MEASUREMENT_SMOOTH_FACTOR * vsync_metric_runahead_percent) + (1.0 - MEASUREMENT_SMOOTH_FACTOR) * percent;
+    }
+
+    METRIC_UNLOCK();
+}
+
+/* Frame pacing of the frontend's display path, measured by the frontend
+   (see render_queue.c of the GTK3 UI).  */
+void vsync_set_present_metrics(const vsync_present_metrics_t *present_metrics)
+{
+    METRIC_LOCK();
+
+    vsync_metric_present = *present_metrics;
+
+    METRIC_UNLOCK();
+}
+
 void vsync_do_end_of_line(void)
 {
     const int microseconds_between_sync = 2 * 1000;
@@ -515,6 +553,11 @@ void vsync_do_end_of_line(void)
         return;
     }
 
+    /* frames emulated ahead are neither synchronized nor get new input */
+    if (runahead_is_speculating()) {
+        return;
+    }
+
     /* deal with any accumulated sound immediately */
     tick_based_sync_timing = sound_flush();
 
@@ -617,6 +660,12 @@ bool vsync_should_skip_frame(struct video_canvas_s *canvas)
 {
     tick_t now = tick_now();
 
+    /* decided when the frame started, see vsync_will_skip_frame() */
+    if (canvas->skip_frame) {
+        canvas->skip_frame = 0;
+        return true;
+    }
+
     /*
      * Ideally the draw alarm wouldn't be triggered
      * during shutdown but here we are - apply workaround.
@@ -627,6 +676,11 @@ bool vsync_should_skip_frame(struct video_canvas_s *canvas)
         return true;
     }
 
+    /* when running ahead only the last frame emulated ahead is shown */
+    if (runahead_is_active()) {
+        return !runahead_is_presenting();
+    }
+
     /*
      * Limit rendering fps if we're in warp mode.
      * It's ugly enough for dqh to weep but makes warp faster.
@@ -656,6 +710,39 @@ bool vsync_should_skip_frame(struct video_canvas_s *canvas)
     return false;
 }
 
+/*
+ * Called by video chips that can save work on frames that are not displayed,
+ * when a frame starts (e.g. right after vsync_do_vsync()).  Returns true only
+ * if the frame starting now is certain to be skipped, because the canvas is
+ * hidden or for the reasons vsync_should_skip_frame() checks.  The next
+ * vsync_should_skip_frame() then returns true as well so the unfinished frame
+ * is never shown.
+ */
+bool vsync_will_skip_frame(struct video_canvas_s *canvas)
+{
+    tick_t now;
+    int forced = bench_enabled ? bench_frame_skip() : -1;
+
+    if (forced >= 0) {
+        canvas->skip_frame = forced;
+    } else if (archdep_is_exiting() || video_arch_canvas_is_hidden(canvas)) {
+        canvas->skip_frame = 1;
+    } else if (runahead_is_active()) {
+        canvas->skip_frame = runahead_frame_is_hidden();
+    } else if (warp_enabled) {
+        now = tick_now();
+        if (now < canvas->warp_next_render_tick - warp_render_tick_interval) {
+            /* next render tick is further ahead than it should be */
+            canvas->warp_next_render_tick = now + warp_render_tick_interval;
+        }
+        canvas->skip_frame = now < canvas->warp_next_render_tick;
+    } else {
+        canvas->skip_frame = 0;
+    }
+
+    return canvas->skip_frame;
+}
+
 /* This is called at the end of each screen frame. */
 void vsync_do_vsync(struct video_canvas_s *c)
 {
@@ -664,8 +751,15 @@ void vsync_do_vsync(struct video_canvas_s *c)
     tick_t now;
     tick_t network_hook_time = 0;
 
+    if (runahead_vsync_hook()) {
+        /* speculative frame, see runahead.c */
+        return;
+    }
+
     monitor_vsync_hook();
 
+    bench_vsync();
+
     /*
      * process everything wich should be done before the synchronisation
      * e.g. OS/2: exit the programm if trigger_shutdown set
@@ -677,7 +771,11 @@ void vsync_do_vsync(struct video_canvas_s *c)
         network_hook_time = tick_now();
     }
 
+    BENCH_ENTER(BENCH_SECTION_VSYNC);
     vsync_hook();
+    BENCH_LEAVE();
+
+    rewind_vsync_hook();
 
     if (network_connected()) {
         /* TODO - re-eval if any of this network stuff makes sense */
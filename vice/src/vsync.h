@@ -51,9 +51,11 @@ void vsync_set_machine_parameter(double refresh_rate, long cycles);
 double vsync_get_refresh_frequency(void);
 void vsync_do_end_of_line(void);
 bool vsync_should_skip_frame(struct video_canvas_s *canvas);
+bool vsync_will_skip_frame(struct video_canvas_s *canvas);
 void vsync_do_vsync(struct video_canvas_s *c);
 void vsync_on_vsync_do(vsync_callback_func_t callback_func, void *callback_param);
 void vsync_set_warp_mode(int val);
 int vsync_get_warp_mode(void);
+void vsync_set_runahead_cost(double percent);
 
 #endif
@@ -33,8 +33,22 @@ struct video_canvas_s;
 
 typedef void (*void_hook_t)(void);
 
-/* current performance metrics */
-void vsyncarch_get_metrics(double *cpu_percent, double *emulated_fps, int *warp_enabled);
+/* frame pacing of the frontend, from the end of an emulated frame to its present */
+typedef struct vsync_present_metrics_s {
+    double latency_min_ms;          /* over the last presented frames */
+    double latency_avg_ms;
+    double latency_p99_ms;
+    unsigned long frames_presented; /* totals since startup */
+    unsigned long frames_dropped;   /* rendered but replaced before presented */
+    unsigned long frames_repeated;  /* presents without a new frame */
+} vsync_present_metrics_t;
+
+/* current performance metrics, present_metrics may be NULL */
+void vsyncarch_get_metrics(double *cpu_percent, double *emulated_fps, int *warp_enabled, double *runahead_percent,
+                           vsync_present_metrics_t *present_metrics);
+
+/* called by the frontend to publish its frame pacing metrics */
+void vsync_set_present_metrics(const vsync_present_metrics_t *present_metrics);
 
 /* this is called before vsync_do_vsync does the synchroniation */
 void vsyncarch_presync(void);
@@ -5410,12 +5410,17 @@ static void opcode_fd(uint8_t ip1, uint8_t ip2, uint8_t ip3, uint16_t ip12, uint
 static void z80_maincpu_loop(interrupt_cpu_status_t *cpu_int_status, alarm_context_t *cpu_alarm_context)
 {
     opcode_t opcode;
+    CLOCK start_clk = CLK;
 
     import_registers();
 
     Z80_SET_DMA_REQUEST(0)
 
     do {
+        /* Checked before every opcode: running blocks of opcodes up to the
+           next alarm still needs a clock compare per opcode, plus a check
+           for I/O accesses that may set alarms or interrupts, and was not
+           measurably faster.  */
         while (CLK >= alarm_context_next_pending_clk(cpu_alarm_context)) {
             alarm_context_dispatch(cpu_alarm_context, CLK);
         }
@@ -6217,7 +6222,20 @@ static void z80_maincpu_loop(interrupt_cpu_status_t *cpu_int_status, alarm_conte
         }
 
         cpu_int_status->num_dma_per_opcode = 0;
+        bench_z80_instructions++;
+
+        /* the main CPU loop does not run while the Z80 is active */
+        if (maincpu_clk_limit && (maincpu_clk > maincpu_clk_limit)) {
+            if (bench_enabled) {
+                bench_z80_cycles += CLK - start_clk;
+                bench_finish();
+            }
+            log_error(LOG_DEFAULT, "cycle limit reached.");
+            archdep_vice_exit(EXIT_FAILURE);
+        }
     } while (Z80_LOOP_COND);
 
+    bench_z80_cycles += CLK - start_clk;
+
     export_registers();
 }
@@ -31,6 +31,11 @@
 
 /* This code might be improved a lot...  */
 
+/* for fopencookie() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+
 #include "vice.h"
 
 #include <ctype.h>
@@ -70,6 +75,23 @@
 #define ZDEBUG(a)
 #endif
 
+/* Files compressed with gzip are uncompressed into memory instead of a
+   temporary file.  Read-only opens read them through a fmemopen() stream,
+   opens for writing through a fopencookie() stream that can grow; those are
+   compressed again from memory on close.  */
+#if defined(HAVE_ZLIB) && defined(HAVE_FMEMOPEN)
+#define ZFILE_IN_MEMORY
+#endif
+#if defined(HAVE_ZLIB) && defined(HAVE_FOPENCOOKIE)
+#define ZFILE_IN_MEMORY_WRITE
+#endif
+
+/* Uncompressed files bigger than this still go through a temporary file.  */
+#define ZFILE_MEMORY_MAX    (64 * 1024 * 1024)
+
+/* Size of the blocks read from zlib.  */
+#define ZFILE_BLOCK_SIZE    (64 * 1024)
+
 /* We could add more here...  */
 enum compression_type {
     COMPR_NONE,
@@ -83,12 +105,21 @@ enum compression_type {
 
 /* This defines a linked list of all the compressed files that have been
    opened.  */
+/* Uncompressed data of a file kept in memory.  */
+typedef struct zfile_mem_s {
+    uint8_t *buf;                /* Data.  */
+    size_t size;                 /* Size of the data.  */
+    size_t capacity;             /* Allocated size of `buf'.  */
+    size_t pos;                  /* Stream position, for writable streams.  */
+} zfile_mem_t;
+
 struct zfile_s {
     char *tmp_name;              /* Name of the temporary file.  */
     char *orig_name;             /* Name of the original file.  */
     int write_mode;              /* Non-zero if the file is open for writing.*/
     FILE *stream;                /* Associated stdio-style stream.  */
     FILE *fd;                    /* Associated file descriptor.  */
+    zfile_mem_t *mem;            /* Uncompressed data if kept in memory.  */
     enum compression_type type;  /* Compression algorithm.  */
     struct zfile_s *prev, *next; /* Link to the previous and next nodes.  */
     zfile_action_t action;       /* action on close */
@@ -104,6 +135,14 @@ static log_t zlog = LOG_ERR;
 
 static int zinit_done = 0;
 
+static void zfile_mem_free(zfile_mem_t *mem)
+{
+    if (mem != NULL) {
+        lib_free(mem->buf);
+        lib_free(mem);
+    }
+}
+
 
 /** \@brief 'Check' is file \a name is a gzip or compress file
  *
@@ -136,6 +175,7 @@ static void zfile_list_destroy(void)
 
         lib_free(p->orig_name);
         lib_free(p->tmp_name);
+        zfile_mem_free(p->mem);
         next = p->next;
         lib_free(p);
         p = next;
@@ -162,7 +202,8 @@ static void zfile_list_add(const char *tmp_name,
                            const char *orig_name,
                            enum compression_type type,
                            int write_mode,
-                           FILE *stream, FILE *fd)
+                           FILE *stream, FILE *fd,
+                           zfile_mem_t *mem)
 {
     zfile_t *new_zfile = lib_malloc(sizeof(zfile_t));
 
@@ -174,6 +215,7 @@ static void zfile_list_add(const char *tmp_name,
     new_zfile->write_mode = write_mode;
     new_zfile->stream = stream;
     new_zfile->fd = fd;
+    new_zfile->mem = mem;
     new_zfile->type = type;
     new_zfile->action = ZFILE_KEEP;
     new_zfile->request_string = NULL;
@@ -203,6 +245,7 @@ static char *try_uncompress_with_gzip(const char *name)
     FILE *fddest;
     gzFile fdsrc;
     char *tmp_name = NULL;
+    char *buf;
     int len;
 
     if (!file_is_gzip(name)) {
@@ -222,13 +265,16 @@ static char *try_uncompress_with_gzip(const char *name)
         lib_free(tmp_name);
         return NULL;
     }
+#if ZLIB_VERNUM >= 0x1240
+    gzbuffer(fdsrc, ZFILE_BLOCK_SIZE);
+#endif
 
+    buf = lib_malloc(ZFILE_BLOCK_SIZE);
     do {
-        char buf[256];
-
-        len = gzread(fdsrc, (void *)buf, 256);
+        len = gzread(fdsrc, (void *)buf, ZFILE_BLOCK_SIZE);
         if (len > 0) {
             if (fwrite((void *)buf, 1, (size_t)len, fddest) < len) {
+                lib_free(buf);
                 gzclose(fdsrc);
                 fclose(fddest);
                 archdep_remove(tmp_name);
@@ -237,6 +283,7 @@ static char *try_uncompress_with_gzip(const char *name)
             }
         }
     } while (len > 0);
+    lib_free(buf);
 
     gzclose(fdsrc);
     fclose(fddest);
@@ -276,6 +323,171 @@ static char *try_uncompress_with_gzip(const char *name)
 #endif
 }
 
+#if defined(ZFILE_IN_MEMORY) || defined(ZFILE_IN_MEMORY_WRITE)
+/* If `name' has a gzip-like extension, try to uncompress it into memory.
+   Return the uncompressed data, or NULL if the file cannot be uncompressed
+   or is bigger than ZFILE_MEMORY_MAX, so the caller can fall back to a
+   temporary file.  */
+static zfile_mem_t *try_uncompress_with_gzip_to_memory(const char *name)
+{
+    gzFile fdsrc;
+    zfile_mem_t *mem;
+    int len;
+
+    if (!file_is_gzip(name)) {
+        return NULL;
+    }
+
+    fdsrc = gzopen(name, MODE_READ);
+    if (fdsrc == NULL) {
+        return NULL;
+    }
+#if ZLIB_VERNUM >= 0x1240
+    gzbuffer(fdsrc, ZFILE_BLOCK_SIZE);
+#endif
+
+    mem = lib_calloc(1, sizeof *mem);
+    do {
+        if (mem->capacity - mem->size < ZFILE_BLOCK_SIZE) {
+            if (mem->capacity >= ZFILE_MEMORY_MAX) {
+                ZDEBUG(("try_uncompress_with_gzip_to_memory: `%s' is too big",
+                        name));
+                len = -1;
+                break;
+            }
+            mem->capacity = mem->capacity ? mem->capacity * 2 : ZFILE_BLOCK_SIZE * 4;
+            mem->buf = lib_realloc(mem->buf, mem->capacity);
+        }
+        len = gzread(fdsrc, (void *)(mem->buf + mem->size), ZFILE_BLOCK_SIZE);
+        if (len > 0) {
+            mem->size += (size_t)len;
+        }
+    } while (len > 0);
+
+    gzclose(fdsrc);
+
+    if (len < 0) {
+        zfile_mem_free(mem);
+        return NULL;
+    }
+    return mem;
+}
+#endif
+
+#ifdef ZFILE_IN_MEMORY_WRITE
+/* fopencookie() functions of the streams on files kept in memory that are
+   opened for writing.  Writes past the end grow the data, the gap left by
+   seeking past the end is filled with zeroes.  */
+static ssize_t zfile_mem_read(void *cookie, char *buf, size_t size)
+{
+    zfile_mem_t *mem = cookie;
+
+    if (mem->pos >= mem->size) {
+        return 0;
+    }
+    if (size > mem->size - mem->pos) {
+        size = mem->size - mem->pos;
+    }
+    memcpy(buf, mem->buf + mem->pos, size);
+    mem->pos += size;
+    return (ssize_t)size;
+}
+
+static ssize_t zfile_mem_write(void *cookie, const char *buf, size_t size)
+{
+    zfile_mem_t *mem = cookie;
+    size_t end = mem->pos + size;
+
+    if (end > mem->capacity) {
+        size_t capacity = mem->capacity ? mem->capacity : ZFILE_BLOCK_SIZE;
+
+        while (capacity < end) {
+            capacity *= 2;
+        }
+        mem->buf = lib_realloc(mem->buf, capacity);
+        mem->capacity = capacity;
+    }
+    if (mem->pos > mem->size) {
+        memset(mem->buf + mem->size, 0, mem->pos - mem->size);
+    }
+    memcpy(mem->buf + mem->pos, buf, size);
+    mem->pos = end;
+    if (end > mem->size) {
+        mem->size = end;
+    }
+    return (ssize_t)size;
+}
+
+static int zfile_mem_seek(void *cookie, off64_t *offset, int whence)
+{
+    zfile_mem_t *mem = cookie;
+    off64_t pos;
+
+    switch (whence) {
+        case SEEK_SET:
+            pos = *offset;
+            break;
+        case SEEK_CUR:
+            pos = (off64_t)mem->pos + *offset;
+            break;
+        case SEEK_END:
+            pos = (off64_t)mem->size + *offset;
+            break;
+        default:
+            return -1;
+    }
+    if (pos < 0) {
+        return -1;
+    }
+    mem->pos = (size_t)pos;
+    *offset = pos;
+    return 0;
+}
+
+static int zfile_mem_close(void *cookie)
+{
+    /* the data is compressed and freed by handle_close() */
+    return 0;
+}
+
+static const cookie_io_functions_t zfile_mem_functions = {
+    zfile_mem_read,
+    zfile_mem_write,
+    zfile_mem_seek,
+    zfile_mem_close
+};
+#endif
+
+#if defined(ZFILE_IN_MEMORY) || defined(ZFILE_IN_MEMORY_WRITE)
+/* Open a stream with `mode' on the uncompressed data in `mem'.  Return NULL
+   if the data cannot be accessed in this mode without a temporary file.  */
+static FILE *zfile_mem_open(zfile_mem_t *mem, const char *mode, int write_mode)
+{
+    if (write_mode) {
+#ifdef ZFILE_IN_MEMORY_WRITE
+        /* appending is left to the temporary file */
+        if (strchr(mode, 'a') != NULL) {
+            return NULL;
+        }
+        if (strchr(mode, 'w') != NULL) {
+            mem->size = 0;
+        }
+        mem->pos = 0;
+        return fopencookie(mem, mode, zfile_mem_functions);
+#else
+        return NULL;
+#endif
+    }
+#ifdef ZFILE_IN_MEMORY
+    /* fmemopen() does not accept empty buffers */
+    if (mem->size > 0) {
+        return fmemopen(mem->buf, mem->size, "r");
+    }
+#endif
+    return NULL;
+}
+#endif
+
 /* If `name' has a bzip-like extension, try to uncompress it into a temporary
    file using bzip.  If this succeeds, return the name of the temporary file;
    return NULL otherwise.  */
@@ -779,13 +991,21 @@ static const valid_archives_t valid_archives[] = {
    temporary file, return the type of algorithm used and the name of the
    temporary file in `tmp_name'.  If `write_mode' is non-zero and the
    returned `tmp_name' has zero length, then the file cannot be accessed in
-   write mode.  */
+   write mode.  If the file was uncompressed into memory instead, `tmp_name'
+   is NULL and a stream opened with `mode' and the data are returned in
+   `mem_stream' and `mem'.  */
 static enum compression_type try_uncompress(const char *name,
                                             char **tmp_name,
-                                            int write_mode)
+                                            const char *mode,
+                                            int write_mode,
+                                            FILE **mem_stream,
+                                            zfile_mem_t **mem)
 {
     int i;
 
+    *mem_stream = NULL;
+    *mem = NULL;
+
     for (i = 0; valid_archives[i].program; i++) {
         if ((*tmp_name = try_uncompress_archive(name, write_mode,
                                                 valid_archives[i].program,
@@ -799,6 +1019,17 @@ static enum compression_type try_uncompress(const char *name,
     }
 
     /* need this order or .tar.gz is misunderstood */
+#if defined(ZFILE_IN_MEMORY) || defined(ZFILE_IN_MEMORY_WRITE)
+    if ((*mem = try_uncompress_with_gzip_to_memory(name)) != NULL) {
+        *mem_stream = zfile_mem_open(*mem, mode, write_mode);
+        if (*mem_stream != NULL) {
+            *tmp_name = NULL;
+            return COMPR_GZIP;
+        }
+        zfile_mem_free(*mem);
+        *mem = NULL;
+    }
+#endif
     if ((*tmp_name = try_uncompress_with_gzip(name)) != NULL) {
         return COMPR_GZIP;
     }
@@ -832,33 +1063,39 @@ static int compress_with_gzip(const char *src, const char *dest)
 #ifdef HAVE_ZLIB
     FILE *fdsrc;
     gzFile fddest;
+    char *buf;
     size_t len;
+    int retval = 0;
 
-    fdsrc = fopen(dest, MODE_READ);
+    fdsrc = fopen(src, MODE_READ);
     if (fdsrc == NULL) {
         return -1;
     }
 
-    fddest = gzopen(src, MODE_WRITE "9");
+    fddest = gzopen(dest, MODE_WRITE "9");
     if (fddest == NULL) {
         fclose(fdsrc);
         return -1;
     }
 
+    buf = lib_malloc(ZFILE_BLOCK_SIZE);
     do {
-        char buf[256];
-        len = fread((void *)buf, 256, 1, fdsrc);
-        if (len > 0) {
-            gzwrite(fddest, (void *)buf, (unsigned int)len);
+        len = fread((void *)buf, 1, ZFILE_BLOCK_SIZE, fdsrc);
+        if (len > 0 && gzwrite(fddest, (void *)buf, (unsigned int)len) != (int)len) {
+            retval = -1;
+            break;
         }
     } while (len > 0);
+    lib_free(buf);
 
-    gzclose(fddest);
+    if (gzclose(fddest) != Z_OK) {
+        retval = -1;
+    }
     fclose(fdsrc);
 
-    ZDEBUG(("compress with zlib: OK."));
+    ZDEBUG(("compress with zlib: %s.", retval == 0 ? "OK" : "failed"));
 
-    return 0;
+    return retval;
 #else
     static char *argv[4];
     int exit_status;
@@ -891,6 +1128,40 @@ static int compress_with_gzip(const char *src, const char *dest)
 #endif
 }
 
+#ifdef ZFILE_IN_MEMORY_WRITE
+/* Compress the data in `mem' into `dest' using zlib.  */
+static int compress_memory_with_gzip(const zfile_mem_t *mem, const char *dest)
+{
+    gzFile fddest;
+    size_t done, len;
+    int retval = 0;
+
+    fddest = gzopen(dest, MODE_WRITE "9");
+    if (fddest == NULL) {
+        return -1;
+    }
+
+    for (done = 0; done < mem->size; done += len) {
+        len = mem->size - done;
+        if (len > ZFILE_BLOCK_SIZE) {
+            len = ZFILE_BLOCK_SIZE;
+        }
+        if (gzwrite(fddest, (void *)(mem->buf + done), (unsigned int)len) != (int)len) {
+            retval = -1;
+            break;
+        }
+    }
+
+    if (gzclose(fddest) != Z_OK) {
+        retval = -1;
+    }
+
+    ZDEBUG(("compress from memory with zlib: %s.", retval == 0 ? "OK" : "failed"));
+
+    return retval;
+}
+#endif
+
 /* Compress `src' into `dest' using bzip.  */
 static int compress_with_bzip(const char *src, const char *dest)
 {
@@ -924,9 +1195,10 @@ static int compress_with_bzip(const char *src, const char *dest)
     }
 }
 
-/* Compress `src' into `dest' using algorithm `type'.  */
-static int zfile_compress(const char *src, const char *dest,
-                          enum compression_type type)
+/* Compress `src', or the data in `mem' if `src' is NULL, into `dest' using
+   algorithm `type'.  */
+static int zfile_compress(const char *src, const zfile_mem_t *mem,
+                          const char *dest, enum compression_type type)
 {
     char *dest_backup_name;
     int retval;
@@ -989,6 +1261,12 @@ static int zfile_compress(const char *src, const char *dest,
 
     switch (type) {
         case COMPR_GZIP:
+#ifdef ZFILE_IN_MEMORY_WRITE
+            if (src == NULL) {
+                retval = compress_memory_with_gzip(mem, dest);
+                break;
+            }
+#endif
             retval = compress_with_gzip(src, dest);
             break;
         case COMPR_BZIP:
@@ -1036,8 +1314,10 @@ FILE *zfile_fopen(const char *name, const char *mode)
 {
     char *tmp_name;
     FILE *stream;
+    zfile_mem_t *mem;
     enum compression_type type;
     int write_mode = 0;
+    tick_t start;
 
     if (!zinit_done) {
         zinit();
@@ -1057,13 +1337,19 @@ FILE *zfile_fopen(const char *name, const char *mode)
         return NULL;
     }
 
-    type = try_uncompress(name, &tmp_name, write_mode);
+    start = tick_now();
+    type = try_uncompress(name, &tmp_name, mode, write_mode, &stream, &mem);
     if (type == COMPR_NONE) {
         stream = fopen(name, mode);
         if (stream == NULL) {
             return NULL;
         }
-        zfile_list_add(NULL, name, type, write_mode, stream, NULL);
+        zfile_list_add(NULL, name, type, write_mode, stream, NULL, NULL);
+        return stream;
+    } else if (stream != NULL) {
+        log_message(zlog, "Uncompressed `%s' into memory in %.1f ms.",
+                    name, TICK_TO_MICRO(tick_now_delta(start)) / 1000.0);
+        zfile_list_add(NULL, name, type, write_mode, stream, NULL, mem);
         return stream;
     } else if (*tmp_name == '\0') {
         errno = EACCES;
@@ -1076,7 +1362,9 @@ FILE *zfile_fopen(const char *name, const char *mode)
         return NULL;
     }
 
-    zfile_list_add(tmp_name, name, type, write_mode, stream, NULL);
+    log_message(zlog, "Uncompressed `%s' into a temporary file in %.1f ms.",
+                name, TICK_TO_MICRO(tick_now_delta(start)) / 1000.0);
+    zfile_list_add(tmp_name, name, type, write_mode, stream, NULL, NULL);
 
     /* now we don't need the archdep_tmpnam allocation any more */
     lib_free(tmp_name);
@@ -1116,11 +1404,20 @@ static int handle_close(zfile_t *ptr)
             ptr->tmp_name ? ptr->tmp_name : "(null)",
             ptr->orig_name, ptr->write_mode));
 
+    if (ptr->mem) {
+        /* Recompress into the original file.  */
+        if (ptr->orig_name
+            && ptr->write_mode
+            && zfile_compress(NULL, ptr->mem, ptr->orig_name, ptr->type)) {
+            return -1;
+        }
+    }
+
     if (ptr->tmp_name) {
         /* Recompress into the original file.  */
         if (ptr->orig_name
             && ptr->write_mode
-            && zfile_compress(ptr->tmp_name, ptr->orig_name, ptr->type)) {
+            && zfile_compress(ptr->tmp_name, NULL, ptr->orig_name, ptr->type)) {
             return -1;
         }
 
@@ -1149,6 +1446,7 @@ static int handle_close(zfile_t *ptr)
     if (ptr->tmp_name) {
         lib_free(ptr->tmp_name);
     }
+    zfile_mem_free(ptr->mem);
     if (ptr->request_string) {
         lib_free(ptr->request_string);
     }